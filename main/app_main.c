@@ -4,52 +4,125 @@
 #include "drivers/touch_driver.h"
 #include "ui/screens/ui_first_setup.h"
 #include "ui/ui.h"
+#include "core/anomaly_detector.h"
+#include "core/actuator_manager.h"
 #include "core/climate_controller.h"
 #include "core/data_simulator.h"
+#include "core/probe_manager.h"
+#include "core/profile_manager.h"
+#include "core/safety_interlock.h"
+#include "core/schedule_manager.h"
+#include "core/sensor_hal.h"
 #include "core/event_logger.h"
 #include "core/system_monitor.h"
 #include "core/settings_manager.h"
 #include "core/power_manager.h"
 #include "core/network_manager.h"
+#ifndef REPTICONTROL_HEADLESS
+#include "core/mqtt_manager.h"
+#endif
 #include "core/watchdog_manager.h"
 #include "utils/rtc_manager.h"
+#include "utils/alloc_tracker.h"
+#ifdef REPTICONTROL_FUNC_TRACE
+#include "utils/func_trace.h"
+#endif
+#ifdef REPTICONTROL_UI_REPLAY
+#include "utils/ui_interaction_bench.h"
+#endif
+#ifdef REPTICONTROL_BOOT_PROFILE
+#include "utils/boot_profiler.h"
+#define BOOT_MARK(stage) boot_profiler_mark(stage)
+#else
+#define BOOT_MARK(stage) do { } while (0)
+#endif
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 static const char *TAG = "app_main";
 
+// Notified by the sensor task after each sample
+static TaskHandle_t climate_task_handle;
+
 // Forward declarations for task functions
 static void ui_task(void *pvParameter);
-static void sensor_simulator_task(void *pvParameter);
+static void sensor_task(void *pvParameter);
 static void climate_control_task(void *pvParameter);
 static void system_monitor_task(void *pvParameter);
 static void power_management_task(void *pvParameter);
 static void network_task(void *pvParameter);
+#ifdef REPTICONTROL_BOOT_PROFILE
+static void boot_report_task(void *pvParameter);
+#endif
+#ifdef REPTICONTROL_ALLOC_TRACE
+static void zero_alloc_check_task(void *pvParameter);
+#endif
+#ifdef REPTICONTROL_FUNC_TRACE
+static void func_trace_task(void *pvParameter);
+#endif
 
 // Initialization and main entry point
 void repticontrol_main(void) {
     ESP_LOGI(TAG, "Initializing ReptiControl application");
+#ifdef REPTICONTROL_ALLOC_TRACE
+    alloc_tracker_init();
+#endif
+#ifdef REPTICONTROL_BOOT_PROFILE
+    boot_profiler_start();
+#endif
 
     // Initialize components
     settings_init();
+    BOOT_MARK("settings");
     display_config_init();
+    lv_init();
     display_init();
+    BOOT_MARK("display");
     touch_init();
+    BOOT_MARK("touch");
     rtc_init();
+    BOOT_MARK("rtc");
     event_logger_init();
+    BOOT_MARK("event_logger");
     climate_controller_init();
+    BOOT_MARK("climate_controller");
     data_simulator_init();
+    BOOT_MARK("data_simulator");
+    sensor_hal_init();
+    BOOT_MARK("sensor_hal");
+    probe_manager_init();
+    BOOT_MARK("probe_manager");
+    actuator_manager_init();
+    BOOT_MARK("actuators");
+    safety_interlock_init();
+    BOOT_MARK("safety_interlock");
+    anomaly_detector_init();
+    BOOT_MARK("anomaly_detector");
+    schedule_manager_init();
+    BOOT_MARK("schedule_manager");
+    profile_manager_init();
+    BOOT_MARK("profile_manager");
     system_monitor_init();
+    BOOT_MARK("system_monitor");
     power_manager_init();
+    BOOT_MARK("power_manager");
     network_manager_init();
+    BOOT_MARK("network_manager");
     watchdog_manager_init();
+    BOOT_MARK("watchdog");
 
     // Initialize the UI (with splash screen)
     ui_init();
+    BOOT_MARK("ui");
 
-    // First-run setup if necessary
+#ifndef REPTICONTROL_HEADLESS
+    // First-run setup if necessary (nobody can tap through it headless)
     if (!settings_has_display_type()) {
         ui_first_setup_create();
         while (!ui_first_setup_is_complete()) {
@@ -58,22 +131,41 @@ void repticontrol_main(void) {
         }
         display_config_apply(display_config_get_type());
     }
+#endif
 
     // Register tasks with watchdog
     watchdog_manager_register_task("ui_task", 2000);
-    watchdog_manager_register_task("simulator_task", 3000);
-    watchdog_manager_register_task("climate_task", 2000);
+    watchdog_manager_register_task("sensor_task", 3000);
+    watchdog_manager_register_task("climate_task", CLIMATE_FALLBACK_PERIOD_MS + 1000);
     watchdog_manager_register_task("monitor_task", 4000);
     watchdog_manager_register_task("power_task", 3000);
     watchdog_manager_register_task("network_task", 5000);
 
+    // Start the safety interlock before anything can drive an output
+    safety_interlock_start();
+
     // Create tasks
     xTaskCreatePinnedToCore(ui_task, "ui_task", 4096, NULL, 5, NULL, 1);
-    xTaskCreate(sensor_simulator_task, "simulator_task", 2048, NULL, 3, NULL);
-    xTaskCreate(climate_control_task, "climate_task", 2048, NULL, 4, NULL);
-    xTaskCreate(system_monitor_task, "monitor_task", 2048, NULL, 2, NULL);
+    // The control tick can save auto-tune gains and format log lines
+    xTaskCreate(climate_control_task, "climate_task", 4096, NULL, 4, &climate_task_handle);
+    xTaskCreate(sensor_task, "sensor_task", 3072, NULL, 3, NULL);
+    // The monitor formats the statistics line and the interlock and anomaly
+    // log entries
+    xTaskCreate(system_monitor_task, "monitor_task", 4096, NULL, 2, NULL);
     xTaskCreate(power_management_task, "power_task", 2048, NULL, 2, NULL);
     xTaskCreate(network_task, "network_task", 4096, NULL, 1, NULL);
+    BOOT_MARK("tasks");
+
+#ifdef REPTICONTROL_BOOT_PROFILE
+    boot_profiler_report();
+    xTaskCreate(boot_report_task, "boot_report", 3072, NULL, 1, NULL);
+#endif
+#ifdef REPTICONTROL_ALLOC_TRACE
+    xTaskCreate(zero_alloc_check_task, "alloc_check", 3072, NULL, 1, NULL);
+#endif
+#ifdef REPTICONTROL_FUNC_TRACE
+    xTaskCreate(func_trace_task, "func_trace", 3072, NULL, 1, NULL);
+#endif
 
     ESP_LOGI(TAG, "ReptiControl started successfully");
 }
@@ -81,9 +173,16 @@ void repticontrol_main(void) {
 // UI task - handles all GUI updates
 static void ui_task(void *pvParameter) {
     ESP_LOGI(TAG, "UI task started");
+    ALLOC_TRACK_TASK(ALLOC_MODULE_UI);
+
+#ifdef REPTICONTROL_UI_REPLAY
+    // Replay the interaction scripts once on real hardware
+    ui_interaction_bench_run();
+#endif
 
     while (1) {
-        // Process UI events
+        // Show what the other tasks logged, then process UI events
+        event_logger_drain_ui();
         ui_update();
 
         // Feed watchdog
@@ -94,53 +193,108 @@ static void ui_task(void *pvParameter) {
     }
 }
 
-// Simulates sensor data
-static void sensor_simulator_task(void *pvParameter) {
-    ESP_LOGI(TAG, "Sensor simulator task started");
+// Samples the sensors: polls the sensor HAL whenever a conversion is ready
+// or a sample is due, and hands a frame of the latest values to the
+// control loop once per period
+static void sensor_task(void *pvParameter) {
+    ESP_LOGI(TAG, "Sensor task started");
+    ALLOC_TRACK_TASK(ALLOC_MODULE_SIMULATOR);
 
+    const int64_t period_us = CLIMATE_CONTROL_PERIOD_MS * 1000LL;
+    int64_t frame_us = esp_timer_get_time();
     while (1) {
-        // Update simulated sensor readings
-        data_simulator_update();
+        int64_t now_us = esp_timer_get_time();
+        bool frame = now_us >= frame_us;
 
-        // Update BLE characteristics with new sensor values
-        network_manager_ble_update_sensors(
-            data_simulator_get_temperature(),
-            data_simulator_get_humidity(),
-            data_simulator_get_light()
-        );
-
-        // Feed watchdog
-        watchdog_manager_feed("simulator_task");
+#ifndef REPTICONTROL_SENSOR_HW
+        // The simulated enclosures move on once per period
+        if (frame) {
+            data_simulator_update();
+        }
+#endif
+        int64_t due_us = sensor_hal_poll(now_us);
+
+        if (frame) {
+            frame_us += period_us;
+            if (frame_us <= now_us) {
+                frame_us = now_us + period_us;
+            }
+
+            // Fresh samples keep the safety interlock from tripping on stale
+            // sensors, so a missing reading is not reported. It gets them
+            // unfiltered, so the filter's lag never delays a cut. Probes are fused
+            // here, once per frame, not per control tick, after suspect
+            // probes have been dropped
+            for (int z = 0; z < climate_controller_get_zone_count(); z++) {
+                sensor_zone_t values;
+                sensor_hal_get_zone(z, &values);
+                anomaly_detector_update(z, &values, climate_controller_zone_is_on(z, CLIMATE_ACTUATOR_HEATING),
+                                        now_us / 1000);
+                float safety_temp = sensor_hal_get_unfiltered(z, SENSOR_VALUE_TEMPERATURE);
+                float safety_humidity = sensor_hal_get_unfiltered(z, SENSOR_VALUE_HUMIDITY);
+                if (!isnan(safety_temp) && !isnan(safety_humidity)) {
+                    safety_interlock_report_sample(z, safety_temp, safety_humidity);
+                }
+                probe_manager_report(z, values.probes, now_us);
+            }
+
+            // Hand the frame to the control loop; it runs at a higher priority
+            climate_controller_sample_ready(now_us);
+            xTaskNotifyGive(climate_task_handle);
+
+            // Update BLE characteristics with new sensor values
+            network_manager_ble_update_sensors(
+                sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE),
+                sensor_hal_get_value(0, SENSOR_VALUE_HUMIDITY),
+                sensor_hal_get_value(0, SENSOR_VALUE_LIGHT)
+            );
+
+            // Feed watchdog
+            watchdog_manager_feed("sensor_task");
+        }
 
-        // Delay between updates (1 second)
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        // Sleep until the next conversion or frame, whichever comes first
+        int64_t wait_us = (due_us < frame_us ? due_us : frame_us) - esp_timer_get_time();
+        TickType_t ticks = wait_us > 0 ? pdMS_TO_TICKS(wait_us / 1000) : 0;
+        vTaskDelay(ticks > 0 ? ticks : 1);
     }
 }
 
 // Climate control execution task
 static void climate_control_task(void *pvParameter) {
     ESP_LOGI(TAG, "Climate control task started");
+    ALLOC_TRACK_TASK(ALLOC_MODULE_CLIMATE);
 
     while (1) {
-        // Update climate controls based on current settings and schedule
+        // Wait for a fresh sample, or fall back to a slower tick when the
+        // sensors stall
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CLIMATE_FALLBACK_PERIOD_MS));
+
+        // Follow day/night profiles, move targets ahead of scheduled
+        // changes, then update climate controls
+        time_t now = time(NULL);
+        profile_manager_update(now);
+        schedule_manager_update(now);
         climate_controller_update();
 
         // Feed watchdog
         watchdog_manager_feed("climate_task");
-
-        // Delay between control updates (500ms)
-        vTaskDelay(pdMS_TO_TICKS(500));
     }
 }
 
 // System monitoring task
 static void system_monitor_task(void *pvParameter) {
     ESP_LOGI(TAG, "System monitor task started");
+    ALLOC_TRACK_TASK(ALLOC_MODULE_MONITOR);
 
     while (1) {
         // Update system status (battery, memory, etc.)
         system_monitor_update();
 
+        // Log safety trips here, where waiting on the logger or UI is harmless
+        safety_interlock_report();
+        anomaly_detector_report();
+
         // Feed watchdog
         watchdog_manager_feed("monitor_task");
 
@@ -152,6 +306,7 @@ static void system_monitor_task(void *pvParameter) {
 // Power management task
 static void power_management_task(void *pvParameter) {
     ESP_LOGI(TAG, "Power management task started");
+    ALLOC_TRACK_TASK(ALLOC_MODULE_POWER);
 
     while (1) {
         // Update power management status
@@ -168,6 +323,7 @@ static void power_management_task(void *pvParameter) {
 // Network management task
 static void network_task(void *pvParameter) {
     ESP_LOGI(TAG, "Network task started");
+    ALLOC_TRACK_TASK(ALLOC_MODULE_NETWORK);
 
     // Load Wi-Fi credentials from settings
     rc_wifi_config_t wifi_config = {0};
@@ -183,11 +339,100 @@ static void network_task(void *pvParameter) {
     network_manager_wifi_start(&wifi_config);
     network_manager_ble_start();
 
+#ifndef REPTICONTROL_HEADLESS
+    int64_t energy_published_us = 0;
+#endif
     while (1) {
         // Feed watchdog
         watchdog_manager_feed("network_task");
 
+#ifndef REPTICONTROL_HEADLESS
+        // Zone 0 actuator energy, moist-air metrics and reading
+        // statistics, the control latency and the sensor filters, once a
+        // minute while the broker is up
+        int64_t now_us = esp_timer_get_time();
+        if (mqtt_manager_is_connected() && now_us - energy_published_us >= 60LL * 1000 * 1000) {
+            static const char *const names[CLIMATE_ACTUATOR_COUNT] = {
+                "heating", "cooling", "humidifier", "lighting"
+            };
+            for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+                energy_summary_t energy;
+                climate_controller_zone_get_energy(0, a, &energy);
+                mqtt_manager_publish_energy(names[a], energy.last_hour_duty, energy.day_cycles,
+                                            energy.day_wh, (float)(energy.total_wh / 1000.0));
+            }
+
+            climate_metrics_t metrics;
+            climate_controller_zone_get_metrics(0, &metrics);
+            if (!isnan(metrics.vpd_kpa)) {
+                mqtt_manager_publish_climate_metrics(metrics.vpd_kpa, metrics.dew_point_c, metrics.abs_humidity_gm3);
+            }
+
+            // The day in progress, and the last full hour and day
+            static const char *const readings[CLIMATE_STAT_COUNT] = { "temperature", "humidity", "light", "vpd" };
+            for (int c = 0; c < CLIMATE_STAT_COUNT; c++) {
+                stream_summary_t summary;
+                climate_controller_zone_get_stats(0, c, STREAM_WINDOW_DAY, false, &summary);
+                mqtt_manager_publish_stats(readings[c], "day", &summary);
+                climate_controller_zone_get_stats(0, c, STREAM_WINDOW_HOUR, true, &summary);
+                mqtt_manager_publish_stats(readings[c], "last_hour", &summary);
+                climate_controller_zone_get_stats(0, c, STREAM_WINDOW_DAY, true, &summary);
+                mqtt_manager_publish_stats(readings[c], "last_day", &summary);
+            }
+
+            climate_timing_t timing;
+            climate_controller_get_timing(&timing);
+            mqtt_manager_publish_control_latency(timing.latency_avg_us / 1000.0f, timing.latency_max_us / 1000.0f,
+                                                 timing.fallback_ticks);
+
+            static const char *const values[SENSOR_VALUE_COUNT] = { "temperature", "humidity", "light" };
+            for (int v = 0; v < SENSOR_VALUE_COUNT; v++) {
+                sensor_filter_report_t report;
+                sensor_hal_get_filter_report(v, &report);
+                mqtt_manager_publish_filter(values[v], report.lag_ms, report.noise_ratio, report.stats.gated);
+            }
+            energy_published_us = now_us;
+        }
+#endif
+
         // Network management loop
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
+
+#ifdef REPTICONTROL_BOOT_PROFILE
+// Reports task CPU usage once the application has settled
+static void boot_report_task(void *pvParameter) {
+    vTaskDelay(pdMS_TO_TICKS(BOOT_PROFILE_SETTLE_MS));
+    boot_profiler_report_tasks();
+    ESP_LOGI(TAG, "BOOT_PROFILE_END");
+    vTaskDelete(NULL);
+}
+#endif
+
+#ifdef REPTICONTROL_ALLOC_TRACE
+// Asserts that the core tasks stop allocating once the system has settled
+static void zero_alloc_check_task(void *pvParameter) {
+    vTaskDelay(pdMS_TO_TICKS(ALLOC_STEADY_STATE_MS));
+    alloc_tracker_arm();
+    vTaskDelay(pdMS_TO_TICKS(ALLOC_CHECK_WINDOW_MS));
+
+    if (alloc_tracker_check(ALLOC_CORE_MODULES) != ESP_OK) {
+        ESP_LOGE(TAG, "ZERO_ALLOC FAIL");
+        abort();
+    }
+    ESP_LOGI(TAG, "ZERO_ALLOC PASS");
+    vTaskDelete(NULL);
+}
+#endif
+
+#ifdef REPTICONTROL_FUNC_TRACE
+// Traces the running application and dumps per-function counters
+static void func_trace_task(void *pvParameter) {
+    func_trace_start();
+    vTaskDelay(pdMS_TO_TICKS(FUNC_TRACE_DURATION_MS));
+    func_trace_stop();
+    func_trace_dump();
+    vTaskDelete(NULL);
+}
+#endif
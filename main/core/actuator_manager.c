@@ -0,0 +1,288 @@
+#include "actuator_manager.h"
+#include "actuator_driver.h"
+#include "climate_controller.h"
+#include "pin_mapping.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "actuator_manager";
+
+// Board wiring: zone 0's relays on the expander, its lamp on a dimmer
+static const actuator_channel_t default_channels[] = {
+    { 0, CLIMATE_ACTUATOR_HEATING, ACTUATOR_KIND_RELAY, RELAY_HEATER_BIT,
+      ACTUATOR_RELAY_MIN_ON_MS, ACTUATOR_RELAY_MIN_OFF_MS },
+    { 0, CLIMATE_ACTUATOR_COOLING, ACTUATOR_KIND_RELAY, RELAY_FAN_BIT,
+      ACTUATOR_RELAY_MIN_ON_MS, ACTUATOR_RELAY_MIN_OFF_MS },
+    { 0, CLIMATE_ACTUATOR_HUMIDIFIER, ACTUATOR_KIND_RELAY, RELAY_HUMIDIFIER_BIT,
+      ACTUATOR_RELAY_MIN_ON_MS, ACTUATOR_RELAY_MIN_OFF_MS },
+    { 0, CLIMATE_ACTUATOR_LIGHTING, ACTUATOR_KIND_PWM, LAMP_PWM_GPIO, 0, 0 },
+};
+
+// Channel table and the channel of each zone's actuator (-1 if none)
+static actuator_channel_t channels[ACTUATOR_MAX_CHANNELS];
+static int channel_count = 0;
+static int8_t channel_of[CLIMATE_ACTUATOR_COUNT][CLIMATE_MAX_ZONES];
+
+// Requested level and output state per channel
+static float requested[ACTUATOR_MAX_CHANNELS];
+static bool on[ACTUATOR_MAX_CHANNELS];
+static uint16_t duty[ACTUATOR_MAX_CHANNELS];
+static int64_t changed_at[ACTUATOR_MAX_CHANNELS];
+static uint32_t cycles[ACTUATOR_MAX_CHANNELS];
+
+// Cut channels, one bit each. Set by the safety task without the lock and
+// applied by whoever holds it.
+static _Atomic uint32_t cut_mask;
+
+// Relay bits and duties last written
+static uint8_t written_bits;
+static uint16_t written_duty[ACTUATOR_MAX_CHANNELS];
+
+static actuator_stats_t stats;
+
+// Commits come from the climate task, cuts from the safety task
+static SemaphoreHandle_t lock = NULL;
+
+// Initialize the outputs from the board's channel table
+esp_err_t actuator_manager_init(void) {
+    ESP_LOGI(TAG, "Initializing actuator outputs");
+    return actuator_manager_set_channels(default_channels,
+                                         sizeof(default_channels) / sizeof(default_channels[0]));
+}
+
+// Replace the channel table; all outputs go off
+esp_err_t actuator_manager_set_channels(const actuator_channel_t *table, int count) {
+    if (count < 0 || count > ACTUATOR_MAX_CHANNELS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < count; i++) {
+        if (table[i].zone >= CLIMATE_MAX_ZONES || table[i].actuator >= CLIMATE_ACTUATOR_COUNT ||
+            (table[i].kind == ACTUATOR_KIND_RELAY && table[i].pin > 7)) {
+            ESP_LOGE(TAG, "Invalid channel %d", i);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    if (lock == NULL) {
+        lock = xSemaphoreCreateMutex();
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    memset(channel_of, -1, sizeof(channel_of));
+    for (int i = 0; i < count; i++) {
+        channels[i] = table[i];
+        channel_of[table[i].actuator][table[i].zone] = i;
+        requested[i] = 0.0f;
+        on[i] = false;
+        duty[i] = 0;
+        changed_at[i] = INT64_MIN / 2;  // Long ago: the first switch is never held
+        cycles[i] = 0;
+        written_duty[i] = 0;
+    }
+    channel_count = count;
+    atomic_store(&cut_mask, 0);
+    written_bits = 0;
+    memset(&stats, 0, sizeof(stats));
+
+    esp_err_t ret = actuator_driver_init(channels, count);
+    xSemaphoreGive(lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Output driver init failed: %s", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "%d output channels", count);
+    }
+    return ret;
+}
+
+// Channel of a zone's actuator, or -1
+static int find_channel(int zone, int actuator) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES || actuator < 0 || actuator >= CLIMATE_ACTUATOR_COUNT ||
+        channel_count == 0) {
+        return -1;
+    }
+    return channel_of[actuator][zone];
+}
+
+// Request an output level of a zone's actuator
+void actuator_manager_set(int zone, int actuator, float level) {
+    int c = find_channel(zone, actuator);
+    if (c < 0) {
+        return;
+    }
+    requested[c] = level < 0.0f ? 0.0f : level > 1.0f ? 1.0f : level;
+}
+
+// Force the cut channels off, inside their minimum on time too. Called
+// with the lock held.
+static void apply_cuts(uint32_t mask, int64_t now_us) {
+    for (int c = 0; c < channel_count; c++) {
+        if (!((mask >> c) & 1) || !on[c]) {
+            continue;
+        }
+        if (channels[c].kind == ACTUATOR_KIND_RELAY &&
+            now_us - changed_at[c] < (int64_t)channels[c].min_on_ms * 1000) {
+            stats.forced_off++;
+        }
+        on[c] = false;
+        duty[c] = 0;
+        changed_at[c] = now_us;
+    }
+}
+
+// Write the outputs if they differ from what was last written. Called
+// with the lock held.
+static void write_outputs(int64_t now_us) {
+    uint8_t bits = 0;
+    bool changed = false;
+
+    for (int c = 0; c < channel_count; c++) {
+        if (channels[c].kind == ACTUATOR_KIND_RELAY) {
+            bits |= on[c] ? (uint8_t)(1 << channels[c].pin) : 0;
+        } else if (duty[c] != written_duty[c]) {
+            changed = true;
+        }
+    }
+    if (!changed && bits == written_bits) {
+        return;
+    }
+
+    stats.writes++;
+    if (actuator_driver_write(now_us, bits, duty) != ESP_OK) {
+        // Leave the written state alone so the next tick retries
+        stats.write_errors++;
+        return;
+    }
+    written_bits = bits;
+    memcpy(written_duty, duty, sizeof(written_duty));
+}
+
+// Apply the latched cuts and write, until no cut lands during the write,
+// then release the lock. Called with the lock held.
+static void write_and_unlock(int64_t now_us) {
+    for (;;) {
+        uint32_t mask;
+        do {
+            mask = atomic_load(&cut_mask);
+            apply_cuts(mask, now_us);
+            write_outputs(now_us);
+        } while (atomic_load(&cut_mask) != mask);
+        xSemaphoreGive(lock);
+
+        // A cut that landed after the last check found the lock taken and
+        // left it to us
+        if (atomic_load(&cut_mask) == mask || xSemaphoreTake(lock, 0) != pdTRUE) {
+            return;
+        }
+        now_us = esp_timer_get_time();
+    }
+}
+
+// Apply the requested levels and write the changed outputs in one batch
+void actuator_manager_commit(int64_t now_us) {
+    if (channel_count == 0) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    uint32_t mask = atomic_load(&cut_mask);
+    for (int c = 0; c < channel_count; c++) {
+        float level = (mask >> c) & 1 ? 0.0f : requested[c];
+
+        if (channels[c].kind == ACTUATOR_KIND_PWM) {
+            duty[c] = (uint16_t)(level * ACTUATOR_PWM_MAX + 0.5f);
+            bool now_on = duty[c] > 0;
+            cycles[c] += now_on && !on[c];
+            on[c] = now_on;
+            continue;
+        }
+
+        bool want = level > 0.0f;
+        if (want == on[c]) {
+            continue;
+        }
+
+        // Hold the relay until it has been in its state long enough
+        uint32_t min_ms = on[c] ? channels[c].min_on_ms : channels[c].min_off_ms;
+        if (now_us - changed_at[c] < (int64_t)min_ms * 1000) {
+            stats.held++;
+            continue;
+        }
+
+        on[c] = want;
+        duty[c] = want ? ACTUATOR_PWM_MAX : 0;
+        changed_at[c] = now_us;
+        cycles[c] += want;
+    }
+
+    write_and_unlock(now_us);
+}
+
+// Latch a zone's cut and force its outputs off. Never waits on the lock:
+// if a commit is writing, it applies the cut before it lets go.
+void actuator_manager_cut(int zone, uint8_t cut_bits) {
+    if (channel_count == 0 || zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return;
+    }
+
+    uint32_t zone_mask = 0;
+    uint32_t set_mask = 0;
+    for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+        int c = channel_of[a][zone];
+        if (c < 0) {
+            continue;
+        }
+        zone_mask |= 1u << c;
+        set_mask |= ((cut_bits >> a) & 1u) << c;
+    }
+
+    // Cut first, release after, so the zone is never briefly uncut
+    atomic_fetch_or(&cut_mask, set_mask);
+    atomic_fetch_and(&cut_mask, ~(zone_mask & ~set_mask));
+
+    // Releases wait for the next commit; new cuts go out now
+    if (set_mask == 0 || xSemaphoreTake(lock, 0) != pdTRUE) {
+        return;
+    }
+    write_and_unlock(esp_timer_get_time());
+}
+
+// Check if the physical output of a zone's actuator is on
+bool actuator_manager_is_on(int zone, int actuator) {
+    int c = find_channel(zone, actuator);
+    return c >= 0 && on[c];
+}
+
+// Get the PWM duty of a zone's actuator
+uint16_t actuator_manager_get_duty(int zone, int actuator) {
+    int c = find_channel(zone, actuator);
+    return c >= 0 ? duty[c] : 0;
+}
+
+// Get the number of off->on switches of a zone's physical output
+uint32_t actuator_manager_get_cycle_count(int zone, int actuator) {
+    int c = find_channel(zone, actuator);
+    return c >= 0 ? cycles[c] : 0;
+}
+
+// Get the number of channels
+int actuator_manager_get_channel_count(void) {
+    return channel_count;
+}
+
+// Get the channel at an index, or NULL
+const actuator_channel_t *actuator_manager_get_channel(int index) {
+    if (index < 0 || index >= channel_count) {
+        return NULL;
+    }
+    return &channels[index];
+}
+
+// Get the output counters
+void actuator_manager_get_stats(actuator_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,92 @@
+#ifndef ACTUATOR_MANAGER_H
+#define ACTUATOR_MANAGER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Physical output channels (relays share one 8-bit expander)
+#define ACTUATOR_MAX_CHANNELS 8
+
+// Full-scale PWM duty (10-bit LEDC)
+#define ACTUATOR_PWM_MAX 1023
+
+// PWM frequency for lamp dimmers and fans
+#ifndef ACTUATOR_PWM_FREQ_HZ
+#define ACTUATOR_PWM_FREQ_HZ 1000
+#endif
+
+// Default shortest relay on and off times. Sized like CLIMATE_TPO_MIN_MS
+// for the time-compressed simulator; real heaters and misting pumps want
+// tens of seconds.
+#ifndef ACTUATOR_RELAY_MIN_ON_MS
+#define ACTUATOR_RELAY_MIN_ON_MS 1000
+#endif
+#ifndef ACTUATOR_RELAY_MIN_OFF_MS
+#define ACTUATOR_RELAY_MIN_OFF_MS 1000
+#endif
+
+// Output kinds
+typedef enum {
+    ACTUATOR_KIND_RELAY,        // On/off through the I2C expander
+    ACTUATOR_KIND_PWM           // Dimmable lamp or fan on an LEDC channel
+} actuator_kind_t;
+
+// Physical output a logical actuator of a zone is wired to
+typedef struct {
+    uint8_t zone;
+    uint8_t actuator;           // climate_actuator_t
+    actuator_kind_t kind;
+    uint8_t pin;                // Expander bit for relays, GPIO for PWM
+    uint32_t min_on_ms;         // Relays only
+    uint32_t min_off_ms;
+} actuator_channel_t;
+
+// Output counters since init
+typedef struct {
+    uint32_t writes;            // Batched output writes (one per tick with a change)
+    uint32_t write_errors;
+    uint32_t held;              // Relay changes deferred by a minimum on/off time
+    uint32_t forced_off;        // Relays cut by the safety interlock inside their minimum on time
+} actuator_stats_t;
+
+// Initialize the outputs from the board's channel table, all off
+esp_err_t actuator_manager_init(void);
+
+// Replace the channel table (tests and other boards); all outputs go off
+esp_err_t actuator_manager_set_channels(const actuator_channel_t *channels, int count);
+
+// Request an output level of a zone's actuator, 0..1. Relays switch on
+// above 0. Takes effect at the next commit; actuators without a channel
+// are ignored.
+void actuator_manager_set(int zone, int actuator, float level);
+
+// Apply the requested levels, holding relays inside their minimum on/off
+// times, and write every changed output in one batch. Called once per
+// control tick.
+void actuator_manager_commit(int64_t now_us);
+
+// Force a zone's outputs off right away, regardless of minimum on times,
+// and keep them off while cut. cut has bit (1 << actuator) set per output
+// (the SAFETY_CUT_* bits). Called from the safety interlock; never waits
+// on a commit in progress, which writes the cut before it returns.
+void actuator_manager_cut(int zone, uint8_t cut);
+
+// Check if the physical output of a zone's actuator is on
+bool actuator_manager_is_on(int zone, int actuator);
+
+// Get the PWM duty of a zone's actuator (0..ACTUATOR_PWM_MAX; relays read
+// 0 or full scale)
+uint16_t actuator_manager_get_duty(int zone, int actuator);
+
+// Get the number of off->on switches of a zone's physical output
+uint32_t actuator_manager_get_cycle_count(int zone, int actuator);
+
+// Get the channel table
+int actuator_manager_get_channel_count(void);
+const actuator_channel_t *actuator_manager_get_channel(int index);
+
+// Get the output counters
+void actuator_manager_get_stats(actuator_stats_t *stats);
+
+#endif /* ACTUATOR_MANAGER_H */
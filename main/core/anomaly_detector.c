@@ -0,0 +1,363 @@
+#include "anomaly_detector.h"
+#include "climate_controller.h"
+#include "event_logger.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "anomaly_detector";
+
+// Enclosure probes come first in probe_t and have channels of their own
+#define ENCLOSURE_PROBES PROBE_AMBIENT
+#define PROBE_CHANNEL(probe) (ANOMALY_CH_BASKING + (probe))
+
+#define NO_TIME INT64_MIN
+
+// Per channel, written by the sensor task: the last sample, the variance
+// of changes and when it went flat, and until when a rate violation holds
+static float last_value[ANOMALY_CH_COUNT][CLIMATE_MAX_ZONES];
+static int64_t last_ms[ANOMALY_CH_COUNT][CLIMATE_MAX_ZONES];
+static float change_var[ANOMALY_CH_COUNT][CLIMATE_MAX_ZONES];
+static int64_t flat_since_ms[ANOMALY_CH_COUNT][CLIMATE_MAX_ZONES];
+static int64_t rate_until_ms[ANOMALY_CH_COUNT][CLIMATE_MAX_ZONES];
+
+// Drift per enclosure probe: this minute's offsets, the learned offset and
+// the CUSUM sums
+static float offset_sum[ENCLOSURE_PROBES][CLIMATE_MAX_ZONES];
+static uint16_t offset_count[ENCLOSURE_PROBES][CLIMATE_MAX_ZONES];
+static float offset_baseline[ENCLOSURE_PROBES][CLIMATE_MAX_ZONES];
+static uint16_t baseline_minutes[ENCLOSURE_PROBES][CLIMATE_MAX_ZONES];
+static float cusum_high[ENCLOSURE_PROBES][CLIMATE_MAX_ZONES];
+static float cusum_low[ENCLOSURE_PROBES][CLIMATE_MAX_ZONES];
+static int64_t drift_step_ms[CLIMATE_MAX_ZONES];
+
+// Heater response window per zone
+static int64_t heat_window_ms[CLIMATE_MAX_ZONES];
+static float heat_start_temp[CLIMATE_MAX_ZONES];
+static float heat_start_gap[CLIMATE_MAX_ZONES];     // Target minus the reading
+static float heat_rise_idle[CLIMATE_MAX_ZONES];     // Model rise with the heater off, NaN without
+static float heat_rise_full[CLIMATE_MAX_ZONES];     // and on
+static uint16_t heat_on_ticks[CLIMATE_MAX_ZONES];
+static uint16_t heat_ticks[CLIMATE_MAX_ZONES];
+static bool no_response[CLIMATE_MAX_ZONES];
+
+// Results, read by the climate update and the report
+static volatile uint8_t flags[ANOMALY_CH_COUNT][CLIMATE_MAX_ZONES];
+static volatile uint8_t hold[CLIMATE_MAX_ZONES];
+
+// Changes not yet written to the event log, and the stats
+static uint8_t raised_pending[ANOMALY_CH_COUNT][CLIMATE_MAX_ZONES];
+static uint8_t cleared_pending[ANOMALY_CH_COUNT][CLIMATE_MAX_ZONES];
+static anomaly_stats_t stats;
+static portMUX_TYPE state_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Event log text
+static const char *const channel_names[ANOMALY_CH_COUNT] = {
+    "Temperature sensor", "Humidity sensor", "Basking probe", "Cool side probe", "Substrate probe"
+};
+static const struct {
+    uint8_t flag;
+    const char *name;
+} anomaly_names[] = {
+    { ANOMALY_FLATLINE, "stuck at one value" },
+    { ANOMALY_DRIFT, "drifting from the other probes" },
+    { ANOMALY_RATE, "changing faster than possible" },
+    { ANOMALY_NO_RESPONSE, "not rising with the heater on" },
+};
+
+// Clear every detector
+void anomaly_detector_init(void) {
+    for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+        for (int c = 0; c < ANOMALY_CH_COUNT; c++) {
+            last_ms[c][z] = NO_TIME;
+            change_var[c][z] = 1.0f;
+            flat_since_ms[c][z] = NO_TIME;
+            rate_until_ms[c][z] = NO_TIME;
+            flags[c][z] = 0;
+            raised_pending[c][z] = 0;
+            cleared_pending[c][z] = 0;
+        }
+        for (int p = 0; p < ENCLOSURE_PROBES; p++) {
+            offset_sum[p][z] = 0.0f;
+            offset_count[p][z] = 0;
+            offset_baseline[p][z] = 0.0f;
+            baseline_minutes[p][z] = 0;
+            cusum_high[p][z] = 0.0f;
+            cusum_low[p][z] = 0.0f;
+        }
+        drift_step_ms[z] = NO_TIME;
+        heat_window_ms[z] = NO_TIME;
+        no_response[z] = false;
+        hold[z] = 0;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Flat line and rate checks of one channel; returns its FLATLINE and RATE bits
+static uint8_t check_channel(int c, int zone, float value, float rate_max, int64_t now_ms) {
+    if (isnan(value)) {
+        // A missing reading is the interlock's to handle; start over
+        last_ms[c][zone] = NO_TIME;
+        flat_since_ms[c][zone] = NO_TIME;
+    } else {
+        if (last_ms[c][zone] != NO_TIME) {
+            float change = value - last_value[c][zone];
+            float dt_s = (now_ms - last_ms[c][zone]) / 1000.0f;
+
+            if (dt_s > 0.0f && fabsf(change) > rate_max * dt_s) {
+                rate_until_ms[c][zone] = now_ms + ANOMALY_RATE_HOLD_MS;
+            }
+            change_var[c][zone] += (change * change - change_var[c][zone]) / ANOMALY_FLATLINE_SPAN;
+            if (change_var[c][zone] >= ANOMALY_FLATLINE_VARIANCE) {
+                flat_since_ms[c][zone] = NO_TIME;
+            } else if (flat_since_ms[c][zone] == NO_TIME) {
+                flat_since_ms[c][zone] = now_ms;
+            }
+        }
+        last_value[c][zone] = value;
+        last_ms[c][zone] = now_ms;
+    }
+
+    uint8_t result = 0;
+    if (flat_since_ms[c][zone] != NO_TIME && now_ms - flat_since_ms[c][zone] >= ANOMALY_FLATLINE_MS) {
+        result |= ANOMALY_FLATLINE;
+    }
+    if (rate_until_ms[c][zone] != NO_TIME && now_ms < rate_until_ms[c][zone]) {
+        result |= ANOMALY_RATE;
+    }
+    return result;
+}
+
+// Close a minute of probe offsets: learn the offset, then run the CUSUM.
+// Returns whether the probe is drifting.
+static bool step_drift(int p, int zone, bool was_drifting) {
+    if (offset_count[p][zone] == 0) {
+        return was_drifting;
+    }
+    float offset = offset_sum[p][zone] / offset_count[p][zone];
+    offset_sum[p][zone] = 0.0f;
+    offset_count[p][zone] = 0;
+
+    if (baseline_minutes[p][zone] < ANOMALY_DRIFT_WARMUP_MIN) {
+        baseline_minutes[p][zone]++;
+        offset_baseline[p][zone] += (offset - offset_baseline[p][zone]) / baseline_minutes[p][zone];
+        return false;
+    }
+
+    float dev = offset - offset_baseline[p][zone];
+    float high = fmaxf(0.0f, cusum_high[p][zone] + dev - ANOMALY_DRIFT_SLACK_C);
+    float low = fmaxf(0.0f, cusum_low[p][zone] - dev - ANOMALY_DRIFT_SLACK_C);
+
+    // Capped, so a probe that comes back clears in bounded time
+    cusum_high[p][zone] = fminf(high, 2.0f * ANOMALY_DRIFT_LIMIT);
+    cusum_low[p][zone] = fminf(low, 2.0f * ANOMALY_DRIFT_LIMIT);
+
+    float limit = was_drifting ? ANOMALY_DRIFT_LIMIT / 2.0f : ANOMALY_DRIFT_LIMIT;
+    return cusum_high[p][zone] > limit || cusum_low[p][zone] > limit;
+}
+
+// Gather each enclosure probe's offset from the mean of the others. Needs
+// all of them, or a drift could not be told from its reference; while one
+// is drifting only its own offset is kept, so it can come back without
+// dragging the others along.
+static void track_offsets(int zone, const float *probes) {
+    bool drifting[ENCLOSURE_PROBES];
+    bool any_drifting = false;
+    float sum = 0.0f;
+
+    for (int p = 0; p < ENCLOSURE_PROBES; p++) {
+        if (isnan(probes[p]) || (flags[PROBE_CHANNEL(p)][zone] & ANOMALY_FLATLINE)) {
+            return;
+        }
+        drifting[p] = flags[PROBE_CHANNEL(p)][zone] & ANOMALY_DRIFT;
+        any_drifting |= drifting[p];
+        sum += probes[p];
+    }
+    for (int p = 0; p < ENCLOSURE_PROBES; p++) {
+        if (any_drifting && !drifting[p]) {
+            continue;
+        }
+        offset_sum[p][zone] += probes[p] - (sum - probes[p]) / (ENCLOSURE_PROBES - 1);
+        offset_count[p][zone]++;
+    }
+}
+
+// Heater response over the current window; returns whether the reading
+// failed to follow the heater. A window is only judged when the reading
+// started well below target and, once the thermal model is identified,
+// the model expects a clear rise at the duty the heater ran; a heater
+// holding the target at high duty is at equilibrium and not a fault.
+static bool check_response(int zone, float temp, bool heating_on, int64_t now_ms) {
+    if (isnan(temp)) {
+        heat_window_ms[zone] = NO_TIME;
+        return no_response[zone];
+    }
+    if (heat_window_ms[zone] == NO_TIME) {
+        heat_window_ms[zone] = now_ms;
+        heat_start_temp[zone] = temp;
+        heat_start_gap[zone] = climate_controller_zone_get_temp_target(zone) - temp;
+        heat_rise_idle[zone] = climate_controller_zone_predict_rise(zone, 0.0f, ANOMALY_HEAT_WINDOW_MS);
+        heat_rise_full[zone] = climate_controller_zone_predict_rise(zone, 1.0f, ANOMALY_HEAT_WINDOW_MS);
+        heat_on_ticks[zone] = 0;
+        heat_ticks[zone] = 0;
+    }
+
+    heat_ticks[zone]++;
+    if (heating_on) {
+        heat_on_ticks[zone]++;
+    }
+    if (now_ms - heat_window_ms[zone] >= ANOMALY_HEAT_WINDOW_MS) {
+        float rise = temp - heat_start_temp[zone];
+        float duty = (float)heat_on_ticks[zone] / heat_ticks[zone];
+
+        // The model is linear in the duty
+        float expected = heat_rise_idle[zone] + duty * (heat_rise_full[zone] - heat_rise_idle[zone]);
+        bool judged = duty >= ANOMALY_HEAT_MIN_DUTY && heat_start_gap[zone] >= ANOMALY_HEAT_MIN_GAP_C &&
+                      (isnan(expected) || expected >= 2.0f * ANOMALY_HEAT_MIN_RISE_C);
+
+        if (judged) {
+            no_response[zone] = rise < ANOMALY_HEAT_MIN_RISE_C;
+        } else if ((heat_on_ticks[zone] > 0 && rise >= ANOMALY_HEAT_MIN_RISE_C) ||
+                   heat_start_gap[zone] < ANOMALY_HEAT_MIN_GAP_C) {
+            // The heater is seen again, or no longer has to catch up
+            no_response[zone] = false;
+        }
+        heat_window_ms[zone] = NO_TIME;
+    }
+    return no_response[zone];
+}
+
+// Check a zone's frame
+void anomaly_detector_update(int zone, sensor_zone_t *values, bool heating_on, int64_t now_ms) {
+    int64_t start_us = esp_timer_get_time();
+    uint8_t result[ANOMALY_CH_COUNT];
+
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return;
+    }
+
+    result[ANOMALY_CH_TEMPERATURE] = check_channel(ANOMALY_CH_TEMPERATURE, zone,
+                                                   values->value[SENSOR_VALUE_TEMPERATURE],
+                                                   ANOMALY_TEMP_RATE_MAX, now_ms);
+    result[ANOMALY_CH_HUMIDITY] = check_channel(ANOMALY_CH_HUMIDITY, zone, values->value[SENSOR_VALUE_HUMIDITY],
+                                                ANOMALY_HUMIDITY_RATE_MAX, now_ms);
+    for (int p = 0; p < ENCLOSURE_PROBES; p++) {
+        result[PROBE_CHANNEL(p)] = check_channel(PROBE_CHANNEL(p), zone, values->probes[p],
+                                                 ANOMALY_TEMP_RATE_MAX, now_ms);
+    }
+
+    // Drift, one CUSUM step a minute
+    track_offsets(zone, values->probes);
+    if (drift_step_ms[zone] == NO_TIME) {
+        drift_step_ms[zone] = now_ms;
+    }
+    bool step = now_ms - drift_step_ms[zone] >= ANOMALY_DRIFT_STEP_MS;
+    if (step) {
+        drift_step_ms[zone] = now_ms;
+    }
+    for (int p = 0; p < ENCLOSURE_PROBES; p++) {
+        bool drifting = flags[PROBE_CHANNEL(p)][zone] & ANOMALY_DRIFT;
+        if (step) {
+            drifting = step_drift(p, zone, drifting);
+        }
+        if (drifting) {
+            result[PROBE_CHANNEL(p)] |= ANOMALY_DRIFT;
+        }
+    }
+
+    // The heater should move the basking probe, or the zone sensor without
+    // a trusted one
+    float response_temp = values->value[SENSOR_VALUE_TEMPERATURE];
+    if (!isnan(values->probes[PROBE_BASKING]) && !result[PROBE_CHANNEL(PROBE_BASKING)]) {
+        response_temp = values->probes[PROBE_BASKING];
+    }
+    if (check_response(zone, response_temp, heating_on, now_ms)) {
+        result[ANOMALY_CH_TEMPERATURE] |= ANOMALY_NO_RESPONSE;
+    }
+
+    // Suspect probes leave the fusion
+    for (int p = 0; p < ENCLOSURE_PROBES; p++) {
+        if (result[PROBE_CHANNEL(p)] & (ANOMALY_FLATLINE | ANOMALY_DRIFT | ANOMALY_RATE)) {
+            values->probes[p] = NAN;
+        }
+    }
+
+    // A missed heater response alone is only reported: the reading is
+    // otherwise consistent, and holding the heater would starve the zone
+    uint8_t held = 0;
+    if (result[ANOMALY_CH_TEMPERATURE] & (ANOMALY_FLATLINE | ANOMALY_RATE)) {
+        held |= ANOMALY_HOLD_TEMPERATURE;
+    }
+    if (result[ANOMALY_CH_HUMIDITY]) {
+        held |= ANOMALY_HOLD_HUMIDITY;
+    }
+    hold[zone] = held;
+
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    portENTER_CRITICAL(&state_lock);
+    for (int c = 0; c < ANOMALY_CH_COUNT; c++) {
+        uint8_t was = flags[c][zone];
+        raised_pending[c][zone] |= result[c] & ~was;
+        cleared_pending[c][zone] |= was & ~result[c];
+        if (result[c] & ~was) {
+            stats.raised++;
+        }
+        flags[c][zone] = result[c];
+    }
+    stats.updates++;
+    if (elapsed_us > stats.update_max_us) {
+        stats.update_max_us = elapsed_us;
+    }
+    portEXIT_CRITICAL(&state_lock);
+}
+
+// Get the anomalies of a channel in a zone
+uint8_t anomaly_detector_get_flags(int zone, anomaly_channel_t channel) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES || channel >= ANOMALY_CH_COUNT) {
+        return 0;
+    }
+    return flags[channel][zone];
+}
+
+// Get the outputs held in a zone
+uint8_t anomaly_detector_get_hold(int zone) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return 0;
+    }
+    return hold[zone];
+}
+
+// Get the work done so far
+void anomaly_detector_get_stats(anomaly_stats_t *out) {
+    portENTER_CRITICAL(&state_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&state_lock);
+}
+
+// Log raised and cleared anomalies
+void anomaly_detector_report(void) {
+    int zones = climate_controller_get_zone_count();
+
+    for (int z = 0; z < zones; z++) {
+        for (int c = 0; c < ANOMALY_CH_COUNT; c++) {
+            portENTER_CRITICAL(&state_lock);
+            uint8_t raised = raised_pending[c][z];
+            uint8_t cleared = cleared_pending[c][z];
+            raised_pending[c][z] = 0;
+            cleared_pending[c][z] = 0;
+            portEXIT_CRITICAL(&state_lock);
+
+            for (size_t i = 0; i < sizeof(anomaly_names) / sizeof(anomaly_names[0]); i++) {
+                if (raised & anomaly_names[i].flag) {
+                    ESP_LOGW(TAG, "Zone %d %s %s", z + 1, channel_names[c], anomaly_names[i].name);
+                    event_logger_add_zone_fmt(z, "SENSOR: %s %s", true, channel_names[c], anomaly_names[i].name);
+                } else if (cleared & anomaly_names[i].flag) {
+                    event_logger_add_zone_fmt(z, "%s no longer %s", false, channel_names[c],
+                                              anomaly_names[i].name);
+                }
+            }
+        }
+    }
+}
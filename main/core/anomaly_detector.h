@@ -0,0 +1,98 @@
+#ifndef ANOMALY_DETECTOR_H
+#define ANOMALY_DETECTOR_H
+
+#include "sensor_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Online checks for sensors that are stuck, drifting or disconnected. Each
+// zone's frame is checked once per sample from the sensor task, in
+// constant time. Suspect probes are dropped from fusion, and the climate
+// update holds the outputs whose reading cannot be trusted.
+
+// Channels checked per zone: the zone's own temperature and humidity and
+// the enclosure probes. The ambient probe is room air and is not checked.
+typedef enum {
+    ANOMALY_CH_TEMPERATURE,
+    ANOMALY_CH_HUMIDITY,
+    ANOMALY_CH_BASKING,
+    ANOMALY_CH_COOL_SIDE,
+    ANOMALY_CH_SUBSTRATE,
+    ANOMALY_CH_COUNT
+} anomaly_channel_t;
+
+// Anomalies, as bits per channel
+#define ANOMALY_FLATLINE    (1 << 0)    // Reading stopped moving
+#define ANOMALY_DRIFT       (1 << 1)    // Probe wandering away from the others
+#define ANOMALY_RATE        (1 << 2)    // Changed faster than an enclosure can
+#define ANOMALY_NO_RESPONSE (1 << 3)    // Heater on below target without a rise (temperature channel)
+
+// Flat line: the variance of sample-to-sample changes (an average over
+// about ANOMALY_FLATLINE_SPAN samples) stays under this for this long
+#ifndef ANOMALY_FLATLINE_MS
+#define ANOMALY_FLATLINE_MS (30 * 60 * 1000)
+#endif
+#define ANOMALY_FLATLINE_VARIANCE 1e-6f
+#define ANOMALY_FLATLINE_SPAN 64
+
+// Rate of change limits, and how long a violation stays flagged
+#define ANOMALY_TEMP_RATE_MAX 1.0f          // °C/s
+#define ANOMALY_HUMIDITY_RATE_MAX 10.0f     // %/s
+#define ANOMALY_RATE_HOLD_MS (60 * 1000)
+
+// Drift: a two-sided CUSUM of each probe's offset from the mean of the
+// others, on one-minute averages, against the offset learned over the
+// first ANOMALY_DRIFT_WARMUP_MIN minutes. Offsets within the slack are
+// ignored; a sum past the limit (°C·min) flags the probe, which clears
+// once the sum is back under half of it.
+#define ANOMALY_DRIFT_STEP_MS (60 * 1000)
+#define ANOMALY_DRIFT_WARMUP_MIN 60
+#define ANOMALY_DRIFT_SLACK_C 1.0f
+#define ANOMALY_DRIFT_LIMIT 20.0f
+
+// Heater response: over each window in which the heater was on for at
+// least this share of the time, the basking probe (or the zone
+// temperature) must rise by this much. Only windows that start at least
+// ANOMALY_HEAT_MIN_GAP_C below target are judged, and once the thermal
+// model is identified only those it expects twice the rise in. A miss is
+// reported but does not hold the outputs.
+#ifndef ANOMALY_HEAT_WINDOW_MS
+#define ANOMALY_HEAT_WINDOW_MS (10 * 60 * 1000)
+#endif
+#define ANOMALY_HEAT_MIN_DUTY 0.8f
+#define ANOMALY_HEAT_MIN_RISE_C 0.3f
+#define ANOMALY_HEAT_MIN_GAP_C 1.0f
+
+// Outputs the climate update holds in a zone
+#define ANOMALY_HOLD_TEMPERATURE (1 << 0)   // Heater open-loop at a low duty, cooler off
+#define ANOMALY_HOLD_HUMIDITY    (1 << 1)   // Humidifier off
+
+// Work done by the detectors
+typedef struct {
+    uint32_t updates;
+    uint32_t raised;
+    uint32_t update_max_us;     // Longest check of one zone
+} anomaly_stats_t;
+
+// Clear every detector
+void anomaly_detector_init(void);
+
+// Check a zone's frame taken at now_ms, with whether its heater was on
+// over the last period. Probes found stuck, drifting or jumping are set to
+// NaN in values, so the probe fusion drops them.
+void anomaly_detector_update(int zone, sensor_zone_t *values, bool heating_on, int64_t now_ms);
+
+// Get the anomalies of a channel in a zone (ANOMALY_* bits)
+uint8_t anomaly_detector_get_flags(int zone, anomaly_channel_t channel);
+
+// Get the outputs held in a zone (ANOMALY_HOLD_* bits); safe from any task
+uint8_t anomaly_detector_get_hold(int zone);
+
+// Get the work done so far
+void anomaly_detector_get_stats(anomaly_stats_t *stats);
+
+// Log raised and cleared anomalies to the event log. Called from a
+// normal-priority task so the sensor task never waits on the logger.
+void anomaly_detector_report(void);
+
+#endif /* ANOMALY_DETECTOR_H */
@@ -1,254 +1,1405 @@
 #include "climate_controller.h"
+#include "actuator_manager.h"
+#include "anomaly_detector.h"
+#include "control_fsm.h"
 #include "data_simulator.h"
 #include "event_logger.h"
+#include "pid_controller.h"
+#include "probe_manager.h"
+#include "psychrometrics.h"
+#include "thermal_model.h"
+#include "safety_interlock.h"
+#include "sensor_hal.h"
+#include "settings_manager.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
 
 static const char *TAG = "climate_controller";
 
+#if CLIMATE_MAX_ZONES > DATA_SIMULATOR_MAX_ZONES
+#error "CLIMATE_MAX_ZONES exceeds the zones the simulator can model"
+#endif
+
+// Active zones
+static int zone_count = CLIMATE_DEFAULT_ZONES;
+
+// Zone state is kept as struct-of-arrays: the update pass walks each field
+// across zones instead of striding over per-zone structs
+
 // Target values
-static float temp_target = 25.0f;
-static float humidity_target = 50.0f;
-static float light_target = 75.0f;
+static float temp_target[CLIMATE_MAX_ZONES];
+static float humidity_target[CLIMATE_MAX_ZONES];
+static float light_target[CLIMATE_MAX_ZONES];
+
+// VPD targets (kPa, 0 for none) and the humidity the humidifier works to
+static float vpd_target[CLIMATE_MAX_ZONES];
+static float humidity_setpoint[CLIMATE_MAX_ZONES];
+
+// Target limits
+static float temp_min[CLIMATE_MAX_ZONES];
+static float temp_max[CLIMATE_MAX_ZONES];
+static float humidity_min[CLIMATE_MAX_ZONES];
+static float humidity_max[CLIMATE_MAX_ZONES];
+
+// Held for a whole update pass, and while a setter changes the state it
+// reads
+static SemaphoreHandle_t lock = NULL;
+
+// Settings stored under the lock, to be saved once it is released
+static bool settings_unsaved = false;
+
+// Time of the sample not yet acted on (-1 for none), and the timing of
+// the updates
+static portMUX_TYPE sample_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t pending_sample_us = -1;
+static climate_timing_t timing;
 
 // System state
-static bool heating_enabled = true;
-static bool cooling_enabled = true;
-static bool humidifier_enabled = true;
-static bool lighting_enabled = true;
+static bool heating_enabled[CLIMATE_MAX_ZONES];
+static bool cooling_enabled[CLIMATE_MAX_ZONES];
+static bool humidifier_enabled[CLIMATE_MAX_ZONES];
+static bool lighting_enabled[CLIMATE_MAX_ZONES];
 
 // Active status
-static bool heating_active = false;
-static bool cooling_active = false;
-static bool humidifier_active = false;
-static bool lighting_active = false;
+static bool heating_active[CLIMATE_MAX_ZONES];
+static bool cooling_active[CLIMATE_MAX_ZONES];
+static bool humidifier_active[CLIMATE_MAX_ZONES];
+static bool lighting_active[CLIMATE_MAX_ZONES];
+
+// Moist-air metrics of the last update, the readings they were computed
+// from, and whether condensation has been flagged
+static float air_temp[CLIMATE_MAX_ZONES];
+static float air_humidity[CLIMATE_MAX_ZONES];
+static float metric_vpd[CLIMATE_MAX_ZONES];
+static float metric_dew_point[CLIMATE_MAX_ZONES];
+static float metric_abs_humidity[CLIMATE_MAX_ZONES];
+static bool condensation[CLIMATE_MAX_ZONES];
+
+// Running statistics of each zone's readings, one channel per
+// climate_stat_t. Allocated when the zone first comes into use and kept
+// after, so only zones that have been used take memory; NULL if the
+// allocation failed.
+static stream_channel_t *stats[CLIMATE_MAX_ZONES];
+
+// Hysteresis state machine of each actuator, and its table
+static uint8_t states[CLIMATE_ACTUATOR_COUNT][CLIMATE_MAX_ZONES];
+static const control_fsm_t *const fsms[CLIMATE_ACTUATOR_COUNT] = {
+    &control_fsm_heating, &control_fsm_cooling, &control_fsm_humidifier, &control_fsm_lighting
+};
 
 // Hysteresis values to prevent rapid cycling
 static const float TEMP_HYSTERESIS = 1.0f;    // ±1°C
 static const float HUMIDITY_HYSTERESIS = 5.0f; // ±5%
 static const float LIGHT_HYSTERESIS = 5.0f;    // ±5%
 
+// PID loops drive relays through time-proportioning windows
+#define CONTROL_DT (CLIMATE_CONTROL_PERIOD_MS / 1000.0f)
+#define TPO_WINDOW_TICKS (CLIMATE_TPO_WINDOW_MS / CLIMATE_CONTROL_PERIOD_MS)
+#define TPO_MIN_TICKS (CLIMATE_TPO_MIN_MS / CLIMATE_CONTROL_PERIOD_MS)
+
+// Relay auto-tune hysteresis around the target
+#define TEMP_AUTOTUNE_HYSTERESIS 0.2f
+#define HUMIDITY_AUTOTUNE_HYSTERESIS 1.0f
+
+// Control mode per actuator and zone
+static uint8_t modes[CLIMATE_ACTUATOR_COUNT][CLIMATE_MAX_ZONES];
+
+// PID loops and relay outputs
+static pid_controller_t loops[CLIMATE_LOOP_COUNT][CLIMATE_MAX_ZONES];
+static pid_tpo_t heating_tpo[CLIMATE_MAX_ZONES];
+static pid_tpo_t cooling_tpo[CLIMATE_MAX_ZONES];
+static pid_tpo_t humidifier_tpo[CLIMATE_MAX_ZONES];
+
+// Mist pulses per zone, and whether the cap has been logged this period
+static mist_pulse_t mist[CLIMATE_MAX_ZONES];
+static bool mist_capped[CLIMATE_MAX_ZONES];
+
+// Control time, advanced one period per update
+static int64_t control_ms;
+
+// Thermal models identified online for MPC
+static thermal_model_t temp_model[CLIMATE_MAX_ZONES];
+static bool model_reported[CLIMATE_MAX_ZONES];
+
+// Relay auto-tune, one zone at a time
+static pid_autotune_t autotune;
+static int autotune_zone;
+static climate_loop_t autotune_loop;
+
+// Relay cycle counting
+static uint32_t cycle_counts[CLIMATE_ACTUATOR_COUNT][CLIMATE_MAX_ZONES];
+static bool was_active[CLIMATE_ACTUATOR_COUNT][CLIMATE_MAX_ZONES];
+
+// Energy meters, hours closed since the totals were last saved, and
+// whether an output stuck on has been reported
+static energy_meter_t meters[CLIMATE_ACTUATOR_COUNT][CLIMATE_MAX_ZONES];
+static uint8_t unsaved_hours[CLIMATE_MAX_ZONES];
+static bool saturated[CLIMATE_ACTUATOR_COUNT][CLIMATE_MAX_ZONES];
+
+static const float default_watts[CLIMATE_ACTUATOR_COUNT] = {
+    CLIMATE_HEATING_DEFAULT_WATTS, CLIMATE_COOLING_DEFAULT_WATTS,
+    CLIMATE_HUMIDIFIER_DEFAULT_WATTS, CLIMATE_LIGHTING_DEFAULT_WATTS
+};
+
+// Settings keys of the per-zone modes, by actuator
+static const char *const mode_keys[] = {
+    SETTINGS_KEY_HEATING_MODE, SETTINGS_KEY_COOLING_MODE, SETTINGS_KEY_HUMIDIFIER_MODE
+};
+
+// Settings keys of the per-zone wattage and energy totals, by actuator
+static const char *const watt_keys[CLIMATE_ACTUATOR_COUNT] = {
+    SETTINGS_KEY_HEATING_WATTS, SETTINGS_KEY_COOLING_WATTS,
+    SETTINGS_KEY_HUMIDIFIER_WATTS, SETTINGS_KEY_LIGHTING_WATTS
+};
+static const char *const wh_keys[CLIMATE_ACTUATOR_COUNT] = {
+    SETTINGS_KEY_HEATING_WH, SETTINGS_KEY_COOLING_WH,
+    SETTINGS_KEY_HUMIDIFIER_WH, SETTINGS_KEY_LIGHTING_WH
+};
+static const char *const on_s_keys[CLIMATE_ACTUATOR_COUNT] = {
+    SETTINGS_KEY_HEATING_ON_S, SETTINGS_KEY_COOLING_ON_S,
+    SETTINGS_KEY_HUMIDIFIER_ON_S, SETTINGS_KEY_LIGHTING_ON_S
+};
+static const char *const cycle_keys[CLIMATE_ACTUATOR_COUNT] = {
+    SETTINGS_KEY_HEATING_CYCLES, SETTINGS_KEY_COOLING_CYCLES,
+    SETTINGS_KEY_HUMIDIFIER_CYCLES, SETTINGS_KEY_LIGHTING_CYCLES
+};
+
 // Forward declarations
-static void update_heating_cooling(float current_temp);
-static void update_humidifier(float current_humidity);
-static void update_lighting(float current_light);
+static void update_heating_cooling(int zone, float heat_temp, float cool_temp, float ambient_temp);
+static void update_humidifier(int zone, float current_humidity);
+static void update_metrics(void);
+static float humidity_setpoint_at(int zone, float temperature);
+static float clamp_target(float value, float min, float max);
+static void update_lighting(int zone, float current_light);
+static void alloc_stats(int zone);
+static void reset_zone(int zone);
+static void load_zone_settings(int zone);
+static void finish_autotune(void);
+static void count_cycles(void);
+static bool step_actuator(int zone, climate_actuator_t actuator, uint8_t guards);
+static void sync_state(int zone, climate_actuator_t actuator, bool enabled, bool active);
+static uint8_t current_guards(int zone, climate_actuator_t actuator);
+static void drive_outputs(void);
+static void check_energy_hour(int zone);
+static void save_energy(int zone);
+static void store_pid_gains(int zone, climate_loop_t loop, float kp, float ki, float kd);
+static void control_temps(int zone, float *heat_temp, float *cool_temp);
+
+// Check a zone index from the public API
+static bool valid_zone(int zone) {
+    if (zone < 0 || zone >= zone_count) {
+        ESP_LOGW(TAG, "Invalid zone %d", zone);
+        return false;
+    }
+    return true;
+}
 
 // Initialize the climate controller
 void climate_controller_init(void) {
     ESP_LOGI(TAG, "Initializing climate controller");
 
+    zone_count = settings_get_int(SETTINGS_KEY_ZONE_COUNT, CLIMATE_DEFAULT_ZONES);
+    if (zone_count < 1 || zone_count > CLIMATE_MAX_ZONES) {
+        zone_count = CLIMATE_DEFAULT_ZONES;
+    }
+    data_simulator_set_zone_count(zone_count);
+    event_logger_set_zone_count(zone_count);
+
+    if (lock == NULL) {
+        lock = xSemaphoreCreateMutex();
+    }
+    pending_sample_us = -1;
+    memset(&timing, 0, sizeof(timing));
+    for (int z = 0; z < zone_count; z++) {
+        alloc_stats(z);
+    }
+    for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+        reset_zone(z);
+    }
+    for (int z = 0; z < zone_count; z++) {
+        load_zone_settings(z);
+    }
+
+    autotune.state = PID_AUTOTUNE_IDLE;
+
+    if (zone_count == 1) {
+        event_logger_add("Climate controller initialized", false);
+    } else {
+        event_logger_add_fmt("Climate controller initialized (%d zones)", false, zone_count);
+    }
+}
+
+// Give a zone coming into use its statistics, in PSRAM where there is
+// some. Called before reset_zone, which empties them.
+static void alloc_stats(int zone) {
+    if (stats[zone]) {
+        return;
+    }
+    stats[zone] = heap_caps_calloc_prefer(CLIMATE_STAT_COUNT, sizeof(stream_channel_t), 2,
+                                          MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT);
+    if (!stats[zone]) {
+        ESP_LOGW(TAG, "No memory for zone %d statistics", zone + 1);
+    }
+}
+
+// Put a zone back to its defaults
+static void reset_zone(int zone) {
     // Set initial target values
-    temp_target = 25.0f;
-    humidity_target = 50.0f;
-    light_target = 75.0f;
+    temp_target[zone] = 25.0f;
+    humidity_target[zone] = 50.0f;
+    light_target[zone] = 75.0f;
+    temp_min[zone] = CLIMATE_TEMP_LIMIT_MIN_C;
+    temp_max[zone] = CLIMATE_TEMP_LIMIT_MAX_C;
+    humidity_min[zone] = CLIMATE_HUMIDITY_LIMIT_MIN_PCT;
+    humidity_max[zone] = CLIMATE_HUMIDITY_LIMIT_MAX_PCT;
+    vpd_target[zone] = 0.0f;
+    humidity_setpoint[zone] = humidity_target[zone];
+    metric_vpd[zone] = metric_dew_point[zone] = metric_abs_humidity[zone] = NAN;
+    condensation[zone] = false;
+    if (stats[zone]) {
+        for (int c = 0; c < CLIMATE_STAT_COUNT; c++) {
+            stream_channel_init(&stats[zone][c]);
+        }
+    }
 
     // Enable all systems by default
-    heating_enabled = true;
-    cooling_enabled = true;
-    humidifier_enabled = true;
-    lighting_enabled = true;
+    heating_enabled[zone] = true;
+    cooling_enabled[zone] = true;
+    humidifier_enabled[zone] = true;
+    lighting_enabled[zone] = true;
 
     // All systems start inactive
-    heating_active = false;
-    cooling_active = false;
-    humidifier_active = false;
-    lighting_active = false;
+    heating_active[zone] = false;
+    cooling_active[zone] = false;
+    humidifier_active[zone] = false;
+    lighting_active[zone] = false;
+
+    // Control modes and PID state
+    for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+        modes[a][zone] = CLIMATE_MODE_HYSTERESIS;
+        states[a][zone] = CONTROL_STATE_IDLE;
+        cycle_counts[a][zone] = 0;
+        was_active[a][zone] = false;
+        energy_meter_init(&meters[a][zone], default_watts[a]);
+        saturated[a][zone] = false;
+    }
+    unsaved_hours[zone] = 0;
+    pid_init(&loops[CLIMATE_LOOP_TEMPERATURE][zone], CLIMATE_TEMP_DEFAULT_KP,
+             CLIMATE_TEMP_DEFAULT_KI, CLIMATE_TEMP_DEFAULT_KD, -1.0f, 1.0f);
+    pid_init(&loops[CLIMATE_LOOP_HUMIDITY][zone], CLIMATE_HUMIDITY_DEFAULT_KP,
+             CLIMATE_HUMIDITY_DEFAULT_KI, CLIMATE_HUMIDITY_DEFAULT_KD, 0.0f, 1.0f);
+    pid_tpo_init(&heating_tpo[zone], TPO_WINDOW_TICKS, TPO_MIN_TICKS);
+    pid_tpo_init(&cooling_tpo[zone], TPO_WINDOW_TICKS, TPO_MIN_TICKS);
+    pid_tpo_init(&humidifier_tpo[zone], TPO_WINDOW_TICKS, TPO_MIN_TICKS);
+    mist_pulse_init(&mist[zone]);
+    mist_capped[zone] = false;
+    thermal_model_init(&temp_model[zone], CLIMATE_THERMAL_MODEL_ORDER);
+    model_reported[zone] = false;
+}
+
+// Load control modes and PID gains of a zone from settings
+static void load_zone_settings(int zone) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    for (int a = 0; a < CLIMATE_ACTUATOR_LIGHTING; a++) {
+        modes[a][zone] = settings_get_int(settings_zone_key(key, mode_keys[a], zone), CLIMATE_MODE_HYSTERESIS);
+    }
+
+    // One key buffer, so read each gain before building the next key
+    float kp = settings_get_float(settings_zone_key(key, SETTINGS_KEY_TEMP_KP, zone), CLIMATE_TEMP_DEFAULT_KP);
+    float ki = settings_get_float(settings_zone_key(key, SETTINGS_KEY_TEMP_KI, zone), CLIMATE_TEMP_DEFAULT_KI);
+    float kd = settings_get_float(settings_zone_key(key, SETTINGS_KEY_TEMP_KD, zone), CLIMATE_TEMP_DEFAULT_KD);
+    pid_set_gains(&loops[CLIMATE_LOOP_TEMPERATURE][zone], kp, ki, kd);
+
+    kp = settings_get_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_KP, zone), CLIMATE_HUMIDITY_DEFAULT_KP);
+    ki = settings_get_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_KI, zone), CLIMATE_HUMIDITY_DEFAULT_KI);
+    kd = settings_get_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_KD, zone), CLIMATE_HUMIDITY_DEFAULT_KD);
+    pid_set_gains(&loops[CLIMATE_LOOP_HUMIDITY][zone], kp, ki, kd);
+
+    mist[zone].daily_cap_ml = settings_get_float(settings_zone_key(key, SETTINGS_KEY_MIST_CAP, zone),
+                                                 MIST_DAILY_CAP_ML);
+    vpd_target[zone] = settings_get_float(settings_zone_key(key, SETTINGS_KEY_VPD_TARGET, zone), 0.0f);
+
+    temp_min[zone] = settings_get_float(settings_zone_key(key, SETTINGS_KEY_TEMP_MIN, zone), CLIMATE_TEMP_LIMIT_MIN_C);
+    temp_max[zone] = settings_get_float(settings_zone_key(key, SETTINGS_KEY_TEMP_MAX, zone), CLIMATE_TEMP_LIMIT_MAX_C);
+    humidity_min[zone] = settings_get_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_MIN, zone),
+                                            CLIMATE_HUMIDITY_LIMIT_MIN_PCT);
+    humidity_max[zone] = settings_get_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_MAX, zone),
+                                            CLIMATE_HUMIDITY_LIMIT_MAX_PCT);
+
+    for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+        energy_meter_t *m = &meters[a][zone];
+        m->watts = settings_get_float(settings_zone_key(key, watt_keys[a], zone), default_watts[a]);
+        m->total_wh = settings_get_float(settings_zone_key(key, wh_keys[a], zone), 0.0f);
+        m->total_on_s = settings_get_int(settings_zone_key(key, on_s_keys[a], zone), 0);
+        m->total_cycles = settings_get_int(settings_zone_key(key, cycle_keys[a], zone), 0);
+    }
+}
+
+// Save the energy totals of a zone
+static void save_energy(int zone) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+        const energy_meter_t *m = &meters[a][zone];
+        settings_set_float(settings_zone_key(key, wh_keys[a], zone), (float)m->total_wh);
+        settings_set_int(settings_zone_key(key, on_s_keys[a], zone), (int)m->total_on_s);
+        settings_set_int(settings_zone_key(key, cycle_keys[a], zone), (int)m->total_cycles);
+    }
+    unsaved_hours[zone] = 0;
+}
+
+// Record a fresh sensor sample
+void climate_controller_sample_ready(int64_t sampled_us) {
+    portENTER_CRITICAL(&sample_lock);
+    if (pending_sample_us >= 0) {
+        timing.missed_samples++;
+    }
+    pending_sample_us = sampled_us;
+    portEXIT_CRITICAL(&sample_lock);
+}
+
+// Account one update: the latency of the sample it acted on, or a
+// fallback tick
+static void record_timing(int64_t sampled_us) {
+    int64_t elapsed = esp_timer_get_time() - sampled_us;
+    uint32_t latency = elapsed < 0 ? 0 : elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
 
-    event_logger_add("Climate controller initialized", false);
+    portENTER_CRITICAL(&sample_lock);
+    if (sampled_us < 0) {
+        timing.fallback_ticks++;
+    } else {
+        timing.latency_last_us = latency;
+        if (latency > timing.latency_max_us) {
+            timing.latency_max_us = latency;
+        }
+        timing.latency_avg_us = timing.samples == 0 ? latency :
+                                timing.latency_avg_us - timing.latency_avg_us / 16 + latency / 16;
+        timing.samples++;
+    }
+    portEXIT_CRITICAL(&sample_lock);
 }
 
-// Update climate control logic
+// Update climate control logic of every zone
 void climate_controller_update(void) {
-    // Get current sensor values
-    float current_temp = data_simulator_get_temperature();
-    float current_humidity = data_simulator_get_humidity();
-    float current_light = data_simulator_get_light();
+    float ambient_temp = sensor_hal_get_ambient();
+
+    portENTER_CRITICAL(&sample_lock);
+    int64_t sampled_us = pending_sample_us;
+    pending_sample_us = -1;
+    portEXIT_CRITICAL(&sample_lock);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    control_ms += CLIMATE_CONTROL_PERIOD_MS;
+    update_metrics();
+    for (int z = 0; z < zone_count; z++) {
+        // Get current sensor values; heating and cooling act on the fused
+        // probes, cached when they were sampled
+        float heat_temp, cool_temp;
+        control_temps(z, &heat_temp, &cool_temp);
+        float current_humidity = sensor_hal_get_value(z, SENSOR_VALUE_HUMIDITY);
+        float current_light = sensor_hal_get_value(z, SENSOR_VALUE_LIGHT);
+
+        // Fit the thermal model with the relay states of the last period
+        if (!isnan(heat_temp) && !isnan(ambient_temp)) {
+            thermal_model_update(&temp_model[z], heat_temp, heating_active[z] ? 1.0f : 0.0f,
+                                 cooling_active[z] ? 1.0f : 0.0f, ambient_temp);
+        }
+        if (!model_reported[z] && thermal_model_is_ready(&temp_model[z])) {
+            model_reported[z] = true;
+            ESP_LOGI(TAG, "Zone %d thermal model identified: a=%.4f heat=%.4f cool=%.4f", z + 1,
+                     temp_model[z].theta[0], thermal_model_heat_gain(&temp_model[z]),
+                     thermal_model_cool_gain(&temp_model[z]));
+        }
 
-    // Update each system
-    update_heating_cooling(current_temp);
-    update_humidifier(current_humidity);
-    update_lighting(current_light);
+        // Update each system. Heat, cool and mist stay off while their
+        // reading is missing or stale, mist also while the humidity reading
+        // is suspect; the lights keep their state.
+        if (isnan(heat_temp) || isnan(cool_temp)) {
+            heating_active[z] = cooling_active[z] = false;
+            sync_state(z, CLIMATE_ACTUATOR_HEATING, heating_enabled[z], false);
+            sync_state(z, CLIMATE_ACTUATOR_COOLING, cooling_enabled[z], false);
+        } else {
+            update_heating_cooling(z, heat_temp, cool_temp, isnan(ambient_temp) ? cool_temp : ambient_temp);
+        }
+        if (isnan(current_humidity) || isnan(humidity_setpoint[z]) ||
+            (anomaly_detector_get_hold(z) & ANOMALY_HOLD_HUMIDITY)) {
+            // A pulse in progress ends now, not when the reading returns,
+            // so the outage is not booked as mist
+            if (modes[CLIMATE_ACTUATOR_HUMIDIFIER][z] == CLIMATE_MODE_PULSE) {
+                mist_pulse_update(&mist[z], NAN, humidity_setpoint[z], false, control_ms);
+            }
+            humidifier_active[z] = false;
+            sync_state(z, CLIMATE_ACTUATOR_HUMIDIFIER, humidifier_enabled[z], false);
+        } else {
+            update_humidifier(z, current_humidity);
+        }
+        if (!isnan(current_light)) {
+            update_lighting(z, current_light);
+        }
+    }
+
+    count_cycles();
+    drive_outputs();
+    record_timing(sampled_us);
+    bool save = settings_unsaved;
+    settings_unsaved = false;
+    xSemaphoreGive(lock);
+
+    if (save) {
+        settings_save();
+    }
 }
 
-// Control logic for heating and cooling
-static void update_heating_cooling(float current_temp) {
-    // Check if heating should be activated
-    if (heating_enabled && !heating_active && current_temp < (temp_target - TEMP_HYSTERESIS)) {
-        heating_active = true;
-        cooling_active = false; // Prevent both systems running simultaneously
-        event_logger_add("Heating activated", false);
+// Get the sample-to-decision timing
+void climate_controller_get_timing(climate_timing_t *out) {
+    portENTER_CRITICAL(&sample_lock);
+    *out = timing;
+    portEXIT_CRITICAL(&sample_lock);
+}
+
+// Hand the actuator states to the physical outputs, one batch per tick,
+// and meter what each was asked for
+static void drive_outputs(void) {
+    for (int z = 0; z < zone_count; z++) {
+        const float levels[CLIMATE_ACTUATOR_COUNT] = {
+            heating_active[z] ? 1.0f : 0.0f,
+            cooling_active[z] ? 1.0f : 0.0f,
+            humidifier_active[z] ? 1.0f : 0.0f,
+            lighting_active[z] ? light_target[z] / 100.0f : 0.0f
+        };
+        bool hour_closed = false;
+
+        for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+            actuator_manager_set(z, a, levels[a]);
+            hour_closed |= energy_meter_update(&meters[a][z], levels[a], CLIMATE_CONTROL_PERIOD_MS, control_ms);
+        }
+        if (hour_closed) {
+            check_energy_hour(z);
+        }
+    }
+    actuator_manager_commit(esp_timer_get_time());
+}
+
+// Report a heater or cooler that ran the whole hour that just closed (a
+// failed element or a door left open), and save the totals every few hours
+static void check_energy_hour(int zone) {
+    for (int a = CLIMATE_ACTUATOR_HEATING; a <= CLIMATE_ACTUATOR_COOLING; a++) {
+        energy_hour_t hour;
+        energy_meter_get_hour(&meters[a][zone], 0, &hour);
+
+        bool full = hour.on_s >= CLIMATE_SATURATED_DUTY * (ENERGY_HOUR_MS / 1000);
+        if (full && !saturated[a][zone]) {
+            event_logger_add_zone(zone, a == CLIMATE_ACTUATOR_HEATING ?
+                                  "Heating on for a full hour, check the heater" :
+                                  "Cooling on for a full hour, check the cooler", true);
+        }
+        saturated[a][zone] = full;
+    }
+
+    if (++unsaved_hours[zone] >= CLIMATE_ENERGY_SAVE_HOURS) {
+        save_energy(zone);
+    }
+}
+
+// Count off->on relay transitions
+static void count_cycles(void) {
+    const bool *active[CLIMATE_ACTUATOR_COUNT] = {
+        heating_active, cooling_active, humidifier_active, lighting_active
+    };
+
+    for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+        for (int z = 0; z < zone_count; z++) {
+            cycle_counts[a][z] += active[a][z] && !was_active[a][z];
+            was_active[a][z] = active[a][z];
+        }
+    }
+}
+
+// Step the state table of an actuator, log the transition, and return
+// whether its output is on
+static bool step_actuator(int zone, climate_actuator_t actuator, uint8_t guards) {
+    const control_fsm_t *fsm = fsms[actuator];
+    const control_transition_t *t = control_fsm_step(fsm, &states[actuator][zone], guards);
+
+    if (t != NULL && t->event != NULL) {
+        event_logger_add_zone(zone, t->event, false);
+    }
+    return fsm->output[states[actuator][zone]];
+}
+
+// Put an actuator's table state in line with an output set outside the
+// table (PID, MPC, auto-tune, mixed-mode arbitration)
+static void sync_state(int zone, climate_actuator_t actuator, bool enabled, bool active) {
+    states[actuator][zone] = !enabled ? CONTROL_STATE_DISABLED :
+                             active ? CONTROL_STATE_RUNNING : CONTROL_STATE_IDLE;
+}
+
+// Temperatures heating and cooling act on: the zone's fused probes, or its
+// air sensor when no probe is usable (NaN when that is missing too)
+static void control_temps(int zone, float *heat_temp, float *cool_temp) {
+    if (!probe_manager_get_control_temps(zone, heat_temp, cool_temp)) {
+        *heat_temp = *cool_temp = sensor_hal_get_value(zone, SENSOR_VALUE_TEMPERATURE);
     }
-    // Check if heating should be deactivated
-    else if (heating_active && current_temp > (temp_target + TEMP_HYSTERESIS)) {
-        heating_active = false;
-        event_logger_add("Heating deactivated", false);
+}
+
+// Guards of an actuator from the zone's latest readings, for changes made
+// between updates
+static uint8_t current_guards(int zone, climate_actuator_t actuator) {
+    float heat_temp, cool_temp;
+
+    switch (actuator) {
+        case CLIMATE_ACTUATOR_HEATING:
+            control_temps(zone, &heat_temp, &cool_temp);
+            return control_fsm_band(heat_temp, temp_target[zone], TEMP_HYSTERESIS) |
+                   (heating_enabled[zone] ? CONTROL_GUARD_ENABLED : 0);
+        case CLIMATE_ACTUATOR_COOLING:
+            control_temps(zone, &heat_temp, &cool_temp);
+            return control_fsm_band(cool_temp, temp_target[zone], TEMP_HYSTERESIS) |
+                   (cooling_enabled[zone] ? CONTROL_GUARD_ENABLED : 0);
+        case CLIMATE_ACTUATOR_HUMIDIFIER:
+            return control_fsm_band(sensor_hal_get_value(zone, SENSOR_VALUE_HUMIDITY),
+                                    humidity_setpoint_at(zone, sensor_hal_get_value(zone, SENSOR_VALUE_TEMPERATURE)),
+                                    HUMIDITY_HYSTERESIS) |
+                   (humidifier_enabled[zone] ? CONTROL_GUARD_ENABLED : 0);
+        case CLIMATE_ACTUATOR_LIGHTING:
+            return control_fsm_band(sensor_hal_get_value(zone, SENSOR_VALUE_LIGHT), light_target[zone], LIGHT_HYSTERESIS) |
+                   (lighting_enabled[zone] ? CONTROL_GUARD_ENABLED : 0);
+        default:
+            return 0;
     }
+}
+
+// Control logic for heating and cooling. Both temperatures are the same
+// except in gradient fusion, where heating follows the basking spot and
+// cooling the cool side.
+static void update_heating_cooling(int zone, float heat_temp, float cool_temp, float ambient_temp) {
+    float target = temp_target[zone];
+    bool heating_modulated = modes[CLIMATE_ACTUATOR_HEATING][zone] != CLIMATE_MODE_HYSTERESIS;
+    bool cooling_modulated = modes[CLIMATE_ACTUATOR_COOLING][zone] != CLIMATE_MODE_HYSTERESIS;
+    bool mpc = (modes[CLIMATE_ACTUATOR_HEATING][zone] == CLIMATE_MODE_MPC ||
+                modes[CLIMATE_ACTUATOR_COOLING][zone] == CLIMATE_MODE_MPC) &&
+               thermal_model_is_ready(&temp_model[zone]);
+
+    if (autotune.state == PID_AUTOTUNE_RUNNING && autotune_zone == zone &&
+        autotune_loop == CLIMATE_LOOP_TEMPERATURE) {
+        // Relay auto-tune drives the heater directly
+        heating_active[zone] = heating_enabled[zone] &&
+                               pid_autotune_update(&autotune, heat_temp, CONTROL_DT) > 0.5f;
+        cooling_active[zone] = false;
+        if (autotune.state != PID_AUTOTUNE_RUNNING) {
+            finish_autotune();
+        }
+    } else if (anomaly_detector_get_hold(zone) & ANOMALY_HOLD_TEMPERATURE) {
+        // The reading cannot be trusted: heat open-loop at a low duty so
+        // the animal is neither cooked nor chilled, and never cool
+        heating_active[zone] = pid_tpo_update(&heating_tpo[zone],
+                                              heating_enabled[zone] ? CLIMATE_FAILSAFE_HEAT_DUTY : 0.0f) &&
+                               heating_enabled[zone];
+        cooling_active[zone] = false;
+    } else {
+        float output = 0.0f;
+        if (mpc) {
+            output = thermal_mpc_plan(&temp_model[zone], target, ambient_temp, CLIMATE_MPC_ENERGY_WEIGHT);
+        } else if (heating_modulated || cooling_modulated) {
+            output = pid_update(&loops[CLIMATE_LOOP_TEMPERATURE][zone], target, heat_temp, CONTROL_DT);
+        }
 
-    // Check if cooling should be activated
-    if (cooling_enabled && !cooling_active && current_temp > (temp_target + TEMP_HYSTERESIS)) {
-        cooling_active = true;
-        heating_active = false; // Prevent both systems running simultaneously
-        event_logger_add("Cooling activated", false);
+        // Hysteresis follows the state tables, each on its own temperature
+        uint8_t heat_band = control_fsm_band(heat_temp, target, TEMP_HYSTERESIS);
+        uint8_t cool_band = control_fsm_band(cool_temp, target, TEMP_HYSTERESIS);
+
+        if (heating_modulated) {
+            heating_active[zone] = pid_tpo_update(&heating_tpo[zone], heating_enabled[zone] ? output : 0.0f) &&
+                                   heating_enabled[zone];
+        } else {
+            heating_active[zone] = step_actuator(zone, CLIMATE_ACTUATOR_HEATING,
+                                                 heat_band | (heating_enabled[zone] ? CONTROL_GUARD_ENABLED : 0));
+        }
+
+        if (cooling_modulated) {
+            cooling_active[zone] = pid_tpo_update(&cooling_tpo[zone], cooling_enabled[zone] ? -output : 0.0f) &&
+                                   cooling_enabled[zone];
+        } else {
+            cooling_active[zone] = step_actuator(zone, CLIMATE_ACTUATOR_COOLING,
+                                                 cool_band | (cooling_enabled[zone] ? CONTROL_GUARD_ENABLED : 0));
+        }
+
+        // Mixed modes or a gradient too steep for the target: never run
+        // both, keep the one that moves toward the target
+        if (heating_active[zone] && cooling_active[zone]) {
+            if (heat_temp < target) {
+                cooling_active[zone] = false;
+            } else {
+                heating_active[zone] = false;
+            }
+        }
     }
-    // Check if cooling should be deactivated
-    else if (cooling_active && current_temp < (temp_target - TEMP_HYSTERESIS)) {
-        cooling_active = false;
-        event_logger_add("Cooling deactivated", false);
+
+    // Keep the tables in step with modulated and auto-tuned outputs
+    sync_state(zone, CLIMATE_ACTUATOR_HEATING, heating_enabled[zone], heating_active[zone]);
+    sync_state(zone, CLIMATE_ACTUATOR_COOLING, cooling_enabled[zone], cooling_active[zone]);
+
+    // Safety interlock cutoffs override the control decision
+    uint8_t cut = safety_interlock_get_cutoff(zone);
+    if (cut & SAFETY_CUT_HEATING) {
+        heating_active[zone] = false;
+    }
+    if (cut & SAFETY_CUT_COOLING) {
+        cooling_active[zone] = false;
     }
 
     // Apply influence to the simulated environment
-    if (heating_active) {
-        data_simulator_apply_heating();
+    if (heating_active[zone]) {
+        data_simulator_apply_zone_heating(zone);
     }
 
-    if (cooling_active) {
-        data_simulator_apply_cooling();
+    if (cooling_active[zone]) {
+        data_simulator_apply_zone_cooling(zone);
+    }
+}
+
+// Humidity the humidifier works to at a temperature: the target, or with
+// a VPD target the humidity that gives it, within the zone's limits
+static float humidity_setpoint_at(int zone, float temperature) {
+    if (vpd_target[zone] <= 0.0f) {
+        return humidity_target[zone];
+    }
+    return clamp_target(psychro_humidity_for_vpd(temperature, vpd_target[zone]), humidity_min[zone],
+                        humidity_max[zone]);
+}
+
+// Compute the moist-air metrics of every zone from its latest sample in
+// one pass, then the statistics, humidifier setpoints and condensation
+// alerts
+static void update_metrics(void) {
+    for (int z = 0; z < zone_count; z++) {
+        air_temp[z] = sensor_hal_get_value(z, SENSOR_VALUE_TEMPERATURE);
+        air_humidity[z] = sensor_hal_get_value(z, SENSOR_VALUE_HUMIDITY);
+    }
+    psychro_compute_batch(air_temp, air_humidity, metric_vpd, metric_dew_point, metric_abs_humidity, zone_count);
+
+    for (int z = 0; z < zone_count; z++) {
+        stream_channel_t *zs = stats[z];
+        if (!zs) {
+            continue;
+        }
+        uint8_t closed = stream_channel_add(&zs[CLIMATE_STAT_TEMPERATURE], air_temp[z], control_ms);
+        stream_channel_add(&zs[CLIMATE_STAT_HUMIDITY], air_humidity[z], control_ms);
+        stream_channel_add(&zs[CLIMATE_STAT_LIGHT], sensor_hal_get_value(z, SENSOR_VALUE_LIGHT), control_ms);
+        stream_channel_add(&zs[CLIMATE_STAT_VPD], metric_vpd[z], control_ms);
+
+        if (closed & (1 << STREAM_WINDOW_DAY)) {
+            const stream_summary_t *day = &zs[CLIMATE_STAT_TEMPERATURE].last[STREAM_WINDOW_DAY];
+            ESP_LOGI(TAG, "Zone %d day: %.1f..%.1f°C, mean %.1f, p95 %.1f", z + 1, day->min, day->max, day->mean,
+                     day->quantile[STREAM_STATS_P95]);
+        }
+    }
+
+    for (int z = 0; z < zone_count; z++) {
+        humidity_setpoint[z] = humidity_setpoint_at(z, air_temp[z]);
+        if (isnan(metric_dew_point[z])) {
+            continue;
+        }
+
+        // Water condenses on the coldest surface first; the coldest probe
+        // stands in for it (the ambient probe for the glass)
+        sensor_zone_t values;
+        float coldest = air_temp[z];
+        sensor_hal_get_zone(z, &values);
+        for (int p = 0; p < PROBE_COUNT; p++) {
+            if (values.probes[p] < coldest) {
+                coldest = values.probes[p];
+            }
+        }
+
+        float gap = coldest - metric_dew_point[z];
+        if (!condensation[z] && gap < CLIMATE_CONDENSATION_MARGIN_C) {
+            condensation[z] = true;
+            ESP_LOGW(TAG, "Zone %d dew point %.1f°C is within %.1f°C of %.1f°C", z + 1, metric_dew_point[z],
+                     CLIMATE_CONDENSATION_MARGIN_C, coldest);
+            event_logger_add_zone_fmt(z, "Condensation risk: dew point %.1f°C", true, metric_dew_point[z]);
+        } else if (condensation[z] && gap > CLIMATE_CONDENSATION_MARGIN_C + CLIMATE_CONDENSATION_RELEASE_C) {
+            condensation[z] = false;
+            event_logger_add_zone(z, "Condensation risk cleared", false);
+        }
     }
 }
 
 // Control logic for humidifier
-static void update_humidifier(float current_humidity) {
-    // Check if humidifier should be activated
-    if (humidifier_enabled && !humidifier_active && current_humidity < (humidity_target - HUMIDITY_HYSTERESIS)) {
-        humidifier_active = true;
-        event_logger_add("Humidifier activated", false);
+static void update_humidifier(int zone, float current_humidity) {
+    float target = humidity_setpoint[zone];
+
+    if (autotune.state == PID_AUTOTUNE_RUNNING && autotune_zone == zone &&
+        autotune_loop == CLIMATE_LOOP_HUMIDITY) {
+        humidifier_active[zone] = humidifier_enabled[zone] &&
+                                  pid_autotune_update(&autotune, current_humidity, CONTROL_DT) > 0.5f;
+        if (autotune.state != PID_AUTOTUNE_RUNNING) {
+            finish_autotune();
+        }
+    } else if (modes[CLIMATE_ACTUATOR_HUMIDIFIER][zone] == CLIMATE_MODE_PULSE) {
+        // A cut ends the pulse early so it is measured for what it delivered
+        bool allowed = humidifier_enabled[zone] && !(safety_interlock_get_cutoff(zone) & SAFETY_CUT_HUMIDIFIER);
+        humidifier_active[zone] = mist_pulse_update(&mist[zone], current_humidity, target, allowed, control_ms);
+        if (mist[zone].capped && !mist_capped[zone]) {
+            event_logger_add_zone(zone, "Daily mist volume reached, pulses held", true);
+        }
+        mist_capped[zone] = mist[zone].capped;
+    } else if (modes[CLIMATE_ACTUATOR_HUMIDIFIER][zone] == CLIMATE_MODE_PID) {
+        float output = pid_update(&loops[CLIMATE_LOOP_HUMIDITY][zone], target, current_humidity, CONTROL_DT);
+        humidifier_active[zone] = pid_tpo_update(&humidifier_tpo[zone], humidifier_enabled[zone] ? output : 0.0f) &&
+                                  humidifier_enabled[zone];
+    } else {
+        humidifier_active[zone] = step_actuator(zone, CLIMATE_ACTUATOR_HUMIDIFIER,
+                                                control_fsm_band(current_humidity, target, HUMIDITY_HYSTERESIS) |
+                                                (humidifier_enabled[zone] ? CONTROL_GUARD_ENABLED : 0));
     }
-    // Check if humidifier should be deactivated
-    else if (humidifier_active && current_humidity > (humidity_target + HUMIDITY_HYSTERESIS)) {
-        humidifier_active = false;
-        event_logger_add("Humidifier deactivated", false);
+    sync_state(zone, CLIMATE_ACTUATOR_HUMIDIFIER, humidifier_enabled[zone], humidifier_active[zone]);
+
+    if (safety_interlock_get_cutoff(zone) & SAFETY_CUT_HUMIDIFIER) {
+        humidifier_active[zone] = false;
     }
 
     // Apply influence to the simulated environment
-    if (humidifier_active) {
-        data_simulator_apply_humidifier();
+    if (humidifier_active[zone]) {
+        data_simulator_apply_zone_humidifier(zone);
     }
 }
 
-// Control logic for lighting
-static void update_lighting(float current_light) {
-    // For lighting, we try to maintain the exact level
-    if (lighting_enabled) {
-        // Only toggle state if we're significantly off target
-        if (!lighting_active && fabs(current_light - light_target) > LIGHT_HYSTERESIS) {
-            lighting_active = true;
-            event_logger_add("Lighting adjusted", false);
-        }
-    } else if (lighting_active) {
-        lighting_active = false;
-        event_logger_add("Lighting disabled", false);
+// Store the auto-tuned gains, or report the failure
+static void finish_autotune(void) {
+    const char *loop_name = autotune_loop == CLIMATE_LOOP_TEMPERATURE ? "Temperature" : "Humidity";
+    float kp, ki, kd;
+
+    if (!pid_autotune_get_gains(&autotune, &kp, &ki, &kd)) {
+        event_logger_add_zone_fmt(autotune_zone, "%s auto-tune failed", true, loop_name);
+        return;
     }
 
+    // Runs under the lock from the update; saved once it is released
+    pid_set_gains(&loops[autotune_loop][autotune_zone], kp, ki, kd);
+    store_pid_gains(autotune_zone, autotune_loop, kp, ki, kd);
+    settings_unsaved = true;
+    ESP_LOGI(TAG, "Zone %d %s auto-tune: Ku=%.3f Tu=%.1fs", autotune_zone + 1, loop_name,
+             autotune.ku, autotune.tu);
+    event_logger_add_zone_fmt(autotune_zone, "%s auto-tune done: Kp=%.3f Ki=%.4f Kd=%.3f", false,
+                              loop_name, kp, ki, kd);
+}
+
+// Control logic for lighting
+static void update_lighting(int zone, float current_light) {
+    // Switch on once significantly off target, then hold the target level
+    lighting_active[zone] = step_actuator(zone, CLIMATE_ACTUATOR_LIGHTING,
+                                          control_fsm_band(current_light, light_target[zone], LIGHT_HYSTERESIS) |
+                                          (lighting_enabled[zone] ? CONTROL_GUARD_ENABLED : 0));
+
     // Apply target to simulator
-    if (lighting_active) {
-        data_simulator_set_light_target(light_target);
+    if (lighting_active[zone]) {
+        data_simulator_set_zone_light_target(zone, light_target[zone]);
     } else {
-        data_simulator_set_light_target(0);
+        data_simulator_set_zone_light_target(zone, 0);
     }
 }
 
-// Set target temperature
-void climate_controller_set_temp_target(float temp) {
-    if (temp < 15.0f) {
-        temp = 15.0f;
-    } else if (temp > 40.0f) {
-        temp = 40.0f;
+// Set the number of active zones
+void climate_controller_set_zone_count(int count) {
+    if (count < 1) {
+        count = 1;
+    } else if (count > CLIMATE_MAX_ZONES) {
+        count = CLIMATE_MAX_ZONES;
     }
 
-    temp_target = temp;
-    ESP_LOGI(TAG, "Temperature target set to %.1f°C", temp_target);
-    event_logger_add_fmt("Temperature target set to %.1f°C", false, temp_target);
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    // Zones going out of use keep their energy totals; zones coming into
+    // use start from their defaults and stored settings
+    for (int z = count; z < zone_count; z++) {
+        save_energy(z);
+    }
+    for (int z = zone_count; z < count; z++) {
+        alloc_stats(z);
+        reset_zone(z);
+        load_zone_settings(z);
+    }
+
+    // Stop an auto-tune on a zone going out of use
+    if (autotune.state == PID_AUTOTUNE_RUNNING && autotune_zone >= count) {
+        autotune.state = PID_AUTOTUNE_IDLE;
+    }
+
+    zone_count = count;
+    data_simulator_set_zone_count(count);
+    event_logger_set_zone_count(count);
+    xSemaphoreGive(lock);
+
+    settings_set_int(SETTINGS_KEY_ZONE_COUNT, count);
+    settings_save();
+    ESP_LOGI(TAG, "Zone count set to %d", count);
+    event_logger_add_fmt("Zone count set to %d", false, count);
 }
 
-// Set target humidity
-void climate_controller_set_humidity_target(float humidity) {
-    if (humidity < 20.0f) {
-        humidity = 20.0f;
-    } else if (humidity > 90.0f) {
-        humidity = 90.0f;
+// Get the number of active zones
+int climate_controller_get_zone_count(void) {
+    return zone_count;
+}
+
+// Set target temperature of a zone
+void climate_controller_zone_set_temp_target(int zone, float temp) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
+    if (temp < temp_min[zone]) {
+        temp = temp_min[zone];
+    } else if (temp > temp_max[zone]) {
+        temp = temp_max[zone];
     }
 
-    humidity_target = humidity;
-    ESP_LOGI(TAG, "Humidity target set to %.1f%%", humidity_target);
-    event_logger_add_fmt("Humidity target set to %.1f%%", false, humidity_target);
+    temp_target[zone] = temp;
+    ESP_LOGI(TAG, "Zone %d temperature target set to %.1f°C", zone + 1, temp);
+    event_logger_add_zone_fmt(zone, "Temperature target set to %.1f°C", false, temp);
 }
 
-// Set target light level
-void climate_controller_set_light_target(float light) {
+// Set target humidity of a zone
+void climate_controller_zone_set_humidity_target(int zone, float humidity) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
+    if (humidity < humidity_min[zone]) {
+        humidity = humidity_min[zone];
+    } else if (humidity > humidity_max[zone]) {
+        humidity = humidity_max[zone];
+    }
+
+    humidity_target[zone] = humidity;
+    ESP_LOGI(TAG, "Zone %d humidity target set to %.1f%%", zone + 1, humidity);
+    event_logger_add_zone_fmt(zone, "Humidity target set to %.1f%%", false, humidity);
+}
+
+// Set target light level of a zone
+void climate_controller_zone_set_light_target(int zone, float light) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
     if (light < 0.0f) {
         light = 0.0f;
     } else if (light > 100.0f) {
         light = 100.0f;
     }
 
-    light_target = light;
-    ESP_LOGI(TAG, "Light target set to %.1f%%", light_target);
-    event_logger_add_fmt("Light target set to %.1f%%", false, light_target);
+    light_target[zone] = light;
+    ESP_LOGI(TAG, "Zone %d light target set to %.1f%%", zone + 1, light);
+    event_logger_add_zone_fmt(zone, "Light target set to %.1f%%", false, light);
+}
+
+// Set a VPD target of a zone
+void climate_controller_zone_set_vpd_target(int zone, float vpd_kpa) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone)) {
+        return;
+    }
+    if (vpd_kpa > 0.0f) {
+        vpd_kpa = clamp_target(vpd_kpa, CLIMATE_VPD_TARGET_MIN_KPA, CLIMATE_VPD_TARGET_MAX_KPA);
+    } else {
+        vpd_kpa = 0.0f;
+    }
+
+    vpd_target[zone] = vpd_kpa;
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_VPD_TARGET, zone), vpd_kpa);
+
+    if (vpd_kpa > 0.0f) {
+        ESP_LOGI(TAG, "Zone %d VPD target set to %.2f kPa", zone + 1, vpd_kpa);
+        event_logger_add_zone_fmt(zone, "VPD target set to %.2f kPa", false, vpd_kpa);
+    } else {
+        ESP_LOGI(TAG, "Zone %d humidity controlled to its target", zone + 1);
+        event_logger_add_zone(zone, "VPD target cleared", false);
+    }
+}
+
+// Get the VPD target of a zone
+float climate_controller_zone_get_vpd_target(int zone) {
+    return valid_zone(zone) ? vpd_target[zone] : 0.0f;
+}
+
+// Get the statistics of a reading in a zone over a window
+bool climate_controller_zone_get_stats(int zone, climate_stat_t stat, stream_window_t window, bool closed,
+                                       stream_summary_t *summary) {
+    if (!valid_zone(zone) || !stats[zone] || stat >= CLIMATE_STAT_COUNT || window >= STREAM_WINDOW_COUNT) {
+        return false;
+    }
+    stream_channel_get(&stats[zone][stat], window, closed, summary);
+    return true;
+}
+
+// Get the moist-air metrics of a zone
+void climate_controller_zone_get_metrics(int zone, climate_metrics_t *metrics) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+    metrics->vpd_kpa = metric_vpd[zone];
+    metrics->dew_point_c = metric_dew_point[zone];
+    metrics->abs_humidity_gm3 = metric_abs_humidity[zone];
+    metrics->humidity_setpoint = humidity_setpoint[zone];
+    metrics->condensation_risk = condensation[zone];
+}
+
+// Clamp a target to its range
+static float clamp_target(float value, float min, float max) {
+    return value < min ? min : value > max ? max : value;
+}
+
+// Set all three targets of a zone from a profile, without logging
+void climate_controller_zone_follow_targets(int zone, float temp, float humidity, float light) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
+    temp_target[zone] = clamp_target(temp, temp_min[zone], temp_max[zone]);
+    humidity_target[zone] = clamp_target(humidity, humidity_min[zone], humidity_max[zone]);
+    light_target[zone] = clamp_target(light, 0.0f, 100.0f);
+}
+
+// Set the targets and target limits of a zone in one step
+esp_err_t climate_controller_zone_apply_targets(int zone, const climate_zone_targets_t *targets) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    float t_min = clamp_target(targets->temp_min, CLIMATE_TEMP_LIMIT_MIN_C, CLIMATE_TEMP_LIMIT_MAX_C);
+    float t_max = clamp_target(targets->temp_max, CLIMATE_TEMP_LIMIT_MIN_C, CLIMATE_TEMP_LIMIT_MAX_C);
+    float h_min = clamp_target(targets->humidity_min, CLIMATE_HUMIDITY_LIMIT_MIN_PCT, CLIMATE_HUMIDITY_LIMIT_MAX_PCT);
+    float h_max = clamp_target(targets->humidity_max, CLIMATE_HUMIDITY_LIMIT_MIN_PCT, CLIMATE_HUMIDITY_LIMIT_MAX_PCT);
+    if (t_min >= t_max || h_min >= h_max) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    temp_min[zone] = t_min;
+    temp_max[zone] = t_max;
+    humidity_min[zone] = h_min;
+    humidity_max[zone] = h_max;
+    temp_target[zone] = clamp_target(targets->temp_target, t_min, t_max);
+    humidity_target[zone] = clamp_target(targets->humidity_target, h_min, h_max);
+    light_target[zone] = clamp_target(targets->light_target, 0.0f, 100.0f);
+    xSemaphoreGive(lock);
+
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_TEMP_MIN, zone), t_min);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_TEMP_MAX, zone), t_max);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_MIN, zone), h_min);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_MAX, zone), h_max);
+    ESP_LOGI(TAG, "Zone %d targets %.1f°C %.0f%% %.0f%%, limits %.1f..%.1f°C %.0f..%.0f%%", zone + 1,
+             temp_target[zone], humidity_target[zone], light_target[zone], t_min, t_max, h_min, h_max);
+    return ESP_OK;
+}
+
+// Get the target limits of a zone
+void climate_controller_zone_get_limits(int zone, float *t_min, float *t_max, float *h_min, float *h_max) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+    *t_min = temp_min[zone];
+    *t_max = temp_max[zone];
+    *h_min = humidity_min[zone];
+    *h_max = humidity_max[zone];
+}
+
+// Toggle heating system of a zone
+void climate_controller_zone_set_heating(int zone, bool enable) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    heating_enabled[zone] = enable;
+    heating_active[zone] = step_actuator(zone, CLIMATE_ACTUATOR_HEATING, current_guards(zone, CLIMATE_ACTUATOR_HEATING));
+    xSemaphoreGive(lock);
+
+    ESP_LOGI(TAG, "Zone %d heating system %s", zone + 1, enable ? "enabled" : "disabled");
+    event_logger_add_zone_fmt(zone, "Heating system %s", false, enable ? "enabled" : "disabled");
+}
+
+// Toggle cooling system of a zone
+void climate_controller_zone_set_cooling(int zone, bool enable) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    cooling_enabled[zone] = enable;
+    cooling_active[zone] = step_actuator(zone, CLIMATE_ACTUATOR_COOLING, current_guards(zone, CLIMATE_ACTUATOR_COOLING));
+    xSemaphoreGive(lock);
+
+    ESP_LOGI(TAG, "Zone %d cooling system %s", zone + 1, enable ? "enabled" : "disabled");
+    event_logger_add_zone_fmt(zone, "Cooling system %s", false, enable ? "enabled" : "disabled");
+}
+
+// Toggle humidifier of a zone
+void climate_controller_zone_set_humidifier(int zone, bool enable) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    humidifier_enabled[zone] = enable;
+    humidifier_active[zone] = step_actuator(zone, CLIMATE_ACTUATOR_HUMIDIFIER, current_guards(zone, CLIMATE_ACTUATOR_HUMIDIFIER));
+    xSemaphoreGive(lock);
+
+    ESP_LOGI(TAG, "Zone %d humidifier %s", zone + 1, enable ? "enabled" : "disabled");
+    event_logger_add_zone_fmt(zone, "Humidifier %s", false, enable ? "enabled" : "disabled");
+}
+
+// Toggle lighting of a zone
+void climate_controller_zone_set_lighting(int zone, bool enable) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    lighting_enabled[zone] = enable;
+    lighting_active[zone] = step_actuator(zone, CLIMATE_ACTUATOR_LIGHTING, current_guards(zone, CLIMATE_ACTUATOR_LIGHTING));
+    xSemaphoreGive(lock);
+
+    ESP_LOGI(TAG, "Zone %d lighting %s", zone + 1, enable ? "enabled" : "disabled");
+    event_logger_add_zone_fmt(zone, "Lighting %s", false, enable ? "enabled" : "disabled");
+}
+
+// Get target temperature of a zone
+float climate_controller_zone_get_temp_target(int zone) {
+    return valid_zone(zone) ? temp_target[zone] : 0.0f;
+}
+
+// Get target humidity of a zone
+float climate_controller_zone_get_humidity_target(int zone) {
+    return valid_zone(zone) ? humidity_target[zone] : 0.0f;
+}
+
+// Get target light level of a zone
+float climate_controller_zone_get_light_target(int zone) {
+    return valid_zone(zone) ? light_target[zone] : 0.0f;
+}
+
+// Get actuator status of a zone
+bool climate_controller_zone_is_on(int zone, climate_actuator_t actuator) {
+    if (!valid_zone(zone)) {
+        return false;
+    }
+
+    switch (actuator) {
+        case CLIMATE_ACTUATOR_HEATING:
+            return heating_active[zone];
+        case CLIMATE_ACTUATOR_COOLING:
+            return cooling_active[zone];
+        case CLIMATE_ACTUATOR_HUMIDIFIER:
+            return humidifier_active[zone];
+        case CLIMATE_ACTUATOR_LIGHTING:
+            return lighting_active[zone];
+        default:
+            return false;
+    }
+}
+
+// Select the control mode of an actuator in a zone
+void climate_controller_zone_set_mode(int zone, climate_actuator_t actuator, climate_mode_t mode) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone) || actuator >= CLIMATE_ACTUATOR_LIGHTING) {
+        return;
+    }
+    if (actuator == CLIMATE_ACTUATOR_HUMIDIFIER && mode == CLIMATE_MODE_MPC) {
+        ESP_LOGW(TAG, "No humidity model, using PID for the humidifier");
+        mode = CLIMATE_MODE_PID;
+    }
+    if (actuator != CLIMATE_ACTUATOR_HUMIDIFIER && mode == CLIMATE_MODE_PULSE) {
+        ESP_LOGW(TAG, "Pulse mode is for the humidifier only");
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (modes[actuator][zone] != mode) {
+        // Start the loop fresh rather than from a stale integral, and drop
+        // any pulse in progress (the learned mist response stays)
+        climate_loop_t loop = actuator == CLIMATE_ACTUATOR_HUMIDIFIER ?
+                              CLIMATE_LOOP_HUMIDITY : CLIMATE_LOOP_TEMPERATURE;
+        pid_reset(&loops[loop][zone]);
+        mist[zone].state = MIST_IDLE;
+    }
+
+    modes[actuator][zone] = mode;
+    xSemaphoreGive(lock);
+
+    settings_set_int(settings_zone_key(key, mode_keys[actuator], zone), mode);
+    settings_save();
+    event_logger_add_zone_fmt(zone, "%s control: %s", false,
+                              actuator == CLIMATE_ACTUATOR_HEATING ? "Heating" :
+                              actuator == CLIMATE_ACTUATOR_COOLING ? "Cooling" : "Humidifier",
+                              mode == CLIMATE_MODE_MPC ? "MPC" : mode == CLIMATE_MODE_PID ? "PID" :
+                              mode == CLIMATE_MODE_PULSE ? "mist pulses" : "hysteresis");
+}
+
+// Get the control mode of an actuator in a zone
+climate_mode_t climate_controller_zone_get_mode(int zone, climate_actuator_t actuator) {
+    if (!valid_zone(zone) || actuator >= CLIMATE_ACTUATOR_COUNT) {
+        return CLIMATE_MODE_HYSTERESIS;
+    }
+    return modes[actuator][zone];
+}
+
+// Store the PID gains of a loop in a zone; the caller saves
+static void store_pid_gains(int zone, climate_loop_t loop, float kp, float ki, float kd) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (loop == CLIMATE_LOOP_TEMPERATURE) {
+        settings_set_float(settings_zone_key(key, SETTINGS_KEY_TEMP_KP, zone), kp);
+        settings_set_float(settings_zone_key(key, SETTINGS_KEY_TEMP_KI, zone), ki);
+        settings_set_float(settings_zone_key(key, SETTINGS_KEY_TEMP_KD, zone), kd);
+    } else {
+        settings_set_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_KP, zone), kp);
+        settings_set_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_KI, zone), ki);
+        settings_set_float(settings_zone_key(key, SETTINGS_KEY_HUMIDITY_KD, zone), kd);
+    }
+}
+
+// Set the PID gains of a loop in a zone
+void climate_controller_zone_set_pid_gains(int zone, climate_loop_t loop, float kp, float ki, float kd) {
+    if (!valid_zone(zone) || loop >= CLIMATE_LOOP_COUNT) {
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    pid_set_gains(&loops[loop][zone], kp, ki, kd);
+    xSemaphoreGive(lock);
+
+    store_pid_gains(zone, loop, kp, ki, kd);
+    settings_save();
+}
+
+// Get the PID gains of a loop in a zone
+void climate_controller_zone_get_pid_gains(int zone, climate_loop_t loop, float *kp, float *ki, float *kd) {
+    if (!valid_zone(zone) || loop >= CLIMATE_LOOP_COUNT) {
+        return;
+    }
+    *kp = loops[loop][zone].kp;
+    *ki = loops[loop][zone].ki;
+    *kd = loops[loop][zone].kd;
+}
+
+// Start a relay auto-tune of a loop in a zone
+esp_err_t climate_controller_zone_start_autotune(int zone, climate_loop_t loop) {
+    if (!valid_zone(zone) || loop >= CLIMATE_LOOP_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (autotune.state == PID_AUTOTUNE_RUNNING) {
+        xSemaphoreGive(lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    autotune_zone = zone;
+    autotune_loop = loop;
+    if (loop == CLIMATE_LOOP_TEMPERATURE) {
+        pid_autotune_start(&autotune, temp_target[zone], TEMP_AUTOTUNE_HYSTERESIS, 0.0f, 1.0f,
+                           CLIMATE_AUTOTUNE_TIMEOUT_MS / 1000.0f);
+    } else {
+        pid_autotune_start(&autotune, humidity_target[zone], HUMIDITY_AUTOTUNE_HYSTERESIS, 0.0f, 1.0f,
+                           CLIMATE_AUTOTUNE_TIMEOUT_MS / 1000.0f);
+    }
+    pid_reset(&loops[loop][zone]);
+    xSemaphoreGive(lock);
+
+    event_logger_add_zone_fmt(zone, "%s auto-tune started", false,
+                              loop == CLIMATE_LOOP_TEMPERATURE ? "Temperature" : "Humidity");
+    return ESP_OK;
+}
+
+// Get the number of off->on relay transitions of an actuator in a zone
+uint32_t climate_controller_zone_get_cycle_count(int zone, climate_actuator_t actuator) {
+    if (!valid_zone(zone) || actuator >= CLIMATE_ACTUATOR_COUNT) {
+        return 0;
+    }
+    return cycle_counts[actuator][zone];
+}
+
+// Set the daily mist volume cap of a zone
+void climate_controller_zone_set_mist_cap(int zone, float ml_per_day) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone) || ml_per_day < 0.0f) {
+        return;
+    }
+    mist[zone].daily_cap_ml = ml_per_day;
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_MIST_CAP, zone), ml_per_day);
+    ESP_LOGI(TAG, "Zone %d mist cap set to %.0f ml/day", zone + 1, ml_per_day);
+}
+
+// Get the pulse scheduler of a zone
+void climate_controller_zone_get_mist(int zone, mist_pulse_t *out) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+    *out = mist[zone];
+}
+
+// Set the rated power of an actuator in a zone
+void climate_controller_zone_set_watts(int zone, climate_actuator_t actuator, float watts) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone) || actuator >= CLIMATE_ACTUATOR_COUNT || watts < 0.0f) {
+        return;
+    }
+    meters[actuator][zone].watts = watts;
+    settings_set_float(settings_zone_key(key, watt_keys[actuator], zone), watts);
+    ESP_LOGI(TAG, "Zone %d actuator %d rated at %.0f W", zone + 1, actuator, watts);
+}
+
+// Get the rated power of an actuator in a zone
+float climate_controller_zone_get_watts(int zone, climate_actuator_t actuator) {
+    if (!valid_zone(zone) || actuator >= CLIMATE_ACTUATOR_COUNT) {
+        return 0.0f;
+    }
+    return meters[actuator][zone].watts;
+}
+
+// Get the runtime, cycles and energy of an actuator in a zone
+void climate_controller_zone_get_energy(int zone, climate_actuator_t actuator, energy_summary_t *summary) {
+    if (!valid_zone(zone) || actuator >= CLIMATE_ACTUATOR_COUNT) {
+        return;
+    }
+    energy_meter_get_summary(&meters[actuator][zone], summary);
+}
+
+// Check if the thermal model of a zone has been identified
+bool climate_controller_zone_is_model_ready(int zone) {
+    return valid_zone(zone) && thermal_model_is_ready(&temp_model[zone]);
+}
+
+// Predict the heater's effect on a zone from the thermal model
+float climate_controller_zone_predict_rise(int zone, float heat_duty, int64_t duration_ms) {
+    float ambient_temp = sensor_hal_get_ambient();
+
+    if (!valid_zone(zone) || isnan(ambient_temp) || !thermal_model_is_ready(&temp_model[zone])) {
+        return NAN;
+    }
+    return thermal_model_predict_rise(&temp_model[zone], heat_duty, ambient_temp,
+                                      (int)(duration_ms / CLIMATE_CONTROL_PERIOD_MS));
+}
+
+// Check if an auto-tune is running in any zone
+bool climate_controller_is_autotuning(void) {
+    return autotune.state == PID_AUTOTUNE_RUNNING;
+}
+
+// Set target temperature
+void climate_controller_set_temp_target(float temp) {
+    climate_controller_zone_set_temp_target(0, temp);
+}
+
+// Set target humidity
+void climate_controller_set_humidity_target(float humidity) {
+    climate_controller_zone_set_humidity_target(0, humidity);
+}
+
+// Set target light level
+void climate_controller_set_light_target(float light) {
+    climate_controller_zone_set_light_target(0, light);
 }
 
 // Toggle heating system
 void climate_controller_set_heating(bool enable) {
-    heating_enabled = enable;
-    heating_active = enable;
-    ESP_LOGI(TAG, "Heating system %s", enable ? "enabled" : "disabled");
-    event_logger_add_fmt("Heating system %s", false, enable ? "enabled" : "disabled");
+    climate_controller_zone_set_heating(0, enable);
 }
 
 // Toggle cooling system
 void climate_controller_set_cooling(bool enable) {
-    cooling_enabled = enable;
-    cooling_active = enable;
-    ESP_LOGI(TAG, "Cooling system %s", enable ? "enabled" : "disabled");
-    event_logger_add_fmt("Cooling system %s", false, enable ? "enabled" : "disabled");
+    climate_controller_zone_set_cooling(0, enable);
 }
 
 // Toggle humidifier
 void climate_controller_set_humidifier(bool enable) {
-    humidifier_enabled = enable;
-    humidifier_active = enable;
-    ESP_LOGI(TAG, "Humidifier %s", enable ? "enabled" : "disabled");
-    event_logger_add_fmt("Humidifier %s", false, enable ? "enabled" : "disabled");
+    climate_controller_zone_set_humidifier(0, enable);
 }
 
 // Toggle lighting
 void climate_controller_set_lighting(bool enable) {
-    lighting_enabled = enable;
-    lighting_active = enable;
-    ESP_LOGI(TAG, "Lighting %s", enable ? "enabled" : "disabled");
-    event_logger_add_fmt("Lighting %s", false, enable ? "enabled" : "disabled");
+    climate_controller_zone_set_lighting(0, enable);
 }
 
 // Get current target temperature
 float climate_controller_get_temp_target(void) {
-    return temp_target;
+    return temp_target[0];
 }
 
 // Get current target humidity
 float climate_controller_get_humidity_target(void) {
-    return humidity_target;
+    return humidity_target[0];
 }
 
 // Get current target light level
 float climate_controller_get_light_target(void) {
-    return light_target;
+    return light_target[0];
 }
 
 // Get heating system status
 bool climate_controller_is_heating_on(void) {
-    return heating_active;
+    return heating_active[0];
 }
 
 // Get cooling system status
 bool climate_controller_is_cooling_on(void) {
-    return cooling_active;
+    return cooling_active[0];
 }
 
 // Get humidifier status
 bool climate_controller_is_humidifier_on(void) {
-    return humidifier_active;
+    return humidifier_active[0];
 }
 
 // Get lighting status
 bool climate_controller_is_lighting_on(void) {
-    return lighting_active;
+    return lighting_active[0];
+}
+
+// Select the control mode of an actuator
+void climate_controller_set_mode(climate_actuator_t actuator, climate_mode_t mode) {
+    climate_controller_zone_set_mode(0, actuator, mode);
+}
+
+// Get the control mode of an actuator
+climate_mode_t climate_controller_get_mode(climate_actuator_t actuator) {
+    return climate_controller_zone_get_mode(0, actuator);
+}
+
+// Set the PID gains of a loop
+void climate_controller_set_pid_gains(climate_loop_t loop, float kp, float ki, float kd) {
+    climate_controller_zone_set_pid_gains(0, loop, kp, ki, kd);
+}
+
+// Get the PID gains of a loop
+void climate_controller_get_pid_gains(climate_loop_t loop, float *kp, float *ki, float *kd) {
+    climate_controller_zone_get_pid_gains(0, loop, kp, ki, kd);
+}
+
+// Start a relay auto-tune of a loop
+esp_err_t climate_controller_start_autotune(climate_loop_t loop) {
+    return climate_controller_zone_start_autotune(0, loop);
+}
+
+// Get the number of off->on relay transitions of an actuator
+uint32_t climate_controller_get_cycle_count(climate_actuator_t actuator) {
+    return climate_controller_zone_get_cycle_count(0, actuator);
+}
+
+// Check if the thermal model used by MPC has been identified
+bool climate_controller_is_model_ready(void) {
+    return climate_controller_zone_is_model_ready(0);
 }
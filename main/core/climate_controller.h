@@ -1,14 +1,308 @@
 #ifndef CLIMATE_CONTROLLER_H
 #define CLIMATE_CONTROLLER_H
 
+#include "esp_err.h"
+#include "energy_meter.h"
+#include "mist_pulse.h"
+#include "stream_stats.h"
 #include <stdbool.h>
+#include <stdint.h>
+
+// Zones (enclosures) one controller can drive. State is kept as
+// struct-of-arrays sized for this many zones; the active count is set at
+// runtime and stored in settings.
+#ifndef CLIMATE_MAX_ZONES
+#define CLIMATE_MAX_ZONES 64
+#endif
+#ifndef CLIMATE_DEFAULT_ZONES
+#define CLIMATE_DEFAULT_ZONES 1
+#endif
+
+// Period of the sensor samples. The sensor task notifies the climate task
+// after each one and climate_controller_update() runs once per sample, so
+// every decision sees fresh data.
+#define CLIMATE_CONTROL_PERIOD_MS 1000
+
+// Without a sample for this long the update runs anyway, so relay windows
+// keep their timing while the sensors stall. Each such tick counts as one
+// period; the interlock cuts heat and mist after SAFETY_SENSOR_STALE_MS.
+#define CLIMATE_FALLBACK_PERIOD_MS 2000
+
+// Time-proportioning window and shortest on/off time for PID-driven relays.
+// Real enclosures change over minutes: a 60 s window switches a relay at
+// most 1440 times a day. The simulator compresses a day into two minutes,
+// so simulator builds (the default without REPTICONTROL_SENSOR_HW, the
+// benches and the tests) use a short window instead.
+#ifndef CLIMATE_TPO_WINDOW_MS
+#ifdef REPTICONTROL_SENSOR_HW
+#define CLIMATE_TPO_WINDOW_MS 60000
+#else
+#define CLIMATE_TPO_WINDOW_MS 4000
+#endif
+#endif
+#ifndef CLIMATE_TPO_MIN_MS
+#ifdef REPTICONTROL_SENSOR_HW
+#define CLIMATE_TPO_MIN_MS 5000
+#else
+#define CLIMATE_TPO_MIN_MS 1000
+#endif
+#endif
+
+// Default PID gains until an auto-tune has run (the output is a relay duty)
+#define CLIMATE_TEMP_DEFAULT_KP 0.4f
+#define CLIMATE_TEMP_DEFAULT_KI 0.02f
+#define CLIMATE_TEMP_DEFAULT_KD 0.0f
+#define CLIMATE_HUMIDITY_DEFAULT_KP 0.1f
+#define CLIMATE_HUMIDITY_DEFAULT_KI 0.005f
+#define CLIMATE_HUMIDITY_DEFAULT_KD 0.0f
+
+// Order of the thermal model fitted for MPC (1 or 2)
+#define CLIMATE_THERMAL_MODEL_ORDER 2
+
+// MPC cost of one unit of heater or cooler duty per sample, against the
+// squared temperature error (°C²)
+#define CLIMATE_MPC_ENERGY_WEIGHT 0.2f
+
+// Give up a relay auto-tune after this long
+#define CLIMATE_AUTOTUNE_TIMEOUT_MS (60 * 60 * 1000)
+
+// Outer bounds of the temperature and humidity targets. Each zone's own
+// limits (a species preset's) lie within them and default to them.
+#define CLIMATE_TEMP_LIMIT_MIN_C 15.0f
+#define CLIMATE_TEMP_LIMIT_MAX_C 40.0f
+#define CLIMATE_HUMIDITY_LIMIT_MIN_PCT 20.0f
+#define CLIMATE_HUMIDITY_LIMIT_MAX_PCT 90.0f
+
+// Bounds of a vapour pressure deficit target (kPa)
+#define CLIMATE_VPD_TARGET_MIN_KPA 0.2f
+#define CLIMATE_VPD_TARGET_MAX_KPA 3.0f
+
+// Raise a condensation alert when a zone's dew point comes within this of
+// its coldest reading (air or any probe), and clear it once the gap is
+// this much wider again
+#define CLIMATE_CONDENSATION_MARGIN_C 1.0f
+#define CLIMATE_CONDENSATION_RELEASE_C 0.5f
+
+// Heater duty while a zone's temperature reading is held as suspect
+// (anomaly_detector.h)
+#ifndef CLIMATE_FAILSAFE_HEAT_DUTY
+#define CLIMATE_FAILSAFE_HEAT_DUTY 0.2f
+#endif
+
+// Rated power of each actuator until configured (W)
+#define CLIMATE_HEATING_DEFAULT_WATTS 100.0f
+#define CLIMATE_COOLING_DEFAULT_WATTS 60.0f
+#define CLIMATE_HUMIDIFIER_DEFAULT_WATTS 25.0f
+#define CLIMATE_LIGHTING_DEFAULT_WATTS 50.0f
+
+// Report a heater or cooler that was on for this share of an hour or more
+#define CLIMATE_SATURATED_DUTY 0.98f
+
+// Save the energy totals every this many hours; they live in NVS flash
+#ifndef CLIMATE_ENERGY_SAVE_HOURS
+#define CLIMATE_ENERGY_SAVE_HOURS 6
+#endif
+
+// Actuators
+typedef enum {
+    CLIMATE_ACTUATOR_HEATING,
+    CLIMATE_ACTUATOR_COOLING,
+    CLIMATE_ACTUATOR_HUMIDIFIER,
+    CLIMATE_ACTUATOR_LIGHTING,
+    CLIMATE_ACTUATOR_COUNT
+} climate_actuator_t;
+
+// Control mode per actuator
+typedef enum {
+    CLIMATE_MODE_HYSTERESIS,
+    CLIMATE_MODE_PID,
+    CLIMATE_MODE_MPC,           // Heating and cooling only; PID until the model is identified
+    CLIMATE_MODE_PULSE          // Humidifier only: timed mist pulses (mist_pulse.h)
+} climate_mode_t;
+
+// Control loops shared by PID-driven actuators
+typedef enum {
+    CLIMATE_LOOP_TEMPERATURE,   // Heating (+) and cooling (-)
+    CLIMATE_LOOP_HUMIDITY,      // Humidifier
+    CLIMATE_LOOP_COUNT
+} climate_loop_t;
+
+// Sample-to-decision timing of the control update
+typedef struct {
+    uint32_t samples;           // Updates run for a fresh sample
+    uint32_t fallback_ticks;    // Updates run without one
+    uint32_t missed_samples;    // Samples replaced by a newer one before an update
+    uint32_t latency_last_us;   // From the sample to the outputs being committed
+    uint32_t latency_max_us;
+    uint32_t latency_avg_us;    // Exponential average, about the last 16 samples
+} climate_timing_t;
+
+// Readings with running statistics
+typedef enum {
+    CLIMATE_STAT_TEMPERATURE,
+    CLIMATE_STAT_HUMIDITY,
+    CLIMATE_STAT_LIGHT,
+    CLIMATE_STAT_VPD,
+    CLIMATE_STAT_COUNT
+} climate_stat_t;
+
+// Moist-air metrics of a zone from its latest sample (psychrometrics.h),
+// NaN while the temperature or humidity is missing
+typedef struct {
+    float vpd_kpa;
+    float dew_point_c;
+    float abs_humidity_gm3;
+    float humidity_setpoint;    // What the humidifier works to: the target, or the humidity giving the VPD target
+    bool condensation_risk;
+} climate_metrics_t;
+
+// Targets and target limits of a zone, applied together
+typedef struct {
+    float temp_target;
+    float humidity_target;
+    float light_target;
+    float temp_min;
+    float temp_max;
+    float humidity_min;
+    float humidity_max;
+} climate_zone_targets_t;
 
 // Initialize the climate controller
 void climate_controller_init(void);
 
-// Update climate control logic
+// Update climate control logic of every zone
 void climate_controller_update(void);
 
+// Record a fresh sensor sample taken at sampled_us (esp_timer time). The
+// sensor task calls this before notifying the climate task; the next
+// update measures its latency from here. Safe to call from any task.
+void climate_controller_sample_ready(int64_t sampled_us);
+
+// Get the sample-to-decision timing measured so far
+void climate_controller_get_timing(climate_timing_t *timing);
+
+// Set the number of active zones (1..CLIMATE_MAX_ZONES)
+void climate_controller_set_zone_count(int count);
+
+// Get the number of active zones
+int climate_controller_get_zone_count(void);
+
+// Set target temperature of a zone
+void climate_controller_zone_set_temp_target(int zone, float temp);
+
+// Set target humidity of a zone
+void climate_controller_zone_set_humidity_target(int zone, float humidity);
+
+// Set target light level of a zone
+void climate_controller_zone_set_light_target(int zone, float light);
+
+// Set a vapour pressure deficit target of a zone (kPa, saved): the
+// humidifier then works to the humidity giving it at the current
+// temperature, within the humidity limits. 0 goes back to the humidity
+// target.
+void climate_controller_zone_set_vpd_target(int zone, float vpd_kpa);
+
+// Get the VPD target of a zone (0 when humidity is controlled directly)
+float climate_controller_zone_get_vpd_target(int zone);
+
+// Get the moist-air metrics of a zone, as of the last update
+void climate_controller_zone_get_metrics(int zone, climate_metrics_t *metrics);
+
+// Get the statistics of a reading in a zone over a window: the window in
+// progress, or the last closed one. Every zone keeps them, in about 2.8 KB
+// allocated when it first comes into use. False for a zone out of use, or
+// if that allocation failed.
+bool climate_controller_zone_get_stats(int zone, climate_stat_t stat, stream_window_t window, bool closed,
+                                       stream_summary_t *summary);
+
+// Set all three targets of a zone from a profile: clamped like the setters
+// above but not logged, as a ramp moves them every few minutes
+void climate_controller_zone_follow_targets(int zone, float temp, float humidity, float light);
+
+// Set the targets and target limits of a zone in one step: no control tick
+// sees some of them changed and others not. Limits are bounded by the
+// CLIMATE_*_LIMIT_* values and saved; later targets are clamped to them.
+esp_err_t climate_controller_zone_apply_targets(int zone, const climate_zone_targets_t *targets);
+
+// Get the target limits of a zone
+void climate_controller_zone_get_limits(int zone, float *temp_min, float *temp_max,
+                                        float *humidity_min, float *humidity_max);
+
+// Toggle heating system of a zone
+void climate_controller_zone_set_heating(int zone, bool enable);
+
+// Toggle cooling system of a zone
+void climate_controller_zone_set_cooling(int zone, bool enable);
+
+// Toggle humidifier of a zone
+void climate_controller_zone_set_humidifier(int zone, bool enable);
+
+// Toggle lighting of a zone
+void climate_controller_zone_set_lighting(int zone, bool enable);
+
+// Get target temperature of a zone
+float climate_controller_zone_get_temp_target(int zone);
+
+// Get target humidity of a zone
+float climate_controller_zone_get_humidity_target(int zone);
+
+// Get target light level of a zone
+float climate_controller_zone_get_light_target(int zone);
+
+// Get actuator status of a zone
+bool climate_controller_zone_is_on(int zone, climate_actuator_t actuator);
+
+// Select the control mode of an actuator in a zone (lighting is always
+// hysteresis). MPC plans heater and cooler duty together from the
+// identified thermal model.
+void climate_controller_zone_set_mode(int zone, climate_actuator_t actuator, climate_mode_t mode);
+
+// Get the control mode of an actuator in a zone
+climate_mode_t climate_controller_zone_get_mode(int zone, climate_actuator_t actuator);
+
+// Set the PID gains of a loop in a zone
+void climate_controller_zone_set_pid_gains(int zone, climate_loop_t loop, float kp, float ki, float kd);
+
+// Get the PID gains of a loop in a zone
+void climate_controller_zone_get_pid_gains(int zone, climate_loop_t loop, float *kp, float *ki, float *kd);
+
+// Start a relay auto-tune of a loop in a zone around its current target;
+// the new gains are stored in settings when it finishes. One auto-tune
+// runs at a time.
+esp_err_t climate_controller_zone_start_autotune(int zone, climate_loop_t loop);
+
+// Get the number of off->on relay transitions of an actuator in a zone
+uint32_t climate_controller_zone_get_cycle_count(int zone, climate_actuator_t actuator);
+
+// Check if the thermal model of a zone has been identified
+bool climate_controller_zone_is_model_ready(int zone);
+
+// Predict how far the heater at a duty (0..1) would move a zone's heating
+// temperature over duration_ms from its last sample; NaN until the thermal
+// model is identified or without an ambient reading
+float climate_controller_zone_predict_rise(int zone, float heat_duty, int64_t duration_ms);
+
+// Set the daily mist volume cap of a zone in pulse mode (saved)
+void climate_controller_zone_set_mist_cap(int zone, float ml_per_day);
+
+// Get the pulse scheduler of a zone (learned gain, volume used today)
+void climate_controller_zone_get_mist(int zone, mist_pulse_t *mist);
+
+// Set the rated power of an actuator in a zone (W, saved); energy is
+// estimated from it and the output level
+void climate_controller_zone_set_watts(int zone, climate_actuator_t actuator, float watts);
+
+// Get the rated power of an actuator in a zone (W)
+float climate_controller_zone_get_watts(int zone, climate_actuator_t actuator);
+
+// Get the runtime, cycles and energy of an actuator in a zone
+void climate_controller_zone_get_energy(int zone, climate_actuator_t actuator, energy_summary_t *summary);
+
+// Check if an auto-tune is running in any zone
+bool climate_controller_is_autotuning(void);
+
+// Single-zone API, acting on zone 0
+
 // Set target temperature
 void climate_controller_set_temp_target(float temp);
 
@@ -51,4 +345,25 @@ bool climate_controller_is_humidifier_on(void);
 // Get lighting status
 bool climate_controller_is_lighting_on(void);
 
+// Select the control mode of an actuator
+void climate_controller_set_mode(climate_actuator_t actuator, climate_mode_t mode);
+
+// Get the control mode of an actuator
+climate_mode_t climate_controller_get_mode(climate_actuator_t actuator);
+
+// Set the PID gains of a loop
+void climate_controller_set_pid_gains(climate_loop_t loop, float kp, float ki, float kd);
+
+// Get the PID gains of a loop
+void climate_controller_get_pid_gains(climate_loop_t loop, float *kp, float *ki, float *kd);
+
+// Start a relay auto-tune of a loop
+esp_err_t climate_controller_start_autotune(climate_loop_t loop);
+
+// Get the number of off->on relay transitions of an actuator since init
+uint32_t climate_controller_get_cycle_count(climate_actuator_t actuator);
+
+// Check if the thermal model used by MPC has been identified
+bool climate_controller_is_model_ready(void);
+
 #endif /* CLIMATE_CONTROLLER_H */
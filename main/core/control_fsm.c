@@ -0,0 +1,132 @@
+#include "control_fsm.h"
+#include <stddef.h>
+
+// Short names for the tables below
+#define DISABLED CONTROL_STATE_DISABLED
+#define IDLE CONTROL_STATE_IDLE
+#define RUNNING CONTROL_STATE_RUNNING
+#define ENABLED CONTROL_GUARD_ENABLED
+#define BELOW CONTROL_GUARD_BELOW
+#define ABOVE CONTROL_GUARD_ABOVE
+#define OUTSIDE CONTROL_GUARD_OUTSIDE
+
+// Rows of one state, with the count taken from the array
+#define ROWS(rows) { rows, sizeof(rows) / sizeof(rows[0]) }
+
+// Heating: on below the band, off above it
+static const control_transition_t heating_disabled[] = {
+    { ENABLED | BELOW, 0, RUNNING, "Heating activated" },
+    { ENABLED, 0, IDLE, NULL },
+};
+static const control_transition_t heating_idle[] = {
+    { 0, ENABLED, DISABLED, NULL },
+    { BELOW, 0, RUNNING, "Heating activated" },
+};
+static const control_transition_t heating_running[] = {
+    { 0, ENABLED, DISABLED, NULL },
+    { ABOVE, 0, IDLE, "Heating deactivated" },
+};
+
+const control_fsm_t control_fsm_heating = {
+    .name = "heating",
+    .states = {
+        [DISABLED] = ROWS(heating_disabled),
+        [IDLE] = ROWS(heating_idle),
+        [RUNNING] = ROWS(heating_running),
+    },
+    .output = { [RUNNING] = true },
+};
+
+// Cooling: on above the band, off below it
+static const control_transition_t cooling_disabled[] = {
+    { ENABLED | ABOVE, 0, RUNNING, "Cooling activated" },
+    { ENABLED, 0, IDLE, NULL },
+};
+static const control_transition_t cooling_idle[] = {
+    { 0, ENABLED, DISABLED, NULL },
+    { ABOVE, 0, RUNNING, "Cooling activated" },
+};
+static const control_transition_t cooling_running[] = {
+    { 0, ENABLED, DISABLED, NULL },
+    { BELOW, 0, IDLE, "Cooling deactivated" },
+};
+
+const control_fsm_t control_fsm_cooling = {
+    .name = "cooling",
+    .states = {
+        [DISABLED] = ROWS(cooling_disabled),
+        [IDLE] = ROWS(cooling_idle),
+        [RUNNING] = ROWS(cooling_running),
+    },
+    .output = { [RUNNING] = true },
+};
+
+// Humidifier: on below the band, off above it
+static const control_transition_t humidifier_disabled[] = {
+    { ENABLED | BELOW, 0, RUNNING, "Humidifier activated" },
+    { ENABLED, 0, IDLE, NULL },
+};
+static const control_transition_t humidifier_idle[] = {
+    { 0, ENABLED, DISABLED, NULL },
+    { BELOW, 0, RUNNING, "Humidifier activated" },
+};
+static const control_transition_t humidifier_running[] = {
+    { 0, ENABLED, DISABLED, NULL },
+    { ABOVE, 0, IDLE, "Humidifier deactivated" },
+};
+
+const control_fsm_t control_fsm_humidifier = {
+    .name = "humidifier",
+    .states = {
+        [DISABLED] = ROWS(humidifier_disabled),
+        [IDLE] = ROWS(humidifier_idle),
+        [RUNNING] = ROWS(humidifier_running),
+    },
+    .output = { [RUNNING] = true },
+};
+
+// Lighting: on once the level is off target, then held at the target
+// until switched off
+static const control_transition_t lighting_disabled[] = {
+    { ENABLED | OUTSIDE, 0, RUNNING, "Lighting adjusted" },
+    { ENABLED, 0, IDLE, NULL },
+};
+static const control_transition_t lighting_idle[] = {
+    { 0, ENABLED, DISABLED, NULL },
+    { OUTSIDE, 0, RUNNING, "Lighting adjusted" },
+};
+static const control_transition_t lighting_running[] = {
+    { 0, ENABLED, DISABLED, NULL },
+};
+
+const control_fsm_t control_fsm_lighting = {
+    .name = "lighting",
+    .states = {
+        [DISABLED] = ROWS(lighting_disabled),
+        [IDLE] = ROWS(lighting_idle),
+        [RUNNING] = ROWS(lighting_running),
+    },
+    .output = { [RUNNING] = true },
+};
+
+// Band guards of a reading against its target
+uint8_t control_fsm_band(float value, float target, float hysteresis) {
+    uint8_t below = value < target - hysteresis;
+    uint8_t above = value > target + hysteresis;
+    return below * BELOW | above * ABOVE | (below | above) * OUTSIDE;
+}
+
+// Take the first transition out of a state whose guards hold
+const control_transition_t *control_fsm_step(const control_fsm_t *fsm, uint8_t *state, uint8_t guards) {
+    const control_rows_t *rows = &fsm->states[*state];
+
+    for (uint8_t i = 0; i < rows->count; i++) {
+        const control_transition_t *t = &rows->rows[i];
+        // Zero when all required guards hold and no forbidden one does
+        if ((((guards & t->require) ^ t->require) | (guards & t->forbid)) == 0) {
+            *state = t->to;
+            return t;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,61 @@
+#ifndef CONTROL_FSM_H
+#define CONTROL_FSM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Hysteresis control of each actuator as a state machine. Behavior lives in
+// const transition tables (in flash); the controller only computes the
+// guards and steps the table. New behavior (defrost, night drop, manual
+// override) is a new guard and rows, not a new code path.
+
+// States of an actuator
+typedef enum {
+    CONTROL_STATE_DISABLED,     // Switched off by the user
+    CONTROL_STATE_IDLE,         // Enabled, output off
+    CONTROL_STATE_RUNNING,      // Output on
+    CONTROL_STATE_COUNT
+} control_state_t;
+
+// Guards, computed once per tick as a bit set
+#define CONTROL_GUARD_ENABLED (1 << 0)     // System switched on by the user
+#define CONTROL_GUARD_BELOW   (1 << 1)     // Reading below target minus hysteresis
+#define CONTROL_GUARD_ABOVE   (1 << 2)     // Reading above target plus hysteresis
+#define CONTROL_GUARD_OUTSIDE (1 << 3)     // BELOW or ABOVE
+#define CONTROL_GUARD_COUNT 4
+
+// A transition fires when every guard in require holds and none in forbid
+typedef struct {
+    uint8_t require;
+    uint8_t forbid;
+    uint8_t to;
+    const char *event;          // Logged when taken, or NULL
+} control_transition_t;
+
+// Transitions out of one state, tried in order
+typedef struct {
+    const control_transition_t *rows;
+    uint8_t count;
+} control_rows_t;
+
+// State machine of one actuator
+typedef struct {
+    const char *name;
+    control_rows_t states[CONTROL_STATE_COUNT];
+    bool output[CONTROL_STATE_COUNT];   // Output on in each state
+} control_fsm_t;
+
+// Tables of the hysteresis-controlled actuators
+extern const control_fsm_t control_fsm_heating;
+extern const control_fsm_t control_fsm_cooling;
+extern const control_fsm_t control_fsm_humidifier;
+extern const control_fsm_t control_fsm_lighting;
+
+// Band guards of a reading against its target
+uint8_t control_fsm_band(float value, float target, float hysteresis);
+
+// Take the first transition out of a state whose guards hold; returns it,
+// or NULL if the state is kept
+const control_transition_t *control_fsm_step(const control_fsm_t *fsm, uint8_t *state, uint8_t guards);
+
+#endif /* CONTROL_FSM_H */
@@ -1,5 +1,7 @@
 #include "data_simulator.h"
 #include "event_logger.h"
+#include "probe_manager.h"
+#include "safety_interlock.h"
 #include "esp_log.h"
 #include "esp_random.h"
 #include <math.h>
@@ -7,13 +9,19 @@
 
 static const char *TAG = "data_simulator";
 
-// Current simulated values
-static float current_temp = 25.0f;
-static float current_humidity = 50.0f;
-static float current_light = 75.0f;
+// Simulated zones
+static int zone_count = 1;
 
-// Target for light system (set by controller)
-static float light_target = 75.0f;
+// Current simulated values per zone
+static float current_temp[DATA_SIMULATOR_MAX_ZONES];
+static float current_humidity[DATA_SIMULATOR_MAX_ZONES];
+static float current_light[DATA_SIMULATOR_MAX_ZONES];
+
+// Target for light system per zone (set by controller)
+static float light_target[DATA_SIMULATOR_MAX_ZONES];
+
+// Actuators cut at the output per zone
+static volatile uint8_t output_cutoff[DATA_SIMULATOR_MAX_ZONES];
 
 // Natural environment factors
 static float ambient_temp = 22.0f;    // Ambient room temperature
@@ -30,15 +38,19 @@ static const float HUMIDIFIER_POWER = 0.5f;      // Humidifier effect per update
 static const float TEMP_FLUCTUATION = 0.1f;      // Random fluctuation
 static const float HUMIDITY_FLUCTUATION = 0.2f;  // Random fluctuation
 static const float LIGHT_FLUCTUATION = 0.3f;     // Random fluctuation
+static const float PROBE_GRADIENT_HALF = 3.0f;   // Basking and cool side offsets
 
 // Initialize the data simulator
 void data_simulator_init(void) {
     ESP_LOGI(TAG, "Initializing data simulator");
 
     // Set initial values
-    current_temp = 25.0f;
-    current_humidity = 50.0f;
-    current_light = 75.0f;
+    for (int z = 0; z < DATA_SIMULATOR_MAX_ZONES; z++) {
+        current_temp[z] = 25.0f;
+        current_humidity[z] = 50.0f;
+        current_light[z] = 75.0f;
+        light_target[z] = 75.0f;
+    }
 
     // Seed random number generator
     srand(time(NULL));
@@ -51,6 +63,21 @@ static float random_float(float range) {
     return ((float)rand() / RAND_MAX * 2.0f - 1.0f) * range;
 }
 
+// Raise alerts for out-of-range values in one zone
+static void check_zone_alerts(int zone) {
+    if (current_temp[zone] > 35.0f) {
+        event_logger_add_zone(zone, "ALERT: High temperature detected!", true);
+    } else if (current_temp[zone] < 15.0f) {
+        event_logger_add_zone(zone, "ALERT: Low temperature detected!", true);
+    }
+
+    if (current_humidity[zone] < 20.0f) {
+        event_logger_add_zone(zone, "ALERT: Low humidity detected!", true);
+    } else if (current_humidity[zone] > 80.0f) {
+        event_logger_add_zone(zone, "ALERT: High humidity detected!", true);
+    }
+}
+
 // Update simulated sensor data
 void data_simulator_update(void) {
     // Update day/night cycle (runs from 0.0 to 1.0 over a 2-minute period for simulation)
@@ -63,91 +90,157 @@ void data_simulator_update(void) {
     float time_factor = sinf(day_night_cycle * 2.0f * 3.1416f);
     ambient_temp = 22.0f + 3.0f * time_factor;  // Varies from 19-25°C
 
-    // Natural drift toward ambient conditions
-    // Temperature naturally moves toward ambient
-    float temp_drift = (ambient_temp - current_temp) * TEMP_CHANGE_RATE;
-    current_temp += temp_drift;
-
-    // Humidity naturally decreases over time
-    current_humidity -= HUMIDITY_CHANGE_RATE * 0.5f;
-
-    // Light based on day/night cycle (plus any artificial light)
+    // Natural light based on day/night cycle
     float natural_light = 100.0f * sinf(day_night_cycle * 3.1416f); // Peaks at midday
     natural_light = natural_light < 0.0f ? 0.0f : natural_light;    // No negative light
 
-    // Adjust light towards target (artificial) or natural light
-    float light_drift;
-    if (light_target > 0) {
-        // If artificial lighting is on, move toward target
-        light_drift = (light_target - current_light) * LIGHT_CHANGE_RATE;
-    } else {
-        // Otherwise, move toward natural light
-        light_drift = (natural_light - current_light) * LIGHT_CHANGE_RATE;
-    }
-    current_light += light_drift;
+    for (int z = 0; z < zone_count; z++) {
+        // Natural drift toward ambient conditions
+        // Temperature naturally moves toward ambient
+        float temp_drift = (ambient_temp - current_temp[z]) * TEMP_CHANGE_RATE;
+        current_temp[z] += temp_drift;
+
+        // Humidity naturally decreases over time
+        current_humidity[z] -= HUMIDITY_CHANGE_RATE * 0.5f;
+
+        // Adjust light towards target (artificial) or natural light
+        float light_drift;
+        if (light_target[z] > 0) {
+            // If artificial lighting is on, move toward target
+            light_drift = (light_target[z] - current_light[z]) * LIGHT_CHANGE_RATE;
+        } else {
+            // Otherwise, move toward natural light
+            light_drift = (natural_light - current_light[z]) * LIGHT_CHANGE_RATE;
+        }
+        current_light[z] += light_drift;
 
-    // Add random fluctuations
-    current_temp += random_float(TEMP_FLUCTUATION);
-    current_humidity += random_float(HUMIDITY_FLUCTUATION);
-    current_light += random_float(LIGHT_FLUCTUATION);
+        // Add random fluctuations
+        current_temp[z] += random_float(TEMP_FLUCTUATION);
+        current_humidity[z] += random_float(HUMIDITY_FLUCTUATION);
+        current_light[z] += random_float(LIGHT_FLUCTUATION);
 
-    // Ensure values stay within realistic bounds
-    if (current_temp < 10.0f) current_temp = 10.0f;
-    if (current_temp > 45.0f) current_temp = 45.0f;
+        // Ensure values stay within realistic bounds
+        if (current_temp[z] < 10.0f) current_temp[z] = 10.0f;
+        if (current_temp[z] > 45.0f) current_temp[z] = 45.0f;
 
-    if (current_humidity < 10.0f) current_humidity = 10.0f;
-    if (current_humidity > 95.0f) current_humidity = 95.0f;
+        if (current_humidity[z] < 10.0f) current_humidity[z] = 10.0f;
+        if (current_humidity[z] > 95.0f) current_humidity[z] = 95.0f;
 
-    if (current_light < 0.0f) current_light = 0.0f;
-    if (current_light > 100.0f) current_light = 100.0f;
+        if (current_light[z] < 0.0f) current_light[z] = 0.0f;
+        if (current_light[z] > 100.0f) current_light[z] = 100.0f;
+    }
 
     // Generate random events
     if (rand() % 1000 == 0) {  // 0.1% chance per update
-        if (current_temp > 35.0f) {
-            event_logger_add("ALERT: High temperature detected!", true);
-        } else if (current_temp < 15.0f) {
-            event_logger_add("ALERT: Low temperature detected!", true);
+        for (int z = 0; z < zone_count; z++) {
+            check_zone_alerts(z);
         }
+    }
+}
 
-        if (current_humidity < 20.0f) {
-            event_logger_add("ALERT: Low humidity detected!", true);
-        } else if (current_humidity > 80.0f) {
-            event_logger_add("ALERT: High humidity detected!", true);
-        }
+// Set the number of simulated zones
+void data_simulator_set_zone_count(int count) {
+    if (count < 1) {
+        count = 1;
+    } else if (count > DATA_SIMULATOR_MAX_ZONES) {
+        count = DATA_SIMULATOR_MAX_ZONES;
     }
+    zone_count = count;
+}
+
+// Get the simulated temperature of one zone
+float data_simulator_get_zone_temperature(int zone) {
+    return current_temp[zone];
+}
+
+// Get the simulated humidity of one zone
+float data_simulator_get_zone_humidity(int zone) {
+    return current_humidity[zone];
+}
+
+// Get the simulated light level of one zone
+float data_simulator_get_zone_light(int zone) {
+    return current_light[zone];
+}
+
+// Get the simulated probe readings of one zone
+void data_simulator_get_zone_probes(int zone, float *probes) {
+    probes[PROBE_BASKING] = current_temp[zone] + PROBE_GRADIENT_HALF;
+    probes[PROBE_COOL_SIDE] = current_temp[zone] - PROBE_GRADIENT_HALF;
+    probes[PROBE_SUBSTRATE] = current_temp[zone];
+    probes[PROBE_AMBIENT] = ambient_temp;
+}
+
+// Set the light target of one zone
+void data_simulator_set_zone_light_target(int zone, float target) {
+    light_target[zone] = target;
+}
+
+// Apply heating influence to one zone
+void data_simulator_apply_zone_heating(int zone) {
+    if (output_cutoff[zone] & SAFETY_CUT_HEATING) {
+        return;
+    }
+    current_temp[zone] += HEATING_POWER;
+}
+
+// Apply cooling influence to one zone
+void data_simulator_apply_zone_cooling(int zone) {
+    if (output_cutoff[zone] & SAFETY_CUT_COOLING) {
+        return;
+    }
+    current_temp[zone] -= COOLING_POWER;
+}
+
+// Apply humidifier influence to one zone
+void data_simulator_apply_zone_humidifier(int zone) {
+    if (output_cutoff[zone] & SAFETY_CUT_HUMIDIFIER) {
+        return;
+    }
+    current_humidity[zone] += HUMIDIFIER_POWER;
+}
+
+// Cut actuators of one zone at the output
+void data_simulator_set_zone_cutoff(int zone, uint8_t cut) {
+    output_cutoff[zone] = cut;
 }
 
 // Get current simulated temperature
 float data_simulator_get_temperature(void) {
-    return current_temp;
+    return current_temp[0];
 }
 
 // Get current simulated humidity
 float data_simulator_get_humidity(void) {
-    return current_humidity;
+    return current_humidity[0];
 }
 
 // Get current simulated light level
 float data_simulator_get_light(void) {
-    return current_light;
+    return current_light[0];
+}
+
+// Get current simulated ambient (room) temperature
+float data_simulator_get_ambient_temperature(void) {
+    return ambient_temp;
 }
 
 // Set the light target
 void data_simulator_set_light_target(float target) {
-    light_target = target;
+    light_target[0] = target;
 }
 
 // Apply heating influence
 void data_simulator_apply_heating(void) {
-    current_temp += HEATING_POWER;
+    data_simulator_apply_zone_heating(0);
 }
 
 // Apply cooling influence
 void data_simulator_apply_cooling(void) {
-    current_temp -= COOLING_POWER;
+    data_simulator_apply_zone_cooling(0);
 }
 
 // Apply humidifier influence
 void data_simulator_apply_humidifier(void) {
-    current_humidity += HUMIDIFIER_POWER;
+    data_simulator_apply_zone_humidifier(0);
 }
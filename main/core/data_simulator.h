@@ -1,12 +1,44 @@
 #ifndef DATA_SIMULATOR_H
 #define DATA_SIMULATOR_H
 
+#include <stdint.h>
+
+// Enclosures the simulator can model
+#define DATA_SIMULATOR_MAX_ZONES 64
+
 // Initialize the data simulator
 void data_simulator_init(void);
 
 // Update simulated sensor data
 void data_simulator_update(void);
 
+// Set the number of simulated zones (1..DATA_SIMULATOR_MAX_ZONES)
+void data_simulator_set_zone_count(int count);
+
+// Get the simulated values of one zone
+float data_simulator_get_zone_temperature(int zone);
+float data_simulator_get_zone_humidity(int zone);
+float data_simulator_get_zone_light(int zone);
+
+// Get the simulated probe readings of one zone (PROBE_COUNT values, in
+// probe_t order): a fixed hot-to-cool gradient around the zone temperature
+// and the room temperature on the ambient probe
+void data_simulator_get_zone_probes(int zone, float *probes);
+
+// Set the light target of one zone
+void data_simulator_set_zone_light_target(int zone, float target);
+
+// Apply actuator influence to one zone
+void data_simulator_apply_zone_heating(int zone);
+void data_simulator_apply_zone_cooling(int zone);
+void data_simulator_apply_zone_humidifier(int zone);
+
+// Cut actuators of one zone at the output, whatever the controller asks
+// for (SAFETY_CUT_* bits, set by the safety interlock)
+void data_simulator_set_zone_cutoff(int zone, uint8_t cut);
+
+// Zone 0 accessors for single-enclosure callers
+
 // Get current simulated temperature
 float data_simulator_get_temperature(void);
 
@@ -16,6 +48,9 @@ float data_simulator_get_humidity(void);
 // Get current simulated light level
 float data_simulator_get_light(void);
 
+// Get current simulated ambient (room) temperature
+float data_simulator_get_ambient_temperature(void);
+
 // Set the light target (for simulation)
 void data_simulator_set_light_target(float target);
 
@@ -0,0 +1,129 @@
+#include "energy_meter.h"
+#include <string.h>
+
+// Initialize an empty meter
+void energy_meter_init(energy_meter_t *meter, float watts) {
+    memset(meter, 0, sizeof(*meter));
+    meter->watts = watts;
+    meter->hour_start_ms = INT64_MIN;
+}
+
+// Push the day in progress onto the daily ring
+static void close_day(energy_meter_t *meter) {
+    meter->day_head = (meter->day_head + 1) % ENERGY_DAYS;
+    meter->days[meter->day_head] = meter->today;
+    if (meter->day_count < ENERGY_DAYS) {
+        meter->day_count++;
+    }
+    memset(&meter->today, 0, sizeof(meter->today));
+    meter->hours_today = 0;
+}
+
+// Push the hour in progress onto the hourly ring and into the day and
+// the totals
+static void close_hour(energy_meter_t *meter) {
+    energy_hour_t hour = {
+        .on_s = (uint16_t)(meter->on_ms / 1000),
+        .cycles = meter->cycles > UINT16_MAX ? UINT16_MAX : (uint16_t)meter->cycles,
+        .wh = meter->watts * meter->full_ms / ENERGY_HOUR_MS,
+    };
+
+    meter->hour_head = (meter->hour_head + 1) % ENERGY_HOURS;
+    meter->hours[meter->hour_head] = hour;
+    if (meter->hour_count < ENERGY_HOURS) {
+        meter->hour_count++;
+    }
+
+    meter->today.on_s += hour.on_s;
+    meter->today.cycles += meter->cycles;
+    meter->today.wh += hour.wh;
+    meter->total_on_s += hour.on_s;
+    meter->total_cycles += meter->cycles;
+    meter->total_wh += hour.wh;
+
+    meter->on_ms = 0;
+    meter->full_ms = 0.0f;
+    meter->cycles = 0;
+    meter->hour_start_ms += ENERGY_HOUR_MS;
+
+    if (++meter->hours_today == ENERGY_HOURS_PER_DAY) {
+        close_day(meter);
+    }
+}
+
+// Account one tick of output
+bool energy_meter_update(energy_meter_t *meter, float level, uint32_t dt_ms, int64_t now_ms) {
+    bool closed = false;
+
+    if (meter->hour_start_ms == INT64_MIN) {
+        meter->hour_start_ms = now_ms;
+    }
+    // A gap of several hours closes the empty ones in between
+    while (now_ms - meter->hour_start_ms >= ENERGY_HOUR_MS) {
+        close_hour(meter);
+        closed = true;
+    }
+
+    if (level < 0.0f) level = 0.0f;
+    if (level > 1.0f) level = 1.0f;
+
+    bool on = level > 0.0f;
+    if (on) {
+        meter->on_ms += dt_ms;
+        meter->full_ms += level * dt_ms;
+    }
+    meter->cycles += on && !meter->was_on;
+    meter->was_on = on;
+    return closed;
+}
+
+// Get a closed hour, 0 being the latest
+bool energy_meter_get_hour(const energy_meter_t *meter, int ago, energy_hour_t *hour) {
+    if (ago < 0 || ago >= meter->hour_count) {
+        return false;
+    }
+    *hour = meter->hours[(meter->hour_head + ENERGY_HOURS - ago) % ENERGY_HOURS];
+    return true;
+}
+
+// Get a closed day, 0 being the latest
+bool energy_meter_get_day(const energy_meter_t *meter, int ago, energy_day_t *day) {
+    if (ago < 0 || ago >= meter->day_count) {
+        return false;
+    }
+    *day = meter->days[(meter->day_head + ENERGY_DAYS - ago) % ENERGY_DAYS];
+    return true;
+}
+
+// Sum the windows of a summary
+void energy_meter_get_summary(const energy_meter_t *meter, energy_summary_t *summary) {
+    energy_hour_t hour;
+    energy_day_t day;
+
+    memset(summary, 0, sizeof(*summary));
+    if (energy_meter_get_hour(meter, 0, &hour)) {
+        summary->last_hour_duty = hour.on_s / (ENERGY_HOUR_MS / 1000.0f);
+    }
+
+    // The hour in progress and the 23 closed before it
+    float wh = meter->watts * meter->full_ms / ENERGY_HOUR_MS;
+
+    summary->day_on_s = meter->on_ms / 1000;
+    summary->day_cycles = meter->cycles;
+    summary->day_wh = wh;
+    for (int i = 0; i < ENERGY_HOURS_PER_DAY - 1 && energy_meter_get_hour(meter, i, &hour); i++) {
+        summary->day_on_s += hour.on_s;
+        summary->day_cycles += hour.cycles;
+        summary->day_wh += hour.wh;
+    }
+
+    // Today so far and the 6 days closed before it
+    summary->week_wh = meter->today.wh + wh;
+    for (int i = 0; i < 6 && energy_meter_get_day(meter, i, &day); i++) {
+        summary->week_wh += day.wh;
+    }
+
+    summary->total_on_s = meter->total_on_s + meter->on_ms / 1000;
+    summary->total_cycles = meter->total_cycles + meter->cycles;
+    summary->total_wh = meter->total_wh + wh;
+}
@@ -0,0 +1,91 @@
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Runtime, switch cycles and estimated energy of one output, kept in
+// rolling hourly and daily buckets. Fed the output level once per control
+// tick; energy is the rated power times the level, so a lamp dimmed to
+// 40 % counts 40 % of its wattage while it is on. Never blocks.
+
+// Closed periods kept
+#ifndef ENERGY_HOURS
+#define ENERGY_HOURS 24
+#endif
+#ifndef ENERGY_DAYS
+#define ENERGY_DAYS 7
+#endif
+
+// Hours run from the first update; a day closes every 24 of them
+#define ENERGY_HOUR_MS (60LL * 60 * 1000)
+#define ENERGY_HOURS_PER_DAY 24
+
+// One closed hour
+typedef struct {
+    uint16_t on_s;              // Time the output was on
+    uint16_t cycles;            // Off->on switches
+    float wh;
+} energy_hour_t;
+
+// One closed day
+typedef struct {
+    uint32_t on_s;
+    uint32_t cycles;
+    float wh;
+} energy_day_t;
+
+// Meter of one output
+typedef struct {
+    float watts;                // Rated power at full level
+
+    // Hour in progress
+    int64_t hour_start_ms;      // INT64_MIN before the first update
+    uint32_t on_ms;
+    float full_ms;              // Level-weighted on time, priced at the close
+    uint32_t cycles;
+    bool was_on;
+
+    // Closed hours and days, newest at the head
+    energy_hour_t hours[ENERGY_HOURS];
+    energy_day_t days[ENERGY_DAYS];
+    uint8_t hour_head;
+    uint8_t hour_count;
+    uint8_t day_head;
+    uint8_t day_count;
+    energy_day_t today;         // Closed hours of the day in progress
+    uint8_t hours_today;
+
+    // Closed hours since first use; the owner restores them after a restart
+    uint32_t total_on_s;
+    uint32_t total_cycles;
+    double total_wh;
+} energy_meter_t;
+
+// Totals over the windows a display wants, including the hour in progress
+typedef struct {
+    float last_hour_duty;       // On fraction of the last closed hour
+    uint32_t day_on_s;          // Last 24 hours
+    uint32_t day_cycles;
+    float day_wh;
+    float week_wh;              // Last 7 days
+    uint32_t total_on_s;
+    uint32_t total_cycles;
+    double total_wh;
+} energy_summary_t;
+
+// Initialize an empty meter for an output of the given rated power
+void energy_meter_init(energy_meter_t *meter, float watts);
+
+// Account level (0..1; on above 0) over the dt_ms ending at now_ms.
+// Returns true if an hour closed.
+bool energy_meter_update(energy_meter_t *meter, float level, uint32_t dt_ms, int64_t now_ms);
+
+// Get a closed hour or day, 0 being the latest; false if not kept
+bool energy_meter_get_hour(const energy_meter_t *meter, int ago, energy_hour_t *hour);
+bool energy_meter_get_day(const energy_meter_t *meter, int ago, energy_day_t *day);
+
+// Sum the windows of a summary
+void energy_meter_get_summary(const energy_meter_t *meter, energy_summary_t *summary);
+
+#endif /* ENERGY_METER_H */
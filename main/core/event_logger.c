@@ -1,6 +1,7 @@
 #include "event_logger.h"
 #include "ui/ui.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -20,14 +21,26 @@ static log_entry_t log_buffer[MAX_LOG_ENTRIES];
 static int log_count = 0;
 static int log_next_index = 0;
 
+// Entries not yet shown by the UI; the newest ones in the buffer
+static int ui_pending = 0;
+
+// Entries come from every task, the UI drains them
+static portMUX_TYPE log_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Zones in use, as last set by the climate controller
+static int zone_count = 1;
+
 // Initialize the event logger
 void event_logger_init(void) {
     ESP_LOGI(TAG, "Initializing event logger");
 
     // Clear log buffer
+    portENTER_CRITICAL(&log_lock);
     memset(log_buffer, 0, sizeof(log_buffer));
     log_count = 0;
     log_next_index = 0;
+    ui_pending = 0;
+    portEXIT_CRITICAL(&log_lock);
 }
 
 // Add a log entry
@@ -43,23 +56,45 @@ void event_logger_add(const char* message, bool is_alert) {
         ESP_LOGI(TAG, "%s", message);
     }
 
-    // Store in circular buffer
+    // Store in circular buffer; the UI task picks it up from there, so the
+    // calling task never allocates LVGL objects
+    portENTER_CRITICAL(&log_lock);
     strncpy(log_buffer[log_next_index].message, message, MAX_LOG_MESSAGE_LEN - 1);
     log_buffer[log_next_index].message[MAX_LOG_MESSAGE_LEN - 1] = '\0';
     log_buffer[log_next_index].is_alert = is_alert;
 
-    // Update indices
+    // Update indices; when the UI falls a whole buffer behind it loses the
+    // oldest entries
     log_next_index = (log_next_index + 1) % MAX_LOG_ENTRIES;
     if (log_count < MAX_LOG_ENTRIES) {
         log_count++;
     }
+    if (ui_pending < MAX_LOG_ENTRIES) {
+        ui_pending++;
+    }
+    portEXIT_CRITICAL(&log_lock);
+}
 
-    // Update UI
-    ui_add_log_entry(message, is_alert);
-
-    // Show alert if needed
-    if (is_alert) {
-        ui_show_alert("Alert", message);
+// Show the entries added since the last call on the UI
+void event_logger_drain_ui(void) {
+    log_entry_t entry;
+
+    while (1) {
+        portENTER_CRITICAL(&log_lock);
+        if (ui_pending == 0) {
+            portEXIT_CRITICAL(&log_lock);
+            return;
+        }
+        entry = log_buffer[(log_next_index - ui_pending + MAX_LOG_ENTRIES) % MAX_LOG_ENTRIES];
+        ui_pending--;
+        portEXIT_CRITICAL(&log_lock);
+
+        ui_add_log_entry(entry.message, entry.is_alert);
+
+        // Show alert if needed
+        if (entry.is_alert) {
+            ui_show_alert("Alert", entry.message);
+        }
     }
 }
 
@@ -75,6 +110,33 @@ void event_logger_add_fmt(const char* format, bool is_alert, ...) {
     event_logger_add(buffer, is_alert);
 }
 
+// Set the number of zones in use, which decides whether zone entries are
+// prefixed
+void event_logger_set_zone_count(int count) {
+    zone_count = count;
+}
+
+// Add a log entry for a zone; single-zone installs keep the plain messages
+void event_logger_add_zone(int zone, const char* message, bool is_alert) {
+    if (zone_count == 1) {
+        event_logger_add(message, is_alert);
+    } else {
+        event_logger_add_fmt("Zone %d: %s", is_alert, zone + 1, message);
+    }
+}
+
+// Add a formatted log entry for a zone
+void event_logger_add_zone_fmt(int zone, const char* format, bool is_alert, ...) {
+    char buffer[MAX_LOG_MESSAGE_LEN];
+    va_list args;
+
+    va_start(args, is_alert);
+    vsnprintf(buffer, MAX_LOG_MESSAGE_LEN, format, args);
+    va_end(args);
+
+    event_logger_add_zone(zone, buffer, is_alert);
+}
+
 // Get log entry count
 int event_logger_get_count(void) {
     return log_count;
@@ -82,9 +144,12 @@ int event_logger_get_count(void) {
 
 // Clear all log entries
 void event_logger_clear(void) {
+    portENTER_CRITICAL(&log_lock);
     memset(log_buffer, 0, sizeof(log_buffer));
     log_count = 0;
     log_next_index = 0;
+    ui_pending = 0;
+    portEXIT_CRITICAL(&log_lock);
 
     ESP_LOGI(TAG, "Event log cleared");
 }
@@ -12,6 +12,21 @@ void event_logger_add(const char* message, bool is_alert);
 // Add a formatted log entry
 void event_logger_add_fmt(const char* format, bool is_alert, ...);
 
+// Set the number of zones in use. Called by the climate controller
+// whenever its zone count changes.
+void event_logger_set_zone_count(int count);
+
+// Add a log entry for a zone, prefixed "Zone N: " when there is more than
+// one zone
+void event_logger_add_zone(int zone, const char* message, bool is_alert);
+
+// Add a formatted log entry for a zone
+void event_logger_add_zone_fmt(int zone, const char* format, bool is_alert, ...);
+
+// Show the entries added since the last call on the UI. Called from the UI
+// task, which makes all the LVGL objects.
+void event_logger_drain_ui(void);
+
 // Get log entry count
 int event_logger_get_count(void);
 
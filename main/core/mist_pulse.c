@@ -0,0 +1,104 @@
+#include "mist_pulse.h"
+
+// Initialize a pulse scheduler with the defaults
+void mist_pulse_init(mist_pulse_t *mist) {
+    mist->min_pulse_ms = MIST_MIN_PULSE_MS;
+    mist->max_pulse_ms = MIST_MAX_PULSE_MS;
+    mist->settle_ms = MIST_SETTLE_MS;
+    mist->min_interval_ms = MIST_MIN_INTERVAL_MS;
+    mist->daily_cap_ml = MIST_DAILY_CAP_ML;
+    mist->gain = MIST_DEFAULT_GAIN;
+    mist->pulses = 0;
+    mist->state = MIST_IDLE;
+    mist->state_since_ms = 0;
+    mist->last_start_ms = INT64_MIN;
+    mist->pulse_ms = 0;
+    mist->start_humidity = 0.0f;
+    mist->peak_humidity = 0.0f;
+    mist->day_start_ms = INT64_MIN;
+    mist->used_ml = 0.0f;
+    mist->capped = false;
+}
+
+// Length of the next pulse: enough to close the deficit at the learned
+// gain, within the pulse limits and what is left of the cap (0 if none)
+static uint32_t plan_pulse(const mist_pulse_t *mist, float deficit) {
+    float ms = deficit / mist->gain * 1000.0f;
+    float left_ms = (mist->daily_cap_ml - mist->used_ml) / MIST_FLOW_ML_S * 1000.0f;
+
+    if (ms < mist->min_pulse_ms) ms = mist->min_pulse_ms;
+    if (ms > mist->max_pulse_ms) ms = mist->max_pulse_ms;
+    if (ms > left_ms) ms = left_ms;
+    return ms < mist->min_pulse_ms ? 0 : (uint32_t)ms;
+}
+
+// End the pulse in progress and book its volume
+static void end_pulse(mist_pulse_t *mist, int64_t now_ms) {
+    mist->pulse_ms = (uint32_t)(now_ms - mist->state_since_ms);
+    mist->used_ml += mist->pulse_ms / 1000.0f * MIST_FLOW_ML_S;
+    mist->state = MIST_SETTLING;
+    mist->state_since_ms = now_ms;
+}
+
+// Run one step at now_ms and return whether the mister is on
+bool mist_pulse_update(mist_pulse_t *mist, float humidity, float target, bool allowed, int64_t now_ms) {
+    // New cap period
+    if (mist->day_start_ms == INT64_MIN || now_ms - mist->day_start_ms >= MIST_DAY_MS) {
+        mist->day_start_ms = now_ms;
+        mist->used_ml = 0.0f;
+        mist->capped = false;
+    }
+
+    switch (mist->state) {
+        case MIST_IDLE: {
+            float deficit = target - humidity;
+            if (!allowed || deficit <= MIST_DEADBAND_PCT ||
+                (mist->last_start_ms != INT64_MIN && now_ms - mist->last_start_ms < mist->min_interval_ms)) {
+                return false;
+            }
+            uint32_t ms = plan_pulse(mist, deficit);
+            if (ms == 0) {
+                mist->capped = true;
+                return false;
+            }
+            mist->pulse_ms = ms;
+            mist->start_humidity = humidity;
+            mist->peak_humidity = humidity;
+            mist->last_start_ms = now_ms;
+            mist->state = MIST_PULSING;
+            mist->state_since_ms = now_ms;
+            return true;
+        }
+
+        case MIST_PULSING:
+            if (humidity > mist->peak_humidity) {
+                mist->peak_humidity = humidity;
+            }
+            if (!allowed || now_ms - mist->state_since_ms >= mist->pulse_ms) {
+                end_pulse(mist, now_ms);
+                return false;
+            }
+            return true;
+
+        case MIST_SETTLING:
+            // Mist takes a while to show on the sensor; judge the pulse by
+            // the highest reading before the next one may start
+            if (humidity > mist->peak_humidity) {
+                mist->peak_humidity = humidity;
+            }
+            if (now_ms - mist->state_since_ms >= mist->settle_ms) {
+                if (mist->pulse_ms >= mist->min_pulse_ms) {
+                    float rise = mist->peak_humidity - mist->start_humidity;
+                    float measured = rise > 0.0f ? rise / (mist->pulse_ms / 1000.0f) : MIST_MIN_GAIN;
+                    mist->gain += MIST_GAIN_ALPHA * (measured - mist->gain);
+                    if (mist->gain < MIST_MIN_GAIN) mist->gain = MIST_MIN_GAIN;
+                    if (mist->gain > MIST_MAX_GAIN) mist->gain = MIST_MAX_GAIN;
+                    mist->pulses++;
+                }
+                mist->state = MIST_IDLE;
+                mist->state_since_ms = now_ms;
+            }
+            return false;
+    }
+    return false;
+}
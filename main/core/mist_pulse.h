@@ -0,0 +1,84 @@
+#ifndef MIST_PULSE_H
+#define MIST_PULSE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Mist pulse scheduler: bounded pulses, a settle time after each before
+// its effect is judged, a minimum interval between starts and a daily cap
+// on volume. Each pulse is sized from the humidity rise per second of mist
+// that earlier pulses produced. Runs one step per control tick; never
+// blocks.
+
+// Defaults
+#ifndef MIST_MIN_PULSE_MS
+#define MIST_MIN_PULSE_MS 1000
+#endif
+#ifndef MIST_MAX_PULSE_MS
+#define MIST_MAX_PULSE_MS 10000
+#endif
+#ifndef MIST_SETTLE_MS
+#define MIST_SETTLE_MS 30000
+#endif
+#ifndef MIST_MIN_INTERVAL_MS
+#define MIST_MIN_INTERVAL_MS 60000
+#endif
+#ifndef MIST_FLOW_ML_S
+#define MIST_FLOW_ML_S 1.0f             // Nozzle flow while on
+#endif
+#ifndef MIST_DAILY_CAP_ML
+#define MIST_DAILY_CAP_ML 500.0f
+#endif
+
+// Humidity below target by more than this starts a pulse (%RH)
+#define MIST_DEADBAND_PCT 1.0f
+
+// Response assumed before the first pulse, its limits, and how fast each
+// pulse's measurement moves it (%RH per second of mist)
+#define MIST_DEFAULT_GAIN 1.0f
+#define MIST_MIN_GAIN 0.05f
+#define MIST_MAX_GAIN 10.0f
+#define MIST_GAIN_ALPHA 0.3f
+
+// Cap periods run 24 h from the first update
+#define MIST_DAY_MS (24LL * 60 * 60 * 1000)
+
+typedef enum {
+    MIST_IDLE,
+    MIST_PULSING,
+    MIST_SETTLING
+} mist_state_t;
+
+typedef struct {
+    // Configuration
+    uint32_t min_pulse_ms;
+    uint32_t max_pulse_ms;
+    uint32_t settle_ms;
+    uint32_t min_interval_ms;
+    float daily_cap_ml;
+
+    // Learned response
+    float gain;                 // %RH per second of mist
+    uint32_t pulses;            // Pulses measured
+
+    // State
+    mist_state_t state;
+    int64_t state_since_ms;
+    int64_t last_start_ms;      // INT64_MIN before the first pulse
+    uint32_t pulse_ms;          // Length of the current or last pulse
+    float start_humidity;
+    float peak_humidity;
+    int64_t day_start_ms;       // INT64_MIN before the first update
+    float used_ml;              // Volume in the current cap period
+    bool capped;                // A pulse was held back by the cap this period
+} mist_pulse_t;
+
+// Initialize a pulse scheduler with the defaults above
+void mist_pulse_init(mist_pulse_t *mist);
+
+// Run one step at now_ms and return whether the mister is on. allowed is
+// false while the humidifier is switched off or cut; a pulse in progress
+// then ends early and is measured for what it delivered.
+bool mist_pulse_update(mist_pulse_t *mist, float humidity, float target, bool allowed, int64_t now_ms);
+
+#endif /* MIST_PULSE_H */
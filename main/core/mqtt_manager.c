@@ -5,7 +5,6 @@
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
-#include "cJSON.h"
 
 static const char *TAG = "mqtt_manager";
 
@@ -18,6 +17,22 @@ static bool is_connected = false;
 // Device unique identifier
 static char device_id[32];
 
+// Periodic telemetry goes out at QoS 0, retained or not: the next period
+// replaces a lost message, and QoS 1 would hold each one in the client's
+// heap outbox until its PUBACK, charged to the network task, which must
+// not allocate in steady state. Discovery, alerts and the online status
+// are one-off and stay at QoS 1.
+#define MQTT_QOS_TELEMETRY 0
+
+// Discovery payload, reused for every config message
+#define HA_DISCOVERY_PAYLOAD_SIZE 512
+static char discovery_payload[HA_DISCOVERY_PAYLOAD_SIZE];
+
+// Device block shared by all discovery messages
+#define HA_DEVICE_JSON_FMT \
+    "\"device\":{\"identifiers\":\"%s\",\"name\":\"ReptiControl\"," \
+    "\"model\":\"ReptiControl v1.0\",\"manufacturer\":\"ReptiControl\"}"
+
 // Forward declarations
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
                              int32_t event_id, void *event_data);
@@ -105,6 +120,21 @@ esp_err_t mqtt_manager_configure_ha_discovery(void) {
     publish_ha_discovery_sensor("battery", "Battery Level", "%",
                               MQTT_TOPIC_BATTERY, "battery");
 
+    publish_ha_discovery_sensor("heating_energy", "Heating Energy", "kWh",
+                              MQTT_TOPIC_ENERGY "/heating/total", "energy");
+
+    publish_ha_discovery_sensor("cooling_energy", "Cooling Energy", "kWh",
+                              MQTT_TOPIC_ENERGY "/cooling/total", "energy");
+
+    publish_ha_discovery_sensor("humidifier_energy", "Humidifier Energy", "kWh",
+                              MQTT_TOPIC_ENERGY "/humidifier/total", "energy");
+
+    publish_ha_discovery_sensor("lighting_energy", "Lighting Energy", "kWh",
+                              MQTT_TOPIC_ENERGY "/lighting/total", "energy");
+
+    publish_ha_discovery_sensor("control_latency", "Control Latency", "ms",
+                              MQTT_TOPIC_DIAGNOSTICS "/control_latency", "duration");
+
     // Configure switches
     publish_ha_discovery_switch("heating", "Heating System",
                               MQTT_TOPIC_HEATING,
@@ -135,27 +165,18 @@ static esp_err_t publish_ha_discovery_sensor(const char* sensor_type,
     snprintf(topic, sizeof(topic), "%s/sensor/%s/%s/config",
              HA_DISCOVERY_PREFIX, device_id, sensor_type);
 
-    // Create discovery message
-    cJSON *config = cJSON_CreateObject();
-    cJSON_AddStringToObject(config, "name", name);
-    cJSON_AddStringToObject(config, "unique_id", device_id);
-    cJSON_AddStringToObject(config, "state_topic", state_topic);
-    cJSON_AddStringToObject(config, "device_class", device_class);
-    cJSON_AddStringToObject(config, "unit_of_measurement", unit);
-
-    // Add device info
-    cJSON *device = cJSON_CreateObject();
-    cJSON_AddStringToObject(device, "identifiers", device_id);
-    cJSON_AddStringToObject(device, "name", "ReptiControl");
-    cJSON_AddStringToObject(device, "model", "ReptiControl v1.0");
-    cJSON_AddStringToObject(device, "manufacturer", "ReptiControl");
-    cJSON_AddItemToObject(config, "device", device);
-
-    char *message = cJSON_PrintUnformatted(config);
-    esp_mqtt_client_publish(mqtt_client, topic, message, 0, 1, 1);
+    // Build discovery message in place
+    int len = snprintf(discovery_payload, sizeof(discovery_payload),
+                       "{\"name\":\"%s\",\"unique_id\":\"%s\",\"state_topic\":\"%s\","
+                       "\"device_class\":\"%s\",\"unit_of_measurement\":\"%s\","
+                       HA_DEVICE_JSON_FMT "}",
+                       name, device_id, state_topic, device_class, unit, device_id);
+    if (len < 0 || len >= (int)sizeof(discovery_payload)) {
+        ESP_LOGE(TAG, "Discovery payload for %s too long", sensor_type);
+        return ESP_ERR_INVALID_SIZE;
+    }
 
-    free(message);
-    cJSON_Delete(config);
+    esp_mqtt_client_publish(mqtt_client, topic, discovery_payload, len, 1, 1);
 
     return ESP_OK;
 }
@@ -169,29 +190,18 @@ static esp_err_t publish_ha_discovery_switch(const char* component,
     snprintf(topic, sizeof(topic), "%s/switch/%s/%s/config",
              HA_DISCOVERY_PREFIX, device_id, component);
 
-    // Create discovery message
-    cJSON *config = cJSON_CreateObject();
-    cJSON_AddStringToObject(config, "name", name);
-    cJSON_AddStringToObject(config, "unique_id", device_id);
-    cJSON_AddStringToObject(config, "state_topic", state_topic);
-    cJSON_AddStringToObject(config, "command_topic", command_topic);
-    cJSON_AddStringToObject(config, "payload_on", "on");
-    cJSON_AddStringToObject(config, "payload_off", "off");
-    cJSON_AddBoolToObject(config, "retain", true);
-
-    // Add device info
-    cJSON *device = cJSON_CreateObject();
-    cJSON_AddStringToObject(device, "identifiers", device_id);
-    cJSON_AddStringToObject(device, "name", "ReptiControl");
-    cJSON_AddStringToObject(device, "model", "ReptiControl v1.0");
-    cJSON_AddStringToObject(device, "manufacturer", "ReptiControl");
-    cJSON_AddItemToObject(config, "device", device);
-
-    char *message = cJSON_PrintUnformatted(config);
-    esp_mqtt_client_publish(mqtt_client, topic, message, 0, 1, 1);
-
-    free(message);
-    cJSON_Delete(config);
+    // Build discovery message in place
+    int len = snprintf(discovery_payload, sizeof(discovery_payload),
+                       "{\"name\":\"%s\",\"unique_id\":\"%s\",\"state_topic\":\"%s\","
+                       "\"command_topic\":\"%s\",\"payload_on\":\"on\",\"payload_off\":\"off\","
+                       "\"retain\":true," HA_DEVICE_JSON_FMT "}",
+                       name, device_id, state_topic, command_topic, device_id);
+    if (len < 0 || len >= (int)sizeof(discovery_payload)) {
+        ESP_LOGE(TAG, "Discovery payload for %s too long", component);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_mqtt_client_publish(mqtt_client, topic, discovery_payload, len, 1, 1);
 
     return ESP_OK;
 }
@@ -222,15 +232,35 @@ esp_err_t mqtt_manager_publish_sensors(float temperature, float humidity, float
 
     // Publish temperature
     snprintf(data, sizeof(data), "%.1f", temperature);
-    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_TEMP, data, 0, 1, 0);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_TEMP, data, 0, MQTT_QOS_TELEMETRY, 0);
 
     // Publish humidity
     snprintf(data, sizeof(data), "%.1f", humidity);
-    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_HUMIDITY, data, 0, 1, 0);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_HUMIDITY, data, 0, MQTT_QOS_TELEMETRY, 0);
 
     // Publish light
     snprintf(data, sizeof(data), "%.1f", light);
-    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_LIGHT, data, 0, 1, 0);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_LIGHT, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    return ESP_OK;
+}
+
+// Publish the moist-air metrics
+esp_err_t mqtt_manager_publish_climate_metrics(float vpd_kpa, float dew_point_c, float abs_humidity_gm3) {
+    if (!is_connected) {
+        return ESP_FAIL;
+    }
+
+    char data[32];
+
+    snprintf(data, sizeof(data), "%.2f", vpd_kpa);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_VPD, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    snprintf(data, sizeof(data), "%.1f", dew_point_c);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_DEW_POINT, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    snprintf(data, sizeof(data), "%.1f", abs_humidity_gm3);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_ABS_HUMIDITY, data, 0, MQTT_QOS_TELEMETRY, 0);
 
     return ESP_OK;
 }
@@ -245,22 +275,120 @@ esp_err_t mqtt_manager_publish_status(bool heating_on, bool cooling_on,
 
     // Publish individual status
     esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_HEATING,
-                          heating_on ? "on" : "off", 0, 1, 1);
+                          heating_on ? "on" : "off", 0, MQTT_QOS_TELEMETRY, 1);
 
     esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_COOLING,
-                          cooling_on ? "on" : "off", 0, 1, 1);
+                          cooling_on ? "on" : "off", 0, MQTT_QOS_TELEMETRY, 1);
 
     esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_HUMIDIFIER,
-                          humidifier_on ? "on" : "off", 0, 1, 1);
+                          humidifier_on ? "on" : "off", 0, MQTT_QOS_TELEMETRY, 1);
 
     esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_LIGHTING,
-                          lighting_on ? "on" : "off", 0, 1, 1);
+                          lighting_on ? "on" : "off", 0, MQTT_QOS_TELEMETRY, 1);
 
     // Publish battery level
     char battery_str[8];
     snprintf(battery_str, sizeof(battery_str), "%d", battery_level);
     esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_BATTERY,
-                          battery_str, 0, 1, 1);
+                          battery_str, 0, MQTT_QOS_TELEMETRY, 1);
+
+    return ESP_OK;
+}
+
+// Publish the accounting of one actuator
+esp_err_t mqtt_manager_publish_energy(const char* actuator, float duty, uint32_t day_cycles,
+                                    float day_wh, float total_kwh) {
+    if (!is_connected) {
+        return ESP_FAIL;
+    }
+
+    char topic[64];
+    char data[32];
+
+    snprintf(topic, sizeof(topic), "%s/%s/duty", MQTT_TOPIC_ENERGY, actuator);
+    snprintf(data, sizeof(data), "%.0f", duty * 100.0f);
+    esp_mqtt_client_publish(mqtt_client, topic, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    snprintf(topic, sizeof(topic), "%s/%s/cycles_24h", MQTT_TOPIC_ENERGY, actuator);
+    snprintf(data, sizeof(data), "%lu", (unsigned long)day_cycles);
+    esp_mqtt_client_publish(mqtt_client, topic, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    snprintf(topic, sizeof(topic), "%s/%s/energy_24h", MQTT_TOPIC_ENERGY, actuator);
+    snprintf(data, sizeof(data), "%.1f", day_wh);
+    esp_mqtt_client_publish(mqtt_client, topic, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    // Retained so Home Assistant's energy dashboard picks it up on restart
+    snprintf(topic, sizeof(topic), "%s/%s/total", MQTT_TOPIC_ENERGY, actuator);
+    snprintf(data, sizeof(data), "%.3f", total_kwh);
+    esp_mqtt_client_publish(mqtt_client, topic, data, 0, MQTT_QOS_TELEMETRY, 1);
+
+    return ESP_OK;
+}
+
+// Publish the sample-to-decision latency of the control loop
+esp_err_t mqtt_manager_publish_control_latency(float avg_ms, float max_ms, uint32_t fallback_ticks) {
+    if (!is_connected) {
+        return ESP_FAIL;
+    }
+
+    char data[32];
+
+    snprintf(data, sizeof(data), "%.2f", avg_ms);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_DIAGNOSTICS "/control_latency", data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    snprintf(data, sizeof(data), "%.2f", max_ms);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_DIAGNOSTICS "/control_latency_max", data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    snprintf(data, sizeof(data), "%lu", (unsigned long)fallback_ticks);
+    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_DIAGNOSTICS "/control_fallback_ticks", data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    return ESP_OK;
+}
+
+// Publish the lag and noise reduction of a sensor filter
+esp_err_t mqtt_manager_publish_filter(const char* value, float lag_ms, float noise_ratio, uint32_t gated) {
+    if (!is_connected) {
+        return ESP_FAIL;
+    }
+
+    char topic[96];
+    char data[32];
+
+    snprintf(topic, sizeof(topic), "%s/filter_%s_lag", MQTT_TOPIC_DIAGNOSTICS, value);
+    snprintf(data, sizeof(data), "%.0f", lag_ms);
+    esp_mqtt_client_publish(mqtt_client, topic, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    snprintf(topic, sizeof(topic), "%s/filter_%s_noise", MQTT_TOPIC_DIAGNOSTICS, value);
+    snprintf(data, sizeof(data), "%.3f", noise_ratio);
+    esp_mqtt_client_publish(mqtt_client, topic, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    snprintf(topic, sizeof(topic), "%s/filter_%s_gated", MQTT_TOPIC_DIAGNOSTICS, value);
+    snprintf(data, sizeof(data), "%lu", (unsigned long)gated);
+    esp_mqtt_client_publish(mqtt_client, topic, data, 0, MQTT_QOS_TELEMETRY, 0);
+
+    return ESP_OK;
+}
+
+// Publish the statistics of a reading over a window
+esp_err_t mqtt_manager_publish_stats(const char* reading, const char* window, const stream_summary_t *summary) {
+    if (!is_connected) {
+        return ESP_FAIL;
+    }
+    if (summary->count == 0) {
+        return ESP_OK;
+    }
+
+    char topic[96];
+    char data[192];
+
+    snprintf(topic, sizeof(topic), "%s/%s/%s", MQTT_TOPIC_STATS, reading, window);
+    snprintf(data, sizeof(data),
+             "{\"count\":%lu,\"mean\":%.2f,\"stddev\":%.2f,\"min\":%.2f,\"max\":%.2f,"
+             "\"p05\":%.2f,\"p50\":%.2f,\"p95\":%.2f}",
+             (unsigned long)summary->count, summary->mean, summary->stddev, summary->min, summary->max,
+             summary->quantile[STREAM_STATS_P05], summary->quantile[STREAM_STATS_P50],
+             summary->quantile[STREAM_STATS_P95]);
+    esp_mqtt_client_publish(mqtt_client, topic, data, 0, MQTT_QOS_TELEMETRY, 0);
 
     return ESP_OK;
 }
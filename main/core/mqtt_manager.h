@@ -2,12 +2,17 @@
 #define MQTT_MANAGER_H
 
 #include "esp_err.h"
+#include "stream_stats.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 // MQTT Topics
 #define MQTT_TOPIC_TEMP        "repticontrol/sensors/temperature"
 #define MQTT_TOPIC_HUMIDITY    "repticontrol/sensors/humidity"
 #define MQTT_TOPIC_LIGHT       "repticontrol/sensors/light"
+#define MQTT_TOPIC_VPD         "repticontrol/sensors/vpd"
+#define MQTT_TOPIC_DEW_POINT   "repticontrol/sensors/dew_point"
+#define MQTT_TOPIC_ABS_HUMIDITY "repticontrol/sensors/abs_humidity"
 #define MQTT_TOPIC_HEATING     "repticontrol/status/heating"
 #define MQTT_TOPIC_COOLING     "repticontrol/status/cooling"
 #define MQTT_TOPIC_HUMIDIFIER  "repticontrol/status/humidifier"
@@ -16,6 +21,9 @@
 #define MQTT_TOPIC_ALERTS      "repticontrol/alerts"
 #define MQTT_TOPIC_COMMANDS    "repticontrol/commands"
 #define MQTT_TOPIC_STATUS      "repticontrol/status"
+#define MQTT_TOPIC_ENERGY      "repticontrol/energy"
+#define MQTT_TOPIC_DIAGNOSTICS "repticontrol/diagnostics"
+#define MQTT_TOPIC_STATS       "repticontrol/stats"
 
 // Home Assistant discovery prefix
 #define HA_DISCOVERY_PREFIX    "homeassistant"
@@ -33,11 +41,36 @@ esp_err_t mqtt_manager_disconnect(void);
 // Publish sensor data
 esp_err_t mqtt_manager_publish_sensors(float temperature, float humidity, float light);
 
+// Publish the moist-air metrics: VPD (kPa), dew point (°C) and absolute
+// humidity (g/m³)
+esp_err_t mqtt_manager_publish_climate_metrics(float vpd_kpa, float dew_point_c, float abs_humidity_gm3);
+
 // Publish system status
 esp_err_t mqtt_manager_publish_status(bool heating_on, bool cooling_on,
                                     bool humidifier_on, bool lighting_on,
                                     int battery_level);
 
+// Publish the accounting of one actuator under MQTT_TOPIC_ENERGY/<actuator>:
+// duty of the last hour (%), cycles and energy of the last 24 h (Wh), and
+// the total energy (kWh)
+esp_err_t mqtt_manager_publish_energy(const char* actuator, float duty, uint32_t day_cycles,
+                                    float day_wh, float total_kwh);
+
+// Publish the sample-to-decision latency of the control loop under
+// MQTT_TOPIC_DIAGNOSTICS: average and worst (ms), and the number of
+// updates run without a fresh sample
+esp_err_t mqtt_manager_publish_control_latency(float avg_ms, float max_ms, uint32_t fallback_ticks);
+
+// Publish the sensor filter of one value kind under
+// MQTT_TOPIC_DIAGNOSTICS/filter_<value>: its lag (ms), output over input
+// noise, and the samples its Kalman gate rejected
+esp_err_t mqtt_manager_publish_filter(const char* value, float lag_ms, float noise_ratio, uint32_t gated);
+
+// Publish the statistics of a reading over a window as JSON under
+// MQTT_TOPIC_STATS/<reading>/<window>: count, mean, standard deviation,
+// min, max and the 5th, 50th and 95th percentiles. Skipped while empty.
+esp_err_t mqtt_manager_publish_stats(const char* reading, const char* window, const stream_summary_t *summary);
+
 // Publish alert
 esp_err_t mqtt_manager_publish_alert(const char* message, bool is_critical);
 
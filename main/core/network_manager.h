@@ -8,6 +8,7 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 // Wi-Fi modes specific to ReptiControl to avoid conflicts with esp_wifi.h
 typedef enum {
@@ -0,0 +1,79 @@
+#include "network_manager.h"
+#include "esp_log.h"
+#include "event_logger.h"
+#include "nvs.h"
+#include <string.h>
+
+// Radio-less network manager for headless and QEMU builds. Keeps the
+// network_manager.h contract so the application runs unchanged.
+
+static const char *TAG = "network_manager";
+
+static bool wifi_started = false;
+
+// Initialize network manager
+esp_err_t network_manager_init(void) {
+    ESP_LOGI(TAG, "Initializing network manager (no radio)");
+    event_logger_add("Network manager initialized (no radio)", false);
+    return ESP_OK;
+}
+
+// Configure and start Wi-Fi
+esp_err_t network_manager_wifi_start(rc_wifi_config_t *config) {
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    wifi_started = true;
+    ESP_LOGI(TAG, "Wi-Fi start ignored (no radio), SSID %s", config->ssid);
+    return ESP_OK;
+}
+
+// Stop Wi-Fi
+esp_err_t network_manager_wifi_stop(void) {
+    wifi_started = false;
+    return ESP_OK;
+}
+
+// Never connected without a radio
+bool network_manager_wifi_is_connected(void) {
+    return false;
+}
+
+// Start BLE services
+esp_err_t network_manager_ble_start(void) {
+    return ESP_OK;
+}
+
+// Stop BLE services
+esp_err_t network_manager_ble_stop(void) {
+    return ESP_OK;
+}
+
+// Update BLE sensor values
+esp_err_t network_manager_ble_update_sensors(float temperature, float humidity, float light) {
+    return ESP_OK;
+}
+
+// Load Wi-Fi credentials from NVS (same storage as the radio build)
+bool network_manager_load_wifi_credentials(char *ssid, size_t ssid_len,
+                                           char *password, size_t pass_len,
+                                           rc_wifi_mode_t *mode) {
+    nvs_handle_t h;
+    if (nvs_open("settings", NVS_READONLY, &h) != ESP_OK) {
+        return false;
+    }
+    size_t s_len = ssid_len;
+    size_t p_len = pass_len;
+    if (nvs_get_str(h, "wifi_ssid", ssid, &s_len) != ESP_OK ||
+        nvs_get_str(h, "wifi_password", password, &p_len) != ESP_OK) {
+        nvs_close(h);
+        return false;
+    }
+    int32_t mode_val;
+    if (nvs_get_i32(h, "wifi_mode", &mode_val) != ESP_OK) {
+        mode_val = RC_WIFI_MODE_STA;
+    }
+    if (mode) *mode = (rc_wifi_mode_t)mode_val;
+    nvs_close(h);
+    return true;
+}
@@ -20,10 +20,14 @@ static ota_progress_cb_t progress_callback = NULL;
 static esp_ota_handle_t update_handle = 0;
 static const esp_partition_t *update_partition = NULL;
 
+// Version check response, reused for every check
+static char version_buffer[OTA_BUFFER_SIZE];
+
 // Forward declarations
 static void http_cleanup(esp_http_client_handle_t client);
 static esp_err_t validate_image_header(esp_app_desc_t *new_app_info);
 static void set_error(const char* message);
+static bool parse_version_field(const char *json, char *out, size_t out_len);
 
 // Initialize OTA manager
 esp_err_t ota_manager_init(void) {
@@ -81,22 +85,19 @@ esp_err_t ota_manager_check_update(const char* current_version) {
         return ESP_FAIL;
     }
 
-    // Parse response
-    char *buffer = malloc(OTA_BUFFER_SIZE);
-    int read_len = esp_http_client_read(client, buffer, OTA_BUFFER_SIZE);
+    // Parse response (leave room for the terminator)
+    int read_len = esp_http_client_read(client, version_buffer, OTA_BUFFER_SIZE - 1);
     if (read_len <= 0) {
         set_error("Failed to read version info");
         current_state = OTA_STATE_ERROR;
-        free(buffer);
         http_cleanup(client);
         return ESP_FAIL;
     }
 
-    buffer[read_len] = 0;
-    cJSON *root = cJSON_Parse(buffer);
-    free(buffer);
+    version_buffer[read_len] = 0;
+    static char latest_version[32];
 
-    if (!root) {
+    if (!parse_version_field(version_buffer, latest_version, sizeof(latest_version))) {
         set_error("Failed to parse version info");
         current_state = OTA_STATE_ERROR;
         http_cleanup(client);
@@ -104,10 +105,8 @@ esp_err_t ota_manager_check_update(const char* current_version) {
     }
 
     // Compare versions
-    const char *latest_version = cJSON_GetObjectItem(root, "version")->valuestring;
     bool update_available = strcmp(latest_version, current_version) > 0;
 
-    cJSON_Delete(root);
     http_cleanup(client);
 
     current_state = update_available ? OTA_STATE_READY : OTA_STATE_IDLE;
@@ -287,6 +286,37 @@ static void http_cleanup(esp_http_client_handle_t client) {
     esp_http_client_cleanup(client);
 }
 
+// Helper function to extract "version" from the version.json response in
+// place, without building a JSON tree
+static bool parse_version_field(const char *json, char *out, size_t out_len) {
+    const char *p = strstr(json, "\"version\"");
+    if (!p) {
+        return false;
+    }
+    p += strlen("\"version\"");
+
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    if (*p++ != ':') {
+        return false;
+    }
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    if (*p++ != '"') {
+        return false;
+    }
+
+    size_t len = 0;
+    while (p[len] && p[len] != '"') {
+        len++;
+    }
+    if (p[len] != '"' || len == 0 || len >= out_len) {
+        return false;
+    }
+
+    memcpy(out, p, len);
+    out[len] = '\0';
+    return true;
+}
+
 // Helper function to validate firmware header
 static esp_err_t validate_image_header(esp_app_desc_t *new_app_info) {
     if (!new_app_info) {
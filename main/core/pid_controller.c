@@ -0,0 +1,182 @@
+#include "pid_controller.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Default derivative filter: newest sample weighs 20%
+#define PID_DEFAULT_D_FILTER 0.2f
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Initialize a PID loop
+void pid_init(pid_controller_t *pid, float kp, float ki, float kd, float out_min, float out_max) {
+    memset(pid, 0, sizeof(*pid));
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+    pid->d_filter = PID_DEFAULT_D_FILTER;
+}
+
+// Change gains; the integral is stored pre-scaled by ki, so the output
+// doesn't jump
+void pid_set_gains(pid_controller_t *pid, float kp, float ki, float kd) {
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+}
+
+// Clear the integral and derivative state
+void pid_reset(pid_controller_t *pid) {
+    pid->integral = 0.0f;
+    pid->derivative = 0.0f;
+    pid->initialized = false;
+}
+
+// Run one step
+float pid_update(pid_controller_t *pid, float setpoint, float measurement, float dt) {
+    float error = setpoint - measurement;
+
+    if (!pid->initialized) {
+        pid->prev_measurement = measurement;
+        pid->initialized = true;
+    }
+
+    // Derivative on measurement avoids a kick on setpoint changes
+    float d_raw = dt > 0.0f ? -pid->kd * (measurement - pid->prev_measurement) / dt : 0.0f;
+    pid->derivative += pid->d_filter * (d_raw - pid->derivative);
+    pid->prev_measurement = measurement;
+
+    float p = pid->kp * error;
+    float candidate = pid->integral + pid->ki * error * dt;
+    float unsat = p + candidate + pid->derivative;
+
+    // Clamping anti-windup: only integrate if that doesn't push further
+    // into saturation
+    if ((unsat > pid->out_max && error > 0.0f) || (unsat < pid->out_min && error < 0.0f)) {
+        unsat = p + pid->integral + pid->derivative;
+    } else {
+        pid->integral = candidate;
+    }
+
+    // Keep the integral alone within the output range
+    pid->integral = clampf(pid->integral, pid->out_min, pid->out_max);
+
+    return clampf(unsat, pid->out_min, pid->out_max);
+}
+
+// Initialize a time-proportioning output
+void pid_tpo_init(pid_tpo_t *tpo, uint32_t window_ticks, uint32_t min_ticks) {
+    tpo->window_ticks = window_ticks ? window_ticks : 1;
+    tpo->min_ticks = min_ticks;
+    tpo->tick = 0;
+    tpo->on_ticks = 0;
+}
+
+// Advance one tick with the current duty
+bool pid_tpo_update(pid_tpo_t *tpo, float duty) {
+    if (tpo->tick == 0) {
+        uint32_t on = (uint32_t)lroundf(clampf(duty, 0.0f, 1.0f) * tpo->window_ticks);
+
+        // Avoid relay pulses shorter than the minimum on or off time
+        if (on < tpo->min_ticks) {
+            on = 0;
+        } else if (tpo->window_ticks - on < tpo->min_ticks) {
+            on = tpo->window_ticks;
+        }
+        tpo->on_ticks = on;
+    }
+
+    bool relay_on = tpo->tick < tpo->on_ticks;
+    tpo->tick = (tpo->tick + 1) % tpo->window_ticks;
+    return relay_on;
+}
+
+// Start a relay auto-tune
+void pid_autotune_start(pid_autotune_t *at, float setpoint, float hysteresis,
+                        float out_low, float out_high, float max_time) {
+    memset(at, 0, sizeof(*at));
+    at->state = PID_AUTOTUNE_RUNNING;
+    at->setpoint = setpoint;
+    at->hysteresis = hysteresis;
+    at->out_low = out_low;
+    at->out_high = out_high;
+    at->max_time = max_time;
+    at->last_rise = -1.0f;
+    at->relay_high = true;
+    at->cycle_max = -INFINITY;
+    at->cycle_min = INFINITY;
+}
+
+// Advance the auto-tune
+float pid_autotune_update(pid_autotune_t *at, float measurement, float dt) {
+    if (at->state != PID_AUTOTUNE_RUNNING) {
+        return at->out_low;
+    }
+
+    at->elapsed += dt;
+    if (at->elapsed > at->max_time) {
+        at->state = PID_AUTOTUNE_FAILED;
+        return at->out_low;
+    }
+
+    if (measurement > at->cycle_max) at->cycle_max = measurement;
+    if (measurement < at->cycle_min) at->cycle_min = measurement;
+
+    if (at->relay_high && measurement > at->setpoint + at->hysteresis) {
+        at->relay_high = false;
+    } else if (!at->relay_high && measurement < at->setpoint - at->hysteresis) {
+        // A low->high switch closes one oscillation
+        at->relay_high = true;
+
+        if (at->last_rise >= 0.0f) {
+            at->cycles++;
+            // The first oscillation still carries the start transient
+            if (at->cycles > 1) {
+                at->amplitude_sum += (at->cycle_max - at->cycle_min) / 2.0f;
+                at->period_sum += at->elapsed - at->last_rise;
+            }
+        }
+        at->last_rise = at->elapsed;
+        at->cycle_max = -INFINITY;
+        at->cycle_min = INFINITY;
+
+        if (at->cycles > PID_AUTOTUNE_CYCLES) {
+            float a = at->amplitude_sum / PID_AUTOTUNE_CYCLES;
+            float d = (at->out_high - at->out_low) / 2.0f;
+            float e = at->hysteresis;
+
+            at->tu = at->period_sum / PID_AUTOTUNE_CYCLES;
+            // Describing function of a relay with hysteresis
+            float denom = a > e ? sqrtf(a * a - e * e) : a;
+            at->ku = denom > 0.0f ? 4.0f * d / ((float)M_PI * denom) : 0.0f;
+            at->state = (at->ku > 0.0f && at->tu > 0.0f) ? PID_AUTOTUNE_DONE : PID_AUTOTUNE_FAILED;
+            return at->out_low;
+        }
+    }
+
+    return at->relay_high ? at->out_high : at->out_low;
+}
+
+// Tyreus–Luyben tuning: less overshoot than Ziegler–Nichols on slow
+// thermal and humidity plants
+bool pid_autotune_get_gains(const pid_autotune_t *at, float *kp, float *ki, float *kd) {
+    if (at->state != PID_AUTOTUNE_DONE) {
+        return false;
+    }
+
+    float p = at->ku / 2.2f;
+    float ti = 2.2f * at->tu;
+    float td = at->tu / 6.3f;
+
+    *kp = p;
+    *ki = p / ti;
+    *kd = p * td;
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef PID_CONTROLLER_H
+#define PID_CONTROLLER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// PID loop with derivative on measurement and clamping anti-windup
+typedef struct {
+    float kp;
+    float ki;
+    float kd;
+    float out_min;
+    float out_max;
+    float integral;         // Integral term, already scaled by ki
+    float prev_measurement;
+    float derivative;       // Filtered derivative term
+    float d_filter;         // 0..1, weight of the newest derivative sample
+    bool initialized;
+} pid_controller_t;
+
+// Time-proportioning output: turns a 0..1 duty into relay on/off within a
+// fixed window, latching the duty at the start of each window
+typedef struct {
+    uint32_t window_ticks;
+    uint32_t min_ticks;     // Shortest on or off period
+    uint32_t tick;
+    uint32_t on_ticks;
+} pid_tpo_t;
+
+// Relay auto-tune state
+typedef enum {
+    PID_AUTOTUNE_IDLE,
+    PID_AUTOTUNE_RUNNING,
+    PID_AUTOTUNE_DONE,
+    PID_AUTOTUNE_FAILED
+} pid_autotune_state_t;
+
+// Number of oscillations averaged by the auto-tune (after the first)
+#define PID_AUTOTUNE_CYCLES 4
+
+// Åström–Hägglund relay auto-tune
+typedef struct {
+    pid_autotune_state_t state;
+    float setpoint;
+    float hysteresis;
+    float out_low;
+    float out_high;
+    bool relay_high;
+    float elapsed;              // Seconds since start
+    float max_time;             // Give up after this many seconds
+    float last_rise;            // Time of the last low->high switch, < 0 if none
+    float cycle_max;
+    float cycle_min;
+    int cycles;                 // Completed oscillations
+    float amplitude_sum;
+    float period_sum;
+    float ku;                   // Ultimate gain
+    float tu;                   // Ultimate period (s)
+} pid_autotune_t;
+
+// Initialize a PID loop
+void pid_init(pid_controller_t *pid, float kp, float ki, float kd, float out_min, float out_max);
+
+// Change gains without a bump in the output
+void pid_set_gains(pid_controller_t *pid, float kp, float ki, float kd);
+
+// Clear the integral and derivative state
+void pid_reset(pid_controller_t *pid);
+
+// Run one step and return the output, clamped to [out_min, out_max]
+float pid_update(pid_controller_t *pid, float setpoint, float measurement, float dt);
+
+// Initialize a time-proportioning output
+void pid_tpo_init(pid_tpo_t *tpo, uint32_t window_ticks, uint32_t min_ticks);
+
+// Advance one tick with the current duty (0..1); returns the relay state
+bool pid_tpo_update(pid_tpo_t *tpo, float duty);
+
+// Start a relay auto-tune around setpoint. The relay switches between
+// out_low and out_high when the measurement leaves setpoint ± hysteresis.
+void pid_autotune_start(pid_autotune_t *at, float setpoint, float hysteresis,
+                        float out_low, float out_high, float max_time);
+
+// Advance the auto-tune and return the relay output to apply
+float pid_autotune_update(pid_autotune_t *at, float measurement, float dt);
+
+// Get Tyreus–Luyben PID gains from a finished auto-tune
+bool pid_autotune_get_gains(const pid_autotune_t *at, float *kp, float *ki, float *kd);
+
+#endif /* PID_CONTROLLER_H */
@@ -0,0 +1,52 @@
+#include "power_manager.h"
+#include "esp_log.h"
+#include "event_logger.h"
+
+// Power manager for headless and QEMU builds: no ADC, GPIO or PM locks.
+// Reports a full battery on external power.
+
+static const char *TAG = "power_manager";
+
+static power_mode_t current_mode = POWER_MODE_NORMAL;
+
+// Initialize power management
+esp_err_t power_manager_init(void) {
+    ESP_LOGI(TAG, "Initializing power management (stub)");
+    event_logger_add("Power management initialized", false);
+    return ESP_OK;
+}
+
+// Get battery level
+int power_manager_get_battery_level(void) {
+    return 100;
+}
+
+// Get battery state
+battery_state_t power_manager_get_battery_state(void) {
+    return BATTERY_STATE_FULL;
+}
+
+// Get battery voltage
+uint32_t power_manager_get_battery_voltage(void) {
+    return 4200;
+}
+
+// Check charging status
+bool power_manager_is_charging(void) {
+    return false;
+}
+
+// Set power mode
+esp_err_t power_manager_set_mode(power_mode_t mode) {
+    current_mode = mode;
+    return ESP_OK;
+}
+
+// Light sleep is not available
+esp_err_t power_manager_light_sleep(uint32_t sleep_ms) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// Update power management status
+void power_manager_update(void) {
+}
@@ -0,0 +1,348 @@
+#include "probe_manager.h"
+#include "climate_controller.h"
+#include "event_logger.h"
+#include "settings_manager.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <math.h>
+
+static const char *TAG = "probe_manager";
+
+#define PROBE_HOLD_US ((int64_t)PROBE_HOLD_MS * 1000)
+#define PROBE_NEVER INT64_MIN
+
+// Probes a zone's own climate depends on
+#define PROBE_ENCLOSURE (PROBE_ALL & ~PROBE_BIT(PROBE_AMBIENT))
+
+// Configuration per zone
+static uint8_t fitted[CLIMATE_MAX_ZONES];
+static uint8_t fusion[CLIMATE_MAX_ZONES];
+static float weight[PROBE_COUNT][CLIMATE_MAX_ZONES];
+static float gradient[CLIMATE_MAX_ZONES];
+static bool loaded[CLIMATE_MAX_ZONES];
+
+// Readings per zone, written by the sensor task
+static float value[PROBE_COUNT][CLIMATE_MAX_ZONES];
+static int64_t seen[PROBE_COUNT][CLIMATE_MAX_ZONES];    // Last good reading
+static int64_t last_report[CLIMATE_MAX_ZONES];
+static uint8_t ok[CLIMATE_MAX_ZONES];
+static uint8_t faulted[CLIMATE_MAX_ZONES];          // Fitted, not ok; logged
+
+// Fusion result per zone, read by the control tick
+static float heat_temp[CLIMATE_MAX_ZONES];
+static float cool_temp[CLIMATE_MAX_ZONES];
+static bool fused[CLIMATE_MAX_ZONES];
+static portMUX_TYPE probe_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const probe_names[PROBE_COUNT] = {
+    "Basking", "Cool side", "Substrate", "Ambient"
+};
+static const char *const fusion_names[PROBE_FUSION_COUNT] = {
+    "Weighted", "Minimum", "Maximum", "Gradient"
+};
+
+// Default weights: enclosure probes equally, ambient not at all
+static const float default_weight[PROBE_COUNT] = { 1.0f, 1.0f, 1.0f, 0.0f };
+
+// Settings keys of the weights
+static const char *const weight_keys[PROBE_COUNT] = {
+    SETTINGS_KEY_BASKING_WEIGHT, SETTINGS_KEY_COOL_SIDE_WEIGHT,
+    SETTINGS_KEY_SUBSTRATE_WEIGHT, SETTINGS_KEY_AMBIENT_WEIGHT
+};
+
+// Check a zone index from the public API
+static bool valid_zone(int zone) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        ESP_LOGW(TAG, "Invalid zone %d", zone);
+        return false;
+    }
+    return true;
+}
+
+// Load a zone's saved configuration the first time it is used
+static void load_zone(int zone) {
+    char key[SETTINGS_KEY_MAX_LEN];
+    int stored;
+
+    if (loaded[zone]) {
+        return;
+    }
+    loaded[zone] = true;
+
+    stored = settings_get_int(settings_zone_key(key, SETTINGS_KEY_PROBE_FUSION, zone), PROBE_FUSION_WEIGHTED);
+    fusion[zone] = (stored >= 0 && stored < PROBE_FUSION_COUNT) ? stored : PROBE_FUSION_WEIGHTED;
+    fitted[zone] = settings_get_int(settings_zone_key(key, SETTINGS_KEY_PROBE_FITTED, zone), PROBE_ALL) & PROBE_ALL;
+    gradient[zone] = settings_get_float(settings_zone_key(key, SETTINGS_KEY_PROBE_GRADIENT, zone),
+                                        PROBE_DEFAULT_GRADIENT_C);
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        float w = settings_get_float(settings_zone_key(key, weight_keys[p], zone), default_weight[p]);
+        weight[p][zone] = w >= 0.0f ? w : default_weight[p];
+    }
+}
+
+// Weighted mean of the usable probes in mask; NAN if they weigh nothing
+static float weighted_mean(int zone, uint8_t mask) {
+    float sum = 0.0f;
+    float total = 0.0f;
+
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        if (mask & PROBE_BIT(p)) {
+            sum += weight[p][zone] * value[p][zone];
+            total += weight[p][zone];
+        }
+    }
+    return total > 0.0f ? sum / total : NAN;
+}
+
+// Coldest (sign 1) or hottest (sign -1) usable probe in mask
+static float extreme(int zone, uint8_t mask, float sign) {
+    float result = NAN;
+
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        if ((mask & PROBE_BIT(p)) && (isnan(result) || sign * value[p][zone] < sign * result)) {
+            result = value[p][zone];
+        }
+    }
+    return result;
+}
+
+// Fuse a zone's usable probes into the temperatures heating and cooling
+// act on. Called with probe_lock held; a missing gradient probe falls back
+// to the weighted mean, and no usable probe at all to the zone sensor.
+static void fuse_zone(int zone) {
+    uint8_t usable = ok[zone] & fitted[zone];
+    uint8_t enclosure = usable & PROBE_ENCLOSURE;
+    float mean = weighted_mean(zone, usable);
+    float heat = mean;
+    float cool = mean;
+
+    if (isnan(mean)) {
+        // Nothing weighted left: any enclosure probe beats none
+        heat = cool = extreme(zone, enclosure, 1.0f);
+    }
+
+    switch (fusion[zone]) {
+        case PROBE_FUSION_MIN:
+            if (enclosure) {
+                heat = cool = extreme(zone, enclosure, 1.0f);
+            }
+            break;
+        case PROBE_FUSION_MAX:
+            if (enclosure) {
+                heat = cool = extreme(zone, enclosure, -1.0f);
+            }
+            break;
+        case PROBE_FUSION_GRADIENT:
+            if (usable & PROBE_BIT(PROBE_BASKING)) {
+                heat = value[PROBE_BASKING][zone];
+            }
+            if (usable & PROBE_BIT(PROBE_COOL_SIDE)) {
+                cool = value[PROBE_COOL_SIDE][zone] + gradient[zone];
+            }
+            break;
+        default:
+            break;
+    }
+
+    fused[zone] = !isnan(heat) && !isnan(cool);
+    heat_temp[zone] = heat;
+    cool_temp[zone] = cool;
+}
+
+// Initialize every zone to its defaults
+void probe_manager_init(void) {
+    ESP_LOGI(TAG, "Initializing probe manager");
+
+    for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+        fitted[z] = PROBE_ALL;
+        fusion[z] = PROBE_FUSION_WEIGHTED;
+        gradient[z] = PROBE_DEFAULT_GRADIENT_C;
+        loaded[z] = false;
+        for (int p = 0; p < PROBE_COUNT; p++) {
+            weight[p][z] = default_weight[p];
+            value[p][z] = 0.0f;
+            seen[p][z] = PROBE_NEVER;
+        }
+        last_report[z] = PROBE_NEVER;
+        ok[z] = 0;
+        faulted[z] = 0;
+        fused[z] = false;
+    }
+}
+
+// Report the readings of a zone's probes and fuse them
+void probe_manager_report(int zone, const float *values, int64_t now_us) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+    load_zone(zone);
+
+    uint8_t now_ok = 0;
+
+    portENTER_CRITICAL(&probe_lock);
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        if (!(fitted[zone] & PROBE_BIT(p))) {
+            continue;
+        }
+        float v = values[p];
+        if (!isnan(v) && v >= PROBE_MIN_C && v <= PROBE_MAX_C) {
+            value[p][zone] = v;
+            seen[p][zone] = now_us;
+        }
+        if (seen[p][zone] != PROBE_NEVER && now_us - seen[p][zone] <= PROBE_HOLD_US) {
+            now_ok |= PROBE_BIT(p);
+        }
+    }
+    ok[zone] = now_ok;
+    last_report[zone] = now_us;
+    fuse_zone(zone);
+    portEXIT_CRITICAL(&probe_lock);
+
+    // Log faults and recoveries outside the lock; a fitted probe that never
+    // reads counts as faulted from the first report
+    uint8_t now_faulted = fitted[zone] & ~now_ok;
+    uint8_t lost = now_faulted & ~faulted[zone];
+    uint8_t back = faulted[zone] & now_ok;
+    faulted[zone] = now_faulted;
+    if (!(lost | back)) {
+        return;
+    }
+
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        if (lost & PROBE_BIT(p)) {
+            ESP_LOGW(TAG, "Zone %d %s probe fault", zone + 1, probe_names[p]);
+            event_logger_add_zone_fmt(zone, "%s probe fault, control falls back", true, probe_names[p]);
+        } else if (back & PROBE_BIT(p)) {
+            event_logger_add_zone_fmt(zone, "%s probe restored", false, probe_names[p]);
+        }
+    }
+}
+
+// Get the fused temperatures of a zone
+bool probe_manager_get_control_temps(int zone, float *heat, float *cool) {
+    bool result;
+
+    // Called every tick: no warning, the caller keeps its zone sensor
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&probe_lock);
+    result = fused[zone];
+    if (result) {
+        *heat = heat_temp[zone];
+        *cool = cool_temp[zone];
+    }
+    portEXIT_CRITICAL(&probe_lock);
+    return result;
+}
+
+// Get a snapshot of a zone's probes
+void probe_manager_get_readings(int zone, probe_readings_t *readings) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+
+    portENTER_CRITICAL(&probe_lock);
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        readings->value[p] = value[p][zone];
+    }
+    readings->fitted = fitted[zone];
+    readings->ok = ok[zone] & fitted[zone];
+    readings->fusion = fusion[zone];
+    readings->fused = fused[zone];
+    readings->heat_temp = heat_temp[zone];
+    readings->cool_temp = cool_temp[zone];
+    portEXIT_CRITICAL(&probe_lock);
+
+    uint8_t ends = PROBE_BIT(PROBE_BASKING) | PROBE_BIT(PROBE_COOL_SIDE);
+    readings->spread = (readings->ok & ends) == ends ?
+                       readings->value[PROBE_BASKING] - readings->value[PROBE_COOL_SIDE] : 0.0f;
+}
+
+// Re-fuse a zone after a configuration change, so the control tick sees it
+// before the next report
+static void refuse_zone(int zone) {
+    portENTER_CRITICAL(&probe_lock);
+    if (last_report[zone] != PROBE_NEVER) {
+        fuse_zone(zone);
+    }
+    portEXIT_CRITICAL(&probe_lock);
+}
+
+// Set how a zone's probes are fused
+void probe_manager_set_fusion(int zone, probe_fusion_t mode) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone) || mode < 0 || mode >= PROBE_FUSION_COUNT) {
+        return;
+    }
+    load_zone(zone);
+    fusion[zone] = mode;
+    refuse_zone(zone);
+    settings_set_int(settings_zone_key(key, SETTINGS_KEY_PROBE_FUSION, zone), mode);
+    settings_save();
+    ESP_LOGI(TAG, "Zone %d probe fusion set to %s", zone + 1, fusion_names[mode]);
+}
+
+// Get how a zone's probes are fused
+probe_fusion_t probe_manager_get_fusion(int zone) {
+    if (!valid_zone(zone)) {
+        return PROBE_FUSION_WEIGHTED;
+    }
+    load_zone(zone);
+    return fusion[zone];
+}
+
+// Set the probes installed in a zone (PROBE_BIT() mask)
+void probe_manager_set_fitted(int zone, uint8_t mask) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone)) {
+        return;
+    }
+    load_zone(zone);
+    fitted[zone] = mask & PROBE_ALL;
+    faulted[zone] &= fitted[zone];
+    refuse_zone(zone);
+    settings_set_int(settings_zone_key(key, SETTINGS_KEY_PROBE_FITTED, zone), fitted[zone]);
+    settings_save();
+}
+
+// Set the weight of a probe in the weighted mean of a zone
+void probe_manager_set_weight(int zone, probe_t probe, float w) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone) || probe < 0 || probe >= PROBE_COUNT || w < 0.0f) {
+        return;
+    }
+    load_zone(zone);
+    weight[probe][zone] = w;
+    refuse_zone(zone);
+    settings_set_float(settings_zone_key(key, weight_keys[probe], zone), w);
+    settings_save();
+}
+
+// Set the hot-to-cool gradient of a zone in gradient fusion
+void probe_manager_set_gradient(int zone, float gradient_c) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    if (!valid_zone(zone) || gradient_c < 0.0f) {
+        return;
+    }
+    load_zone(zone);
+    gradient[zone] = gradient_c;
+    refuse_zone(zone);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_PROBE_GRADIENT, zone), gradient_c);
+    settings_save();
+}
+
+// Get the display name of a probe
+const char *probe_manager_get_name(probe_t probe) {
+    return (probe >= 0 && probe < PROBE_COUNT) ? probe_names[probe] : "Unknown";
+}
+
+// Get the display name of a fusion mode
+const char *probe_manager_get_fusion_name(probe_fusion_t mode) {
+    return (mode >= 0 && mode < PROBE_FUSION_COUNT) ? fusion_names[mode] : "Unknown";
+}
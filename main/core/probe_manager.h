@@ -0,0 +1,82 @@
+#ifndef PROBE_MANAGER_H
+#define PROBE_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Temperature probes of a zone. Readings are fused when a zone's samples
+// come in; the control tick only reads the cached result.
+typedef enum {
+    PROBE_BASKING,              // Under the basking lamp
+    PROBE_COOL_SIDE,            // Far end of the enclosure
+    PROBE_SUBSTRATE,            // In or on the substrate
+    PROBE_AMBIENT,              // Room air outside the enclosure
+    PROBE_COUNT
+} probe_t;
+
+#define PROBE_BIT(probe) (1 << (probe))
+#define PROBE_ALL ((1 << PROBE_COUNT) - 1)
+
+// How a zone's probes become the temperatures heating and cooling act on.
+// The ambient probe is shown but only counts where its weight is set.
+typedef enum {
+    PROBE_FUSION_WEIGHTED,      // Weighted mean of the enclosure probes
+    PROBE_FUSION_MIN,           // Coldest enclosure probe
+    PROBE_FUSION_MAX,           // Hottest enclosure probe
+    PROBE_FUSION_GRADIENT,      // Heating on the basking probe, cooling on the
+                                // cool side plus the gradient
+    PROBE_FUSION_COUNT
+} probe_fusion_t;
+
+// Plausible probe range; anything outside (or NaN) is a read fault
+#define PROBE_MIN_C -20.0f
+#define PROBE_MAX_C 80.0f
+
+// A faulted probe keeps its last good value this long before it is dropped
+#ifndef PROBE_HOLD_MS
+#define PROBE_HOLD_MS 5000
+#endif
+
+// Default hot-to-cool gradient of PROBE_FUSION_GRADIENT
+#ifndef PROBE_DEFAULT_GRADIENT_C
+#define PROBE_DEFAULT_GRADIENT_C 6.0f
+#endif
+
+// Latest state of a zone's probes
+typedef struct {
+    float value[PROBE_COUNT];   // Last good reading of each probe
+    uint8_t fitted;             // PROBE_BIT() of the probes installed
+    uint8_t ok;                 // Fitted probes with a fresh or held reading
+    probe_fusion_t fusion;
+    bool fused;                 // false: no usable probe, heat/cool_temp unset
+    float heat_temp;            // Fused temperature heating acts on
+    float cool_temp;            // Fused temperature cooling acts on
+    float spread;               // Basking minus cool side, 0 without both
+} probe_readings_t;
+
+// Initialize every zone to its defaults (all probes fitted, weighted fusion)
+void probe_manager_init(void);
+
+// Report the readings of a zone's probes (PROBE_COUNT values, NaN for a
+// failed read) and fuse them; called from the sensor task
+void probe_manager_report(int zone, const float *values, int64_t now_us);
+
+// Get the fused temperatures of a zone; returns false (leaving both
+// untouched) when the zone has no usable probe
+bool probe_manager_get_control_temps(int zone, float *heat_temp, float *cool_temp);
+
+// Get a snapshot of a zone's probes
+void probe_manager_get_readings(int zone, probe_readings_t *readings);
+
+// Configuration of a zone; fusion, fitted probes and gradient are saved
+void probe_manager_set_fusion(int zone, probe_fusion_t fusion);
+probe_fusion_t probe_manager_get_fusion(int zone);
+void probe_manager_set_fitted(int zone, uint8_t fitted);
+void probe_manager_set_weight(int zone, probe_t probe, float weight);
+void probe_manager_set_gradient(int zone, float gradient_c);
+
+// Display names
+const char *probe_manager_get_name(probe_t probe);
+const char *probe_manager_get_fusion_name(probe_fusion_t fusion);
+
+#endif /* PROBE_MANAGER_H */
@@ -0,0 +1,383 @@
+#include "profile_manager.h"
+#include "climate_controller.h"
+#include "event_logger.h"
+#include "settings_manager.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "profile_manager";
+
+#define DAY_S (24 * 60 * 60)
+#define DEG (3.14159265f / 180.0f)
+
+// Phases of a zone's day
+#define PHASE_NIGHT 0
+#define PHASE_SUNRISE 1
+#define PHASE_DAY 2
+#define PHASE_SUNSET 3
+#define PHASE_UNKNOWN 0xFF
+
+// Location sunrise and sunset are computed for
+static float latitude;
+static float longitude;
+
+// Profiles per zone, loaded from settings on first use
+static profile_t profiles[CLIMATE_MAX_ZONES];
+static bool loaded[CLIMATE_MAX_ZONES];
+
+// Current local day, shared by all zones
+static time_t midnight;
+static time_t next_midnight;
+static int day_of_year;
+static int32_t sunrise_s;
+static int32_t sunset_s;
+static int32_t noon_s;
+
+// Breakpoints of each zone's day, computed on its first tick of the day
+static profile_day_t days[CLIMATE_MAX_ZONES];
+static bool day_valid[CLIMATE_MAX_ZONES];
+static bool brumating[CLIMATE_MAX_ZONES];
+
+// Targets last handed to the controller, and the phase they came from
+static float applied_temp[CLIMATE_MAX_ZONES];
+static float applied_humidity[CLIMATE_MAX_ZONES];
+static float applied_light[CLIMATE_MAX_ZONES];
+static uint8_t phase[CLIMATE_MAX_ZONES];
+
+static profile_stats_t stats;
+
+static const char *const phase_names[] = { "night", "sunrise", "day", "sunset" };
+
+// Check a zone index from the public API
+static bool valid_zone(int zone) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        ESP_LOGW(TAG, "Invalid zone %d", zone);
+        return false;
+    }
+    return true;
+}
+
+// Load the profile of a zone
+static void load_zone(int zone) {
+    char key[SETTINGS_KEY_MAX_LEN];
+    profile_t *p = &profiles[zone];
+
+    loaded[zone] = true;
+    p->enabled = settings_get_bool(settings_zone_key(key, SETTINGS_KEY_PROFILE_ENABLED, zone), false);
+    p->day_temp = settings_get_float(settings_zone_key(key, SETTINGS_KEY_DAY_TEMP, zone), PROFILE_DEFAULT_DAY_TEMP);
+    p->night_temp = settings_get_float(settings_zone_key(key, SETTINGS_KEY_NIGHT_TEMP, zone),
+                                       PROFILE_DEFAULT_NIGHT_TEMP);
+    p->day_humidity = settings_get_float(settings_zone_key(key, SETTINGS_KEY_DAY_HUMIDITY, zone),
+                                         PROFILE_DEFAULT_DAY_HUMIDITY);
+    p->night_humidity = settings_get_float(settings_zone_key(key, SETTINGS_KEY_NIGHT_HUMIDITY, zone),
+                                           PROFILE_DEFAULT_NIGHT_HUMIDITY);
+    p->day_light = settings_get_float(settings_zone_key(key, SETTINGS_KEY_DAY_LIGHT, zone), PROFILE_DEFAULT_DAY_LIGHT);
+    p->ramp_min = settings_get_int(settings_zone_key(key, SETTINGS_KEY_RAMP_MIN, zone), PROFILE_DEFAULT_RAMP_MIN);
+    p->photoperiod_h = settings_get_int(settings_zone_key(key, SETTINGS_KEY_PHOTOPERIOD, zone), 0);
+    p->brumation_start = settings_get_int(settings_zone_key(key, SETTINGS_KEY_BRUMATION_START, zone), 1);
+    p->brumation_days = settings_get_int(settings_zone_key(key, SETTINGS_KEY_BRUMATION_DAYS, zone), 0);
+    p->brumation_drop_c = settings_get_float(settings_zone_key(key, SETTINGS_KEY_BRUMATION_DROP, zone),
+                                             PROFILE_DEFAULT_BRUMATION_DROP_C);
+}
+
+// Save the profile of a zone
+static void save_zone(int zone) {
+    char key[SETTINGS_KEY_MAX_LEN];
+    const profile_t *p = &profiles[zone];
+
+    settings_set_bool(settings_zone_key(key, SETTINGS_KEY_PROFILE_ENABLED, zone), p->enabled);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_DAY_TEMP, zone), p->day_temp);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_NIGHT_TEMP, zone), p->night_temp);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_DAY_HUMIDITY, zone), p->day_humidity);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_NIGHT_HUMIDITY, zone), p->night_humidity);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_DAY_LIGHT, zone), p->day_light);
+    settings_set_int(settings_zone_key(key, SETTINGS_KEY_RAMP_MIN, zone), p->ramp_min);
+    settings_set_int(settings_zone_key(key, SETTINGS_KEY_PHOTOPERIOD, zone), p->photoperiod_h);
+    settings_set_int(settings_zone_key(key, SETTINGS_KEY_BRUMATION_START, zone), p->brumation_start);
+    settings_set_int(settings_zone_key(key, SETTINGS_KEY_BRUMATION_DAYS, zone), p->brumation_days);
+    settings_set_float(settings_zone_key(key, SETTINGS_KEY_BRUMATION_DROP, zone), p->brumation_drop_c);
+}
+
+// Initialize the profile manager and load the location
+void profile_manager_init(void) {
+    ESP_LOGI(TAG, "Initializing profile manager");
+
+    latitude = settings_get_float(SETTINGS_KEY_LATITUDE, 0.0f);
+    longitude = settings_get_float(SETTINGS_KEY_LONGITUDE, 0.0f);
+    midnight = 0;
+    next_midnight = 0;
+    memset(loaded, 0, sizeof(loaded));
+    memset(day_valid, 0, sizeof(day_valid));
+    memset(brumating, 0, sizeof(brumating));
+    memset(phase, PHASE_UNKNOWN, sizeof(phase));
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Sunrise and sunset of a day at a location, in minutes after midnight UTC
+bool profile_sun_times(int day_of_year, float lat, float lon, float *sunrise_min, float *sunset_min) {
+    // Fractional year, equation of time (min) and solar declination (rad)
+    float g = 2.0f * 3.14159265f / 365.0f * (day_of_year - 1);
+    float eqtime = 229.18f * (0.000075f + 0.001868f * cosf(g) - 0.032077f * sinf(g) -
+                              0.014615f * cosf(2.0f * g) - 0.040849f * sinf(2.0f * g));
+    float decl = 0.006918f - 0.399912f * cosf(g) + 0.070257f * sinf(g) - 0.006758f * cosf(2.0f * g) +
+                 0.000907f * sinf(2.0f * g) - 0.002697f * cosf(3.0f * g) + 0.00148f * sinf(3.0f * g);
+
+    // Hour angle of the sun's upper limb on the horizon, with refraction
+    float cos_ha = cosf(90.833f * DEG) / (cosf(lat * DEG) * cosf(decl)) - tanf(lat * DEG) * tanf(decl);
+    float noon = 720.0f - 4.0f * lon - eqtime;
+
+    if (cos_ha > 1.0f) {
+        // Polar night
+        *sunrise_min = *sunset_min = noon;
+        return false;
+    }
+    if (cos_ha < -1.0f) {
+        // Midnight sun
+        *sunrise_min = noon - 720.0f;
+        *sunset_min = noon + 720.0f;
+        return true;
+    }
+
+    float ha = acosf(cos_ha) / DEG;
+    *sunrise_min = noon - 4.0f * ha;
+    *sunset_min = noon + 4.0f * ha;
+    return true;
+}
+
+// Start a new local day: find its midnights and today's sun times. Every
+// zone's breakpoints are recomputed on its next tick.
+static void start_day(time_t now) {
+    struct tm local, utc;
+    float rise, set;
+
+    localtime_r(&now, &local);
+    gmtime_r(&now, &utc);
+    utc.tm_isdst = local.tm_isdst;
+    int32_t utc_offset_s = (int32_t)(now - mktime(&utc));
+
+    day_of_year = local.tm_yday + 1;
+    local.tm_hour = local.tm_min = local.tm_sec = 0;
+    local.tm_isdst = -1;
+    midnight = mktime(&local);
+    local.tm_mday++;
+    local.tm_isdst = -1;
+    next_midnight = mktime(&local);
+
+    profile_sun_times(day_of_year, latitude, longitude, &rise, &set);
+    sunrise_s = (int32_t)(rise * 60.0f) + utc_offset_s;
+    sunset_s = (int32_t)(set * 60.0f) + utc_offset_s;
+    noon_s = (int32_t)((rise + set) * 30.0f) + utc_offset_s;
+    if (sunrise_s < 0) sunrise_s = 0;
+    if (sunset_s > DAY_S) sunset_s = DAY_S;
+    if (sunset_s < sunrise_s) sunset_s = sunrise_s;
+
+    memset(day_valid, 0, sizeof(day_valid));
+    stats.day_computations++;
+    ESP_LOGI(TAG, "Day %d: sunrise %02d:%02d, sunset %02d:%02d", day_of_year,
+             (int)(sunrise_s / 3600), (int)(sunrise_s / 60 % 60), (int)(sunset_s / 3600), (int)(sunset_s / 60 % 60));
+}
+
+// Work out the breakpoints of a zone's day
+static void compute_day(int zone) {
+    const profile_t *p = &profiles[zone];
+    profile_day_t *d = &days[zone];
+    float depth = 0.0f;
+
+    d->sunrise_s = sunrise_s;
+    d->sunset_s = sunset_s;
+    // A fixed photoperiod keeps the day length and takes noon from the sun
+    if (p->photoperiod_h > 0) {
+        d->sunrise_s = noon_s - p->photoperiod_h * 1800;
+        d->sunset_s = noon_s + p->photoperiod_h * 1800;
+        if (d->sunrise_s < 0) d->sunrise_s = 0;
+        if (d->sunset_s > DAY_S) d->sunset_s = DAY_S;
+    }
+    d->ramp_s = p->ramp_min * 60;
+    if (d->sunset_s - d->sunrise_s < 2 * d->ramp_s) {
+        d->ramp_s = (d->sunset_s - d->sunrise_s) / 2;
+    }
+
+    // Brumation deepens and lifts along a half cosine over its days
+    if (p->brumation_days > 0) {
+        int into = (day_of_year - p->brumation_start + 366) % 366;
+        if (into < p->brumation_days) {
+            depth = 0.5f * (1.0f - cosf(2.0f * 3.14159265f * into / p->brumation_days));
+        }
+    }
+    d->brumation = depth;
+    d->day_temp = p->day_temp - depth * p->brumation_drop_c;
+    d->night_temp = p->night_temp - depth * p->brumation_drop_c;
+    d->day_light = p->day_light * (1.0f - depth * (1.0f - PROFILE_BRUMATION_LIGHT));
+
+    if ((depth > 0.0f) != brumating[zone]) {
+        brumating[zone] = depth > 0.0f;
+        event_logger_add_zone_fmt(zone, "Profile: brumation %s", false, brumating[zone] ? "started" : "ended");
+    }
+    day_valid[zone] = true;
+    stats.day_computations++;
+}
+
+// Share of full day at a time of the day, from the breakpoints alone
+static float day_share(const profile_day_t *d, int32_t t) {
+    if (t <= d->sunrise_s || t >= d->sunset_s) {
+        return 0.0f;
+    }
+    if (d->ramp_s == 0) {
+        return 1.0f;
+    }
+
+    float up = (float)(t - d->sunrise_s) / d->ramp_s;
+    float down = (float)(d->sunset_s - t) / d->ramp_s;
+    float share = up < down ? up : down;
+    return share > 1.0f ? 1.0f : share;
+}
+
+// Phase of a zone's day at a time of the day
+static uint8_t phase_at(const profile_day_t *d, int32_t t, float share) {
+    if (share <= 0.0f) {
+        return PHASE_NIGHT;
+    }
+    if (share >= 1.0f) {
+        return PHASE_DAY;
+    }
+    return t < d->sunrise_s + d->ramp_s ? PHASE_SUNRISE : PHASE_SUNSET;
+}
+
+// Move the targets of every profiled zone to their value at now
+void profile_manager_update(time_t now) {
+    int zones = climate_controller_get_zone_count();
+
+    stats.ticks++;
+    if (now < midnight || now >= next_midnight) {
+        start_day(now);
+    }
+    int32_t t = (int32_t)(now - midnight);
+
+    for (int z = 0; z < zones; z++) {
+        if (!loaded[z]) {
+            load_zone(z);
+        }
+        const profile_t *p = &profiles[z];
+        if (!p->enabled) {
+            continue;
+        }
+        if (!day_valid[z]) {
+            compute_day(z);
+        }
+
+        // Interpolate between the day and night values
+        const profile_day_t *d = &days[z];
+        float share = day_share(d, t);
+        float temp = d->night_temp + share * (d->day_temp - d->night_temp);
+        float humidity = p->night_humidity + share * (p->day_humidity - p->night_humidity);
+        float light = share * d->day_light;
+
+        uint8_t now_phase = phase_at(d, t, share);
+        bool changed = now_phase != phase[z];
+        if (changed) {
+            phase[z] = now_phase;
+            event_logger_add_zone_fmt(z, "Profile: %s, heading for %.1f°C", false, phase_names[now_phase],
+                                      now_phase == PHASE_SUNRISE || now_phase == PHASE_DAY ? d->day_temp : d->night_temp);
+        }
+
+        // Hand over whole steps only
+        if (changed || fabsf(temp - applied_temp[z]) >= PROFILE_TEMP_STEP_C ||
+            fabsf(humidity - applied_humidity[z]) >= PROFILE_HUMIDITY_STEP_PCT ||
+            fabsf(light - applied_light[z]) >= PROFILE_LIGHT_STEP_PCT) {
+            applied_temp[z] = temp;
+            applied_humidity[z] = humidity;
+            applied_light[z] = light;
+            climate_controller_zone_follow_targets(z, temp, humidity, light);
+            stats.target_updates++;
+        }
+    }
+}
+
+// Set the location sunrise and sunset are computed for
+void profile_manager_set_location(float lat, float lon) {
+    if (lat > 89.9f) lat = 89.9f;
+    if (lat < -89.9f) lat = -89.9f;
+    if (lon > 180.0f) lon = 180.0f;
+    if (lon < -180.0f) lon = -180.0f;
+
+    latitude = lat;
+    longitude = lon;
+    settings_set_float(SETTINGS_KEY_LATITUDE, lat);
+    settings_set_float(SETTINGS_KEY_LONGITUDE, lon);
+
+    // Today's sun times change with it
+    midnight = 0;
+    next_midnight = 0;
+    ESP_LOGI(TAG, "Location set to %.2f, %.2f", lat, lon);
+}
+
+// Get the location
+void profile_manager_get_location(float *lat, float *lon) {
+    *lat = latitude;
+    *lon = longitude;
+}
+
+// Check a profile for a zone without setting it
+esp_err_t profile_manager_check(int zone, const profile_t *profile) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES || profile->ramp_min > 12 * 60 ||
+        profile->photoperiod_h > 24 ||
+        profile->brumation_start < 1 || profile->brumation_start > 366 || profile->brumation_days > 366 ||
+        profile->brumation_drop_c < 0.0f) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+// Set the profile of a zone
+esp_err_t profile_manager_set(int zone, const profile_t *profile) {
+    esp_err_t err = profile_manager_check(zone, profile);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    profiles[zone] = *profile;
+    loaded[zone] = true;
+    day_valid[zone] = false;
+    phase[zone] = PHASE_UNKNOWN;
+    save_zone(zone);
+    ESP_LOGI(TAG, "Zone %d profile %s", zone + 1, profile->enabled ? "enabled" : "disabled");
+    return ESP_OK;
+}
+
+// Get the profile of a zone
+void profile_manager_get(int zone, profile_t *profile) {
+    if (!valid_zone(zone)) {
+        return;
+    }
+    if (!loaded[zone]) {
+        load_zone(zone);
+    }
+    *profile = profiles[zone];
+}
+
+// Check if a zone's targets follow its profile
+bool profile_manager_is_active(int zone) {
+    if (!valid_zone(zone)) {
+        return false;
+    }
+    if (!loaded[zone]) {
+        load_zone(zone);
+    }
+    return profiles[zone].enabled;
+}
+
+// Get the breakpoints of a zone's current day
+bool profile_manager_get_day(int zone, profile_day_t *day) {
+    if (!valid_zone(zone) || !day_valid[zone] || !profiles[zone].enabled) {
+        return false;
+    }
+    *day = days[zone];
+    return true;
+}
+
+// Get the work done so far
+void profile_manager_get_stats(profile_stats_t *out) {
+    *out = stats;
+}
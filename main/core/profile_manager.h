@@ -0,0 +1,101 @@
+#ifndef PROFILE_MANAGER_H
+#define PROFILE_MANAGER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+// Day/night and seasonal target profiles. Sunrise and sunset come from the
+// configured location; each zone's day breakpoints are worked out once a
+// day (at local midnight, or after a change) and the control tick only
+// interpolates between them.
+
+// Defaults of a new profile
+#define PROFILE_DEFAULT_DAY_TEMP 30.0f
+#define PROFILE_DEFAULT_NIGHT_TEMP 24.0f
+#define PROFILE_DEFAULT_DAY_HUMIDITY 50.0f
+#define PROFILE_DEFAULT_NIGHT_HUMIDITY 60.0f
+#define PROFILE_DEFAULT_DAY_LIGHT 100.0f
+#define PROFILE_DEFAULT_RAMP_MIN 60
+#define PROFILE_DEFAULT_BRUMATION_DROP_C 8.0f
+
+// Light kept at the depth of brumation, as a fraction of the day level
+#define PROFILE_BRUMATION_LIGHT 0.5f
+
+// Targets move in steps at least this large (a ramp would otherwise
+// change them every tick)
+#define PROFILE_TEMP_STEP_C 0.1f
+#define PROFILE_HUMIDITY_STEP_PCT 1.0f
+#define PROFILE_LIGHT_STEP_PCT 1.0f
+
+// Profile of one zone
+typedef struct {
+    bool enabled;
+    float day_temp;
+    float night_temp;
+    float day_humidity;
+    float night_humidity;
+    float day_light;            // Light at full day; off at night
+    uint16_t ramp_min;          // Sunrise and sunset ramp length
+    uint8_t photoperiod_h;      // Lit hours centred on solar noon; 0 follows the sun
+    uint16_t brumation_start;   // Day of year brumation starts (1..366)
+    uint16_t brumation_days;    // 0 for none
+    float brumation_drop_c;     // Temperature drop at the depth of brumation
+} profile_t;
+
+// Breakpoints of a zone's current day
+typedef struct {
+    int32_t sunrise_s;          // Local seconds after midnight
+    int32_t sunset_s;
+    int32_t ramp_s;             // Shortened on days too short for two ramps
+    float day_temp;             // With today's brumation drop applied
+    float night_temp;
+    float day_light;
+    float brumation;            // Depth of brumation today, 0..1
+} profile_day_t;
+
+// Work done by the engine
+typedef struct {
+    uint32_t ticks;
+    uint32_t day_computations;  // Breakpoint (trigonometry) passes
+    uint32_t target_updates;    // Targets handed to the controller
+} profile_stats_t;
+
+// Initialize the profile manager and load the location
+void profile_manager_init(void);
+
+// Set the location sunrise and sunset are computed for (degrees, north
+// and east positive)
+void profile_manager_set_location(float latitude, float longitude);
+void profile_manager_get_location(float *latitude, float *longitude);
+
+// Set or get the profile of a zone
+esp_err_t profile_manager_set(int zone, const profile_t *profile);
+void profile_manager_get(int zone, profile_t *profile);
+
+// Check a profile for a zone without setting it; ESP_OK if
+// profile_manager_set would take it
+esp_err_t profile_manager_check(int zone, const profile_t *profile);
+
+// Check if a zone's targets follow its profile
+bool profile_manager_is_active(int zone);
+
+// Move the targets of every profiled zone to their value at now. Called
+// from the climate task before the control update.
+void profile_manager_update(time_t now);
+
+// Get the breakpoints of a zone's current day; false before the first
+// update or when the zone has no profile
+bool profile_manager_get_day(int zone, profile_day_t *day);
+
+// Get the work done so far
+void profile_manager_get_stats(profile_stats_t *stats);
+
+// Sunrise and sunset of a day at a location, in minutes after midnight
+// UTC (NOAA approximation). Returns false for polar night; in midnight
+// sun both span the whole day.
+bool profile_sun_times(int day_of_year, float latitude, float longitude,
+                       float *sunrise_min, float *sunset_min);
+
+#endif /* PROFILE_MANAGER_H */
@@ -0,0 +1,127 @@
+#include "psychrometrics.h"
+#include <math.h>
+
+#define TABLE_LEN (PSYCHRO_TABLE_MAX_C - PSYCHRO_TABLE_MIN_C + 1)
+
+// Saturation vapour pressure (kPa) from PSYCHRO_TABLE_MIN_C to
+// PSYCHRO_TABLE_MAX_C in 1 °C steps: 0.61094 * exp(17.625 T / (T + 243.04))
+static const float saturation[TABLE_LEN] = {
+    0.0189684f, 0.0210347f, 0.0233026f, 0.0257893f, 0.0285134f, 0.0314948f, 0.034755f, 0.0383166f,
+    0.0422042f, 0.0464439f, 0.0510635f, 0.056093f, 0.061564f, 0.0675104f, 0.0739683f, 0.0809761f,
+    0.0885746f, 0.0968071f, 0.10572f, 0.115361f, 0.125784f, 0.137042f, 0.149194f, 0.162302f,
+    0.17643f, 0.191648f, 0.208029f, 0.225648f, 0.244587f, 0.264932f, 0.286773f, 0.310204f,
+    0.335325f, 0.362242f, 0.391064f, 0.421908f, 0.454896f, 0.490156f, 0.527821f, 0.568033f,
+    0.61094f, 0.656696f, 0.705462f, 0.757409f, 0.812713f, 0.87156f, 0.934143f, 1.00066f,
+    1.07134f, 1.14638f, 1.22602f, 1.3105f, 1.40007f, 1.495f, 1.59554f, 1.70198f,
+    1.81462f, 1.93377f, 2.05973f, 2.19284f, 2.33344f, 2.48189f, 2.63855f, 2.80381f,
+    2.97807f, 3.16174f, 3.35523f, 3.55901f, 3.77352f, 3.99924f, 4.23665f, 4.48627f,
+    4.74862f, 5.02424f, 5.3137f, 5.61757f, 5.93645f, 6.27096f, 6.62173f, 6.98942f,
+    7.37472f, 7.77831f, 8.20093f, 8.64331f, 9.10622f, 9.59045f, 10.0968f, 10.6261f,
+    11.1793f, 11.7571f, 12.3606f, 12.9906f, 13.6481f, 14.3341f, 15.0497f, 15.7958f,
+    16.5735f, 17.3839f, 18.2282f, 19.1075f, 20.023f,
+};
+
+// Water vapour density per kPa of vapour pressure and kelvin
+// (molar mass of water over the gas constant, in g/m³)
+#define ABS_HUMIDITY_FACTOR 2166.8f
+
+// Clamp a temperature to the table and split it into an index and a
+// fraction of a step
+static int table_position(float temperature, float *frac) {
+    float x = temperature - PSYCHRO_TABLE_MIN_C;
+
+    if (x <= 0.0f) {
+        *frac = 0.0f;
+        return 0;
+    }
+    if (x >= TABLE_LEN - 1) {
+        *frac = 0.0f;
+        return TABLE_LEN - 1;
+    }
+    int i = (int)x;
+    *frac = x - i;
+    return i;
+}
+
+// Saturation vapour pressure at a temperature
+float psychro_saturation_kpa(float temperature) {
+    float frac;
+    int i = table_position(temperature, &frac);
+
+    if (frac == 0.0f) {
+        return saturation[i];
+    }
+    return saturation[i] + (saturation[i + 1] - saturation[i]) * frac;
+}
+
+// Temperature whose saturation pressure is e: the inverse of the table
+static float saturation_temperature(float e) {
+    int lo = 0;
+    int hi = TABLE_LEN - 1;
+
+    if (e <= saturation[lo]) {
+        return PSYCHRO_TABLE_MIN_C;
+    }
+    if (e >= saturation[hi]) {
+        return PSYCHRO_TABLE_MAX_C;
+    }
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (saturation[mid] <= e) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return PSYCHRO_TABLE_MIN_C + lo + (e - saturation[lo]) / (saturation[hi] - saturation[lo]);
+}
+
+// Dew point of air at a temperature and relative humidity
+float psychro_dew_point(float temperature, float humidity) {
+    psychro_metrics_t metrics;
+
+    psychro_compute(temperature, humidity, &metrics);
+    return metrics.dew_point_c;
+}
+
+// Compute the metrics of one reading
+void psychro_compute(float temperature, float humidity, psychro_metrics_t *metrics) {
+    psychro_compute_batch(&temperature, &humidity, &metrics->vpd_kpa, &metrics->dew_point_c,
+                          &metrics->abs_humidity_gm3, 1);
+}
+
+// Compute the metrics of count readings
+void psychro_compute_batch(const float *temperature, const float *humidity, float *vpd_kpa,
+                           float *dew_point_c, float *abs_humidity_gm3, int count) {
+    for (int i = 0; i < count; i++) {
+        float t = temperature[i];
+        float rh = humidity[i];
+
+        if (isnan(t) || isnan(rh)) {
+            vpd_kpa[i] = dew_point_c[i] = abs_humidity_gm3[i] = NAN;
+            continue;
+        }
+        rh = rh < 0.0f ? 0.0f : (rh > 100.0f ? 100.0f : rh);
+
+        float es = psychro_saturation_kpa(t);
+        float e = es * rh / 100.0f;
+        vpd_kpa[i] = es - e;
+        abs_humidity_gm3[i] = ABS_HUMIDITY_FACTOR * e / (t + 273.15f);
+        if (rh >= 100.0f) {
+            dew_point_c[i] = t;
+        } else if (rh <= 0.0f) {
+            dew_point_c[i] = PSYCHRO_TABLE_MIN_C;
+        } else {
+            dew_point_c[i] = saturation_temperature(e);
+        }
+    }
+}
+
+// Relative humidity that gives a vapour pressure deficit at a temperature
+float psychro_humidity_for_vpd(float temperature, float vpd_kpa) {
+    if (isnan(temperature) || isnan(vpd_kpa)) {
+        return NAN;
+    }
+    float rh = 100.0f * (1.0f - vpd_kpa / psychro_saturation_kpa(temperature));
+    return rh < 0.0f ? 0.0f : (rh > 100.0f ? 100.0f : rh);
+}
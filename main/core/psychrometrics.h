@@ -0,0 +1,39 @@
+#ifndef PSYCHROMETRICS_H
+#define PSYCHROMETRICS_H
+
+// Moist-air metrics from a temperature and relative humidity: vapour
+// pressure deficit, dew point and absolute humidity. Computed every sample
+// for every zone, so the saturation pressure comes from a 1 °C table
+// (Magnus form, over water) with linear interpolation, and the dew point
+// from a search of the same table, instead of expf/logf per call.
+
+// Range of the saturation pressure table; temperatures outside it are
+// clamped to it
+#define PSYCHRO_TABLE_MIN_C (-40)
+#define PSYCHRO_TABLE_MAX_C 60
+
+// Metrics of one reading; NaN when either input is
+typedef struct {
+    float vpd_kpa;              // Vapour pressure deficit
+    float dew_point_c;
+    float abs_humidity_gm3;     // Water vapour per cubic metre of air
+} psychro_metrics_t;
+
+// Saturation vapour pressure at a temperature (kPa)
+float psychro_saturation_kpa(float temperature);
+
+// Dew point of air at a temperature and relative humidity (%)
+float psychro_dew_point(float temperature, float humidity);
+
+// Compute the metrics of one reading
+void psychro_compute(float temperature, float humidity, psychro_metrics_t *metrics);
+
+// Compute the metrics of count readings, one output array per metric
+void psychro_compute_batch(const float *temperature, const float *humidity, float *vpd_kpa,
+                           float *dew_point_c, float *abs_humidity_gm3, int count);
+
+// Relative humidity (%) that gives a vapour pressure deficit at a
+// temperature, for controlling a humidifier to a VPD target
+float psychro_humidity_for_vpd(float temperature, float vpd_kpa);
+
+#endif /* PSYCHROMETRICS_H */
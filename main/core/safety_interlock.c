@@ -0,0 +1,345 @@
+#include "safety_interlock.h"
+#include "actuator_manager.h"
+#include "climate_controller.h"
+#include "data_simulator.h"
+#include "event_logger.h"
+#include "esp_log.h"
+#include "esp_task_wdt.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "safety_interlock";
+
+// Highest priority, on the core the UI task does not use
+#define SAFETY_TASK_PRIORITY (configMAX_PRIORITIES - 1)
+#define SAFETY_TASK_CORE 0
+
+#define SAFETY_PERIOD_US ((int64_t)SAFETY_PERIOD_MS * 1000)
+#define SAFETY_STALE_US ((int64_t)SAFETY_SENSOR_STALE_MS * 1000)
+
+// Latest sample per zone, written by the sensor task
+static float sample_temp[CLIMATE_MAX_ZONES];
+static float sample_humidity[CLIMATE_MAX_ZONES];
+static int64_t sample_time[CLIMATE_MAX_ZONES];     // 0 until the first sample
+static portMUX_TYPE sample_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Trip state per zone, written only by the check pass
+static volatile uint8_t causes[CLIMATE_MAX_ZONES];
+static volatile uint8_t cutoff[CLIMATE_MAX_ZONES];
+
+// Changes not yet written to the event log, and the timing stats
+static uint8_t tripped_pending[CLIMATE_MAX_ZONES];
+static uint8_t released_pending[CLIMATE_MAX_ZONES];
+static bool miss_pending;
+static safety_interlock_stats_t stats;
+static portMUX_TYPE state_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Zones without a sample go stale counting from here
+static int64_t start_time;
+
+static TaskHandle_t task_handle;
+
+// Event log text per trip cause
+static const struct {
+    uint8_t cause;
+    const char *name;
+    const char *outputs;
+} cause_names[] = {
+    { SAFETY_CAUSE_OVER_TEMP, "over-temperature", "heating" },
+    { SAFETY_CAUSE_UNDER_TEMP, "under-temperature", "cooling" },
+    { SAFETY_CAUSE_OVER_HUMIDITY, "humidity too high", "humidifier" },
+    { SAFETY_CAUSE_SENSOR_STALE, "sensor not responding", "all outputs" },
+};
+
+// Forward declarations
+static void safety_task(void *pvParameter);
+
+// Actuators to cut for a set of trip causes
+static uint8_t cutoff_for(uint8_t trip_causes) {
+    uint8_t cut = 0;
+
+    if (trip_causes & SAFETY_CAUSE_OVER_TEMP) cut |= SAFETY_CUT_HEATING;
+    if (trip_causes & SAFETY_CAUSE_UNDER_TEMP) cut |= SAFETY_CUT_COOLING;
+    if (trip_causes & SAFETY_CAUSE_OVER_HUMIDITY) cut |= SAFETY_CUT_HUMIDIFIER;
+    if (trip_causes & SAFETY_CAUSE_SENSOR_STALE) {
+        cut |= SAFETY_CUT_HEATING | SAFETY_CUT_COOLING | SAFETY_CUT_HUMIDIFIER;
+    }
+    return cut;
+}
+
+// Limit causes of a fresh sample; tripped causes hold until the reading is
+// back inside by the release margin
+static uint8_t limit_causes(float temp, float humidity, uint8_t was) {
+    uint8_t result = 0;
+
+    if (temp > SAFETY_TEMP_MAX_C ||
+        ((was & SAFETY_CAUSE_OVER_TEMP) && temp > SAFETY_TEMP_MAX_C - SAFETY_TEMP_RELEASE_MARGIN_C)) {
+        result |= SAFETY_CAUSE_OVER_TEMP;
+    }
+    if (temp < SAFETY_TEMP_MIN_C ||
+        ((was & SAFETY_CAUSE_UNDER_TEMP) && temp < SAFETY_TEMP_MIN_C + SAFETY_TEMP_RELEASE_MARGIN_C)) {
+        result |= SAFETY_CAUSE_UNDER_TEMP;
+    }
+    if (humidity > SAFETY_HUMIDITY_MAX_PCT ||
+        ((was & SAFETY_CAUSE_OVER_HUMIDITY) &&
+         humidity > SAFETY_HUMIDITY_MAX_PCT - SAFETY_HUMIDITY_RELEASE_MARGIN_PCT)) {
+        result |= SAFETY_CAUSE_OVER_HUMIDITY;
+    }
+    return result;
+}
+
+// Initialize the interlock state
+void safety_interlock_init(void) {
+    ESP_LOGI(TAG, "Initializing safety interlock");
+
+    portENTER_CRITICAL(&sample_lock);
+    memset(sample_time, 0, sizeof(sample_time));
+    portEXIT_CRITICAL(&sample_lock);
+
+    portENTER_CRITICAL(&state_lock);
+    for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+        causes[z] = 0;
+        cutoff[z] = 0;
+        tripped_pending[z] = 0;
+        released_pending[z] = 0;
+        data_simulator_set_zone_cutoff(z, 0);
+    }
+    miss_pending = false;
+    memset(&stats, 0, sizeof(stats));
+    portEXIT_CRITICAL(&state_lock);
+
+    start_time = esp_timer_get_time();
+}
+
+// Start the interlock task
+esp_err_t safety_interlock_start(void) {
+    if (task_handle != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // A cut can write the output expander from this task when no commit
+    // holds the outputs, so it needs the same room as the climate task
+    if (xTaskCreatePinnedToCore(safety_task, "safety_task", 4096, NULL, SAFETY_TASK_PRIORITY,
+                                &task_handle, SAFETY_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the safety task");
+        task_handle = NULL;
+        return ESP_FAIL;
+    }
+
+    event_logger_add("Safety interlock started", false);
+    return ESP_OK;
+}
+
+// Stop the interlock task
+void safety_interlock_stop(void) {
+    if (task_handle == NULL) {
+        return;
+    }
+
+    esp_task_wdt_delete(task_handle);
+    vTaskDelete(task_handle);
+    task_handle = NULL;
+}
+
+// Record a fresh sensor sample of a zone
+void safety_interlock_report_sample(int zone, float temperature, float humidity) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&sample_lock);
+    sample_temp[zone] = temperature;
+    sample_humidity[zone] = humidity;
+    sample_time[zone] = now;
+    portEXIT_CRITICAL(&sample_lock);
+}
+
+// Run one check pass
+void safety_interlock_check(int64_t now_us) {
+    int zones = climate_controller_get_zone_count();
+
+    for (int z = 0; z < zones; z++) {
+        portENTER_CRITICAL(&sample_lock);
+        float temp = sample_temp[z];
+        float humidity = sample_humidity[z];
+        int64_t at = sample_time[z];
+        portEXIT_CRITICAL(&sample_lock);
+
+        uint8_t was = causes[z];
+        int64_t since = at ? at : start_time;
+        uint8_t now_causes;
+
+        if (now_us - since > SAFETY_STALE_US) {
+            // No usable reading: keep the limit trips as they were
+            now_causes = (was & ~SAFETY_CAUSE_SENSOR_STALE) | SAFETY_CAUSE_SENSOR_STALE;
+        } else if (at) {
+            now_causes = limit_causes(temp, humidity, was);
+        } else {
+            now_causes = was;
+        }
+
+        if (now_causes == was) {
+            continue;
+        }
+
+        // Cut the outputs first, account afterwards
+        uint8_t cut = cutoff_for(now_causes);
+        data_simulator_set_zone_cutoff(z, cut);
+        actuator_manager_cut(z, cut);
+        cutoff[z] = cut;
+        causes[z] = now_causes;
+
+        uint8_t tripped = now_causes & ~was;
+        uint8_t released = was & ~now_causes;
+
+        portENTER_CRITICAL(&state_lock);
+        tripped_pending[z] |= tripped;
+        released_pending[z] |= released;
+        if (tripped) {
+            // Reaction from the moment the fault became observable
+            int64_t onset = (tripped & SAFETY_CAUSE_SENSOR_STALE) ? since + SAFETY_STALE_US : at;
+            uint32_t reaction = now_us > onset ? (uint32_t)(now_us - onset) : 0;
+
+            stats.trips++;
+            if (reaction > stats.reaction_max_us) {
+                stats.reaction_max_us = reaction;
+            }
+            if (reaction > SAFETY_MAX_REACTION_MS * 1000) {
+                stats.deadline_misses++;
+                miss_pending = true;
+            }
+        }
+        portEXIT_CRITICAL(&state_lock);
+    }
+}
+
+// Interlock task: checks every SAFETY_PERIOD_MS and measures its own timing
+static void safety_task(void *pvParameter) {
+    ESP_LOGI(TAG, "Safety task started on core %d", SAFETY_TASK_CORE);
+
+    // A hung interlock resets the chip, which leaves the outputs off
+    esp_task_wdt_add(NULL);
+
+    TickType_t last_wake = xTaskGetTickCount();
+    int64_t last_run = esp_timer_get_time();
+    bool bound_exceeded = false;
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SAFETY_PERIOD_MS));
+
+        int64_t now = esp_timer_get_time();
+        safety_interlock_check(now);
+        int64_t done = esp_timer_get_time();
+
+        int64_t late = now - last_run - SAFETY_PERIOD_US;
+        last_run = now;
+
+        portENTER_CRITICAL(&state_lock);
+        stats.checks++;
+        if (late > (int64_t)stats.wake_late_max_us) {
+            stats.wake_late_max_us = (uint32_t)late;
+        }
+        if (done - now > (int64_t)stats.check_max_us) {
+            stats.check_max_us = (uint32_t)(done - now);
+        }
+        uint32_t bound = SAFETY_PERIOD_US + stats.wake_late_max_us + stats.check_max_us;
+        if (!bound_exceeded && bound > SAFETY_MAX_REACTION_MS * 1000) {
+            bound_exceeded = true;
+            stats.deadline_misses++;
+            miss_pending = true;
+        }
+        portEXIT_CRITICAL(&state_lock);
+
+        esp_task_wdt_reset();
+    }
+}
+
+// Get the actuators currently cut in a zone
+uint8_t safety_interlock_get_cutoff(int zone) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return 0;
+    }
+    return cutoff[zone];
+}
+
+// Get the active trip causes of a zone
+uint8_t safety_interlock_get_causes(int zone) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return 0;
+    }
+    return causes[zone];
+}
+
+// Check if any zone is tripped
+bool safety_interlock_is_tripped(void) {
+    for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+        if (causes[z]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Get the timing measured so far
+void safety_interlock_get_stats(safety_interlock_stats_t *out) {
+    portENTER_CRITICAL(&state_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&state_lock);
+}
+
+// Worst-case reaction bound from the measurements
+uint32_t safety_interlock_get_worst_case_us(void) {
+    safety_interlock_stats_t s;
+    safety_interlock_get_stats(&s);
+    return SAFETY_PERIOD_US + s.wake_late_max_us + s.check_max_us;
+}
+
+// Log trips, releases and deadline misses to the event log
+void safety_interlock_report(void) {
+    bool changed = false;
+
+    for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+        portENTER_CRITICAL(&state_lock);
+        uint8_t tripped = tripped_pending[z];
+        uint8_t released = released_pending[z];
+        tripped_pending[z] = 0;
+        released_pending[z] = 0;
+        portEXIT_CRITICAL(&state_lock);
+
+        if (!tripped && !released) {
+            continue;
+        }
+        changed = true;
+
+        for (size_t i = 0; i < sizeof(cause_names) / sizeof(cause_names[0]); i++) {
+            if (tripped & cause_names[i].cause) {
+                event_logger_add_zone_fmt(z, "SAFETY: %s, %s off", true,
+                                          cause_names[i].name, cause_names[i].outputs);
+            } else if (released & cause_names[i].cause) {
+                event_logger_add_zone_fmt(z, "Safety cutoff released: %s", false, cause_names[i].name);
+            }
+        }
+    }
+
+    portENTER_CRITICAL(&state_lock);
+    bool missed = miss_pending;
+    miss_pending = false;
+    safety_interlock_stats_t s = stats;
+    portEXIT_CRITICAL(&state_lock);
+
+    if (missed) {
+        event_logger_add_fmt("SAFETY: interlock exceeded its %d ms reaction limit", true, SAFETY_MAX_REACTION_MS);
+    }
+    if (changed || missed) {
+        ESP_LOGI(TAG, "SAFETY trips=%lu misses=%lu reaction_max_us=%lu worst_case_us=%lu "
+                 "wake_late_max_us=%lu check_max_us=%lu",
+                 (unsigned long)s.trips, (unsigned long)s.deadline_misses,
+                 (unsigned long)s.reaction_max_us,
+                 (unsigned long)(SAFETY_PERIOD_US + s.wake_late_max_us + s.check_max_us),
+                 (unsigned long)s.wake_late_max_us, (unsigned long)s.check_max_us);
+    }
+}
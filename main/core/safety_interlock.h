@@ -0,0 +1,90 @@
+#ifndef SAFETY_INTERLOCK_H
+#define SAFETY_INTERLOCK_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Absolute cutoffs, enforced regardless of targets and control modes
+#ifndef SAFETY_TEMP_MAX_C
+#define SAFETY_TEMP_MAX_C 42.0f
+#endif
+#ifndef SAFETY_TEMP_MIN_C
+#define SAFETY_TEMP_MIN_C 12.0f
+#endif
+#ifndef SAFETY_HUMIDITY_MAX_PCT
+#define SAFETY_HUMIDITY_MAX_PCT 92.0f
+#endif
+
+// A tripped cutoff releases once the reading is back inside by this much
+#define SAFETY_TEMP_RELEASE_MARGIN_C 2.0f
+#define SAFETY_HUMIDITY_RELEASE_MARGIN_PCT 5.0f
+
+// Cut everything in a zone whose last sample is older than this
+#ifndef SAFETY_SENSOR_STALE_MS
+#define SAFETY_SENSOR_STALE_MS 5000
+#endif
+
+// Check period of the interlock task, and the reaction time it must hold:
+// from a sample crossing a cutoff (or going stale) to the outputs being cut
+#define SAFETY_PERIOD_MS 20
+#define SAFETY_MAX_REACTION_MS 50
+
+// Trip causes
+#define SAFETY_CAUSE_OVER_TEMP     (1 << 0)
+#define SAFETY_CAUSE_UNDER_TEMP    (1 << 1)
+#define SAFETY_CAUSE_OVER_HUMIDITY (1 << 2)
+#define SAFETY_CAUSE_SENSOR_STALE  (1 << 3)
+
+// Actuators cut by the interlock
+#define SAFETY_CUT_HEATING    (1 << 0)
+#define SAFETY_CUT_COOLING    (1 << 1)
+#define SAFETY_CUT_HUMIDIFIER (1 << 2)
+
+// Timing measured by the interlock
+typedef struct {
+    uint32_t checks;
+    uint32_t trips;
+    uint32_t deadline_misses;   // Reactions, or the worst-case bound, over SAFETY_MAX_REACTION_MS
+    uint32_t reaction_max_us;   // Longest measured trip reaction
+    uint32_t wake_late_max_us;  // Longest delay of the task behind its schedule
+    uint32_t check_max_us;      // Longest check pass
+} safety_interlock_stats_t;
+
+// Initialize the interlock state (all zones untripped, no samples)
+void safety_interlock_init(void);
+
+// Start the interlock task
+esp_err_t safety_interlock_start(void);
+
+// Stop the interlock task (tests only; cutoffs stay as they are)
+void safety_interlock_stop(void);
+
+// Record a fresh sensor sample of a zone; safe to call from any task
+void safety_interlock_report_sample(int zone, float temperature, float humidity);
+
+// Run one check pass at now_us (esp_timer time). The task calls this every
+// SAFETY_PERIOD_MS; tests call it directly.
+void safety_interlock_check(int64_t now_us);
+
+// Get the actuators currently cut in a zone (SAFETY_CUT_* bits)
+uint8_t safety_interlock_get_cutoff(int zone);
+
+// Get the active trip causes of a zone (SAFETY_CAUSE_* bits)
+uint8_t safety_interlock_get_causes(int zone);
+
+// Check if any zone is tripped
+bool safety_interlock_is_tripped(void);
+
+// Get the timing measured so far
+void safety_interlock_get_stats(safety_interlock_stats_t *stats);
+
+// Worst-case reaction bound from the measurements: one period, plus the
+// longest wake-up delay and check pass seen
+uint32_t safety_interlock_get_worst_case_us(void);
+
+// Log trips, releases and deadline misses to the event log. Called from a
+// normal-priority task so the interlock never waits on the logger or UI.
+void safety_interlock_report(void);
+
+#endif /* SAFETY_INTERLOCK_H */
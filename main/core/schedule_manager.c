@@ -0,0 +1,365 @@
+#include "schedule_manager.h"
+#include "climate_controller.h"
+#include "event_logger.h"
+#include "profile_manager.h"
+#include "sensor_hal.h"
+#include "settings_manager.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "schedule_manager";
+
+// Index into the learned rates
+#define RATE_WARM 0
+#define RATE_COOL 1
+
+// Schedule entries, with the occurrence each has started and applied
+static schedule_entry_t entries[SCHEDULE_MAX_ENTRIES];
+static time_t started[SCHEDULE_MAX_ENTRIES];
+static time_t applied[SCHEDULE_MAX_ENTRIES];
+static int entry_count = 0;
+
+// Learned rates per zone (°C/min), loaded from settings on first use
+static schedule_rate_t rates[2][CLIMATE_MAX_ZONES];
+static bool rates_loaded[CLIMATE_MAX_ZONES];
+
+// Transition being timed per zone
+static bool transition_active[CLIMATE_MAX_ZONES];
+static float transition_start_temp[CLIMATE_MAX_ZONES];
+static time_t transition_start_time[CLIMATE_MAX_ZONES];
+static float last_target[CLIMATE_MAX_ZONES];
+
+// Entry time a zone's scheduled transition is racing, 0 if none
+static time_t arrival_due[CLIMATE_MAX_ZONES];
+
+static schedule_accuracy_t accuracy;
+
+// The UI task edits the entries while the climate task applies them
+static SemaphoreHandle_t lock = NULL;
+
+// Settings keys of the learned rates: mean, count, sum of squares
+static const char *const rate_keys[2][3] = {
+    { SETTINGS_KEY_WARM_RATE, SETTINGS_KEY_WARM_COUNT, SETTINGS_KEY_WARM_M2 },
+    { SETTINGS_KEY_COOL_RATE, SETTINGS_KEY_COOL_COUNT, SETTINGS_KEY_COOL_M2 },
+};
+
+// Initialize the schedule manager
+void schedule_manager_init(void) {
+    ESP_LOGI(TAG, "Initializing schedule manager");
+
+    if (lock == NULL) {
+        lock = xSemaphoreCreateMutex();
+    }
+    entry_count = 0;
+    memset(rates_loaded, 0, sizeof(rates_loaded));
+    memset(transition_active, 0, sizeof(transition_active));
+    memset(last_target, 0, sizeof(last_target));
+    memset(arrival_due, 0, sizeof(arrival_due));
+    memset(&accuracy, 0, sizeof(accuracy));
+}
+
+// Load the learned rates of a zone
+static void load_rates(int zone) {
+    char key[SETTINGS_KEY_MAX_LEN];
+
+    for (int r = RATE_WARM; r <= RATE_COOL; r++) {
+        rates[r][zone].mean = settings_get_float(settings_zone_key(key, rate_keys[r][0], zone), 0.0f);
+        rates[r][zone].count = settings_get_int(settings_zone_key(key, rate_keys[r][1], zone), 0);
+        rates[r][zone].m2 = settings_get_float(settings_zone_key(key, rate_keys[r][2], zone), 0.0f);
+    }
+    rates_loaded[zone] = true;
+}
+
+// Add a finished transition to a zone's learned rate
+static void learn_rate(int zone, int r, float rate) {
+    char key[SETTINGS_KEY_MAX_LEN];
+    schedule_rate_t *s = &rates[r][zone];
+
+    s->count++;
+    float delta = rate - s->mean;
+    s->mean += delta / s->count;
+    s->m2 += delta * (rate - s->mean);
+
+    settings_set_float(settings_zone_key(key, rate_keys[r][0], zone), s->mean);
+    settings_set_int(settings_zone_key(key, rate_keys[r][1], zone), s->count);
+    settings_set_float(settings_zone_key(key, rate_keys[r][2], zone), s->m2);
+    settings_save();
+
+    ESP_LOGI(TAG, "Zone %d %s rate %.3f°C/min (mean %.3f over %lu)", zone + 1,
+             r == RATE_WARM ? "warm-up" : "cool-down", rate, s->mean, (unsigned long)s->count);
+}
+
+// Rate to plan with: the mean less one standard deviation, so most
+// transitions finish in time
+static float planning_rate(const schedule_rate_t *s, float default_rate) {
+    if (s->count == 0) {
+        return default_rate;
+    }
+
+    float rate = s->mean;
+    if (s->count > 1) {
+        rate -= sqrtf(s->m2 / (s->count - 1));
+    }
+    return fmaxf(rate, s->mean * 0.5f);
+}
+
+// Next time an entry is due, counting entries up to SCHEDULE_GRACE_S late
+static time_t next_occurrence(const schedule_entry_t *entry, time_t now) {
+    time_t from = now - SCHEDULE_GRACE_S;
+    struct tm t;
+
+    localtime_r(&from, &t);
+    int weekday = t.tm_wday == 0 ? 7 : t.tm_wday;
+    t.tm_mday += (entry->day - weekday + 7) % 7;
+    t.tm_hour = entry->hour;
+    t.tm_min = entry->minute;
+    t.tm_sec = 0;
+    t.tm_isdst = -1;
+
+    time_t at = mktime(&t);
+    if (at < from) {
+        t.tm_mday += 7;
+        t.tm_isdst = -1;
+        at = mktime(&t);
+    }
+    return at;
+}
+
+// Check if another entry of the same zone is due before an entry's time
+static bool earlier_entry_due(int index, time_t now, time_t at) {
+    for (int i = 0; i < entry_count; i++) {
+        if (i == index || entries[i].zone != entries[index].zone) {
+            continue;
+        }
+        time_t other = next_occurrence(&entries[i], now);
+        if (other < at && applied[i] != other) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Time transitions of a zone toward its target and record arrivals
+static void track_transition(int zone, float temp, float target, time_t now) {
+    if (fabsf(target - last_target[zone]) > 0.01f) {
+        // New target: time the run toward it if it is far enough away
+        last_target[zone] = target;
+        transition_active[zone] = fabsf(target - temp) >= SCHEDULE_MIN_TRANSITION_C;
+        transition_start_temp[zone] = temp;
+        transition_start_time[zone] = now;
+    }
+
+    bool reached = fabsf(target - temp) <= SCHEDULE_TOLERANCE_C;
+
+    if (transition_active[zone]) {
+        time_t elapsed = now - transition_start_time[zone];
+        if (reached) {
+            transition_active[zone] = false;
+            if (elapsed > 0) {
+                learn_rate(zone, target > transition_start_temp[zone] ? RATE_WARM : RATE_COOL,
+                           fabsf(temp - transition_start_temp[zone]) * 60.0f / elapsed);
+            }
+        } else if (elapsed > 2 * SCHEDULE_MAX_LEAD_S) {
+            // Never got there (actuator off or undersized); don't learn
+            transition_active[zone] = false;
+        }
+    }
+
+    if (arrival_due[zone] && reached) {
+        accuracy.last_arrival_s = (int32_t)(now - arrival_due[zone]);
+        accuracy.arrival_valid = true;
+        arrival_due[zone] = 0;
+    }
+}
+
+// Record how close a zone got to an entry by its time. Without a reading
+// there is nothing to score.
+static void record_accuracy(int zone, float temp) {
+    if (isnan(temp)) {
+        return;
+    }
+    float error = temp - climate_controller_zone_get_temp_target(zone);
+
+    accuracy.events++;
+    if (fabsf(error) <= SCHEDULE_TOLERANCE_C) {
+        accuracy.on_time++;
+    }
+    accuracy.last_error_c = error;
+    accuracy.mean_abs_error_c += (fabsf(error) - accuracy.mean_abs_error_c) / accuracy.events;
+}
+
+// Start transitions ahead of their entries, apply due entries and learn
+void schedule_manager_update(time_t now) {
+    int zones = climate_controller_get_zone_count();
+
+    for (int z = 0; z < zones; z++) {
+        // A profile's ramps would teach rates the zone was never asked for
+        if (profile_manager_is_active(z)) {
+            continue;
+        }
+        if (!rates_loaded[z]) {
+            load_rates(z);
+        }
+        float temp = sensor_hal_get_value(z, SENSOR_VALUE_TEMPERATURE);
+        if (!isnan(temp)) {
+            track_transition(z, temp, climate_controller_zone_get_temp_target(z), now);
+        }
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < entry_count; i++) {
+        const schedule_entry_t *entry = &entries[i];
+        int zone = entry->zone;
+        if (zone >= zones || profile_manager_is_active(zone)) {
+            continue;
+        }
+
+        float temp = sensor_hal_get_value(zone, SENSOR_VALUE_TEMPERATURE);
+        time_t at = next_occurrence(entry, now);
+
+        // Start the temperature early enough to be there on time, but not
+        // ahead of an earlier entry of the same zone
+        if (started[i] != at && !earlier_entry_due(i, now, at)) {
+            uint32_t lead = schedule_manager_get_lead_time(zone, temp, entry->temperature);
+            if (now + (time_t)lead >= at) {
+                started[i] = at;
+                arrival_due[zone] = at;
+                climate_controller_zone_set_temp_target(zone, entry->temperature);
+                if (at - now >= 60) {
+                    event_logger_add_zone_fmt(zone, "Schedule: starting %.1f°C %ld min early", false,
+                                              entry->temperature, (long)((at - now) / 60));
+                }
+            }
+        }
+
+        // The rest of the entry applies at its time
+        if (now >= at && applied[i] != at) {
+            applied[i] = at;
+            climate_controller_zone_set_humidity_target(zone, entry->humidity);
+            climate_controller_zone_set_light_target(zone, entry->light);
+            record_accuracy(zone, temp);
+        }
+    }
+    xSemaphoreGive(lock);
+}
+
+// Add an entry
+esp_err_t schedule_manager_add(const schedule_entry_t *entry) {
+    if (entry->zone < 0 || entry->zone >= CLIMATE_MAX_ZONES || entry->day < 1 || entry->day > 7 ||
+        entry->hour < 0 || entry->hour > 23 || entry->minute < 0 || entry->minute > 59) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    if (entry_count < SCHEDULE_MAX_ENTRIES) {
+        entries[entry_count] = *entry;
+        started[entry_count] = 0;
+        applied[entry_count] = 0;
+        entry_count++;
+        ret = ESP_OK;
+    }
+    xSemaphoreGive(lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Max entry limit reached");
+    }
+    return ret;
+}
+
+// Remove the entry at an index. Called with the lock held.
+static esp_err_t remove_entry(int index) {
+    if (index < 0 || index >= entry_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Shift remaining entries
+    for (int i = index; i < entry_count - 1; i++) {
+        entries[i] = entries[i + 1];
+        started[i] = started[i + 1];
+        applied[i] = applied[i + 1];
+    }
+    entry_count--;
+    return ESP_OK;
+}
+
+// Remove the entry of a zone at the given day and time
+esp_err_t schedule_manager_remove(int zone, int day, int hour, int minute) {
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < entry_count; i++) {
+        if (entries[i].zone == zone && entries[i].day == day &&
+            entries[i].hour == hour && entries[i].minute == minute) {
+            ret = remove_entry(i);
+            break;
+        }
+    }
+    xSemaphoreGive(lock);
+    return ret;
+}
+
+// Remove the entry at an index
+esp_err_t schedule_manager_remove_at(int index) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    esp_err_t ret = remove_entry(index);
+    xSemaphoreGive(lock);
+    return ret;
+}
+
+// Get the number of entries
+int schedule_manager_get_count(void) {
+    return entry_count;
+}
+
+// Copy out the entry at an index
+esp_err_t schedule_manager_get(int index, schedule_entry_t *entry) {
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (index >= 0 && index < entry_count) {
+        *entry = entries[index];
+        ret = ESP_OK;
+    }
+    xSemaphoreGive(lock);
+    return ret;
+}
+
+// Get the learned warm-up or cool-down rate of a zone
+void schedule_manager_get_rate(int zone, bool warming, schedule_rate_t *rate) {
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        memset(rate, 0, sizeof(*rate));
+        return;
+    }
+    if (!rates_loaded[zone]) {
+        load_rates(zone);
+    }
+    *rate = rates[warming ? RATE_WARM : RATE_COOL][zone];
+}
+
+// Seconds a zone needs to move from one temperature to another
+uint32_t schedule_manager_get_lead_time(int zone, float from, float to) {
+    // Without a reading the entry starts at its time
+    float distance = fabsf(to - from) - SCHEDULE_TOLERANCE_C;
+    if (isnan(distance) || distance <= 0.0f || zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return 0;
+    }
+    if (!rates_loaded[zone]) {
+        load_rates(zone);
+    }
+
+    float rate = to > from ? planning_rate(&rates[RATE_WARM][zone], SCHEDULE_DEFAULT_WARM_RATE)
+                           : planning_rate(&rates[RATE_COOL][zone], SCHEDULE_DEFAULT_COOL_RATE);
+    float seconds = distance / rate * 60.0f;
+    return seconds > SCHEDULE_MAX_LEAD_S ? SCHEDULE_MAX_LEAD_S : (uint32_t)seconds;
+}
+
+// Get the achieved-versus-scheduled accuracy
+void schedule_manager_get_accuracy(schedule_accuracy_t *out) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    *out = accuracy;
+    xSemaphoreGive(lock);
+}
@@ -0,0 +1,89 @@
+#ifndef SCHEDULE_MANAGER_H
+#define SCHEDULE_MANAGER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+// Weekly schedule entries
+#define SCHEDULE_MAX_ENTRIES 10
+
+// A scheduled temperature counts as reached within this band
+#define SCHEDULE_TOLERANCE_C 0.5f
+
+// Warm-up and cool-down rates assumed until a zone has learned its own (°C/min)
+#define SCHEDULE_DEFAULT_WARM_RATE 0.05f
+#define SCHEDULE_DEFAULT_COOL_RATE 0.03f
+
+// Only transitions at least this large are learned from
+#define SCHEDULE_MIN_TRANSITION_C 1.0f
+
+// Never start a transition more than this far ahead of its entry
+#define SCHEDULE_MAX_LEAD_S (4 * 60 * 60)
+
+// An entry whose time passed less than this ago still fires (covers
+// updates landing just after the minute)
+#define SCHEDULE_GRACE_S 60
+
+// Weekly schedule entry
+typedef struct {
+    int zone;
+    int day;            // 1 = Monday .. 7 = Sunday
+    int hour;
+    int minute;
+    float temperature;
+    float humidity;
+    float light;
+} schedule_entry_t;
+
+// Running mean and variance of a learned rate (Welford)
+typedef struct {
+    uint32_t count;
+    float mean;
+    float m2;
+} schedule_rate_t;
+
+// Achieved-versus-scheduled accuracy over all zones
+typedef struct {
+    uint32_t events;            // Entries whose time has passed
+    uint32_t on_time;           // ... with the zone within tolerance at that time
+    float last_error_c;         // Temperature minus target at the last entry time
+    float mean_abs_error_c;
+    int32_t last_arrival_s;     // When the last transition reached tolerance, relative to its entry (< 0 early)
+    bool arrival_valid;
+} schedule_accuracy_t;
+
+// Initialize the schedule manager and load the learned rates
+void schedule_manager_init(void);
+
+// Add an entry
+esp_err_t schedule_manager_add(const schedule_entry_t *entry);
+
+// Remove the entry of a zone at the given day and time
+esp_err_t schedule_manager_remove(int zone, int day, int hour, int minute);
+
+// Remove the entry at an index
+esp_err_t schedule_manager_remove_at(int index);
+
+// Get the number of entries
+int schedule_manager_get_count(void);
+
+// Copy out the entry at an index; ESP_ERR_INVALID_ARG past the end
+esp_err_t schedule_manager_get(int index, schedule_entry_t *entry);
+
+// Start transitions ahead of their entries, apply due entries and learn
+// from finished transitions. Called from the climate task.
+void schedule_manager_update(time_t now);
+
+// Get the learned warm-up or cool-down rate of a zone
+void schedule_manager_get_rate(int zone, bool warming, schedule_rate_t *rate);
+
+// Seconds a zone needs to move from one temperature to another, from the
+// learned rate less one standard deviation
+uint32_t schedule_manager_get_lead_time(int zone, float from, float to);
+
+// Get the achieved-versus-scheduled accuracy
+void schedule_manager_get_accuracy(schedule_accuracy_t *accuracy);
+
+#endif /* SCHEDULE_MANAGER_H */
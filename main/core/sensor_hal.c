@@ -0,0 +1,577 @@
+#include "sensor_hal.h"
+#include "climate_controller.h"
+#include "data_simulator.h"
+#include "sensor_chips.h"
+#include "sensor_driver.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "sensor_hal";
+
+// Value slots of a zone: the sensor values, then one per probe
+#define SLOT_PROBE(p) (SENSOR_VALUE_COUNT + (p))
+#define SLOT_COUNT (SENSOR_VALUE_COUNT + PROBE_COUNT)
+
+// Largest result read back from a sensor
+#define RESULT_MAX_LEN DS18B20_SCRATCHPAD_LEN
+
+#ifdef REPTICONTROL_SENSOR_HW
+#define SHT4X_I2C_ADDR 0x44
+#define BH1750_I2C_ADDR 0x23
+
+// Board wiring: zone 0's air sensor and light sensor on the sensor I2C bus,
+// its probes on the 1-Wire pin (ROM codes taken in search order)
+static const sensor_config_t default_sensors[] = {
+    { SENSOR_KIND_SHT4X, 0, SHT4X_I2C_ADDR, 0, 0, SENSOR_PROBE_NONE, 250, 4 },
+    { SENSOR_KIND_BH1750, 0, BH1750_I2C_ADDR, 0, 0, SENSOR_PROBE_NONE, 500, 2 },
+    { SENSOR_KIND_DS18B20, 0, 0, 0, 0, PROBE_BASKING, 1000, 1 },
+    { SENSOR_KIND_DS18B20, 0, 0, 0, 0, PROBE_COOL_SIDE, 1000, 1 },
+    { SENSOR_KIND_DS18B20, 0, 0, 0, 0, PROBE_SUBSTRATE, 1000, 1 },
+    { SENSOR_KIND_DS18B20, 0, 0, 0, 0, PROBE_AMBIENT, 1000, 1 },
+};
+#else
+// The simulated enclosures, sampled once per control period
+static const sensor_config_t default_sensors[] = {
+    { SENSOR_KIND_SIMULATOR, 0, 0, 0, 0, SENSOR_PROBE_NONE, CLIMATE_CONTROL_PERIOD_MS, 1 },
+};
+#endif
+
+// Filter per value kind. Temperature and humidity get a median of 3
+// against spikes, then a Kalman filter whose process noise covers a heater
+// step of the simulator (0.3 °C per sample) without gating it. Light steps
+// with the lamp and only gets a light EMA.
+static signal_filter_config_t filter_configs[SENSOR_VALUE_COUNT] = {
+    [SENSOR_VALUE_TEMPERATURE] = { 3, SIGNAL_SMOOTH_KALMAN, 0.0f, 0.02f, 0.01f, 4.0f },
+    [SENSOR_VALUE_HUMIDITY] = { 3, SIGNAL_SMOOTH_KALMAN, 0.0f, 0.1f, 0.05f, 4.0f },
+    [SENSOR_VALUE_LIGHT] = { 1, SIGNAL_SMOOTH_EMA, 0.5f, 0.0f, 0.0f, 0.0f },
+};
+
+static const char *kind_names[SENSOR_KIND_COUNT] = {
+    "Simulator", "SHT3x", "SHT4x", "DS18B20", "BH1750"
+};
+
+// Sensor table and per-sensor acquisition state
+static sensor_config_t sensors[SENSOR_HAL_MAX_SENSORS];
+static int sensor_count = 0;
+static int64_t next_sample_us[SENSOR_HAL_MAX_SENSORS];
+static int64_t ready_us[SENSOR_HAL_MAX_SENSORS];
+static bool converting[SENSOR_HAL_MAX_SENSORS];
+static uint8_t result[SENSOR_HAL_MAX_SENSORS][RESULT_MAX_LEN];
+static float sums[SENSOR_HAL_MAX_SENSORS][SENSOR_VALUE_COUNT];
+static uint8_t summed[SENSOR_HAL_MAX_SENSORS];
+static bool searched[SENSOR_HAL_MAX_BUSES];
+
+// Latest value of each zone slot and when it was taken; written by the
+// sensor task, read by the climate task
+static float values[SLOT_COUNT][CLIMATE_MAX_ZONES];
+static float unfiltered[SENSOR_VALUE_COUNT][CLIMATE_MAX_ZONES];   // For the safety interlock
+static int64_t updated_us[SLOT_COUNT][CLIMATE_MAX_ZONES];
+static int64_t last_poll_us = 0;
+static sensor_hal_stats_t stats;
+static portMUX_TYPE value_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Filter stage: one channel per zone slot, settings and counters per kind
+static signal_filter_t filters[SLOT_COUNT][CLIMATE_MAX_ZONES];
+static signal_filter_stats_t filter_stats[SENSOR_VALUE_COUNT];
+static int64_t filter_interval_us[SENSOR_VALUE_COUNT];
+
+// Simulator samples of every zone, filtered a slot at a time
+static float sim_raw[SLOT_COUNT][CLIMATE_MAX_ZONES];
+static float sim_filtered[CLIMATE_MAX_ZONES];
+
+// Value kind of a slot
+static sensor_value_t slot_kind(int slot) {
+    return slot >= SENSOR_VALUE_COUNT ? SENSOR_VALUE_TEMPERATURE : (sensor_value_t)slot;
+}
+
+// Store a filtered value of a zone slot, and the zone values unfiltered
+static void store(int zone, int slot, float value, float raw, int64_t now_us) {
+    portENTER_CRITICAL(&value_lock);
+    if (zone == 0 && slot < SENSOR_VALUE_COUNT && updated_us[slot][0] != INT64_MIN) {
+        filter_interval_us[slot] = now_us - updated_us[slot][0];
+    }
+    if (slot < SENSOR_VALUE_COUNT) {
+        unfiltered[slot][zone] = raw;
+    }
+    values[slot][zone] = value;
+    updated_us[slot][zone] = now_us;
+    portEXIT_CRITICAL(&value_lock);
+}
+
+// Filter and store a value of a zone slot
+static void publish(int zone, int slot, float value, int64_t now_us) {
+    sensor_value_t kind = slot_kind(slot);
+    store(zone, slot, signal_filter_update(&filters[slot][zone], &filter_configs[kind], value,
+                                           &filter_stats[kind]), value, now_us);
+}
+
+// Add a raw sample of a sensor; every decimation samples, hand on the average
+static void accumulate(int i, const float *sample, int64_t now_us) {
+    const sensor_config_t *sensor = &sensors[i];
+
+    stats.samples++;
+    for (int v = 0; v < SENSOR_VALUE_COUNT; v++) {
+        sums[i][v] += sample[v];
+    }
+    if (++summed[i] < sensor->decimation) {
+        return;
+    }
+
+    // Values the chip does not measure summed to NaN
+    for (int v = 0; v < SENSOR_VALUE_COUNT; v++) {
+        if (isnan(sums[i][v])) {
+            continue;
+        }
+        int slot = v == SENSOR_VALUE_TEMPERATURE && sensor->probe != SENSOR_PROBE_NONE ?
+                   SLOT_PROBE(sensor->probe) : v;
+        publish(sensor->zone, slot, sums[i][v] / summed[i], now_us);
+    }
+    memset(sums[i], 0, sizeof(sums[i]));
+    summed[i] = 0;
+    stats.values++;
+}
+
+// Move a sensor's next sample one period on, without catching up on missed ones
+static void schedule_next(int i, int64_t now_us) {
+    int64_t period_us = (int64_t)sensors[i].period_ms * 1000;
+
+    next_sample_us[i] += period_us;
+    if (next_sample_us[i] <= now_us) {
+        next_sample_us[i] = now_us + period_us;
+    }
+}
+
+// Fetch the results due on an I2C bus and start the conversions due, all
+// in one batch. Results go first, so a sensor can start its next
+// conversion in the same batch.
+static void poll_i2c(int bus, int64_t now_us) {
+    sensor_i2c_transaction_t batch[SENSOR_HAL_BATCH_LEN];
+    int owner[SENSOR_HAL_BATCH_LEN];
+    int n = 0;
+
+    for (int i = 0; i < sensor_count && n < SENSOR_HAL_BATCH_LEN; i++) {
+        const sensor_i2c_chip_t *chip = sensor_chips_get_i2c(sensors[i].kind);
+        if (chip == NULL || sensors[i].bus != bus || !converting[i] || ready_us[i] > now_us) {
+            continue;
+        }
+        batch[n] = (sensor_i2c_transaction_t){ .address = sensors[i].address, .rx = result[i],
+                                               .rx_len = chip->result_len };
+        owner[n++] = i;
+        converting[i] = false;
+    }
+    for (int i = 0; i < sensor_count && n < SENSOR_HAL_BATCH_LEN; i++) {
+        const sensor_i2c_chip_t *chip = sensor_chips_get_i2c(sensors[i].kind);
+        if (chip == NULL || sensors[i].bus != bus || converting[i] || next_sample_us[i] > now_us) {
+            continue;
+        }
+        batch[n] = (sensor_i2c_transaction_t){ .address = sensors[i].address,
+                                               .tx_len = chip->command_len };
+        memcpy(batch[n].tx, chip->command, chip->command_len);
+        owner[n++] = i;
+    }
+    if (n == 0) {
+        return;
+    }
+
+    sensor_driver_i2c_batch(bus, batch, n);
+    stats.i2c_batches++;
+    stats.i2c_transactions += n;
+
+    for (int t = 0; t < n; t++) {
+        int i = owner[t];
+        const sensor_i2c_chip_t *chip = sensor_chips_get_i2c(sensors[i].kind);
+
+        if (batch[t].rx_len > 0) {
+            float sample[SENSOR_VALUE_COUNT] = { NAN, NAN, NAN };
+            if (batch[t].result != ESP_OK || !chip->decode(result[i], sample)) {
+                stats.errors++;
+                continue;
+            }
+            sample[SENSOR_VALUE_LIGHT] *= 100.0f / SENSOR_LIGHT_FULL_SCALE_LUX;
+            accumulate(i, sample, now_us);
+        } else {
+            // A sensor that did not take the command is tried again next period
+            if (batch[t].result == ESP_OK) {
+                converting[i] = true;
+                ready_us[i] = now_us + (int64_t)chip->conversion_ms * 1000;
+            } else {
+                stats.errors++;
+            }
+            schedule_next(i, now_us);
+        }
+    }
+}
+
+// Find the DS18B20 ROM codes on a bus (Search ROM) and hand them to the
+// probes of the table left at rom 0, in search order
+static void search_onewire(int bus) {
+    uint64_t found[SENSOR_HAL_MAX_SENSORS];
+    int found_count = 0;
+    int last_discrepancy = -1;
+    uint64_t rom = 0;
+
+    searched[bus] = true;
+    do {
+        int discrepancy = -1;
+        uint8_t command = DS18B20_CMD_SEARCH_ROM;
+
+        if (sensor_driver_onewire_reset(bus) != ESP_OK) {
+            break;
+        }
+        sensor_driver_onewire_write(bus, &command, 1);
+        for (int b = 0; b < 64; b++) {
+            bool id = sensor_driver_onewire_read_bit(bus);
+            bool complement = sensor_driver_onewire_read_bit(bus);
+            bool dir;
+
+            if (id && complement) {
+                last_discrepancy = -1;
+                rom = 0;
+                break;
+            }
+            if (id != complement) {
+                dir = id;
+            } else {
+                // Devices differ here: take 0 first, then 1 on the next pass
+                dir = b < last_discrepancy ? (rom >> b) & 1 : b == last_discrepancy;
+                if (!dir) {
+                    discrepancy = b;
+                }
+            }
+            rom = dir ? rom | 1ULL << b : rom & ~(1ULL << b);
+            sensor_driver_onewire_write_bit(bus, dir);
+        }
+        if (rom == 0) {
+            break;
+        }
+        last_discrepancy = discrepancy;
+
+        uint8_t bytes[8];
+        for (int k = 0; k < 8; k++) {
+            bytes[k] = (uint8_t)(rom >> (8 * k));
+        }
+        if (sensor_chips_crc_dallas(bytes, 7) == bytes[7] && bytes[0] == DS18B20_FAMILY) {
+            found[found_count++] = rom;
+        } else {
+            stats.errors++;
+        }
+    } while (last_discrepancy >= 0 && found_count < SENSOR_HAL_MAX_SENSORS);
+
+    // ROM codes named in the table are not handed out again
+    int next = 0;
+    for (int i = 0; i < sensor_count; i++) {
+        if (sensors[i].kind != SENSOR_KIND_DS18B20 || sensors[i].bus != bus || sensors[i].rom != 0) {
+            continue;
+        }
+        while (next < found_count) {
+            bool taken = false;
+            for (int j = 0; j < sensor_count; j++) {
+                taken |= sensors[j].kind == SENSOR_KIND_DS18B20 && sensors[j].bus == bus &&
+                         sensors[j].rom == found[next];
+            }
+            if (!taken) {
+                break;
+            }
+            next++;
+        }
+        if (next >= found_count) {
+            ESP_LOGW(TAG, "No DS18B20 found for probe %d of zone %d", sensors[i].probe, sensors[i].zone + 1);
+            continue;
+        }
+        sensors[i].rom = found[next++];
+        ESP_LOGI(TAG, "DS18B20 %016llx is probe %d of zone %d", (unsigned long long)sensors[i].rom,
+                 sensors[i].probe, sensors[i].zone + 1);
+    }
+}
+
+// Read the scratchpad of one DS18B20 (Skip ROM when its code is unknown,
+// which only works with a single device on the bus)
+static bool read_ds18b20(int i, float *temperature) {
+    int bus = sensors[i].bus;
+    uint8_t command[10];
+    int len = 0;
+
+    if (sensor_driver_onewire_reset(bus) != ESP_OK) {
+        return false;
+    }
+    if (sensors[i].rom != 0) {
+        command[len++] = DS18B20_CMD_MATCH_ROM;
+        for (int k = 0; k < 8; k++) {
+            command[len++] = (uint8_t)(sensors[i].rom >> (8 * k));
+        }
+    } else {
+        command[len++] = DS18B20_CMD_SKIP_ROM;
+    }
+    command[len++] = DS18B20_CMD_READ_SCRATCHPAD;
+    sensor_driver_onewire_write(bus, command, len);
+    sensor_driver_onewire_read(bus, result[i], DS18B20_SCRATCHPAD_LEN);
+    return sensor_chips_decode_ds18b20(result[i], temperature);
+}
+
+// Read the DS18B20s of a 1-Wire bus whose conversion is done, and start
+// one broadcast conversion for all of them when any is due
+static void poll_onewire(int bus, int64_t now_us) {
+    bool due = false;
+    bool any = false;
+
+    for (int i = 0; i < sensor_count; i++) {
+        if (sensors[i].kind != SENSOR_KIND_DS18B20 || sensors[i].bus != bus) {
+            continue;
+        }
+        any = true;
+        if (converting[i] && ready_us[i] <= now_us) {
+            float sample[SENSOR_VALUE_COUNT] = { NAN, NAN, NAN };
+            converting[i] = false;
+            if (read_ds18b20(i, &sample[SENSOR_VALUE_TEMPERATURE])) {
+                accumulate(i, sample, now_us);
+            } else {
+                stats.errors++;
+            }
+        }
+        due |= !converting[i] && next_sample_us[i] <= now_us;
+    }
+    if (!any) {
+        return;
+    }
+    if (!searched[bus]) {
+        search_onewire(bus);
+    }
+    if (!due) {
+        return;
+    }
+
+    // Every probe converts at once, so probes due together cost one 750 ms
+    // wait between them instead of one each
+    bool started = sensor_driver_onewire_reset(bus) == ESP_OK;
+    if (started) {
+        const uint8_t command[2] = { DS18B20_CMD_SKIP_ROM, DS18B20_CMD_CONVERT };
+        sensor_driver_onewire_write(bus, command, sizeof(command));
+        stats.onewire_conversions++;
+    }
+    for (int i = 0; i < sensor_count; i++) {
+        if (sensors[i].kind != SENSOR_KIND_DS18B20 || sensors[i].bus != bus || converting[i] ||
+            next_sample_us[i] > now_us) {
+            continue;
+        }
+        if (started) {
+            converting[i] = true;
+            ready_us[i] = now_us + DS18B20_CONVERSION_MS * 1000LL;
+        } else {
+            stats.errors++;
+        }
+        schedule_next(i, now_us);
+    }
+}
+
+// Take a sample of every active simulated zone
+static void poll_simulator(int i, int64_t now_us) {
+    int zones = climate_controller_get_zone_count();
+
+    if (next_sample_us[i] > now_us) {
+        return;
+    }
+    for (int z = 0; z < zones; z++) {
+        float probes[PROBE_COUNT];
+        data_simulator_get_zone_probes(z, probes);
+        sim_raw[SENSOR_VALUE_TEMPERATURE][z] = data_simulator_get_zone_temperature(z);
+        sim_raw[SENSOR_VALUE_HUMIDITY][z] = data_simulator_get_zone_humidity(z);
+        sim_raw[SENSOR_VALUE_LIGHT][z] = data_simulator_get_zone_light(z);
+        for (int p = 0; p < PROBE_COUNT; p++) {
+            sim_raw[SLOT_PROBE(p)][z] = probes[p];
+        }
+    }
+
+    // One filter pass per slot across the zones
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        sensor_value_t kind = slot_kind(slot);
+        signal_filter_update_batch(filters[slot], &filter_configs[kind], sim_raw[slot], sim_filtered, zones,
+                                   &filter_stats[kind]);
+        for (int z = 0; z < zones; z++) {
+            store(z, slot, sim_filtered[z], sim_raw[slot][z], now_us);
+        }
+    }
+    stats.samples++;
+    stats.values++;
+    schedule_next(i, now_us);
+}
+
+// Initialize from the board's table
+esp_err_t sensor_hal_init(void) {
+    return sensor_hal_set_sensors(default_sensors, sizeof(default_sensors) / sizeof(default_sensors[0]));
+}
+
+// Replace the sensor table
+esp_err_t sensor_hal_set_sensors(const sensor_config_t *table, int count) {
+    if (count < 0 || count > SENSOR_HAL_MAX_SENSORS) {
+        ESP_LOGE(TAG, "Sensor table of %d entries, at most %d", count, SENSOR_HAL_MAX_SENSORS);
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < count; i++) {
+        const sensor_config_t *s = &table[i];
+        const sensor_i2c_chip_t *chip = sensor_chips_get_i2c(s->kind);
+        uint16_t conversion_ms = chip != NULL ? chip->conversion_ms :
+                                 s->kind == SENSOR_KIND_DS18B20 ? DS18B20_CONVERSION_MS : 0;
+
+        if (s->kind >= SENSOR_KIND_COUNT || s->bus >= SENSOR_HAL_MAX_BUSES ||
+            s->zone >= CLIMATE_MAX_ZONES || s->probe < SENSOR_PROBE_NONE || s->probe >= PROBE_COUNT ||
+            s->decimation == 0 || s->period_ms == 0) {
+            ESP_LOGE(TAG, "Sensor %d: invalid entry", i);
+            return ESP_ERR_INVALID_ARG;
+        }
+        // A shorter period would start the next conversion before the last is read
+        if (s->period_ms < conversion_ms) {
+            ESP_LOGE(TAG, "Sensor %d: %s needs a period of %u ms or more", i, kind_names[s->kind],
+                     conversion_ms);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    memcpy(sensors, table, count * sizeof(table[0]));
+    sensor_count = count;
+    for (int i = 0; i < count; i++) {
+        next_sample_us[i] = INT64_MIN;
+        converting[i] = false;
+        summed[i] = 0;
+        memset(sums[i], 0, sizeof(sums[i]));
+    }
+    memset(searched, 0, sizeof(searched));
+    memset(&stats, 0, sizeof(stats));
+    memset(filters, 0, sizeof(filters));
+    memset(filter_stats, 0, sizeof(filter_stats));
+    memset(filter_interval_us, 0, sizeof(filter_interval_us));
+
+    portENTER_CRITICAL(&value_lock);
+    for (int s = 0; s < SLOT_COUNT; s++) {
+        for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+            values[s][z] = NAN;
+            updated_us[s][z] = INT64_MIN;
+        }
+    }
+    portEXIT_CRITICAL(&value_lock);
+
+    ESP_LOGI(TAG, "%d sensors (%s first)", count, count > 0 ? kind_names[table[0].kind] : "none");
+    return sensor_driver_init();
+}
+
+// Start and fetch whatever is due
+int64_t sensor_hal_poll(int64_t now_us) {
+    int64_t start_us = esp_timer_get_time();
+    int64_t next_us = now_us + (int64_t)CLIMATE_CONTROL_PERIOD_MS * 1000;
+
+    portENTER_CRITICAL(&value_lock);
+    last_poll_us = now_us;
+    portEXIT_CRITICAL(&value_lock);
+
+    for (int bus = 0; bus < SENSOR_HAL_MAX_BUSES; bus++) {
+        poll_i2c(bus, now_us);
+        poll_onewire(bus, now_us);
+    }
+    for (int i = 0; i < sensor_count; i++) {
+        if (sensors[i].kind == SENSOR_KIND_SIMULATOR) {
+            poll_simulator(i, now_us);
+        }
+    }
+
+    for (int i = 0; i < sensor_count; i++) {
+        int64_t at = converting[i] ? ready_us[i] : next_sample_us[i];
+        if (at < next_us) {
+            next_us = at;
+        }
+    }
+
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start_us);
+    stats.polls++;
+    if (elapsed > stats.poll_max_us) {
+        stats.poll_max_us = elapsed;
+    }
+    return next_us;
+}
+
+// Read a zone slot, filtered or not, NaN once stale
+static float read_slot(int zone, int slot, bool filtered) {
+    float value = NAN;
+
+    if (zone < 0 || zone >= CLIMATE_MAX_ZONES) {
+        return NAN;
+    }
+    portENTER_CRITICAL(&value_lock);
+    if (updated_us[slot][zone] != INT64_MIN &&
+        last_poll_us - updated_us[slot][zone] <= SENSOR_HAL_STALE_MS * 1000LL) {
+        value = filtered ? values[slot][zone] : unfiltered[slot][zone];
+    }
+    portEXIT_CRITICAL(&value_lock);
+    return value;
+}
+
+// Read a filtered zone slot
+static float slot_value(int zone, int slot) {
+    return read_slot(zone, slot, true);
+}
+
+// Get the latest values of a zone
+void sensor_hal_get_zone(int zone, sensor_zone_t *out) {
+    for (int v = 0; v < SENSOR_VALUE_COUNT; v++) {
+        out->value[v] = slot_value(zone, v);
+    }
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        out->probes[p] = slot_value(zone, SLOT_PROBE(p));
+    }
+}
+
+// Get one value of a zone
+float sensor_hal_get_value(int zone, sensor_value_t value) {
+    return slot_value(zone, value);
+}
+
+// Get one value of a zone before the filter stage
+float sensor_hal_get_unfiltered(int zone, sensor_value_t value) {
+    return value < SENSOR_VALUE_COUNT ? read_slot(zone, value, false) : NAN;
+}
+
+// Room temperature from zone 0's ambient probe
+float sensor_hal_get_ambient(void) {
+    return slot_value(0, SLOT_PROBE(PROBE_AMBIENT));
+}
+
+// Set the filter of a value kind
+void sensor_hal_set_filter(sensor_value_t value, const signal_filter_config_t *config) {
+    if (value >= SENSOR_VALUE_COUNT) {
+        return;
+    }
+    filter_configs[value] = *config;
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        if (slot_kind(slot) != value) {
+            continue;
+        }
+        for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+            signal_filter_reset(&filters[slot][z]);
+        }
+    }
+    memset(&filter_stats[value], 0, sizeof(filter_stats[value]));
+}
+
+// Get the filter of a value kind
+void sensor_hal_get_filter(sensor_value_t value, signal_filter_config_t *config) {
+    *config = filter_configs[value];
+}
+
+// Get how much a value kind's filter delays and smooths
+void sensor_hal_get_filter_report(sensor_value_t value, sensor_filter_report_t *report) {
+    report->stats = filter_stats[value];
+    report->noise_ratio = signal_filter_get_noise_ratio(&filter_stats[value]);
+    report->lag_ms = signal_filter_get_lag(&filters[value][0], &filter_configs[value]) *
+                     filter_interval_us[value] / 1000.0f;
+}
+
+// Get the work done and faults seen
+void sensor_hal_get_stats(sensor_hal_stats_t *out) {
+    *out = stats;
+}
+
+// Display name of a sensor kind
+const char *sensor_hal_get_kind_name(sensor_kind_t kind) {
+    return kind < SENSOR_KIND_COUNT ? kind_names[kind] : "Unknown";
+}
@@ -0,0 +1,141 @@
+#ifndef SENSOR_HAL_H
+#define SENSOR_HAL_H
+
+#include "esp_err.h"
+#include "probe_manager.h"
+#include "signal_filter.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Sensor hardware abstraction. A table maps each sensor to a zone and a
+// driver; sensor_hal_poll() never waits on a sensor. A conversion is
+// started on one poll and its result fetched on a later one, once the
+// conversion time has passed. The I2C transactions due on a poll run as
+// one batch per bus. The DS18B20s on a 1-Wire bus convert together on one
+// broadcast. Each sensor has its own sample period, and its raw samples
+// are averaged over its decimation factor. Each zone value then passes a
+// filter stage (signal_filter.h) before the controller sees it: a short
+// median against spikes, then an EMA or a gated Kalman filter.
+
+// Sensors in a table
+#ifndef SENSOR_HAL_MAX_SENSORS
+#define SENSOR_HAL_MAX_SENSORS 16
+#endif
+
+// I2C and 1-Wire buses
+#define SENSOR_HAL_MAX_BUSES 2
+
+// I2C transactions run per bus and poll; the rest wait for the next poll
+#define SENSOR_HAL_BATCH_LEN 16
+
+// A value not refreshed for this long reads as NaN
+#ifndef SENSOR_HAL_STALE_MS
+#define SENSOR_HAL_STALE_MS 5000
+#endif
+
+// BH1750 illuminance read as 100 % light
+#ifndef SENSOR_LIGHT_FULL_SCALE_LUX
+#define SENSOR_LIGHT_FULL_SCALE_LUX 10000.0f
+#endif
+
+// Sensor kinds, each with its own driver
+typedef enum {
+    SENSOR_KIND_SIMULATOR,      // Every active zone of data_simulator.c at once, undecimated
+    SENSOR_KIND_SHT3X,          // I2C temperature and humidity
+    SENSOR_KIND_SHT4X,          // I2C temperature and humidity
+    SENSOR_KIND_DS18B20,        // 1-Wire temperature probe
+    SENSOR_KIND_BH1750,         // I2C illuminance
+    SENSOR_KIND_COUNT
+} sensor_kind_t;
+
+// Values a zone gets from its sensors
+typedef enum {
+    SENSOR_VALUE_TEMPERATURE,   // Air temperature (°C)
+    SENSOR_VALUE_HUMIDITY,      // %RH
+    SENSOR_VALUE_LIGHT,         // % of SENSOR_LIGHT_FULL_SCALE_LUX
+    SENSOR_VALUE_COUNT
+} sensor_value_t;
+
+// probe of a sensor whose temperature is the zone's air temperature
+#define SENSOR_PROBE_NONE (-1)
+
+// One sensor of the table
+typedef struct {
+    sensor_kind_t kind;
+    uint8_t bus;                // I2C or 1-Wire bus index
+    uint8_t address;            // I2C address
+    uint64_t rom;               // DS18B20 ROM code; 0 takes the next one found on the bus
+    uint8_t zone;
+    int8_t probe;               // probe_t its temperature goes to, or SENSOR_PROBE_NONE
+    uint16_t period_ms;         // Raw sample period
+    uint8_t decimation;         // Raw samples averaged into one value (1 for none)
+} sensor_config_t;
+
+// Latest values of a zone, NaN where missing or stale
+typedef struct {
+    float value[SENSOR_VALUE_COUNT];
+    float probes[PROBE_COUNT];
+} sensor_zone_t;
+
+// Work done and faults seen since the table was set
+typedef struct {
+    uint32_t polls;
+    uint32_t i2c_batches;       // One per bus and poll with work
+    uint32_t i2c_transactions;
+    uint32_t onewire_conversions; // Broadcast conversions (all probes of a bus)
+    uint32_t samples;           // Raw samples read
+    uint32_t values;            // Decimated values handed on
+    uint32_t errors;            // NACKs, CRC failures, missing devices
+    uint32_t poll_max_us;
+} sensor_hal_stats_t;
+
+// Filtering of one value kind; probes count as temperature
+typedef struct {
+    signal_filter_stats_t stats;
+    float lag_ms;               // Zone 0's output lag behind a ramp
+    float noise_ratio;          // Output over input sample-to-sample noise
+} sensor_filter_report_t;
+
+// Initialize from the board's table: the simulator, or the real sensors
+// when built with REPTICONTROL_SENSOR_HW
+esp_err_t sensor_hal_init(void);
+
+// Replace the sensor table (tests and other boards); all values go NaN
+esp_err_t sensor_hal_set_sensors(const sensor_config_t *sensors, int count);
+
+// Start and fetch whatever is due at now_us (esp_timer time). Returns the
+// time the next conversion is ready or sample is due; the sensor task
+// sleeps until then.
+int64_t sensor_hal_poll(int64_t now_us);
+
+// Get the latest values of a zone
+void sensor_hal_get_zone(int zone, sensor_zone_t *values);
+
+// Get one value of a zone, NaN where missing or stale
+float sensor_hal_get_value(int zone, sensor_value_t value);
+
+// Get one value of a zone as sampled (after decimation), before the filter
+// stage; NaN where missing or stale. The safety interlock reads these, so
+// the median and Kalman gate never delay a cut.
+float sensor_hal_get_unfiltered(int zone, sensor_value_t value);
+
+// Room temperature: zone 0's ambient probe, NaN without one
+float sensor_hal_get_ambient(void);
+
+// Set the filter of a value kind (probes count as temperature); its
+// channels restart from their next sample
+void sensor_hal_set_filter(sensor_value_t value, const signal_filter_config_t *config);
+
+// Get the filter of a value kind
+void sensor_hal_get_filter(sensor_value_t value, signal_filter_config_t *config);
+
+// Get how much a value kind's filter delays and smooths
+void sensor_hal_get_filter_report(sensor_value_t value, sensor_filter_report_t *report);
+
+// Get the work done and faults seen
+void sensor_hal_get_stats(sensor_hal_stats_t *stats);
+
+// Display name of a sensor kind
+const char *sensor_hal_get_kind_name(sensor_kind_t kind);
+
+#endif /* SENSOR_HAL_H */
@@ -3,6 +3,7 @@
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "event_logger.h"
+#include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "settings_manager";
@@ -132,6 +133,15 @@ void settings_set_int(const char* key, int value) {
     }
 }
 
+// Build the key of a per-zone setting
+const char *settings_zone_key(char *buf, const char *key, int zone) {
+    if (zone == 0) {
+        return key;
+    }
+    snprintf(buf, SETTINGS_KEY_MAX_LEN, "z%d_%s", zone, key);
+    return buf;
+}
+
 bool settings_has_key(const char* key) {
     int32_t dummy;
     esp_err_t err = nvs_get_i32(settings_handle, key, &dummy);
@@ -2,6 +2,7 @@
 #define SETTINGS_MANAGER_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 // Settings keys
 #define SETTINGS_KEY_TEMP_TARGET "temp_target"
@@ -11,6 +12,67 @@
 #define SETTINGS_KEY_COOLING_ENABLED "cooling_enabled"
 #define SETTINGS_KEY_HUMIDIFIER_ENABLED "humidifier_enabled"
 #define SETTINGS_KEY_LIGHTING_ENABLED "lighting_enabled"
+#define SETTINGS_KEY_HEATING_MODE "heat_mode"
+#define SETTINGS_KEY_COOLING_MODE "cool_mode"
+#define SETTINGS_KEY_HUMIDIFIER_MODE "humid_mode"
+#define SETTINGS_KEY_TEMP_KP "temp_kp"
+#define SETTINGS_KEY_TEMP_KI "temp_ki"
+#define SETTINGS_KEY_TEMP_KD "temp_kd"
+#define SETTINGS_KEY_HUMIDITY_KP "hum_kp"
+#define SETTINGS_KEY_HUMIDITY_KI "hum_ki"
+#define SETTINGS_KEY_HUMIDITY_KD "hum_kd"
+#define SETTINGS_KEY_ZONE_COUNT "zone_count"
+#define SETTINGS_KEY_WARM_RATE "warm_rate"
+#define SETTINGS_KEY_WARM_COUNT "warm_n"
+#define SETTINGS_KEY_WARM_M2 "warm_m2"
+#define SETTINGS_KEY_COOL_RATE "cool_rate"
+#define SETTINGS_KEY_COOL_COUNT "cool_n"
+#define SETTINGS_KEY_COOL_M2 "cool_m2"
+#define SETTINGS_KEY_PROBE_FUSION "probe_fuse"
+#define SETTINGS_KEY_PROBE_FITTED "probes"
+#define SETTINGS_KEY_PROBE_GRADIENT "gradient"
+#define SETTINGS_KEY_BASKING_WEIGHT "w_bask"
+#define SETTINGS_KEY_COOL_SIDE_WEIGHT "w_cool"
+#define SETTINGS_KEY_SUBSTRATE_WEIGHT "w_subst"
+#define SETTINGS_KEY_AMBIENT_WEIGHT "w_amb"
+#define SETTINGS_KEY_LATITUDE "latitude"
+#define SETTINGS_KEY_LONGITUDE "longitude"
+#define SETTINGS_KEY_PROFILE_ENABLED "prof_on"
+#define SETTINGS_KEY_DAY_TEMP "day_temp"
+#define SETTINGS_KEY_NIGHT_TEMP "night_temp"
+#define SETTINGS_KEY_DAY_HUMIDITY "day_hum"
+#define SETTINGS_KEY_NIGHT_HUMIDITY "night_hum"
+#define SETTINGS_KEY_DAY_LIGHT "day_light"
+#define SETTINGS_KEY_RAMP_MIN "ramp_min"
+#define SETTINGS_KEY_BRUMATION_START "brum_start"
+#define SETTINGS_KEY_BRUMATION_DAYS "brum_days"
+#define SETTINGS_KEY_BRUMATION_DROP "brum_drop"
+#define SETTINGS_KEY_MIST_CAP "mist_cap"
+#define SETTINGS_KEY_VPD_TARGET "vpd_tgt"
+#define SETTINGS_KEY_HEATING_WATTS "heat_w"
+#define SETTINGS_KEY_COOLING_WATTS "cool_w"
+#define SETTINGS_KEY_HUMIDIFIER_WATTS "humid_w"
+#define SETTINGS_KEY_LIGHTING_WATTS "light_w"
+#define SETTINGS_KEY_HEATING_WH "heat_wh"
+#define SETTINGS_KEY_COOLING_WH "cool_wh"
+#define SETTINGS_KEY_HUMIDIFIER_WH "humid_wh"
+#define SETTINGS_KEY_LIGHTING_WH "light_wh"
+#define SETTINGS_KEY_HEATING_ON_S "heat_on_s"
+#define SETTINGS_KEY_COOLING_ON_S "cool_on_s"
+#define SETTINGS_KEY_HUMIDIFIER_ON_S "humid_on_s"
+#define SETTINGS_KEY_LIGHTING_ON_S "light_on_s"
+#define SETTINGS_KEY_HEATING_CYCLES "heat_cyc"
+#define SETTINGS_KEY_COOLING_CYCLES "cool_cyc"
+#define SETTINGS_KEY_HUMIDIFIER_CYCLES "humid_cyc"
+#define SETTINGS_KEY_LIGHTING_CYCLES "light_cyc"
+#define SETTINGS_KEY_TEMP_MIN "temp_min"
+#define SETTINGS_KEY_TEMP_MAX "temp_max"
+#define SETTINGS_KEY_HUMIDITY_MIN "hum_min"
+#define SETTINGS_KEY_HUMIDITY_MAX "hum_max"
+#define SETTINGS_KEY_PHOTOPERIOD "photoperiod"
+
+// Longest NVS key including the terminator
+#define SETTINGS_KEY_MAX_LEN 16
 
 // Initialize settings manager
 void settings_init(void);
@@ -39,6 +101,11 @@ int settings_get_int(const char* key, int default_value);
 // Set integer value
 void settings_set_int(const char* key, int value);
 
+// Build the key of a per-zone setting into buf (SETTINGS_KEY_MAX_LEN bytes).
+// Zone 0 keeps the plain key so single-zone settings carry over; other zones
+// get a "z<n>_" prefix.
+const char *settings_zone_key(char *buf, const char *key, int zone);
+
 // Check if a key exists in NVS
 bool settings_has_key(const char* key);
 
@@ -0,0 +1,142 @@
+#include "signal_filter.h"
+#include <math.h>
+#include <string.h>
+
+// Weight of the newest squared change in the noise averages (about the
+// last 64 samples)
+#define NOISE_WEIGHT (1.0f / 64.0f)
+
+// Clear a channel
+void signal_filter_reset(signal_filter_t *filter) {
+    memset(filter, 0, sizeof(*filter));
+}
+
+// Median of the samples in the window; the mean of the middle two while
+// an even number has arrived
+static float window_median(const signal_filter_t *filter) {
+    float sorted[SIGNAL_MEDIAN_MAX];
+    int n = filter->filled;
+
+    for (int i = 0; i < n; i++) {
+        float v = filter->window[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return n % 2 ? sorted[n / 2] : 0.5f * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+// Median window length of a config, bounded to what a channel holds
+static int median_len(const signal_filter_config_t *config) {
+    int len = config->median_len;
+    return len < 1 ? 1 : len > SIGNAL_MEDIAN_MAX ? SIGNAL_MEDIAN_MAX : len;
+}
+
+// Kalman step on the random-walk model; gated innovations keep the prediction
+static void kalman_step(signal_filter_t *filter, const signal_filter_config_t *config, float z,
+                        signal_filter_stats_t *stats) {
+    float p = filter->variance + config->kalman_q;
+    float innovation = z - filter->estimate;
+    float s = p + config->kalman_r;
+    float gate = config->kalman_gate;
+
+    if (gate > 0.0f && innovation * innovation > gate * gate * s) {
+        if (++filter->rejected_run < SIGNAL_KALMAN_REJECT_LIMIT) {
+            filter->variance = p;
+            if (stats != NULL) {
+                stats->gated++;
+            }
+            return;
+        }
+        // Rejected again and again: the signal really moved
+        filter->estimate = z;
+        filter->variance = config->kalman_r;
+        filter->rejected_run = 0;
+        if (stats != NULL) {
+            stats->restarts++;
+        }
+        return;
+    }
+
+    float k = p / s;
+    filter->rejected_run = 0;
+    filter->estimate += k * innovation;
+    filter->variance = (1.0f - k) * p;
+}
+
+// Filter one sample
+float signal_filter_update(signal_filter_t *filter, const signal_filter_config_t *config, float sample,
+                           signal_filter_stats_t *stats) {
+    int len = median_len(config);
+
+    if (isnan(sample)) {
+        if (filter->primed && stats != NULL) {
+            stats->restarts++;
+        }
+        signal_filter_reset(filter);
+        return NAN;
+    }
+
+    filter->window[filter->next] = sample;
+    filter->next = (uint8_t)((filter->next + 1) % len);
+    if (filter->filled < len) {
+        filter->filled++;
+    }
+    float z = len > 1 ? window_median(filter) : sample;
+    bool had_sample = filter->primed;
+
+    if (!had_sample) {
+        filter->estimate = z;
+        filter->variance = config->kalman_r;
+        filter->primed = true;
+    } else if (config->smooth == SIGNAL_SMOOTH_EMA) {
+        filter->estimate += config->ema_alpha * (z - filter->estimate);
+    } else if (config->smooth == SIGNAL_SMOOTH_KALMAN) {
+        kalman_step(filter, config, z, stats);
+    } else {
+        filter->estimate = z;
+    }
+
+    if (stats != NULL) {
+        if (had_sample) {
+            float in_step = sample - filter->last_in;
+            float out_step = filter->estimate - filter->last_out;
+            stats->in_noise += NOISE_WEIGHT * (in_step * in_step - stats->in_noise);
+            stats->out_noise += NOISE_WEIGHT * (out_step * out_step - stats->out_noise);
+        }
+        stats->samples++;
+    }
+    filter->last_in = sample;
+    filter->last_out = filter->estimate;
+    return filter->estimate;
+}
+
+// Filter one sample of each channel
+void signal_filter_update_batch(signal_filter_t *filters, const signal_filter_config_t *config,
+                                const float *in, float *out, int count, signal_filter_stats_t *stats) {
+    for (int i = 0; i < count; i++) {
+        out[i] = signal_filter_update(&filters[i], config, in[i], stats);
+    }
+}
+
+// Lag of a channel's output behind a ramp, in samples
+float signal_filter_get_lag(const signal_filter_t *filter, const signal_filter_config_t *config) {
+    float lag = (median_len(config) - 1) / 2.0f;
+
+    if (config->smooth == SIGNAL_SMOOTH_EMA && config->ema_alpha > 0.0f) {
+        lag += (1.0f - config->ema_alpha) / config->ema_alpha;
+    } else if (config->smooth == SIGNAL_SMOOTH_KALMAN) {
+        float p = filter->variance + config->kalman_q;
+        float k = p / (p + config->kalman_r);
+        lag += k > 0.0f ? (1.0f - k) / k : 0.0f;
+    }
+    return lag;
+}
+
+// Output over input noise of a group
+float signal_filter_get_noise_ratio(const signal_filter_stats_t *stats) {
+    return stats->in_noise > 0.0f ? stats->out_noise / stats->in_noise : 1.0f;
+}
@@ -0,0 +1,74 @@
+#ifndef SIGNAL_FILTER_H
+#define SIGNAL_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Longest median window (odd)
+#define SIGNAL_MEDIAN_MAX 7
+
+// Consecutive gated samples after which the Kalman filter takes the reading
+// as a real step (a probe moved, a door opened) and restarts from it
+#define SIGNAL_KALMAN_REJECT_LIMIT 5
+
+// Smoothing after the median
+typedef enum {
+    SIGNAL_SMOOTH_NONE,
+    SIGNAL_SMOOTH_EMA,
+    SIGNAL_SMOOTH_KALMAN        // 1-D random-walk model with innovation gating
+} signal_smooth_t;
+
+// Filter settings, shared by every channel of a batch
+typedef struct {
+    uint8_t median_len;         // Median-of-N spike rejection (odd, 1 for none)
+    signal_smooth_t smooth;
+    float ema_alpha;            // 0..1, weight of the newest sample
+    float kalman_q;             // Process noise variance per sample
+    float kalman_r;             // Measurement noise variance
+    float kalman_gate;          // Reject innovations beyond this many sigma (0 for no gate)
+} signal_filter_config_t;
+
+// State of one channel
+typedef struct {
+    float window[SIGNAL_MEDIAN_MAX];
+    float estimate;
+    float variance;             // Kalman error variance of the estimate
+    float last_in;
+    float last_out;
+    uint8_t filled;
+    uint8_t next;
+    uint8_t rejected_run;
+    bool primed;
+} signal_filter_t;
+
+// What the filters of a group of channels did. The noise figures are
+// averages of the squared sample-to-sample change going in and coming
+// out; for a slow signal their ratio is the variance reduction.
+typedef struct {
+    uint32_t samples;
+    uint32_t gated;             // Kalman innovations rejected
+    uint32_t restarts;          // Restarts after a gap or a step
+    float in_noise;
+    float out_noise;
+} signal_filter_stats_t;
+
+// Clear a channel; it restarts from its next sample
+void signal_filter_reset(signal_filter_t *filter);
+
+// Filter one sample. NaN (a missing reading) passes through and resets the
+// channel. stats may be NULL.
+float signal_filter_update(signal_filter_t *filter, const signal_filter_config_t *config, float sample,
+                           signal_filter_stats_t *stats);
+
+// Filter one sample of each of count channels
+void signal_filter_update_batch(signal_filter_t *filters, const signal_filter_config_t *config,
+                                const float *in, float *out, int count, signal_filter_stats_t *stats);
+
+// Lag of a channel's output behind a ramp, in samples: half the median
+// window plus the smoothing lag at its current gain
+float signal_filter_get_lag(const signal_filter_t *filter, const signal_filter_config_t *config);
+
+// Output over input noise of a group (1 for no reduction or no data yet)
+float signal_filter_get_noise_ratio(const signal_filter_stats_t *stats);
+
+#endif /* SIGNAL_FILTER_H */
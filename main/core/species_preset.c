@@ -0,0 +1,76 @@
+#include "species_preset.h"
+#include "climate_controller.h"
+#include "profile_manager.h"
+#include "event_logger.h"
+#include "esp_log.h"
+#include <string.h>
+
+// Generated from species_presets.csv into the build directory
+#include "species_presets_table.h"
+
+static const char *TAG = "species_preset";
+
+// Number of presets in the table
+int species_preset_count(void) {
+    return SPECIES_PRESET_TABLE_COUNT;
+}
+
+// Get a preset by index
+const species_preset_t *species_preset_get(int index) {
+    if (index < 0 || index >= SPECIES_PRESET_TABLE_COUNT) {
+        return NULL;
+    }
+    return &species_preset_table[index];
+}
+
+// Find a preset by key
+const species_preset_t *species_preset_find(const char *key) {
+    for (int i = 0; i < SPECIES_PRESET_TABLE_COUNT; i++) {
+        if (strcmp(species_preset_table[i].key, key) == 0) {
+            return &species_preset_table[i];
+        }
+    }
+    return NULL;
+}
+
+// Apply a preset to a zone
+esp_err_t species_preset_apply(int zone, const species_preset_t *preset) {
+    climate_zone_targets_t targets = {
+        .temp_target = preset->day_temp,
+        .humidity_target = preset->day_humidity,
+        .light_target = climate_controller_zone_get_light_target(zone),
+        .temp_min = preset->temp_min,
+        .temp_max = preset->temp_max,
+        .humidity_min = preset->humidity_min,
+        .humidity_max = preset->humidity_max,
+    };
+    profile_t profile;
+
+    profile_manager_get(zone, &profile);
+    profile.enabled = true;
+    profile.day_temp = preset->day_temp;
+    profile.night_temp = preset->night_temp;
+    profile.day_humidity = preset->day_humidity;
+    profile.night_humidity = preset->night_humidity;
+    profile.photoperiod_h = preset->photoperiod_h;
+
+    // Check the profile before changing anything. The targets are checked
+    // as they are applied and left alone if rejected, so past this point
+    // the profile cannot fail and the preset never lands half applied.
+    esp_err_t err = profile_manager_check(zone, &profile);
+    if (err == ESP_OK) {
+        err = climate_controller_zone_apply_targets(zone, &targets);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Preset %s rejected for zone %d", preset->key, zone + 1);
+        return err;
+    }
+
+    // A tick between the two follows the old profile once, within the new
+    // limits. Setting the profile resets its phase, so the next tick hands
+    // over the preset's day and night targets.
+    profile_manager_set(zone, &profile);
+
+    event_logger_add_zone_fmt(zone, "Preset applied: %s", false, preset->name);
+    return ESP_OK;
+}
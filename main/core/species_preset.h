@@ -0,0 +1,42 @@
+#ifndef SPECIES_PRESET_H
+#define SPECIES_PRESET_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+// Species presets: day/night targets, photoperiod and target limits per
+// species. The table is generated at build time from species_presets.csv
+// by tools/gen_species_presets.py, which rejects out-of-range rows, and is
+// const data in flash; there is no parsing on the device.
+
+// One species
+typedef struct {
+    const char *key;            // Stable identifier, e.g. "leopard_gecko"
+    const char *name;           // Shown in the UI
+    float day_temp;
+    float night_temp;
+    float day_humidity;
+    float night_humidity;
+    uint8_t photoperiod_h;      // Lit hours centred on solar noon
+    uint8_t uvb_h;              // UVB hours within it (shown, not switched)
+    float temp_min;             // Target limits while the preset applies
+    float temp_max;
+    float humidity_min;
+    float humidity_max;
+} species_preset_t;
+
+// Number of presets in the table
+int species_preset_count(void);
+
+// Get a preset by index; NULL when out of range
+const species_preset_t *species_preset_get(int index);
+
+// Find a preset by key; NULL when unknown
+const species_preset_t *species_preset_find(const char *key);
+
+// Apply a preset to a zone: the target limits and the day targets in one
+// step, then a day/night profile with the preset's photoperiod. The light
+// level of the zone is kept.
+esp_err_t species_preset_apply(int zone, const species_preset_t *preset);
+
+#endif /* SPECIES_PRESET_H */
@@ -0,0 +1,171 @@
+#include "stream_stats.h"
+#include <math.h>
+#include <string.h>
+
+// Percentiles of STREAM_STATS_P05..P95
+static const float quantile_p[STREAM_STATS_QUANTILES] = { 0.05f, 0.5f, 0.95f };
+
+static const int64_t window_ms[STREAM_WINDOW_COUNT] = { STREAM_HOUR_MS, STREAM_DAY_MS, STREAM_WEEK_MS };
+
+// Empty an accumulator
+void stream_stats_reset(stream_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->min = INFINITY;
+    stats->max = -INFINITY;
+}
+
+// Keep one of the first five samples, in order
+static void p2_insert(stream_p2_t *p2, int count, float value) {
+    int i = count;
+
+    while (i > 0 && p2->height[i - 1] > value) {
+        p2->height[i] = p2->height[i - 1];
+        i--;
+    }
+    p2->height[i] = value;
+    if (count == 4) {
+        for (int m = 0; m < 5; m++) {
+            p2->pos[m] = m + 1;
+        }
+    }
+}
+
+// Move the markers for a sample; count is the number of samples before it
+static void p2_update(stream_p2_t *p2, float p, uint32_t count, float value) {
+    float *h = p2->height;
+    int32_t *n = p2->pos;
+    int k;
+
+    // Cell the sample falls in, stretching the ends to it
+    if (value < h[0]) {
+        h[0] = value;
+        k = 0;
+    } else if (value >= h[4]) {
+        h[4] = value;
+        k = 3;
+    } else {
+        k = 0;
+        while (value >= h[k + 1]) {
+            k++;
+        }
+    }
+    for (int i = k + 1; i < 5; i++) {
+        n[i]++;
+    }
+
+    // Nudge the middle markers toward their desired positions
+    const float step[5] = { 0.0f, p / 2.0f, p, (1.0f + p) / 2.0f, 1.0f };
+    for (int i = 1; i < 4; i++) {
+        float d = 1.0f + count * step[i] - n[i];
+        if ((d >= 1.0f && n[i + 1] - n[i] > 1) || (d <= -1.0f && n[i - 1] - n[i] < -1)) {
+            int s = d > 0.0f ? 1 : -1;
+            float q = h[i] + (float)s / (n[i + 1] - n[i - 1]) *
+                             ((n[i] - n[i - 1] + s) * (h[i + 1] - h[i]) / (n[i + 1] - n[i]) +
+                              (n[i + 1] - n[i] - s) * (h[i] - h[i - 1]) / (n[i] - n[i - 1]));
+            if (h[i - 1] < q && q < h[i + 1]) {
+                h[i] = q;
+            } else {
+                h[i] += s * (h[i + s] - h[i]) / (n[i + s] - n[i]);
+            }
+            n[i] += s;
+        }
+    }
+}
+
+// Add a sample
+void stream_stats_add(stream_stats_t *stats, float value, int64_t now_ms) {
+    if (isnan(value)) {
+        return;
+    }
+
+    for (int q = 0; q < STREAM_STATS_QUANTILES; q++) {
+        if (stats->count < 5) {
+            p2_insert(&stats->quantiles[q], stats->count, value);
+        } else {
+            p2_update(&stats->quantiles[q], quantile_p[q], stats->count, value);
+        }
+    }
+
+    stats->count++;
+    double delta = value - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += delta * (value - stats->mean);
+
+    if (value < stats->min) {
+        stats->min = value;
+        stats->min_ms = now_ms;
+    }
+    if (value > stats->max) {
+        stats->max = value;
+        stats->max_ms = now_ms;
+    }
+}
+
+// Get a percentile estimate
+float stream_stats_quantile(const stream_stats_t *stats, int index) {
+    const stream_p2_t *p2 = &stats->quantiles[index];
+
+    if (stats->count == 0) {
+        return NAN;
+    }
+    if (stats->count < 5) {
+        return p2->height[(int)(quantile_p[index] * (stats->count - 1) + 0.5f)];
+    }
+    return p2->height[2];
+}
+
+// Summarize an accumulator
+void stream_stats_summarize(const stream_stats_t *stats, stream_summary_t *summary) {
+    summary->count = stats->count;
+    summary->min_ms = stats->min_ms;
+    summary->max_ms = stats->max_ms;
+    if (stats->count == 0) {
+        summary->mean = summary->stddev = summary->min = summary->max = NAN;
+    } else {
+        summary->mean = (float)stats->mean;
+        summary->stddev = stats->count > 1 ? (float)sqrt(stats->m2 / (stats->count - 1)) : 0.0f;
+        summary->min = stats->min;
+        summary->max = stats->max;
+    }
+    for (int q = 0; q < STREAM_STATS_QUANTILES; q++) {
+        summary->quantile[q] = stream_stats_quantile(stats, q);
+    }
+}
+
+// Initialize a channel with no samples
+void stream_channel_init(stream_channel_t *channel) {
+    for (int w = 0; w < STREAM_WINDOW_COUNT; w++) {
+        channel->start_ms[w] = INT64_MIN;
+        stream_stats_reset(&channel->current[w]);
+        stream_stats_summarize(&channel->current[w], &channel->last[w]);
+    }
+}
+
+// Add a sample of the channel
+uint8_t stream_channel_add(stream_channel_t *channel, float value, int64_t now_ms) {
+    uint8_t closed = 0;
+
+    for (int w = 0; w < STREAM_WINDOW_COUNT; w++) {
+        if (channel->start_ms[w] == INT64_MIN) {
+            channel->start_ms[w] = now_ms;
+        } else if (now_ms - channel->start_ms[w] >= window_ms[w]) {
+            // A gap of several windows leaves the skipped ones out
+            stream_stats_summarize(&channel->current[w], &channel->last[w]);
+            stream_stats_reset(&channel->current[w]);
+            channel->start_ms[w] += (now_ms - channel->start_ms[w]) / window_ms[w] * window_ms[w];
+            closed |= 1 << w;
+        }
+        stream_stats_add(&channel->current[w], value, now_ms);
+    }
+    return closed;
+}
+
+// Summarize the window in progress, or the last closed one
+void stream_channel_get(const stream_channel_t *channel, stream_window_t window, bool closed,
+                        stream_summary_t *summary) {
+    if (closed) {
+        *summary = channel->last[window];
+    } else {
+        stream_stats_summarize(&channel->current[window], summary);
+    }
+}
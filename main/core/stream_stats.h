@@ -0,0 +1,93 @@
+#ifndef STREAM_STATS_H
+#define STREAM_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Running statistics of one channel over hour, day and week windows,
+// without keeping the samples: Welford mean and variance, min and max with
+// their times, and P² estimates of a few percentiles (Jain & Chlamtac).
+// Fixed size per channel, constant time per sample. Windows run from the
+// first sample, like the energy meter's, and close every hour, 24 hours
+// and 7 days of control time.
+
+// Percentiles estimated in every window
+#define STREAM_STATS_QUANTILES 3
+#define STREAM_STATS_P05 0
+#define STREAM_STATS_P50 1
+#define STREAM_STATS_P95 2
+
+// Window lengths
+#define STREAM_HOUR_MS (60LL * 60 * 1000)
+#define STREAM_DAY_MS (24 * STREAM_HOUR_MS)
+#define STREAM_WEEK_MS (7 * STREAM_DAY_MS)
+
+typedef enum {
+    STREAM_WINDOW_HOUR,
+    STREAM_WINDOW_DAY,
+    STREAM_WINDOW_WEEK,
+    STREAM_WINDOW_COUNT
+} stream_window_t;
+
+// P² estimate of one percentile: five marker heights and positions. The
+// first five samples are kept in the heights until the markers start.
+typedef struct {
+    float height[5];
+    int32_t pos[5];
+} stream_p2_t;
+
+// Accumulator of one window
+typedef struct {
+    uint32_t count;
+    double mean;                // Double: a week is 600k one-second samples
+    double m2;                  // Sum of squared deviations from the mean
+    float min;
+    float max;
+    int64_t min_ms;
+    int64_t max_ms;
+    stream_p2_t quantiles[STREAM_STATS_QUANTILES];
+} stream_stats_t;
+
+// What a display or report wants of a window; NaN values while empty
+typedef struct {
+    uint32_t count;
+    float mean;
+    float stddev;
+    float min;
+    float max;
+    int64_t min_ms;
+    int64_t max_ms;
+    float quantile[STREAM_STATS_QUANTILES];
+} stream_summary_t;
+
+// Statistics of one channel
+typedef struct {
+    int64_t start_ms[STREAM_WINDOW_COUNT];      // INT64_MIN before the first sample
+    stream_stats_t current[STREAM_WINDOW_COUNT];
+    stream_summary_t last[STREAM_WINDOW_COUNT]; // Last closed window; count 0 if none
+} stream_channel_t;
+
+// Empty an accumulator
+void stream_stats_reset(stream_stats_t *stats);
+
+// Add a sample taken at now_ms; NaN is skipped
+void stream_stats_add(stream_stats_t *stats, float value, int64_t now_ms);
+
+// Get a percentile estimate (STREAM_STATS_P05..P95); NaN while empty
+float stream_stats_quantile(const stream_stats_t *stats, int index);
+
+// Summarize an accumulator
+void stream_stats_summarize(const stream_stats_t *stats, stream_summary_t *summary);
+
+// Initialize a channel with no samples
+void stream_channel_init(stream_channel_t *channel);
+
+// Add a sample of the channel at now_ms, closing any window that has run
+// its length first. Returns the windows closed as bits (1 << window).
+uint8_t stream_channel_add(stream_channel_t *channel, float value, int64_t now_ms);
+
+// Summarize the window in progress, or the last closed one
+void stream_channel_get(const stream_channel_t *channel, stream_window_t window, bool closed,
+                        stream_summary_t *summary);
+
+#endif /* STREAM_STATS_H */
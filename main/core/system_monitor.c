@@ -5,6 +5,10 @@
 #include "event_logger.h"
 #include "ui/ui.h"
 #include "climate_controller.h"
+#include "probe_manager.h"
+#include "schedule_manager.h"
+#include "ui/screens/ui_dashboard.h"
+#include "ui/screens/ui_system.h"
 #include <stdlib.h>
 #include <time.h>
 
@@ -83,6 +87,34 @@ void system_monitor_update(void) {
 
     ui_system_update_stats(cpu_usage, memory_usage);
 
+    // Schedule accuracy and the zone 0 rates that drive preheat
+    schedule_accuracy_t accuracy;
+    schedule_rate_t warm, cool;
+    schedule_manager_get_accuracy(&accuracy);
+    schedule_manager_get_rate(0, true, &warm);
+    schedule_manager_get_rate(0, false, &cool);
+    ui_system_update_schedule(&accuracy,
+                              warm.count ? warm.mean : SCHEDULE_DEFAULT_WARM_RATE,
+                              cool.count ? cool.mean : SCHEDULE_DEFAULT_COOL_RATE);
+
+    // Zone 0 actuator duty and energy
+    energy_summary_t energy[CLIMATE_ACTUATOR_COUNT];
+    for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+        climate_controller_zone_get_energy(0, a, &energy[a]);
+    }
+    ui_system_update_energy(energy);
+
+    // Zone 0 probes on the dashboard
+    probe_readings_t probes;
+    probe_manager_get_readings(0, &probes);
+    ui_dashboard_update_probes(&probes);
+
+    // Zone 0 range of the day so far
+    stream_summary_t day_temp, day_humidity;
+    climate_controller_zone_get_stats(0, CLIMATE_STAT_TEMPERATURE, STREAM_WINDOW_DAY, false, &day_temp);
+    climate_controller_zone_get_stats(0, CLIMATE_STAT_HUMIDITY, STREAM_WINDOW_DAY, false, &day_humidity);
+    ui_dashboard_update_stats(&day_temp, &day_humidity);
+
     // Generate alerts for low battery
     if (battery_level == 20 || battery_level == 10 || battery_level == 5) {
         char alert_msg[64];
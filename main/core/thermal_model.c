@@ -0,0 +1,202 @@
+#include "thermal_model.h"
+#include <math.h>
+#include <string.h>
+
+// Initial covariance: large, since nothing is known yet
+#define RLS_INITIAL_P 1000.0f
+
+// Stop forgetting once the covariance gets this large (no excitation)
+#define RLS_MAX_P 1.0e4f
+
+// Smallest actuator gain treated as identified
+#define MIN_ACTUATOR_GAIN 1.0e-3f
+
+// Parameter indices after the temperature lags
+#define IDX_HEAT(m) ((m)->order)
+#define IDX_COOL(m) ((m)->order + 1)
+#define IDX_AMBIENT(m) ((m)->order + 2)
+
+// Initialize a first- or second-order model
+void thermal_model_init(thermal_model_t *model, int order) {
+    memset(model, 0, sizeof(*model));
+    model->order = order == 2 ? 2 : 1;
+    model->n = model->order + 3;
+
+    for (int i = 0; i < model->n; i++) {
+        model->P[i][i] = RLS_INITIAL_P;
+    }
+}
+
+// Build the regressor from the temperature history and inputs
+static void regressor(const thermal_model_t *model, const float *history,
+                      float heat, float cool, float ambient, float *phi) {
+    phi[0] = history[0];
+    if (model->order == 2) {
+        phi[1] = history[1];
+    }
+    phi[IDX_HEAT(model)] = heat;
+    phi[IDX_COOL(model)] = cool;
+    phi[IDX_AMBIENT(model)] = ambient;
+}
+
+// Feed one sample
+void thermal_model_update(thermal_model_t *model, float temp, float heat, float cool, float ambient) {
+    int n = model->n;
+
+    // The first samples only fill the history
+    if (model->samples >= (uint32_t)model->order) {
+        float phi[THERMAL_MODEL_MAX_PARAMS];
+        float p_phi[THERMAL_MODEL_MAX_PARAMS];
+        regressor(model, model->history, heat, cool, ambient, phi);
+
+        float denom = 0.0f;
+        float prediction = 0.0f;
+        bool saturated = false;
+        for (int i = 0; i < n; i++) {
+            p_phi[i] = 0.0f;
+            for (int j = 0; j < n; j++) {
+                p_phi[i] += model->P[i][j] * phi[j];
+            }
+            prediction += model->theta[i] * phi[i];
+            saturated |= model->P[i][i] > RLS_MAX_P;
+        }
+
+        // Without excitation forgetting would blow up the covariance
+        float lambda = saturated ? 1.0f : THERMAL_MODEL_FORGETTING;
+        for (int i = 0; i < n; i++) {
+            denom += phi[i] * p_phi[i];
+        }
+        denom += lambda;
+
+        float error = temp - prediction;
+        for (int i = 0; i < n; i++) {
+            model->theta[i] += p_phi[i] / denom * error;
+        }
+
+        // P = (P - P*phi*phi'*P / denom) / lambda, kept symmetric
+        for (int i = 0; i < n; i++) {
+            for (int j = i; j < n; j++) {
+                float p = (model->P[i][j] - p_phi[i] * p_phi[j] / denom) / lambda;
+                model->P[i][j] = p;
+                model->P[j][i] = p;
+            }
+        }
+    }
+
+    model->history[1] = model->history[0];
+    model->history[0] = temp;
+    model->samples++;
+}
+
+// Check if the fit has seen enough samples and is stable
+bool thermal_model_is_ready(const thermal_model_t *model) {
+    if (model->samples < THERMAL_MODEL_MIN_SAMPLES) {
+        return false;
+    }
+
+    // Temperature must decay toward ambient, not diverge
+    float a = model->theta[0] + (model->order == 2 ? model->theta[1] : 0.0f);
+    return a > 0.0f && a < 1.0f && thermal_model_heat_gain(model) > MIN_ACTUATOR_GAIN;
+}
+
+// Heater gain (°C per sample at full duty)
+float thermal_model_heat_gain(const thermal_model_t *model) {
+    return model->theta[IDX_HEAT(model)];
+}
+
+// Cooler gain (°C per sample at full duty, positive when it cools)
+float thermal_model_cool_gain(const thermal_model_t *model) {
+    return -model->theta[IDX_COOL(model)];
+}
+
+// Predict the move from the last sample at a constant heater duty
+float thermal_model_predict_rise(const thermal_model_t *model, float heat, float ambient, int samples) {
+    float history[2] = {model->history[0], model->history[1]};
+    float phi[THERMAL_MODEL_MAX_PARAMS];
+
+    for (int k = 0; k < samples; k++) {
+        regressor(model, history, heat, 0.0f, ambient, phi);
+        float next = 0.0f;
+        for (int i = 0; i < model->n; i++) {
+            next += model->theta[i] * phi[i];
+        }
+        history[1] = history[0];
+        history[0] = next;
+    }
+    return history[0] - model->history[0];
+}
+
+// Predict the horizon: the planned inputs over the first block, then the
+// steady-state inputs that hold the target
+static void predict(const thermal_model_t *model, float heat, float cool,
+                    float tail_heat, float tail_cool, float ambient, float *out) {
+    float history[2] = {model->history[0], model->history[1]};
+    float phi[THERMAL_MODEL_MAX_PARAMS];
+
+    for (int k = 0; k < THERMAL_MPC_HORIZON; k++) {
+        bool planned = k < THERMAL_MPC_BLOCK;
+        regressor(model, history, planned ? heat : tail_heat, planned ? cool : tail_cool, ambient, phi);
+        float next = 0.0f;
+        for (int i = 0; i < model->n; i++) {
+            next += model->theta[i] * phi[i];
+        }
+        history[1] = history[0];
+        history[0] = next;
+        out[k] = next;
+    }
+}
+
+// Best duty in [0, 1] for one actuator given the responses with zero and
+// full duty over the first block; returns the cost through *cost
+static float best_duty(const float *free, const float *full, float target,
+                       float energy_weight, float *cost) {
+    // J(u) = sum (f + g*u - r)^2 + w*B*u, quadratic in u
+    float fg = 0.0f, gg = 0.0f, ff = 0.0f;
+    for (int k = 0; k < THERMAL_MPC_HORIZON; k++) {
+        float f = free[k] - target;
+        float g = full[k] - free[k];
+        fg += f * g;
+        gg += g * g;
+        ff += f * f;
+    }
+
+    float linear = 2.0f * fg + energy_weight * THERMAL_MPC_BLOCK;
+    float u = gg > 0.0f ? -linear / (2.0f * gg) : 0.0f;
+    u = u < 0.0f ? 0.0f : (u > 1.0f ? 1.0f : u);
+
+    *cost = ff + linear * u + gg * u * u;
+    return u;
+}
+
+// Plan the duty of the next block
+float thermal_mpc_plan(const thermal_model_t *model, float target, float ambient, float energy_weight) {
+    float free[THERMAL_MPC_HORIZON];
+    float heated[THERMAL_MPC_HORIZON];
+    float cooled[THERMAL_MPC_HORIZON];
+    float heat_cost, cool_cost;
+    bool can_cool = thermal_model_cool_gain(model) > MIN_ACTUATOR_GAIN;
+
+    // Duty that holds the target at this ambient: (1 - a)*r - c*ambient
+    float a = model->theta[0] + (model->order == 2 ? model->theta[1] : 0.0f);
+    float needed = (1.0f - a) * target - model->theta[IDX_AMBIENT(model)] * ambient;
+    float tail_heat = 0.0f, tail_cool = 0.0f;
+    if (needed > 0.0f) {
+        tail_heat = fminf(needed / thermal_model_heat_gain(model), 1.0f);
+    } else if (can_cool) {
+        tail_cool = fminf(-needed / thermal_model_cool_gain(model), 1.0f);
+    }
+
+    predict(model, 0.0f, 0.0f, tail_heat, tail_cool, ambient, free);
+    predict(model, 1.0f, 0.0f, tail_heat, tail_cool, ambient, heated);
+    float heat = best_duty(free, heated, target, energy_weight, &heat_cost);
+
+    // Only plan cooling once the cooler's effect has been identified
+    if (!can_cool) {
+        return heat;
+    }
+
+    predict(model, 0.0f, 1.0f, tail_heat, tail_cool, ambient, cooled);
+    float cool = best_duty(free, cooled, target, energy_weight, &cool_cost);
+
+    return heat_cost <= cool_cost ? heat : -cool;
+}
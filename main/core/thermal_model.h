@@ -0,0 +1,56 @@
+#ifndef THERMAL_MODEL_H
+#define THERMAL_MODEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Largest model: two temperature lags, heater, cooler, ambient
+#define THERMAL_MODEL_MAX_PARAMS 5
+
+// Forgetting factor of the recursive least squares fit (per sample)
+#define THERMAL_MODEL_FORGETTING 0.998f
+
+// Samples needed before the model is trusted
+#define THERMAL_MODEL_MIN_SAMPLES 240
+
+// MPC prediction horizon and the block of samples whose duty is planned;
+// the rest of the horizon assumes the steady-state duty for the target
+#define THERMAL_MPC_HORIZON 20
+#define THERMAL_MPC_BLOCK 4
+
+// Discrete thermal model identified online:
+//   T[k+1] = a1*T[k] (+ a2*T[k-1]) + bh*heat[k] + bc*cool[k] + c*ambient[k]
+// with heat and cool the relay duty (0..1) over the sample
+typedef struct {
+    int order;                      // 1 or 2
+    int n;                          // Number of parameters
+    float theta[THERMAL_MODEL_MAX_PARAMS];
+    float P[THERMAL_MODEL_MAX_PARAMS][THERMAL_MODEL_MAX_PARAMS];
+    float history[2];               // Last two temperatures, newest first
+    uint32_t samples;
+} thermal_model_t;
+
+// Initialize a first- or second-order model
+void thermal_model_init(thermal_model_t *model, int order);
+
+// Feed one sample: the temperature now, and the heater / cooler duty and
+// ambient temperature that applied since the previous sample. O(n^2).
+void thermal_model_update(thermal_model_t *model, float temp, float heat, float cool, float ambient);
+
+// Check if the fit has seen enough samples and is stable
+bool thermal_model_is_ready(const thermal_model_t *model);
+
+// Heater and cooler gain (°C per sample at full duty)
+float thermal_model_heat_gain(const thermal_model_t *model);
+float thermal_model_cool_gain(const thermal_model_t *model);
+
+// Predict how far the temperature moves from the last sample over the
+// given number of samples with the heater held at a duty, cooler off
+float thermal_model_predict_rise(const thermal_model_t *model, float heat, float ambient, int samples);
+
+// Plan the duty of the next block that minimizes the squared tracking error
+// over the horizon plus energy_weight per unit of duty and sample. Returns
+// the heater duty (> 0) or the negated cooler duty (< 0).
+float thermal_mpc_plan(const thermal_model_t *model, float target, float ambient, float energy_weight);
+
+#endif /* THERMAL_MODEL_H */
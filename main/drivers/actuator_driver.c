@@ -0,0 +1,137 @@
+#include "actuator_driver.h"
+#include "i2c_bus.h"
+#include "pin_mapping.h"
+#include "driver/ledc.h"
+#include "esp_log.h"
+
+static const char *TAG = "actuator_driver";
+
+// TCA9554 registers
+#define EXPANDER_REG_OUTPUT 0x01
+#define EXPANDER_REG_CONFIG 0x03
+
+// Relay expander on the sensor bus
+#define EXPANDER_I2C_HZ 400000
+#define EXPANDER_TIMEOUT_MS 10
+
+// One LEDC timer shared by all PWM outputs
+#define PWM_MODE LEDC_LOW_SPEED_MODE
+#define PWM_TIMER LEDC_TIMER_0
+#define PWM_RESOLUTION LEDC_TIMER_10_BIT
+
+// Expander, added to the bus on first use
+static i2c_master_dev_handle_t expander = NULL;
+
+// Channel table and the LEDC channel of each PWM output
+static const actuator_channel_t *table = NULL;
+static int table_count = 0;
+static ledc_channel_t pwm_channel[ACTUATOR_MAX_CHANNELS];
+
+// Write one expander register
+static esp_err_t expander_write(uint8_t reg, uint8_t value) {
+    uint8_t buf[2] = { reg, value };
+    return i2c_master_transmit(expander, buf, sizeof(buf), EXPANDER_TIMEOUT_MS);
+}
+
+// Add the expander to the bus and set every pin to a low output
+static esp_err_t expander_init(void) {
+    i2c_master_bus_handle_t bus = i2c_bus_get();
+    esp_err_t ret;
+
+    if (bus == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (expander == NULL) {
+        i2c_device_config_t dev_config = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address = RELAY_EXPANDER_ADDR,
+            .scl_speed_hz = EXPANDER_I2C_HZ,
+        };
+        ret = i2c_master_bus_add_device(bus, &dev_config, &expander);
+        if (ret != ESP_OK) {
+            expander = NULL;
+            return ret;
+        }
+    }
+
+    // Latch the outputs low before the pins turn into outputs
+    ret = expander_write(EXPANDER_REG_OUTPUT, 0);
+    if (ret == ESP_OK) {
+        ret = expander_write(EXPANDER_REG_CONFIG, 0);
+    }
+    return ret;
+}
+
+// Set up the outputs of a channel table
+esp_err_t actuator_driver_init(const actuator_channel_t *channels, int count) {
+    bool has_relays = false;
+    bool has_pwm = false;
+    int next_pwm = LEDC_CHANNEL_0;
+
+    table = channels;
+    table_count = count;
+
+    for (int i = 0; i < count; i++) {
+        has_relays |= channels[i].kind == ACTUATOR_KIND_RELAY;
+        has_pwm |= channels[i].kind == ACTUATOR_KIND_PWM;
+    }
+
+    if (has_pwm) {
+        ledc_timer_config_t timer_config = {
+            .speed_mode = PWM_MODE,
+            .duty_resolution = PWM_RESOLUTION,
+            .timer_num = PWM_TIMER,
+            .freq_hz = ACTUATOR_PWM_FREQ_HZ,
+            .clk_cfg = LEDC_AUTO_CLK,
+        };
+        ESP_ERROR_CHECK(ledc_timer_config(&timer_config));
+
+        for (int i = 0; i < count; i++) {
+            if (channels[i].kind != ACTUATOR_KIND_PWM) {
+                continue;
+            }
+            pwm_channel[i] = next_pwm++;
+            ledc_channel_config_t channel_config = {
+                .gpio_num = channels[i].pin,
+                .speed_mode = PWM_MODE,
+                .channel = pwm_channel[i],
+                .timer_sel = PWM_TIMER,
+                .duty = 0,
+                .hpoint = 0,
+            };
+            ESP_ERROR_CHECK(ledc_channel_config(&channel_config));
+        }
+    }
+
+    if (has_relays) {
+        esp_err_t ret = expander_init();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Relay expander at 0x%02x not responding: %s", RELAY_EXPANDER_ADDR,
+                     esp_err_to_name(ret));
+            return ret;
+        }
+    }
+
+    ESP_LOGI(TAG, "Outputs ready (%s%s)", has_relays ? "relay expander " : "",
+             has_pwm ? "LEDC PWM" : "");
+    return ESP_OK;
+}
+
+// Write every output in one go
+esp_err_t actuator_driver_write(int64_t now_us, uint8_t relay_bits, const uint16_t *duty) {
+    esp_err_t ret = ESP_OK;
+
+    if (expander != NULL) {
+        ret = expander_write(EXPANDER_REG_OUTPUT, relay_bits);
+    }
+
+    for (int i = 0; i < table_count; i++) {
+        if (table[i].kind != ACTUATOR_KIND_PWM) {
+            continue;
+        }
+        ledc_set_duty(PWM_MODE, pwm_channel[i], duty[i]);
+        ledc_update_duty(PWM_MODE, pwm_channel[i]);
+    }
+    return ret;
+}
@@ -0,0 +1,41 @@
+#ifndef ACTUATOR_DRIVER_H
+#define ACTUATOR_DRIVER_H
+
+#include "esp_err.h"
+#include "actuator_manager.h"
+#include <stdint.h>
+
+// Set up the outputs of a channel table: the relay expander and one LEDC
+// channel per PWM output. All outputs start off. May be called again with
+// a new table.
+esp_err_t actuator_driver_init(const actuator_channel_t *channels, int count);
+
+// Write every output in one go: the relay bits in a single expander
+// transaction, then the PWM duties (indexed by channel). now_us is the
+// control tick the write belongs to.
+esp_err_t actuator_driver_write(int64_t now_us, uint8_t relay_bits, const uint16_t *duty);
+
+#ifdef REPTICONTROL_HEADLESS
+// Writes kept by the mock backend
+#define ACTUATOR_MOCK_TIMELINE_LEN 256
+
+// One write as the outputs saw it
+typedef struct {
+    int64_t time_us;
+    uint8_t relay_bits;
+    uint16_t duty[ACTUATOR_MAX_CHANNELS];
+} actuator_mock_event_t;
+
+// Mock backend: writes recorded since the last clear, oldest first (the
+// last ACTUATOR_MOCK_TIMELINE_LEN are kept)
+int actuator_mock_get_event_count(void);
+const actuator_mock_event_t *actuator_mock_get_event(int index);
+
+// Writes since the last clear, including ones no longer kept
+uint32_t actuator_mock_get_write_count(void);
+
+// Forget the recorded timeline
+void actuator_mock_clear(void);
+#endif
+
+#endif /* ACTUATOR_DRIVER_H */
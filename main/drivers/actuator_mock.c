@@ -0,0 +1,54 @@
+#include "actuator_driver.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "actuator_mock";
+
+// Recorded writes, as a ring of the last ACTUATOR_MOCK_TIMELINE_LEN
+static actuator_mock_event_t timeline[ACTUATOR_MOCK_TIMELINE_LEN];
+static uint32_t write_count = 0;
+static int channel_count = 0;
+
+// Set up the outputs of a channel table
+esp_err_t actuator_driver_init(const actuator_channel_t *channels, int count) {
+    channel_count = count;
+    actuator_mock_clear();
+    ESP_LOGI(TAG, "Recording %d output channels", count);
+    return ESP_OK;
+}
+
+// Record a write
+esp_err_t actuator_driver_write(int64_t now_us, uint8_t relay_bits, const uint16_t *duty) {
+    actuator_mock_event_t *event = &timeline[write_count % ACTUATOR_MOCK_TIMELINE_LEN];
+
+    event->time_us = now_us;
+    event->relay_bits = relay_bits;
+    memset(event->duty, 0, sizeof(event->duty));
+    memcpy(event->duty, duty, channel_count * sizeof(duty[0]));
+    write_count++;
+    return ESP_OK;
+}
+
+// Get the number of writes kept
+int actuator_mock_get_event_count(void) {
+    return write_count < ACTUATOR_MOCK_TIMELINE_LEN ? (int)write_count : ACTUATOR_MOCK_TIMELINE_LEN;
+}
+
+// Get a kept write, oldest first
+const actuator_mock_event_t *actuator_mock_get_event(int index) {
+    int count = actuator_mock_get_event_count();
+    if (index < 0 || index >= count) {
+        return NULL;
+    }
+    return &timeline[(write_count - count + index) % ACTUATOR_MOCK_TIMELINE_LEN];
+}
+
+// Get the number of writes since the last clear
+uint32_t actuator_mock_get_write_count(void) {
+    return write_count;
+}
+
+// Forget the recorded timeline
+void actuator_mock_clear(void) {
+    write_count = 0;
+}
@@ -37,4 +37,18 @@ void display_set_px_cb(lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w,
 // DMA transfer completion callback
 void display_dma_ready_cb(void);
 
+#ifdef REPTICONTROL_HEADLESS
+#include "display_config.h"
+
+// Headless backend: the full frame as rendered so far (RGB565, LCD_H_RES wide)
+const lv_color_t *display_headless_get_framebuffer(void);
+
+// Switch panel type and resize the LVGL display and framebuffer to match
+esp_err_t display_headless_set_type(display_type_t type);
+
+// Flush callbacks and pixels written since the last reset
+void display_headless_get_flush_stats(uint32_t *flushes, uint32_t *pixels);
+void display_headless_reset_flush_stats(void);
+#endif
+
 #endif /* DISPLAY_DRIVER_H */
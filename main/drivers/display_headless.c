@@ -0,0 +1,153 @@
+#include "display_driver.h"
+#include "display_config.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+
+static const char *TAG = "display_headless";
+
+// Number of lines in each LVGL draw buffer (same as the RGB panel driver)
+#define DRAW_BUF_LINES 40
+
+// LVGL display
+static lv_disp_drv_t disp_drv;
+static lv_disp_t *disp = NULL;
+
+// Draw buffers and the memory framebuffer they are flushed into
+static lv_color_t *buf1 = NULL;
+static lv_color_t *buf2 = NULL;
+static lv_disp_draw_buf_t disp_buf;
+static lv_color_t *framebuffer = NULL;
+
+// Flush statistics
+static uint32_t flush_count = 0;
+static uint32_t flush_pixels = 0;
+
+// (Re)allocate buffers for the current LCD_H_RES x LCD_V_RES
+static esp_err_t alloc_buffers(void) {
+    // Allocate the new buffers before freeing the old, so a failed resize
+    // leaves the display drawing into buffers that still exist
+    size_t line_buf_px = (size_t)LCD_H_RES * DRAW_BUF_LINES;
+    lv_color_t *new_buf1 = malloc(line_buf_px * sizeof(lv_color_t));
+    lv_color_t *new_buf2 = malloc(line_buf_px * sizeof(lv_color_t));
+    lv_color_t *new_fb = calloc((size_t)LCD_H_RES * LCD_V_RES, sizeof(lv_color_t));
+
+    if (!new_buf1 || !new_buf2 || !new_fb) {
+        ESP_LOGE(TAG, "Failed to allocate %dx%d framebuffer", LCD_H_RES, LCD_V_RES);
+        free(new_buf1);
+        free(new_buf2);
+        free(new_fb);
+        return ESP_ERR_NO_MEM;
+    }
+
+    free(buf1);
+    free(buf2);
+    free(framebuffer);
+    buf1 = new_buf1;
+    buf2 = new_buf2;
+    framebuffer = new_fb;
+
+    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, line_buf_px);
+    return ESP_OK;
+}
+
+esp_err_t display_init(void) {
+    ESP_LOGI(TAG, "Initializing headless display %dx%d", LCD_H_RES, LCD_V_RES);
+
+    esp_err_t err = alloc_buffers();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // Register display driver (partial refresh into the memory framebuffer)
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = LCD_H_RES;
+    disp_drv.ver_res = LCD_V_RES;
+    disp_drv.flush_cb = display_flush_cb;
+    disp_drv.draw_buf = &disp_buf;
+    disp_drv.full_refresh = 0;
+    disp_drv.direct_mode = 0;
+    disp = lv_disp_drv_register(&disp_drv);
+
+    return disp ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t display_headless_set_type(display_type_t type) {
+    display_type_t old_type = display_config_get_type();
+    display_config_apply(type);
+
+    // On failure keep the old size, which the old buffers still fit
+    esp_err_t err = alloc_buffers();
+    if (err != ESP_OK) {
+        display_config_apply(old_type);
+        return err;
+    }
+
+    disp_drv.hor_res = LCD_H_RES;
+    disp_drv.ver_res = LCD_V_RES;
+    lv_disp_drv_update(disp, &disp_drv);
+
+    ESP_LOGI(TAG, "Headless display resized to %dx%d", LCD_H_RES, LCD_V_RES);
+    return ESP_OK;
+}
+
+const lv_color_t *display_headless_get_framebuffer(void) {
+    return framebuffer;
+}
+
+void display_headless_get_flush_stats(uint32_t *flushes, uint32_t *pixels) {
+    if (flushes) *flushes = flush_count;
+    if (pixels) *pixels = flush_pixels;
+}
+
+void display_headless_reset_flush_stats(void) {
+    flush_count = 0;
+    flush_pixels = 0;
+}
+
+void display_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map) {
+    int32_t w = lv_area_get_width(area);
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&framebuffer[(size_t)y * LCD_H_RES + area->x1], color_map, w * sizeof(lv_color_t));
+        color_map += w;
+    }
+
+    flush_count++;
+    flush_pixels += lv_area_get_size(area);
+    lv_disp_flush_ready(drv);
+}
+
+void display_rounder_cb(lv_disp_drv_t *drv, lv_area_t *area) {
+    // No alignment constraints without a panel
+}
+
+void display_set_px_cb(lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w,
+                      lv_coord_t x, lv_coord_t y, lv_color_t color, lv_opa_t opa) {
+    if (opa >= LV_OPA_MAX) {
+        ((lv_color_t *)buf)[y * buf_w + x] = color;
+    } else {
+        lv_color_t mix_color = lv_color_mix(color, ((lv_color_t *)buf)[y * buf_w + x], opa);
+        ((lv_color_t *)buf)[y * buf_w + x] = mix_color;
+    }
+}
+
+// Panel controls have nothing to drive in a headless build
+void display_set_backlight(bool on) {
+}
+
+void display_set_brightness(uint8_t level) {
+}
+
+void display_enter_sleep(void) {
+}
+
+void display_exit_sleep(void) {
+}
+
+void display_set_rotation(lv_disp_rot_t rotation) {
+}
+
+void display_dma_ready_cb(void) {
+}
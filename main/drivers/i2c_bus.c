@@ -0,0 +1,29 @@
+#include "i2c_bus.h"
+#include "pin_mapping.h"
+#include "esp_log.h"
+
+static const char *TAG = "i2c_bus";
+
+#define SENSOR_I2C_PORT I2C_NUM_1
+
+static i2c_master_bus_handle_t bus = NULL;
+
+// Get the sensor I2C bus, creating it on first use
+i2c_master_bus_handle_t i2c_bus_get(void) {
+    if (bus == NULL) {
+        i2c_master_bus_config_t bus_config = {
+            .i2c_port = SENSOR_I2C_PORT,
+            .scl_io_num = SENSOR_I2C_SCL,
+            .sda_io_num = SENSOR_I2C_SDA,
+            .clk_source = I2C_CLK_SRC_DEFAULT,
+            .glitch_ignore_cnt = 7,
+            .flags.enable_internal_pullup = true,
+        };
+        esp_err_t ret = i2c_new_master_bus(&bus_config, &bus);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Sensor I2C bus failed: %s", esp_err_to_name(ret));
+            bus = NULL;
+        }
+    }
+    return bus;
+}
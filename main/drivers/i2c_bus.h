@@ -0,0 +1,10 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "driver/i2c_master.h"
+
+// The sensor I2C bus (SENSOR_I2C_SCL/SDA), shared by the relay expander and
+// the sensors. Created on first use; NULL if that failed.
+i2c_master_bus_handle_t i2c_bus_get(void);
+
+#endif /* I2C_BUS_H */
@@ -0,0 +1,104 @@
+#include "sensor_chips.h"
+#include <stddef.h>
+
+// Sensirion CRC-8 of a word
+uint8_t sensor_chips_crc_sensirion(const uint8_t *data, int len) {
+    uint8_t crc = 0xFF;
+
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = crc & 0x80 ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Dallas/Maxim CRC-8
+uint8_t sensor_chips_crc_dallas(const uint8_t *data, int len) {
+    uint8_t crc = 0;
+
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = crc & 0x01 ? (uint8_t)((crc >> 1) ^ 0x8C) : (uint8_t)(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+// Check and unpack the two CRC-protected words of an SHT result
+static bool sht_words(const uint8_t *result, uint16_t *t_raw, uint16_t *rh_raw) {
+    if (sensor_chips_crc_sensirion(&result[0], 2) != result[2] ||
+        sensor_chips_crc_sensirion(&result[3], 2) != result[5]) {
+        return false;
+    }
+    *t_raw = (uint16_t)(result[0] << 8 | result[1]);
+    *rh_raw = (uint16_t)(result[3] << 8 | result[4]);
+    return true;
+}
+
+// SHT3x: T = -45 + 175 * raw / 65535, RH = 100 * raw / 65535
+static bool decode_sht3x(const uint8_t *result, float *values) {
+    uint16_t t_raw, rh_raw;
+
+    if (!sht_words(result, &t_raw, &rh_raw)) {
+        return false;
+    }
+    values[SENSOR_VALUE_TEMPERATURE] = -45.0f + 175.0f * t_raw / 65535.0f;
+    values[SENSOR_VALUE_HUMIDITY] = 100.0f * rh_raw / 65535.0f;
+    return true;
+}
+
+// SHT4x: humidity scale runs from -6 to 119 %RH and is clipped
+static bool decode_sht4x(const uint8_t *result, float *values) {
+    uint16_t t_raw, rh_raw;
+
+    if (!sht_words(result, &t_raw, &rh_raw)) {
+        return false;
+    }
+    float humidity = -6.0f + 125.0f * rh_raw / 65535.0f;
+    values[SENSOR_VALUE_TEMPERATURE] = -45.0f + 175.0f * t_raw / 65535.0f;
+    values[SENSOR_VALUE_HUMIDITY] = humidity < 0.0f ? 0.0f : humidity > 100.0f ? 100.0f : humidity;
+    return true;
+}
+
+// BH1750: big-endian count, 1.2 counts per lux in high-resolution mode
+static bool decode_bh1750(const uint8_t *result, float *values) {
+    values[SENSOR_VALUE_LIGHT] = (uint16_t)(result[0] << 8 | result[1]) / 1.2f;
+    return true;
+}
+
+// Single-shot commands: SHT3x high repeatability without clock stretching,
+// SHT4x high precision, BH1750 one-time high resolution (powers down after)
+static const sensor_i2c_chip_t sht3x = { { 0x24, 0x00 }, 2, 6, 16, decode_sht3x };
+static const sensor_i2c_chip_t sht4x = { { 0xFD }, 1, 6, 9, decode_sht4x };
+static const sensor_i2c_chip_t bh1750 = { { 0x20 }, 1, 2, 180, decode_bh1750 };
+
+// Get the I2C chip of a sensor kind
+const sensor_i2c_chip_t *sensor_chips_get_i2c(sensor_kind_t kind) {
+    switch (kind) {
+        case SENSOR_KIND_SHT3X:
+            return &sht3x;
+        case SENSOR_KIND_SHT4X:
+            return &sht4x;
+        case SENSOR_KIND_BH1750:
+            return &bh1750;
+        default:
+            return NULL;
+    }
+}
+
+// Decode a DS18B20 scratchpad: signed 1/16 °C in the first two bytes
+bool sensor_chips_decode_ds18b20(const uint8_t *scratchpad, float *temperature) {
+    bool all_ones = true;
+
+    for (int i = 0; i < DS18B20_SCRATCHPAD_LEN; i++) {
+        all_ones &= scratchpad[i] == 0xFF;
+    }
+    if (all_ones || sensor_chips_crc_dallas(scratchpad, DS18B20_SCRATCHPAD_LEN - 1) != scratchpad[8]) {
+        return false;
+    }
+    *temperature = (int16_t)(scratchpad[1] << 8 | scratchpad[0]) / 16.0f;
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef SENSOR_CHIPS_H
+#define SENSOR_CHIPS_H
+
+#include "sensor_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Command and result formats of the supported sensor chips. Pure byte
+// handling: the bus transactions are run by sensor_hal.c through the bus
+// backend (sensor_driver.h).
+
+// DS18B20 1-Wire commands and its 12-bit conversion time
+#define DS18B20_CMD_SKIP_ROM 0xCC
+#define DS18B20_CMD_MATCH_ROM 0x55
+#define DS18B20_CMD_SEARCH_ROM 0xF0
+#define DS18B20_CMD_CONVERT 0x44
+#define DS18B20_CMD_READ_SCRATCHPAD 0xBE
+#define DS18B20_FAMILY 0x28
+#define DS18B20_SCRATCHPAD_LEN 9
+#define DS18B20_CONVERSION_MS 750
+
+// An I2C chip: the command that starts a single-shot conversion, how long
+// it takes, and the result read back afterwards
+typedef struct {
+    uint8_t command[2];
+    uint8_t command_len;
+    uint8_t result_len;
+    uint16_t conversion_ms;
+    // Decode a result into values[SENSOR_VALUE_COUNT] (light in lux), leaving
+    // the values the chip does not measure alone; false on a CRC error
+    bool (*decode)(const uint8_t *result, float *values);
+} sensor_i2c_chip_t;
+
+// Get the I2C chip of a sensor kind; NULL for kinds not on I2C
+const sensor_i2c_chip_t *sensor_chips_get_i2c(sensor_kind_t kind);
+
+// Decode a DS18B20 scratchpad; false on a CRC error or a read of a missing
+// device (all ones)
+bool sensor_chips_decode_ds18b20(const uint8_t *scratchpad, float *temperature);
+
+// Sensirion CRC-8 (polynomial 0x31, init 0xFF) of a 16-bit word
+uint8_t sensor_chips_crc_sensirion(const uint8_t *data, int len);
+
+// Dallas/Maxim CRC-8 (polynomial 0x31 reflected, init 0) of scratchpads and ROM codes
+uint8_t sensor_chips_crc_dallas(const uint8_t *data, int len);
+
+#endif /* SENSOR_CHIPS_H */
@@ -0,0 +1,185 @@
+#include "sensor_driver.h"
+#include "i2c_bus.h"
+#include "pin_mapping.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "sensor_driver";
+
+// Sensor chips on the I2C bus
+#define SENSOR_I2C_HZ 400000
+#define SENSOR_I2C_TIMEOUT_MS 10
+
+// Addresses with a device handle on the bus
+#define SENSOR_I2C_MAX_DEVICES 8
+
+// 1-Wire standard-speed slot timings (us)
+#define ONEWIRE_RESET_LOW_US 480
+#define ONEWIRE_PRESENCE_WAIT_US 70
+#define ONEWIRE_RESET_TAIL_US 410
+#define ONEWIRE_WRITE1_LOW_US 6
+#define ONEWIRE_WRITE1_TAIL_US 64
+#define ONEWIRE_WRITE0_LOW_US 60
+#define ONEWIRE_WRITE0_TAIL_US 10
+#define ONEWIRE_READ_LOW_US 6
+#define ONEWIRE_READ_WAIT_US 9
+#define ONEWIRE_READ_TAIL_US 55
+
+// The board has one sensor I2C bus and one 1-Wire pin, both bus 0
+static struct {
+    uint8_t address;
+    i2c_master_dev_handle_t handle;
+} i2c_devices[SENSOR_I2C_MAX_DEVICES];
+static int i2c_device_count = 0;
+static bool onewire_ready = false;
+
+// A slot's timing must not be stretched by an interrupt
+static portMUX_TYPE onewire_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Get the device handle of an address, adding it on first use
+static i2c_master_dev_handle_t i2c_device(uint8_t address) {
+    i2c_master_bus_handle_t bus = i2c_bus_get();
+
+    for (int i = 0; i < i2c_device_count; i++) {
+        if (i2c_devices[i].address == address) {
+            return i2c_devices[i].handle;
+        }
+    }
+    if (bus == NULL || i2c_device_count >= SENSOR_I2C_MAX_DEVICES) {
+        return NULL;
+    }
+
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = address,
+        .scl_speed_hz = SENSOR_I2C_HZ,
+    };
+    i2c_master_dev_handle_t handle;
+    if (i2c_master_bus_add_device(bus, &dev_config, &handle) != ESP_OK) {
+        return NULL;
+    }
+    i2c_devices[i2c_device_count].address = address;
+    i2c_devices[i2c_device_count].handle = handle;
+    i2c_device_count++;
+    return handle;
+}
+
+// Set up the buses
+esp_err_t sensor_driver_init(void) {
+    if (i2c_bus_get() == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!onewire_ready) {
+        gpio_config_t io_config = {
+            .pin_bit_mask = 1ULL << SENSOR_ONEWIRE_GPIO,
+            .mode = GPIO_MODE_INPUT_OUTPUT_OD,
+            .pull_up_en = GPIO_PULLUP_ENABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            .intr_type = GPIO_INTR_DISABLE,
+        };
+        esp_err_t ret = gpio_config(&io_config);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "1-Wire pin failed: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        gpio_set_level(SENSOR_ONEWIRE_GPIO, 1);
+        onewire_ready = true;
+    }
+    return ESP_OK;
+}
+
+// Run a batch of transactions on an I2C bus
+void sensor_driver_i2c_batch(int bus, sensor_i2c_transaction_t *transactions, int count) {
+    for (int t = 0; t < count; t++) {
+        sensor_i2c_transaction_t *xfer = &transactions[t];
+        i2c_master_dev_handle_t device = bus == 0 ? i2c_device(xfer->address) : NULL;
+
+        if (device == NULL) {
+            xfer->result = ESP_ERR_NOT_SUPPORTED;
+        } else if (xfer->tx_len > 0 && xfer->rx_len > 0) {
+            xfer->result = i2c_master_transmit_receive(device, xfer->tx, xfer->tx_len, xfer->rx,
+                                                       xfer->rx_len, SENSOR_I2C_TIMEOUT_MS);
+        } else if (xfer->tx_len > 0) {
+            xfer->result = i2c_master_transmit(device, xfer->tx, xfer->tx_len, SENSOR_I2C_TIMEOUT_MS);
+        } else {
+            xfer->result = i2c_master_receive(device, xfer->rx, xfer->rx_len, SENSOR_I2C_TIMEOUT_MS);
+        }
+    }
+}
+
+// 1-Wire reset and presence detect
+esp_err_t sensor_driver_onewire_reset(int bus) {
+    bool present;
+
+    if (bus != 0 || !onewire_ready) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Holding the line low longer does no harm, so only the release and
+    // presence sample need to be exact
+    gpio_set_level(SENSOR_ONEWIRE_GPIO, 0);
+    esp_rom_delay_us(ONEWIRE_RESET_LOW_US);
+    portENTER_CRITICAL(&onewire_lock);
+    gpio_set_level(SENSOR_ONEWIRE_GPIO, 1);
+    esp_rom_delay_us(ONEWIRE_PRESENCE_WAIT_US);
+    present = gpio_get_level(SENSOR_ONEWIRE_GPIO) == 0;
+    portEXIT_CRITICAL(&onewire_lock);
+    esp_rom_delay_us(ONEWIRE_RESET_TAIL_US);
+    return present ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+// Write one bit slot
+void sensor_driver_onewire_write_bit(int bus, bool bit) {
+    if (bus != 0 || !onewire_ready) {
+        return;
+    }
+    portENTER_CRITICAL(&onewire_lock);
+    gpio_set_level(SENSOR_ONEWIRE_GPIO, 0);
+    esp_rom_delay_us(bit ? ONEWIRE_WRITE1_LOW_US : ONEWIRE_WRITE0_LOW_US);
+    gpio_set_level(SENSOR_ONEWIRE_GPIO, 1);
+    portEXIT_CRITICAL(&onewire_lock);
+    esp_rom_delay_us(bit ? ONEWIRE_WRITE1_TAIL_US : ONEWIRE_WRITE0_TAIL_US);
+}
+
+// Read one bit slot
+bool sensor_driver_onewire_read_bit(int bus) {
+    bool bit;
+
+    if (bus != 0 || !onewire_ready) {
+        return true;
+    }
+    portENTER_CRITICAL(&onewire_lock);
+    gpio_set_level(SENSOR_ONEWIRE_GPIO, 0);
+    esp_rom_delay_us(ONEWIRE_READ_LOW_US);
+    gpio_set_level(SENSOR_ONEWIRE_GPIO, 1);
+    esp_rom_delay_us(ONEWIRE_READ_WAIT_US);
+    bit = gpio_get_level(SENSOR_ONEWIRE_GPIO) != 0;
+    portEXIT_CRITICAL(&onewire_lock);
+    esp_rom_delay_us(ONEWIRE_READ_TAIL_US);
+    return bit;
+}
+
+// Write bytes, least significant bit first
+void sensor_driver_onewire_write(int bus, const uint8_t *data, int len) {
+    for (int i = 0; i < len; i++) {
+        for (int bit = 0; bit < 8; bit++) {
+            sensor_driver_onewire_write_bit(bus, (data[i] >> bit) & 1);
+        }
+    }
+}
+
+// Read bytes, least significant bit first
+void sensor_driver_onewire_read(int bus, uint8_t *data, int len) {
+    for (int i = 0; i < len; i++) {
+        uint8_t byte = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            if (sensor_driver_onewire_read_bit(bus)) {
+                byte |= 1 << bit;
+            }
+        }
+        data[i] = byte;
+    }
+}
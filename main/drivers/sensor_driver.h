@@ -0,0 +1,72 @@
+#ifndef SENSOR_DRIVER_H
+#define SENSOR_DRIVER_H
+
+#include "esp_err.h"
+#include "sensor_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Bus backend of the sensor HAL: I2C batches and 1-Wire primitives. The
+// device build drives the sensor I2C bus (shared with the relay expander)
+// and a bit-banged 1-Wire pin; headless builds and tests get a fake bus
+// with scripted devices (sensor_mock.c).
+
+// One I2C transaction of a batch: write tx, then read rx (either may be
+// empty). result is set by the backend.
+typedef struct {
+    uint8_t address;
+    uint8_t tx[2];
+    uint8_t tx_len;
+    uint8_t *rx;
+    uint8_t rx_len;
+    esp_err_t result;
+} sensor_i2c_transaction_t;
+
+// Set up the buses
+esp_err_t sensor_driver_init(void);
+
+// Run a batch of transactions on an I2C bus, in order and back to back. A
+// failed transaction does not stop the others.
+void sensor_driver_i2c_batch(int bus, sensor_i2c_transaction_t *transactions, int count);
+
+// 1-Wire reset; ESP_OK if a device answered with a presence pulse
+esp_err_t sensor_driver_onewire_reset(int bus);
+
+// 1-Wire byte and bit transfers, least significant bit first
+void sensor_driver_onewire_write(int bus, const uint8_t *data, int len);
+void sensor_driver_onewire_read(int bus, uint8_t *data, int len);
+bool sensor_driver_onewire_read_bit(int bus);
+void sensor_driver_onewire_write_bit(int bus, bool bit);
+
+#ifdef REPTICONTROL_HEADLESS
+// Fake devices per bus
+#define SENSOR_MOCK_MAX_DEVICES 8
+
+// Bus traffic seen by the fake
+typedef struct {
+    uint32_t i2c_batches;
+    uint32_t i2c_transactions;
+    uint32_t onewire_resets;
+    uint32_t onewire_conversions;   // Convert T commands, broadcast or addressed
+} sensor_mock_stats_t;
+
+// Remove every fake device and clear the counters
+void sensor_mock_reset(void);
+
+// Add an I2C chip (SHT3x, SHT4x or BH1750) or a DS18B20 with its ROM code
+void sensor_mock_add_i2c(int bus, sensor_kind_t kind, uint8_t address);
+void sensor_mock_add_ds18b20(int bus, uint64_t rom);
+
+// Set what a device measures next (light in lux; unused values ignored).
+// I2C devices are found by address, DS18B20s by ROM code.
+void sensor_mock_set_i2c(int bus, uint8_t address, float temperature, float humidity, float lux);
+void sensor_mock_set_ds18b20(int bus, uint64_t rom, float temperature);
+
+// Make a device stop answering (NACK on I2C, silent on 1-Wire)
+void sensor_mock_set_fault(int bus, uint64_t address_or_rom, bool fault);
+
+// Get the bus traffic since the last reset
+void sensor_mock_get_stats(sensor_mock_stats_t *stats);
+#endif
+
+#endif /* SENSOR_DRIVER_H */
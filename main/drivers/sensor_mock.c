@@ -0,0 +1,377 @@
+#include "sensor_driver.h"
+#include "sensor_chips.h"
+#include "esp_log.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "sensor_mock";
+
+// Where a 1-Wire bus is in a command sequence since its last reset
+typedef enum {
+    ONEWIRE_IDLE,               // Nothing addressed; writes and reads are ignored
+    ONEWIRE_ROM_COMMAND,        // Expecting Skip, Match or Search ROM
+    ONEWIRE_MATCH,              // Collecting the 8 ROM bytes of a Match ROM
+    ONEWIRE_SEARCH,             // Bit-level Search ROM
+    ONEWIRE_FUNCTION,           // Expecting Convert T or Read Scratchpad
+    ONEWIRE_READ                // Shifting out the scratchpad
+} onewire_phase_t;
+
+// A fake device: an I2C chip or a DS18B20
+typedef struct {
+    bool used;
+    int bus;
+    sensor_kind_t kind;
+    uint8_t address;
+    uint64_t rom;
+    bool fault;
+    bool started;               // I2C: a conversion was started and not yet read
+    float temperature;
+    float humidity;
+    float lux;
+    uint8_t scratchpad[DS18B20_SCRATCHPAD_LEN];
+} mock_device_t;
+
+// 1-Wire state of a bus
+typedef struct {
+    onewire_phase_t phase;
+    bool selected[SENSOR_MOCK_MAX_DEVICES];
+    uint64_t match_rom;
+    int match_bytes;
+    int search_bit;
+    bool search_complement;     // Next read is the complement bit
+    int read_pos;
+} mock_onewire_t;
+
+static mock_device_t devices[SENSOR_MOCK_MAX_DEVICES];
+static mock_onewire_t onewire[SENSOR_HAL_MAX_BUSES];
+static sensor_mock_stats_t stats;
+
+// Round and clamp a raw 16-bit value
+static uint16_t raw16(float value) {
+    if (value <= 0.0f) {
+        return 0;
+    }
+    if (value >= 65535.0f) {
+        return 65535;
+    }
+    return (uint16_t)lroundf(value);
+}
+
+// Encode an SHT measurement: two big-endian words, each with its CRC
+static void encode_sht(uint8_t *result, uint16_t t_raw, uint16_t rh_raw) {
+    result[0] = (uint8_t)(t_raw >> 8);
+    result[1] = (uint8_t)t_raw;
+    result[2] = sensor_chips_crc_sensirion(&result[0], 2);
+    result[3] = (uint8_t)(rh_raw >> 8);
+    result[4] = (uint8_t)rh_raw;
+    result[5] = sensor_chips_crc_sensirion(&result[3], 2);
+}
+
+// Fill the result a chip returns for its current measurement
+static void encode_i2c(const mock_device_t *device, uint8_t *result) {
+    switch (device->kind) {
+        case SENSOR_KIND_SHT3X:
+            encode_sht(result, raw16((device->temperature + 45.0f) * 65535.0f / 175.0f),
+                       raw16(device->humidity * 65535.0f / 100.0f));
+            break;
+        case SENSOR_KIND_SHT4X:
+            encode_sht(result, raw16((device->temperature + 45.0f) * 65535.0f / 175.0f),
+                       raw16((device->humidity + 6.0f) * 65535.0f / 125.0f));
+            break;
+        case SENSOR_KIND_BH1750: {
+            uint16_t count = raw16(device->lux * 1.2f);
+            result[0] = (uint8_t)(count >> 8);
+            result[1] = (uint8_t)count;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Latch a DS18B20 conversion into its scratchpad
+static void convert_ds18b20(mock_device_t *device) {
+    int16_t raw = (int16_t)lroundf(device->temperature * 16.0f);
+    uint8_t *sp = device->scratchpad;
+
+    sp[0] = (uint8_t)raw;
+    sp[1] = (uint8_t)((uint16_t)raw >> 8);
+    sp[2] = 0x4B;               // TH, TL alarm registers
+    sp[3] = 0x46;
+    sp[4] = 0x7F;               // 12-bit resolution
+    sp[5] = 0xFF;
+    sp[6] = 0x0C;
+    sp[7] = 0x10;
+    sp[8] = sensor_chips_crc_dallas(sp, DS18B20_SCRATCHPAD_LEN - 1);
+}
+
+// Find a working I2C device by address
+static mock_device_t *find_i2c(int bus, uint8_t address) {
+    for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+        if (devices[i].used && devices[i].bus == bus && devices[i].kind != SENSOR_KIND_DS18B20 &&
+            devices[i].address == address) {
+            return &devices[i];
+        }
+    }
+    return NULL;
+}
+
+// Find a DS18B20 by ROM code
+static mock_device_t *find_ds18b20(int bus, uint64_t rom) {
+    for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+        if (devices[i].used && devices[i].bus == bus && devices[i].kind == SENSOR_KIND_DS18B20 &&
+            devices[i].rom == rom) {
+            return &devices[i];
+        }
+    }
+    return NULL;
+}
+
+// Check if device i takes part in 1-Wire traffic on a bus
+static bool on_wire(int bus, int i) {
+    return devices[i].used && devices[i].bus == bus && devices[i].kind == SENSOR_KIND_DS18B20 &&
+           !devices[i].fault;
+}
+
+// Add a device in the first free slot
+static mock_device_t *add_device(int bus, sensor_kind_t kind) {
+    for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+        if (!devices[i].used) {
+            memset(&devices[i], 0, sizeof(devices[i]));
+            devices[i].used = true;
+            devices[i].bus = bus;
+            devices[i].kind = kind;
+            devices[i].temperature = 85.0f;     // DS18B20 power-on value
+            convert_ds18b20(&devices[i]);
+            return &devices[i];
+        }
+    }
+    ESP_LOGE(TAG, "No room for another fake device");
+    return NULL;
+}
+
+// Set up the buses
+esp_err_t sensor_driver_init(void) {
+    return ESP_OK;
+}
+
+// Run a batch of transactions against the fake I2C devices
+void sensor_driver_i2c_batch(int bus, sensor_i2c_transaction_t *transactions, int count) {
+    stats.i2c_batches++;
+
+    for (int t = 0; t < count; t++) {
+        sensor_i2c_transaction_t *xfer = &transactions[t];
+        mock_device_t *device = find_i2c(bus, xfer->address);
+
+        stats.i2c_transactions++;
+        if (device == NULL || device->fault) {
+            xfer->result = ESP_ERR_INVALID_RESPONSE;
+            continue;
+        }
+
+        const sensor_i2c_chip_t *chip = sensor_chips_get_i2c(device->kind);
+        xfer->result = ESP_OK;
+        if (xfer->tx_len > 0) {
+            device->started = xfer->tx_len == chip->command_len &&
+                              memcmp(xfer->tx, chip->command, chip->command_len) == 0;
+        }
+        if (xfer->rx_len > 0) {
+            // Nothing to read back without a conversion: the chip NACKs
+            if (!device->started) {
+                xfer->result = ESP_ERR_INVALID_STATE;
+                continue;
+            }
+            uint8_t result[6] = { 0 };
+            encode_i2c(device, result);
+            memcpy(xfer->rx, result, xfer->rx_len < sizeof(result) ? xfer->rx_len : sizeof(result));
+            device->started = false;
+        }
+    }
+}
+
+// 1-Wire reset: every working DS18B20 answers
+esp_err_t sensor_driver_onewire_reset(int bus) {
+    mock_onewire_t *wire = &onewire[bus];
+    bool present = false;
+
+    stats.onewire_resets++;
+    for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+        present |= on_wire(bus, i);
+    }
+    memset(wire, 0, sizeof(*wire));
+    wire->phase = present ? ONEWIRE_ROM_COMMAND : ONEWIRE_IDLE;
+    return present ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+// Handle one byte written to a 1-Wire bus
+static void onewire_write_byte(int bus, uint8_t byte) {
+    mock_onewire_t *wire = &onewire[bus];
+
+    switch (wire->phase) {
+        case ONEWIRE_ROM_COMMAND:
+            if (byte == DS18B20_CMD_SKIP_ROM) {
+                for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+                    wire->selected[i] = on_wire(bus, i);
+                }
+                wire->phase = ONEWIRE_FUNCTION;
+            } else if (byte == DS18B20_CMD_MATCH_ROM) {
+                wire->phase = ONEWIRE_MATCH;
+            } else if (byte == DS18B20_CMD_SEARCH_ROM) {
+                for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+                    wire->selected[i] = on_wire(bus, i);
+                }
+                wire->phase = ONEWIRE_SEARCH;
+            } else {
+                wire->phase = ONEWIRE_IDLE;
+            }
+            break;
+        case ONEWIRE_MATCH:
+            wire->match_rom |= (uint64_t)byte << (8 * wire->match_bytes);
+            if (++wire->match_bytes == 8) {
+                for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+                    wire->selected[i] = on_wire(bus, i) && devices[i].rom == wire->match_rom;
+                }
+                wire->phase = ONEWIRE_FUNCTION;
+            }
+            break;
+        case ONEWIRE_FUNCTION:
+            if (byte == DS18B20_CMD_CONVERT) {
+                for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+                    if (wire->selected[i]) {
+                        convert_ds18b20(&devices[i]);
+                    }
+                }
+                stats.onewire_conversions++;
+                wire->phase = ONEWIRE_IDLE;
+            } else if (byte == DS18B20_CMD_READ_SCRATCHPAD) {
+                wire->phase = ONEWIRE_READ;
+                wire->read_pos = 0;
+            } else {
+                wire->phase = ONEWIRE_IDLE;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Write bytes to a 1-Wire bus
+void sensor_driver_onewire_write(int bus, const uint8_t *data, int len) {
+    for (int i = 0; i < len; i++) {
+        onewire_write_byte(bus, data[i]);
+    }
+}
+
+// Read bytes from a 1-Wire bus: the selected devices' scratchpads, wired-AND
+void sensor_driver_onewire_read(int bus, uint8_t *data, int len) {
+    mock_onewire_t *wire = &onewire[bus];
+
+    for (int n = 0; n < len; n++) {
+        uint8_t byte = 0xFF;
+        if (wire->phase == ONEWIRE_READ && wire->read_pos < DS18B20_SCRATCHPAD_LEN) {
+            for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+                if (wire->selected[i]) {
+                    byte &= devices[i].scratchpad[wire->read_pos];
+                }
+            }
+            wire->read_pos++;
+        }
+        data[n] = byte;
+    }
+}
+
+// Read one bit: during a search, the ROM bit (then its complement) of every
+// device still taking part, wired-AND; otherwise the idle-high line
+bool sensor_driver_onewire_read_bit(int bus) {
+    mock_onewire_t *wire = &onewire[bus];
+    bool bit = true;
+
+    if (wire->phase != ONEWIRE_SEARCH || wire->search_bit >= 64) {
+        return true;
+    }
+    for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+        if (wire->selected[i]) {
+            bool rom_bit = (devices[i].rom >> wire->search_bit) & 1;
+            bit &= wire->search_complement ? !rom_bit : rom_bit;
+        }
+    }
+    wire->search_complement = !wire->search_complement;
+    return bit;
+}
+
+// Write one bit: during a search, the direction taken; devices whose ROM
+// bit differs drop out until the next reset
+void sensor_driver_onewire_write_bit(int bus, bool bit) {
+    mock_onewire_t *wire = &onewire[bus];
+
+    if (wire->phase != ONEWIRE_SEARCH || wire->search_bit >= 64) {
+        return;
+    }
+    for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+        if (wire->selected[i] && (bool)((devices[i].rom >> wire->search_bit) & 1) != bit) {
+            wire->selected[i] = false;
+        }
+    }
+    wire->search_bit++;
+    wire->search_complement = false;
+}
+
+// Remove every fake device and clear the counters
+void sensor_mock_reset(void) {
+    memset(devices, 0, sizeof(devices));
+    memset(onewire, 0, sizeof(onewire));
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Add an I2C chip
+void sensor_mock_add_i2c(int bus, sensor_kind_t kind, uint8_t address) {
+    mock_device_t *device = add_device(bus, kind);
+    if (device != NULL) {
+        device->address = address;
+    }
+}
+
+// Add a DS18B20
+void sensor_mock_add_ds18b20(int bus, uint64_t rom) {
+    mock_device_t *device = add_device(bus, SENSOR_KIND_DS18B20);
+    if (device != NULL) {
+        device->rom = rom;
+    }
+}
+
+// Set what an I2C device measures next
+void sensor_mock_set_i2c(int bus, uint8_t address, float temperature, float humidity, float lux) {
+    mock_device_t *device = find_i2c(bus, address);
+    if (device != NULL) {
+        device->temperature = temperature;
+        device->humidity = humidity;
+        device->lux = lux;
+    }
+}
+
+// Set what a DS18B20 measures on its next conversion
+void sensor_mock_set_ds18b20(int bus, uint64_t rom, float temperature) {
+    mock_device_t *device = find_ds18b20(bus, rom);
+    if (device != NULL) {
+        device->temperature = temperature;
+    }
+}
+
+// Make a device stop answering
+void sensor_mock_set_fault(int bus, uint64_t address_or_rom, bool fault) {
+    for (int i = 0; i < SENSOR_MOCK_MAX_DEVICES; i++) {
+        mock_device_t *device = &devices[i];
+        if (!device->used || device->bus != bus) {
+            continue;
+        }
+        uint64_t id = device->kind == SENSOR_KIND_DS18B20 ? device->rom : device->address;
+        if (id == address_or_rom) {
+            device->fault = fault;
+        }
+    }
+}
+
+// Get the bus traffic since the last reset
+void sensor_mock_get_stats(sensor_mock_stats_t *out) {
+    *out = stats;
+}
@@ -9,6 +9,10 @@ static const char *TAG = "touch_driver";
 
 // Touch input driver
 static lv_indev_drv_t indev_drv;
+static lv_indev_t *indev = NULL;
+
+// Alternate input source, NULL when reading the controller
+static const touch_source_t *active_source = NULL;
 
 // This is a stub implementation for the simulator
 // In a real implementation, this would communicate with the touch controller
@@ -19,7 +23,7 @@ esp_err_t touch_init(void) {
     lv_indev_drv_init(&indev_drv);
     indev_drv.type = LV_INDEV_TYPE_POINTER;  // Touchscreen
     indev_drv.read_cb = touch_read_cb;
-    lv_indev_drv_register(&indev_drv);
+    indev = lv_indev_drv_register(&indev_drv);
 
     ESP_LOGI(TAG, "Touch driver initialized");
     return ESP_OK;
@@ -33,9 +37,27 @@ void touch_read(void) {
 
 // LVGL touch input callback - this would read from the input queue
 void touch_read_cb(struct _lv_indev_drv_t *indev_drv, lv_indev_data_t *data) {
+    if (active_source) {
+        bool pressed = false;
+        active_source->read(&data->point.x, &data->point.y, &pressed);
+        data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+        return;
+    }
+
     // In a real implementation, this would read from the queued touch data
     // For simulation, we'll report no touch events
     data->state = LV_INDEV_STATE_RELEASED;
     data->point.x = 0;
     data->point.y = 0;
 }
+
+// Route LVGL input through another source
+void touch_driver_set_source(const touch_source_t *source) {
+    active_source = source;
+    ESP_LOGI(TAG, "Touch input source: %s", source ? source->name : "controller");
+}
+
+// LVGL input device registered by touch_init()
+lv_indev_t *touch_driver_get_indev(void) {
+    return indev;
+}
@@ -2,6 +2,14 @@
 #define TOUCH_DRIVER_H
 
 #include "esp_err.h"
+#include "lvgl.h"
+#include <stdbool.h>
+
+// Pluggable touch input source (hardware controller, replay script, ...)
+typedef struct {
+    const char *name;
+    void (*read)(lv_coord_t *x, lv_coord_t *y, bool *pressed);
+} touch_source_t;
 
 // Touch driver initialization
 esp_err_t touch_init(void);
@@ -12,4 +20,10 @@ void touch_read(void);
 // LVGL touch read callback
 void touch_read_cb(struct _lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
 
+// Route LVGL input through another source (NULL restores the controller)
+void touch_driver_set_source(const touch_source_t *source);
+
+// LVGL input device registered by touch_init()
+lv_indev_t *touch_driver_get_indev(void);
+
 #endif /* TOUCH_DRIVER_H */
@@ -0,0 +1,98 @@
+#include "touch_replay.h"
+#include "lvgl.h"
+
+// Script being replayed
+static const touch_event_t *script = NULL;
+static size_t script_len = 0;
+static size_t cursor = 0;
+static uint32_t start_tick = 0;
+
+// Last delivered state
+static bool last_pressed = false;
+static uint32_t transitions = 0;
+
+static void replay_read(lv_coord_t *x, lv_coord_t *y, bool *pressed);
+
+static const touch_source_t replay_source = {
+    .name = "replay",
+    .read = replay_read,
+};
+
+// Start replaying a script from the current LVGL tick
+void touch_replay_start(const touch_event_t *events, size_t count) {
+    script = events;
+    script_len = count;
+    cursor = 0;
+    start_tick = lv_tick_get();
+    last_pressed = false;
+    transitions = 0;
+}
+
+// Stop replaying
+void touch_replay_stop(void) {
+    script = NULL;
+    script_len = 0;
+}
+
+// True once the last script sample has been delivered
+bool touch_replay_is_done(void) {
+    return !script || (cursor + 1 >= script_len &&
+                       lv_tick_elaps(start_tick) >= script[script_len - 1].t_ms);
+}
+
+// Number of press/release transitions delivered so far
+uint32_t touch_replay_get_transitions(void) {
+    return transitions;
+}
+
+// Touch source to install with touch_driver_set_source()
+const touch_source_t *touch_replay_get_source(void) {
+    return &replay_source;
+}
+
+// Map a per mille coordinate to pixels on the default display
+static lv_coord_t scale(uint32_t permille, lv_coord_t res) {
+    return (lv_coord_t)(permille * (uint32_t)(res - 1) / 1000);
+}
+
+static void replay_read(lv_coord_t *x, lv_coord_t *y, bool *pressed) {
+    if (!script || script_len == 0) {
+        *pressed = false;
+        return;
+    }
+
+    uint32_t now = lv_tick_elaps(start_tick);
+    if (now < script[0].t_ms) {
+        *pressed = false;
+        return;
+    }
+
+    // Advance to the last sample at or before now
+    while (cursor + 1 < script_len && script[cursor + 1].t_ms <= now) {
+        cursor++;
+    }
+
+    const touch_event_t *a = &script[cursor];
+    uint32_t px = a->x;
+    uint32_t py = a->y;
+
+    // Interpolate between two pressed samples (drag)
+    if (a->pressed && cursor + 1 < script_len && script[cursor + 1].pressed) {
+        const touch_event_t *b = &script[cursor + 1];
+        uint32_t span = b->t_ms - a->t_ms;
+        uint32_t t = now - a->t_ms;
+        if (span > 0) {
+            px = a->x + ((int32_t)b->x - (int32_t)a->x) * (int32_t)t / (int32_t)span;
+            py = a->y + ((int32_t)b->y - (int32_t)a->y) * (int32_t)t / (int32_t)span;
+        }
+    }
+
+    *x = scale(px, lv_disp_get_hor_res(NULL));
+    *y = scale(py, lv_disp_get_ver_res(NULL));
+    *pressed = a->pressed;
+
+    if (*pressed != last_pressed) {
+        transitions++;
+        last_pressed = *pressed;
+    }
+}
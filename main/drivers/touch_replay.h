@@ -0,0 +1,35 @@
+#ifndef TOUCH_REPLAY_H
+#define TOUCH_REPLAY_H
+
+#include "touch_driver.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One timestamped sample of a touch script. Positions are given in per mille
+// of the screen size so the same script runs at 1024x600 and 800x480.
+// Consecutive pressed samples are interpolated, which turns two samples into
+// a drag.
+typedef struct {
+    uint32_t t_ms;      // Offset from script start
+    uint16_t x;         // 0..1000 of horizontal resolution
+    uint16_t y;         // 0..1000 of vertical resolution
+    bool pressed;
+} touch_event_t;
+
+// Start replaying a script from the current LVGL tick
+void touch_replay_start(const touch_event_t *events, size_t count);
+
+// Stop replaying; the source reports released from now on
+void touch_replay_stop(void);
+
+// True once the last script sample has been delivered
+bool touch_replay_is_done(void);
+
+// Number of press/release transitions delivered so far
+uint32_t touch_replay_get_transitions(void);
+
+// Touch source to install with touch_driver_set_source()
+const touch_source_t *touch_replay_get_source(void);
+
+#endif /* TOUCH_REPLAY_H */
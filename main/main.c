@@ -3,11 +3,46 @@
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_system.h"
+#ifndef REPTICONTROL_HEADLESS
 #include "esp_spi_flash.h"
+#endif
 #include "nvs_flash.h"
 #include "esp_log.h"
 
 #include "app_main.h"
+#ifdef REPTICONTROL_SOAK
+#include <stdlib.h>
+#include "utils/soak_test.h"
+#endif
+#ifdef REPTICONTROL_STORAGE_BENCH
+#include <stdlib.h>
+#include "utils/storage_bench.h"
+#endif
+#ifdef REPTICONTROL_HOT_PATH_BENCH
+#include "drivers/display_driver.h"
+#include "drivers/touch_driver.h"
+#include "core/climate_controller.h"
+#include "core/data_simulator.h"
+#include "core/event_logger.h"
+#include "core/sensor_hal.h"
+#include "core/settings_manager.h"
+#include "utils/hot_path_bench.h"
+#endif
+#ifdef REPTICONTROL_CONTROL_BENCH
+#include <stdlib.h>
+#include "drivers/display_driver.h"
+#include "core/event_logger.h"
+#include "core/settings_manager.h"
+#include "utils/control_bench.h"
+#endif
+#ifdef REPTICONTROL_UI_BENCH
+#include <stdlib.h>
+#include "drivers/touch_driver.h"
+#include "core/schedule_manager.h"
+#include "ui/ui.h"
+#include "utils/ui_bench.h"
+#include "utils/ui_interaction_bench.h"
+#endif
 
 static const char *TAG = "ReptiControl";
 
@@ -21,6 +56,58 @@ void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
 
+#ifdef REPTICONTROL_STORAGE_BENCH
+    // Storage benchmark build: compare persistence backends and exit
+    exit(storage_bench_run() == ESP_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+#endif
+
+#ifdef REPTICONTROL_HOT_PATH_BENCH
+    // Hot-path build: time the control, flush, touch and logger paths with a
+    // warm and a cold cache, then stop
+    settings_init();
+    event_logger_init();
+    lv_init();
+    display_init();
+    touch_init();
+    climate_controller_init();
+    data_simulator_init();
+
+    // The controller reads the HAL; give it a sample of every slot, or the
+    // update would time a zone at 0 °C with the heater always on
+    sensor_hal_init();
+    sensor_hal_poll(0);
+    hot_path_bench_run();
+    return;
+#endif
+
+#ifdef REPTICONTROL_CONTROL_BENCH
+    // Control build: hysteresis vs PID on the simulator in virtual time
+    settings_init();
+    event_logger_init();
+    lv_init();
+    display_init();
+    exit(control_bench_run() == ESP_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+#endif
+
+#ifdef REPTICONTROL_SOAK
+    // Soak build: run weeks of virtual time and check for resource growth
+    exit(soak_test_run() == ESP_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+#endif
+
+#ifdef REPTICONTROL_UI_BENCH
+    // Benchmark build: render every screen headless, replay the scripted
+    // interactions and report. The schedule screen edits the entry table.
+    schedule_manager_init();
+    esp_err_t bench = ui_bench_run();
+    touch_init();
+    ui_init();
+    if (ui_interaction_bench_run() != ESP_OK) {
+        bench = ESP_FAIL;
+    }
+    exit(bench == ESP_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+#endif
+
+#ifndef REPTICONTROL_HEADLESS
     // Print chip information
     esp_chip_info_t chip_info;
     esp_chip_info(&chip_info);
@@ -32,6 +119,7 @@ void app_main(void)
              chip_info.revision);
     ESP_LOGI(TAG, "%dMB %s flash", spi_flash_get_chip_size() / (1024 * 1024),
              (chip_info.features & CHIP_FEATURE_EMB_FLASH) ? "embedded" : "external");
+#endif
     ESP_LOGI(TAG, "Free heap: %d bytes", esp_get_free_heap_size());
 
     // Start the main ReptiControl application
@@ -54,8 +54,16 @@
 // I2C Sensors
 #define SENSOR_I2C_SCL     33  // I2C Clock for sensors
 #define SENSOR_I2C_SDA     34  // I2C Data for sensors
+#define SENSOR_ONEWIRE_GPIO 0  // DS18B20 probes (4.7k pull-up; strapping pin, idles high)
 
 // LCD Backlight Control
 #define LCD_BK_LIGHT_GPIO  25  // Backlight control pin
 
+// Actuator Outputs
+#define RELAY_EXPANDER_ADDR  0x20  // TCA9554 relay expander on the sensor I2C bus
+#define RELAY_HEATER_BIT     0     // Expander output bits
+#define RELAY_FAN_BIT        1
+#define RELAY_HUMIDIFIER_BIT 2
+#define LAMP_PWM_GPIO        38    // LEDC output to the lamp dimmer
+
 #endif /* PIN_MAPPING_H */
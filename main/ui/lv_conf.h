@@ -12,8 +12,14 @@
 #define LV_COLOR_DEPTH 16
 
 // Memory size settings
+#ifdef REPTICONTROL_HEADLESS
+// Host builds use LVGL's own pool so lv_mem_monitor() reports real usage
+#define LV_MEM_CUSTOM 0
+#define LV_MEM_SIZE (2048U * 1024U)
+#else
 #define LV_MEM_CUSTOM 1
 #define LV_MEM_SIZE (48U * 1024U)
+#endif
 #define LV_MEM_POOL_INCLUDE <stdlib.h>
 #define LV_MEM_POOL_ALLOC malloc
 #define LV_MEM_POOL_FREE free
@@ -1,5 +1,6 @@
 #include "ui_climate.h"
 #include "../ui_helpers.h"
+#include "core/species_preset.h"
 #include "esp_log.h"
 
 static const char *TAG = "ui_climate";
@@ -15,12 +16,15 @@ static lv_obj_t *toggle_heating;
 static lv_obj_t *toggle_cooling;
 static lv_obj_t *toggle_humidifier;
 static lv_obj_t *toggle_lighting;
+static lv_obj_t *dropdown_species;
+static lv_obj_t *label_uvb;
 
 // Callback prototypes
 static void temp_slider_cb(lv_event_t *e);
 static void humidity_slider_cb(lv_event_t *e);
 static void light_slider_cb(lv_event_t *e);
 static void toggle_cb(lv_event_t *e);
+static void species_cb(lv_event_t *e);
 
 // Create the climate control screen
 lv_obj_t *ui_climate_create(void) {
@@ -44,6 +48,23 @@ lv_obj_t *ui_climate_create(void) {
     lv_obj_set_style_text_font(title, &lv_font_montserrat_18, 0);
     lv_obj_align(title, LV_ALIGN_LEFT_MID, GRID_UNIT * 2, 0);
 
+    // Species preset selector, applied to zone 0 like the schedule screen;
+    // "Custom" leaves the targets alone
+    dropdown_species = lv_dropdown_create(header);
+    lv_dropdown_set_options(dropdown_species, "Custom");
+    for (int i = 0; i < species_preset_count(); i++) {
+        lv_dropdown_add_option(dropdown_species, species_preset_get(i)->name, LV_DROPDOWN_POS_LAST);
+    }
+    lv_obj_set_width(dropdown_species, GRID_UNIT * 28);
+    lv_obj_align(dropdown_species, LV_ALIGN_RIGHT_MID, -GRID_UNIT * 2, 0);
+    lv_obj_add_event_cb(dropdown_species, species_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+    // UVB hours of the preset, for the keeper to set the lamp timer
+    label_uvb = lv_label_create(header);
+    lv_obj_add_style(label_uvb, &style_text_muted, 0);
+    lv_label_set_text(label_uvb, "");
+    lv_obj_align_to(label_uvb, dropdown_species, LV_ALIGN_OUT_LEFT_MID, -GRID_UNIT * 2, 0);
+
     // Create main content container with grid layout
     lv_obj_t *content = lv_obj_create(screen);
     lv_obj_set_size(content, LV_HOR_RES - SCREEN_PADDING * 2, LV_VER_RES - TOUCH_TARGET_MIN - SCREEN_PADDING * 2);
@@ -198,3 +219,26 @@ static void toggle_cb(lv_event_t *e) {
         animate_pulse(toggle, 1500);
     }
 }
+
+// Species preset callback: apply the preset and show its targets
+static void species_cb(lv_event_t *e) {
+    lv_obj_t *dropdown = lv_event_get_target(e);
+    const species_preset_t *preset = species_preset_get((int)lv_dropdown_get_selected(dropdown) - 1);
+
+    if (preset == NULL) {
+        lv_label_set_text(label_uvb, "");
+        return;
+    }
+    if (species_preset_apply(0, preset) != ESP_OK) {
+        ESP_LOGW(TAG, "Preset %s not applied", preset->key);
+        lv_dropdown_set_selected(dropdown, 0);
+        lv_label_set_text(label_uvb, "");
+        return;
+    }
+
+    lv_slider_set_value(slider_temp, (int)preset->day_temp, LV_ANIM_ON);
+    lv_slider_set_value(slider_humidity, (int)preset->day_humidity, LV_ANIM_ON);
+    lv_label_set_text_fmt(value_temp, "%.1f°C", preset->day_temp);
+    lv_label_set_text_fmt(value_humidity, "%.1f%%", preset->day_humidity);
+    lv_label_set_text_fmt(label_uvb, "UVB %d h of %d h", preset->uvb_h, preset->photoperiod_h);
+}
@@ -11,6 +11,9 @@ static lv_obj_t *gauge_light;
 static lv_obj_t *value_temp;
 static lv_obj_t *value_humidity;
 static lv_obj_t *value_light;
+static lv_obj_t *probe_values[PROBE_COUNT];
+static lv_obj_t *probe_fusion_label;
+static lv_obj_t *stats_label;
 static lv_obj_t *time_label;
 static lv_obj_t *date_label;
 static lv_obj_t *status_panel;
@@ -76,6 +79,35 @@ lv_obj_t *ui_dashboard_create(void) {
     gauge_humidity = create_gauge(gauge_container, "Humidity", "%", 0, 100, COLOR_INFO);
     gauge_light = create_gauge(gauge_container, "Light", "%", 0, 100, COLOR_WARNING);
 
+    // Create probe readout, one column per probe
+    lv_obj_t *probe_container = lv_obj_create(sensors_card);
+    lv_obj_set_size(probe_container, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(probe_container, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(probe_container, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_top(probe_container, GRID_UNIT, 0);
+
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        lv_obj_t *column = lv_obj_create(probe_container);
+        lv_obj_set_size(column, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+        lv_obj_set_flex_flow(column, LV_FLEX_FLOW_COLUMN);
+        lv_obj_set_flex_align(column, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+        lv_obj_t *name = lv_label_create(column);
+        lv_label_set_text(name, probe_manager_get_name(p));
+        lv_obj_add_style(name, &style_text_muted, 0);
+
+        probe_values[p] = lv_label_create(column);
+        lv_label_set_text(probe_values[p], "--");
+    }
+
+    probe_fusion_label = lv_label_create(sensors_card);
+    lv_label_set_text(probe_fusion_label, "");
+    lv_obj_add_style(probe_fusion_label, &style_text_muted, 0);
+
+    stats_label = lv_label_create(sensors_card);
+    lv_label_set_text(stats_label, "");
+    lv_obj_add_style(stats_label, &style_text_muted, 0);
+
     // Create status card
     lv_obj_t *status_card = create_card(content, "System Status", LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     lv_obj_set_grid_cell(status_card, 1, 1, 1, LV_GRID_ALIGN_STRETCH, LV_GRID_ALIGN_STRETCH);
@@ -175,6 +207,54 @@ void ui_dashboard_update_status(int battery_level, bool heating_on, bool cooling
     }
 }
 
+// Update the probe readout with a zone's probes
+void ui_dashboard_update_probes(const probe_readings_t *readings) {
+    // Called from the monitor task whether or not the screen exists
+    if (!probe_fusion_label) {
+        return;
+    }
+
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        if (!(readings->fitted & PROBE_BIT(p))) {
+            lv_label_set_text(probe_values[p], "--");
+            lv_obj_set_style_text_color(probe_values[p], COLOR_TEXT_SECONDARY, 0);
+        } else if (readings->ok & PROBE_BIT(p)) {
+            lv_label_set_text_fmt(probe_values[p], "%.1f °C", readings->value[p]);
+            lv_obj_set_style_text_color(probe_values[p], COLOR_TEXT, 0);
+        } else {
+            lv_label_set_text(probe_values[p], LV_SYMBOL_WARNING " fault");
+            lv_obj_set_style_text_color(probe_values[p], COLOR_ERROR, 0);
+        }
+    }
+
+    if (!readings->fused) {
+        lv_label_set_text(probe_fusion_label, "No probes: controlling on the zone sensor");
+    } else if (readings->fusion == PROBE_FUSION_GRADIENT) {
+        lv_label_set_text_fmt(probe_fusion_label, "Gradient %.1f °C  (heat %.1f / cool %.1f)",
+                              readings->spread, readings->heat_temp, readings->cool_temp);
+    } else {
+        lv_label_set_text_fmt(probe_fusion_label, "%s: %.1f °C  Gradient %.1f °C",
+                              probe_manager_get_fusion_name(readings->fusion),
+                              readings->heat_temp, readings->spread);
+    }
+}
+
+// Update the day's temperature and humidity range
+void ui_dashboard_update_stats(const stream_summary_t *temperature, const stream_summary_t *humidity) {
+    // Called from the monitor task whether or not the screen exists
+    if (!stats_label) {
+        return;
+    }
+
+    if (temperature->count == 0 || humidity->count == 0) {
+        lv_label_set_text(stats_label, "");
+        return;
+    }
+    lv_label_set_text_fmt(stats_label, "Day %.1f-%.1f °C (p95 %.1f)  %.0f-%.0f %%",
+                          temperature->min, temperature->max, temperature->quantile[STREAM_STATS_P95],
+                          humidity->min, humidity->max);
+}
+
 // Update time display
 void ui_dashboard_update_time(int hour, int minute) {
     lv_label_set_text_fmt(time_label, "%02d:%02d", hour, minute);
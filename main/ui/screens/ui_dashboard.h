@@ -2,6 +2,8 @@
 #define UI_DASHBOARD_H
 
 #include "lvgl.h"
+#include "core/probe_manager.h"
+#include "core/stream_stats.h"
 #include <stdbool.h>
 
 // Create the dashboard screen
@@ -14,6 +16,14 @@ void ui_dashboard_update_sensors(float temperature, float humidity, float light)
 void ui_dashboard_update_status(int battery_level, bool heating_on, bool cooling_on,
                               bool humidifier_on, bool lighting_on);
 
+// Update the probe readout with a zone's probes; safe to call before the
+// screen exists
+void ui_dashboard_update_probes(const probe_readings_t *readings);
+
+// Update the day's range of a zone's temperature and humidity; safe to
+// call before the screen exists
+void ui_dashboard_update_stats(const stream_summary_t *temperature, const stream_summary_t *humidity);
+
 // Update time display
 void ui_dashboard_update_time(int hour, int minute);
 
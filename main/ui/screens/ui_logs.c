@@ -1,17 +1,41 @@
 #include "ui_logs.h"
 #include "../ui_helpers.h"
 #include "esp_log.h"
+#include <string.h>
 #include <time.h>
 
 static const char *TAG = "ui_logs";
 
+// Maximum number of entries shown; rows are created once and recycled
+#define LOG_POOL_SIZE 50
+#define LOG_TEXT_LEN 128
+
+// Pooled log row. Labels point at the static text buffers so updating a
+// row never allocates.
+typedef struct {
+    lv_obj_t *row;
+    lv_obj_t *badge;
+    lv_obj_t *icon_label;
+    lv_obj_t *time_label;
+    lv_obj_t *msg_label;
+    char time_text[16];
+    char msg_text[LOG_TEXT_LEN];
+    bool is_alert;
+    bool used;
+} log_row_t;
+
 // Store references
 static lv_obj_t *log_list;
-static int log_count = 0;
+static log_row_t log_rows[LOG_POOL_SIZE];
+static int log_next_row = 0;
 
 // Button handlers
 static void clear_logs_cb(lv_event_t *e);
+static void clear_confirm_cb(lv_event_t *e);
+static void clear_done_cb(lv_timer_t *t);
 static void filter_logs_cb(lv_event_t *e);
+static void filter_select_cb(lv_event_t *e);
+static void create_log_rows(void);
 
 // Create the logs screen
 lv_obj_t *ui_logs_create(void) {
@@ -78,6 +102,7 @@ lv_obj_t *ui_logs_create(void) {
     lv_obj_set_size(log_list, LV_PCT(100), LV_PCT(100));
     lv_obj_set_style_pad_all(log_list, GRID_UNIT, 0);
     lv_obj_set_style_pad_row(log_list, GRID_UNIT / 2, 0);
+    create_log_rows();
 
     // Add some initial log entries for demonstration
     ui_logs_add_entry("System started", false);
@@ -89,6 +114,40 @@ lv_obj_t *ui_logs_create(void) {
     return screen;
 }
 
+// Create the hidden row pool
+static void create_log_rows(void) {
+    log_next_row = 0;
+
+    for (int i = 0; i < LOG_POOL_SIZE; i++) {
+        log_row_t *r = &log_rows[i];
+        memset(r, 0, sizeof(*r));
+
+        r->row = lv_obj_create(log_list);
+        lv_obj_set_size(r->row, LV_PCT(100), LV_SIZE_CONTENT);
+        lv_obj_set_style_pad_all(r->row, GRID_UNIT, 0);
+        lv_obj_set_style_bg_opa(r->row, LV_OPA_40, 0);
+        lv_obj_set_style_radius(r->row, BORDER_RADIUS / 2, 0);
+        lv_obj_add_flag(r->row, LV_OBJ_FLAG_HIDDEN);
+        add_ripple_effect(r->row);
+
+        // Badge for alert/info icon
+        r->badge = create_badge(r->row, LV_SYMBOL_FILE, COLOR_PRIMARY);
+        r->icon_label = lv_obj_get_child(r->badge, 0);
+        lv_obj_align(r->badge, LV_ALIGN_LEFT_MID, 0, 0);
+
+        // Time label
+        r->time_label = lv_label_create(r->row);
+        lv_label_set_text_static(r->time_label, r->time_text);
+        lv_obj_add_style(r->time_label, &style_text_muted, 0);
+        lv_obj_align(r->time_label, LV_ALIGN_LEFT_MID, TOUCH_TARGET_MIN * 1.2, 0);
+
+        // Message label
+        r->msg_label = lv_label_create(r->row);
+        lv_label_set_text_static(r->msg_label, r->msg_text);
+        lv_obj_align(r->msg_label, LV_ALIGN_LEFT_MID, TOUCH_TARGET_MIN * 2.5, 0);
+    }
+}
+
 // Add an entry to the log
 void ui_logs_add_entry(const char* message, bool is_alert) {
     if (!log_list) return;
@@ -99,50 +158,37 @@ void ui_logs_add_entry(const char* message, bool is_alert) {
     time(&now);
     localtime_r(&now, &timeinfo);
 
-    // Format time string
-    char time_str[16];
-    strftime(time_str, sizeof(time_str), "%H:%M:%S", &timeinfo);
-
-    // Create log entry container
-    lv_obj_t *entry = lv_obj_create(log_list);
-    lv_obj_set_size(entry, LV_PCT(100), LV_SIZE_CONTENT);
-    lv_obj_set_style_pad_all(entry, GRID_UNIT, 0);
-    lv_obj_set_style_bg_color(entry, is_alert ? lv_color_hex(0xFFF3E0) : lv_color_hex(0xF5F5F5), 0);
-    lv_obj_set_style_bg_opa(entry, LV_OPA_40, 0);
-    lv_obj_set_style_radius(entry, BORDER_RADIUS / 2, 0);
-    add_ripple_effect(entry);
-
-    // Create badge for alert/info icon
-    lv_obj_t *icon_badge = create_badge(entry,
-                                      is_alert ? LV_SYMBOL_WARNING : LV_SYMBOL_FILE,
-                                      is_alert ? COLOR_WARNING : COLOR_PRIMARY);
-    lv_obj_align(icon_badge, LV_ALIGN_LEFT_MID, 0, 0);
-
-    // Time label
-    lv_obj_t *time_label = lv_label_create(entry);
-    lv_label_set_text(time_label, time_str);
-    lv_obj_add_style(time_label, &style_text_muted, 0);
-    lv_obj_align(time_label, LV_ALIGN_LEFT_MID, TOUCH_TARGET_MIN * 1.2, 0);
-
-    // Message label
-    lv_obj_t *msg_label = lv_label_create(entry);
-    lv_label_set_text(msg_label, message);
-    lv_obj_set_style_text_color(msg_label, is_alert ? COLOR_ERROR : COLOR_TEXT, 0);
-    lv_obj_align(msg_label, LV_ALIGN_LEFT_MID, TOUCH_TARGET_MIN * 2.5, 0);
+    // Reuse the oldest row
+    log_row_t *r = &log_rows[log_next_row];
+    log_next_row = (log_next_row + 1) % LOG_POOL_SIZE;
+
+    strftime(r->time_text, sizeof(r->time_text), "%H:%M:%S", &timeinfo);
+    strncpy(r->msg_text, message, sizeof(r->msg_text) - 1);
+    r->msg_text[sizeof(r->msg_text) - 1] = '\0';
+    r->is_alert = is_alert;
+    r->used = true;
+
+    lv_obj_set_style_bg_color(r->row, is_alert ? lv_color_hex(0xFFF3E0) : lv_color_hex(0xF5F5F5), 0);
+    lv_obj_set_style_bg_color(r->badge, is_alert ? COLOR_WARNING : COLOR_PRIMARY, 0);
+    lv_label_set_text_static(r->icon_label, is_alert ? LV_SYMBOL_WARNING : LV_SYMBOL_FILE);
+    lv_label_set_text_static(r->time_label, r->time_text);
+    lv_label_set_text_static(r->msg_label, r->msg_text);
+    lv_obj_set_style_text_color(r->msg_label, is_alert ? COLOR_ERROR : COLOR_TEXT, 0);
+    lv_obj_clear_flag(r->row, LV_OBJ_FLAG_HIDDEN);
 
     // Ensure newest logs appear at the top
-    if (lv_obj_get_child_cnt(log_list) > 0) {
-        lv_obj_move_to_index(entry, 0);
-    }
+    lv_obj_move_to_index(r->row, 0);
+}
 
-    // Limit maximum number of log entries
-    if (log_count >= 50) {
-        lv_obj_t *last_entry = lv_obj_get_child(log_list, lv_obj_get_child_cnt(log_list) - 1);
-        if (last_entry) {
-            lv_obj_del_anim(last_entry, LV_ANIM_OFF);
+// Count the alert and info rows the current filter shows
+void ui_logs_get_shown(int *alerts, int *info) {
+    *alerts = 0;
+    *info = 0;
+    for (int i = 0; i < LOG_POOL_SIZE; i++) {
+        const log_row_t *r = &log_rows[i];
+        if (r->used && !lv_obj_has_flag(r->row, LV_OBJ_FLAG_HIDDEN)) {
+            *(r->is_alert ? alerts : info) += 1;
         }
-    } else {
-        log_count++;
     }
 }
 
@@ -156,29 +202,46 @@ void ui_logs_clear(void) {
                                      "Are you sure you want to clear all logs?", btns, false);
     lv_obj_add_style(mbox, &style_alert_box, 0);
     lv_obj_center(mbox);
+    lv_obj_add_event_cb(mbox, clear_confirm_cb, LV_EVENT_VALUE_CHANGED, NULL);
+}
 
-    lv_obj_add_event_cb(mbox, [](lv_event_t *e) {
-        const char *btn_text = lv_msgbox_get_active_btn_text(lv_event_get_current_target(e));
-        if (strcmp(btn_text, "Yes") == 0) {
-            // Clear logs with fade-out animation
-            lv_obj_t *list = log_list;
-            uint32_t child_count = lv_obj_get_child_cnt(list);
+// Clear button handler
+static void clear_logs_cb(lv_event_t *e) {
+    ui_logs_clear();
+}
 
-            for (uint32_t i = 0; i < child_count; i++) {
-                lv_obj_t *child = lv_obj_get_child(list, i);
-                lv_obj_fade_out(child, 300, i * 50);
+// Clear confirmation handler
+static void clear_confirm_cb(lv_event_t *e) {
+    lv_obj_t *mbox = lv_event_get_current_target(e);
+    const char *btn_text = lv_msgbox_get_active_btn_text(mbox);
+
+    if (btn_text && strcmp(btn_text, "Yes") == 0) {
+        // Clear logs with fade-out animation
+        uint32_t shown = 0;
+        for (int i = 0; i < LOG_POOL_SIZE; i++) {
+            if (log_rows[i].used) {
+                lv_obj_fade_out(log_rows[i].row, 300, shown * 50);
+                shown++;
             }
-
-            // Reset after animation
-            lv_timer_t *timer = lv_timer_create([](lv_timer_t *t) {
-                lv_obj_clean(log_list);
-                log_count = 0;
-                ui_logs_add_entry("Log cleared", false);
-            }, 500 + child_count * 50, NULL);
-            lv_timer_set_repeat_count(timer, 1);
         }
-        lv_msgbox_close(lv_event_get_current_target(e));
-    }, LV_EVENT_VALUE_CHANGED, NULL);
+
+        // Reset after animation
+        lv_timer_t *timer = lv_timer_create(clear_done_cb, 500 + shown * 50, NULL);
+        lv_timer_set_repeat_count(timer, 1);
+    }
+
+    lv_msgbox_close(mbox);
+}
+
+// Hide every row once the fade-out has finished
+static void clear_done_cb(lv_timer_t *t) {
+    for (int i = 0; i < LOG_POOL_SIZE; i++) {
+        log_rows[i].used = false;
+        lv_obj_add_flag(log_rows[i].row, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_set_style_opa(log_rows[i].row, LV_OPA_COVER, 0);
+    }
+    log_next_row = 0;
+    ui_logs_add_entry("Log cleared", false);
 }
 
 // Filter logs
@@ -188,29 +251,34 @@ static void filter_logs_cb(lv_event_t *e) {
     lv_obj_t *mbox = lv_msgbox_create(NULL, "Filter Logs", "Select log type to display:", btns, false);
     lv_obj_add_style(mbox, &style_alert_box, 0);
     lv_obj_center(mbox);
+    lv_obj_add_event_cb(mbox, filter_select_cb, LV_EVENT_VALUE_CHANGED, NULL);
+}
 
-    lv_obj_add_event_cb(mbox, [](lv_event_t *e) {
-        const char *btn_text = lv_msgbox_get_active_btn_text(lv_event_get_current_target(e));
-
-        if (strcmp(btn_text, "Close") != 0) {
-            // Apply visual filter effect
-            uint32_t child_count = lv_obj_get_child_cnt(log_list);
-
-            for (uint32_t i = 0; i < child_count; i++) {
-                lv_obj_t *entry = lv_obj_get_child(log_list, i);
-                bool is_alert = lv_obj_get_style_bg_color(entry, 0).full == lv_color_hex(0xFFF3E0).full;
-
-                if (strcmp(btn_text, "All") == 0 ||
-                    (strcmp(btn_text, "Alerts") == 0 && is_alert) ||
-                    (strcmp(btn_text, "Info") == 0 && !is_alert)) {
-                    lv_obj_clear_flag(entry, LV_OBJ_FLAG_HIDDEN);
-                    lv_obj_fade_in(entry, 300, i * 50);
-                } else {
-                    lv_obj_add_flag(entry, LV_OBJ_FLAG_HIDDEN);
-                }
+// Filter selection handler
+static void filter_select_cb(lv_event_t *e) {
+    lv_obj_t *mbox = lv_event_get_current_target(e);
+    const char *btn_text = lv_msgbox_get_active_btn_text(mbox);
+
+    if (btn_text && strcmp(btn_text, "Close") != 0) {
+        // Apply visual filter effect
+        uint32_t shown = 0;
+        for (int i = 0; i < LOG_POOL_SIZE; i++) {
+            log_row_t *r = &log_rows[i];
+            if (!r->used) {
+                continue;
+            }
+
+            if (strcmp(btn_text, "All") == 0 ||
+                (strcmp(btn_text, "Alerts") == 0 && r->is_alert) ||
+                (strcmp(btn_text, "Info") == 0 && !r->is_alert)) {
+                lv_obj_clear_flag(r->row, LV_OBJ_FLAG_HIDDEN);
+                lv_obj_fade_in(r->row, 300, shown * 50);
+                shown++;
+            } else {
+                lv_obj_add_flag(r->row, LV_OBJ_FLAG_HIDDEN);
             }
         }
+    }
 
-        lv_msgbox_close(lv_event_get_current_target(e));
-    }, LV_EVENT_VALUE_CHANGED, NULL);
+    lv_msgbox_close(mbox);
 }
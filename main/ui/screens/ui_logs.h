@@ -13,4 +13,7 @@ void ui_logs_add_entry(const char* message, bool is_alert);
 // Clear all logs
 void ui_logs_clear(void);
 
+// Count the alert and info rows the current filter shows
+void ui_logs_get_shown(int *alerts, int *info);
+
 #endif /* UI_LOGS_H */
@@ -1,6 +1,8 @@
 #include "ui_schedule.h"
 #include "../ui_helpers.h"
+#include "core/schedule_manager.h"
 #include "esp_log.h"
+#include <time.h>
 
 static const char *TAG = "ui_schedule";
 
@@ -9,20 +11,6 @@ static lv_obj_t *calendar;
 static lv_obj_t *time_roller;
 static lv_obj_t *event_list;
 
-// Scheduled event data structure
-typedef struct {
-    int day;
-    int hour;
-    int minute;
-    float temperature;
-    float humidity;
-    float light;
-} schedule_event_t;
-
-// Array to store scheduled events (simplified for demo)
-static schedule_event_t events[10];
-static int event_count = 0;
-
 // Forward declarations
 static void calendar_event_cb(lv_event_t *e);
 static void add_event_cb(lv_event_t *e);
@@ -146,10 +134,8 @@ lv_obj_t *ui_schedule_create(void) {
     lv_obj_set_style_radius(event_list, BORDER_RADIUS, 0);
     lv_obj_align(event_list, LV_ALIGN_TOP_MID, 0, GRID_UNIT * 4);
 
-    // Create sample events for demo
-    ui_schedule_add_event(1, 8, 0, 25.0, 60.0, 80.0);
-    ui_schedule_add_event(1, 20, 0, 22.0, 70.0, 10.0);
-    ui_schedule_add_event(3, 10, 0, 28.0, 50.0, 90.0);
+    // Show the entries the schedule manager already holds
+    update_event_list();
 
     return screen;
 }
@@ -157,20 +143,21 @@ lv_obj_t *ui_schedule_create(void) {
 // Add a scheduled event to the calendar
 void ui_schedule_add_event(int day, int hour, int minute,
                         float temperature, float humidity, float light) {
-    if (event_count >= 10) {
-        ESP_LOGE(TAG, "Max event limit reached");
-        return;
-    }
+    const schedule_entry_t entry = {
+        .zone = 0,
+        .day = day,
+        .hour = hour,
+        .minute = minute,
+        .temperature = temperature,
+        .humidity = humidity,
+        .light = light,
+    };
 
     // Store event
-    events[event_count].day = day;
-    events[event_count].hour = hour;
-    events[event_count].minute = minute;
-    events[event_count].temperature = temperature;
-    events[event_count].humidity = humidity;
-    events[event_count].light = light;
-
-    event_count++;
+    if (schedule_manager_add(&entry) != ESP_OK) {
+        ESP_LOGE(TAG, "Could not add event");
+        return;
+    }
 
     // Update the UI list
     update_event_list();
@@ -179,16 +166,7 @@ void ui_schedule_add_event(int day, int hour, int minute,
 // Remove a scheduled event from the calendar
 void ui_schedule_remove_event(int day, int hour, int minute) {
     // Find and remove event
-    for (int i = 0; i < event_count; i++) {
-        if (events[i].day == day && events[i].hour == hour && events[i].minute == minute) {
-            // Shift remaining events
-            for (int j = i; j < event_count - 1; j++) {
-                events[j] = events[j + 1];
-            }
-            event_count--;
-            break;
-        }
-    }
+    schedule_manager_remove(0, day, hour, minute);
 
     // Update the UI list
     update_event_list();
@@ -225,8 +203,18 @@ static void add_event_cb(lv_event_t *e) {
     float humidity = 60.0f;
     float light = 75.0f;
 
+    // Entries repeat weekly on the weekday of the picked date (1 = Monday)
+    struct tm picked = {
+        .tm_year = date.year - 1900,
+        .tm_mon = date.month - 1,
+        .tm_mday = date.day,
+        .tm_hour = 12,
+    };
+    mktime(&picked);
+    int day = picked.tm_wday == 0 ? 7 : picked.tm_wday;
+
     // Add the event with animation
-    ui_schedule_add_event(date.day, hour, minute, temp, humidity, light);
+    ui_schedule_add_event(day, hour, minute, temp, humidity, light);
 
     // Show success message
     static const char *btns[] = {"OK", ""};
@@ -243,7 +231,7 @@ static void add_event_cb(lv_event_t *e) {
 
 // Delete event button callback
 static void delete_event_cb(lv_event_t *e) {
-    if (event_count > 0) {
+    if (schedule_manager_get_count() > 0) {
         // Show confirmation dialog
         static const char *btns[] = {"Yes", "No", ""};
         lv_obj_t *mbox = lv_msgbox_create(NULL, "Confirm Delete",
@@ -255,7 +243,7 @@ static void delete_event_cb(lv_event_t *e) {
         lv_obj_add_event_cb(mbox, [](lv_event_t *e) {
             const char *btn_text = lv_msgbox_get_active_btn_text(lv_event_get_current_target(e));
             if (strcmp(btn_text, "Yes") == 0) {
-                event_count--;
+                schedule_manager_remove_at(schedule_manager_get_count() - 1);
                 update_event_list();
             }
             lv_msgbox_close(lv_event_get_current_target(e));
@@ -265,6 +253,11 @@ static void delete_event_cb(lv_event_t *e) {
 
 // Update the event list display
 static void update_event_list(void) {
+    // Entries can change before the screen is first shown
+    if (!event_list) {
+        return;
+    }
+
     // Clear the list
     lv_obj_clean(event_list);
 
@@ -272,8 +265,9 @@ static void update_event_list(void) {
     static const char *day_names[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
 
     // Repopulate with current events
-    for (int i = 0; i < event_count; i++) {
-        schedule_event_t *evt = &events[i];
+    schedule_entry_t entry;
+    for (int i = 0; schedule_manager_get(i, &entry) == ESP_OK; i++) {
+        const schedule_entry_t *evt = &entry;
 
         // Create list item with custom styling
         lv_obj_t *item = lv_obj_create(event_list);
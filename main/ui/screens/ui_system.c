@@ -15,6 +15,8 @@ static lv_obj_t *heating_led;
 static lv_obj_t *cooling_led;
 static lv_obj_t *humidifier_led;
 static lv_obj_t *lighting_led;
+static lv_obj_t *energy_values[CLIMATE_ACTUATOR_COUNT];
+static lv_obj_t *schedule_values[4];
 
 // Callback prototypes
 static void reboot_cb(lv_event_t *e);
@@ -123,6 +125,11 @@ lv_obj_t *ui_system_create(void) {
         lv_obj_t *name_label = lv_label_create(status_row);
         lv_label_set_text(name_label, device_names[i]);
 
+        // Duty of the last hour and energy of the last 24 h
+        energy_values[i] = lv_label_create(status_row);
+        lv_label_set_text(energy_values[i], "--");
+        lv_obj_add_style(energy_values[i], &style_text_muted, 0);
+
         *leds[i] = create_badge(status_row, "OFF", led_colors[i]);
     }
 
@@ -162,6 +169,28 @@ lv_obj_t *ui_system_create(void) {
     lv_label_set_text(shutdown_label, LV_SYMBOL_POWER " Shutdown");
     lv_obj_center(shutdown_label);
 
+    // Schedule accuracy card
+    lv_obj_t *schedule_card = create_card(content, "Schedule Accuracy", LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_set_grid_cell(schedule_card, 2, 1, 1, LV_GRID_ALIGN_STRETCH, LV_GRID_ALIGN_STRETCH);
+
+    const char *schedule_rows[] = {"On Time", "Last Error", "Last Arrival", "Warm / Cool"};
+
+    for (int i = 0; i < 4; i++) {
+        lv_obj_t *row = lv_obj_create(schedule_card);
+        lv_obj_set_size(row, LV_PCT(100), TOUCH_TARGET_MIN);
+        lv_obj_set_style_pad_all(row, GRID_UNIT, 0);
+        lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+        lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+        lv_obj_t *label = lv_label_create(row);
+        lv_label_set_text(label, schedule_rows[i]);
+        lv_obj_add_style(label, &style_text_muted, 0);
+
+        schedule_values[i] = lv_label_create(row);
+        lv_label_set_text(schedule_values[i], "--");
+        lv_obj_set_style_text_color(schedule_values[i], COLOR_PRIMARY, 0);
+    }
+
     // Firmware info card
     lv_obj_t *firmware_card = create_card(content, "Firmware Information", LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     lv_obj_set_grid_cell(firmware_card, 2, 2, 1, LV_GRID_ALIGN_STRETCH, LV_GRID_ALIGN_STRETCH);
@@ -257,6 +286,51 @@ void ui_system_update_stats(int cpu_usage, int memory_usage) {
     lv_obj_set_style_bg_color(memory_bar, mem_color, LV_PART_INDICATOR);
 }
 
+// Update schedule accuracy and learned rates
+void ui_system_update_schedule(const schedule_accuracy_t *accuracy, float warm_rate, float cool_rate) {
+    // Called from the monitor task whether or not the screen exists
+    if (!schedule_values[0]) {
+        return;
+    }
+
+    if (accuracy->events > 0) {
+        lv_label_set_text_fmt(schedule_values[0], "%lu / %lu", (unsigned long)accuracy->on_time,
+                              (unsigned long)accuracy->events);
+        lv_label_set_text_fmt(schedule_values[1], "%+.1f°C (avg %.1f)", accuracy->last_error_c,
+                              accuracy->mean_abs_error_c);
+    }
+    if (accuracy->arrival_valid) {
+        int32_t minutes = accuracy->last_arrival_s / 60;
+        lv_label_set_text_fmt(schedule_values[2], "%ld min %s", (long)(minutes < 0 ? -minutes : minutes),
+                              minutes <= 0 ? "early" : "late");
+    }
+    lv_label_set_text_fmt(schedule_values[3], "%.2f / %.2f°C/min", warm_rate, cool_rate);
+
+    // Red once more than one in four entries was missed
+    lv_color_t color = accuracy->events > 0 && accuracy->on_time * 4 < accuracy->events * 3 ?
+                       COLOR_ERROR : COLOR_PRIMARY;
+    lv_obj_set_style_text_color(schedule_values[0], color, 0);
+}
+
+// Update per-actuator duty and energy
+void ui_system_update_energy(const energy_summary_t summaries[CLIMATE_ACTUATOR_COUNT]) {
+    // Called from the monitor task whether or not the screen exists
+    if (!energy_values[0]) {
+        return;
+    }
+
+    for (int i = 0; i < CLIMATE_ACTUATOR_COUNT; i++) {
+        const energy_summary_t *s = &summaries[i];
+        lv_label_set_text_fmt(energy_values[i], "%d%%  %.0f Wh", (int)(s->last_hour_duty * 100.0f + 0.5f),
+                              s->day_wh);
+
+        // Red once a heater or cooler has run a whole hour
+        lv_color_t color = i <= CLIMATE_ACTUATOR_COOLING && s->last_hour_duty >= CLIMATE_SATURATED_DUTY ?
+                           COLOR_ERROR : COLOR_TEXT_SECONDARY;
+        lv_obj_set_style_text_color(energy_values[i], color, 0);
+    }
+}
+
 // Simulate system reboot
 void ui_system_reboot(void) {
     static const char *btns[] = {"Yes", "No", ""};
@@ -2,6 +2,8 @@
 #define UI_SYSTEM_H
 
 #include "lvgl.h"
+#include "core/climate_controller.h"
+#include "core/schedule_manager.h"
 #include <stdbool.h>
 
 // Create the system status screen
@@ -14,6 +16,13 @@ void ui_system_update_status(int battery_level, bool heating_on, bool cooling_on
 // Update memory and CPU usage stats
 void ui_system_update_stats(int cpu_usage, int memory_usage);
 
+// Update schedule accuracy and learned warm-up/cool-down rates (°C/min)
+void ui_system_update_schedule(const schedule_accuracy_t *accuracy, float warm_rate, float cool_rate);
+
+// Update the duty of the last hour and energy of the last 24 h of each
+// actuator, indexed by climate_actuator_t
+void ui_system_update_energy(const energy_summary_t summaries[CLIMATE_ACTUATOR_COUNT]);
+
 // Update OTA progress
 void ui_system_update_ota_progress(int progress, const char* status);
 
@@ -13,6 +13,9 @@ static const char *TAG = "ui";
 static lv_obj_t *screens[SCREEN_COUNT];
 static screen_t current_screen = SCREEN_DASHBOARD;
 
+// Alert box currently on screen (at most one)
+static lv_obj_t *alert_mbox = NULL;
+
 void ui_init(void) {
     ESP_LOGI(TAG, "Initializing UI");
     init_styles();
@@ -83,10 +86,29 @@ void ui_add_log_entry(const char* message, bool is_alert) {
     }
 }
 
+// Close the alert box when OK is pressed
+static void alert_btn_cb(lv_event_t *e) {
+    lv_msgbox_close(lv_event_get_current_target(e));
+}
+
+// Forget the alert box once LVGL deletes it
+static void alert_deleted_cb(lv_event_t *e) {
+    alert_mbox = NULL;
+}
+
 void ui_show_alert(const char* title, const char* message) {
+    // Reuse the open alert box instead of stacking a new one per alert
+    if (alert_mbox) {
+        lv_label_set_text(lv_msgbox_get_title(alert_mbox), title);
+        lv_label_set_text(lv_msgbox_get_text(alert_mbox), message);
+        return;
+    }
+
     static const char *btns[] = {"OK", ""};
-    lv_obj_t *mbox = lv_msgbox_create(NULL, title, message, btns, false);
-    lv_obj_add_style(mbox, &style_alert_box, 0);
-    lv_obj_center(mbox);
+    alert_mbox = lv_msgbox_create(NULL, title, message, btns, false);
+    lv_obj_add_style(alert_mbox, &style_alert_box, 0);
+    lv_obj_center(alert_mbox);
+    lv_obj_add_event_cb(alert_mbox, alert_btn_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    lv_obj_add_event_cb(alert_mbox, alert_deleted_cb, LV_EVENT_DELETE, NULL);
 }
 
@@ -0,0 +1,157 @@
+#include "alloc_tracker.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "alloc_tracker";
+
+#define MAX_TRACKED_TASKS 16
+
+// Task to module binding; written at task start, read from the heap hooks
+typedef struct {
+    TaskHandle_t task;
+    alloc_module_t module;
+} task_binding_t;
+
+static task_binding_t bindings[MAX_TRACKED_TASKS];
+static alloc_stats_t stats[ALLOC_MODULE_COUNT];
+static uint32_t frees = 0;
+static bool tracking = false;
+
+static const char *module_names[ALLOC_MODULE_COUNT] = {
+    "boot", "ui", "climate", "simulator", "monitor", "power", "network"
+};
+
+// Find the binding slot of a task
+static task_binding_t *find_binding(TaskHandle_t task) {
+    for (int i = 0; i < MAX_TRACKED_TASKS; i++) {
+        if (bindings[i].task == task) {
+            return &bindings[i];
+        }
+    }
+    return NULL;
+}
+
+// Module of the task currently allocating
+static alloc_module_t current_module(void) {
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return ALLOC_MODULE_BOOT;
+    }
+    task_binding_t *b = find_binding(xTaskGetCurrentTaskHandle());
+    return b ? b->module : ALLOC_MODULE_BOOT;
+}
+
+#if CONFIG_HEAP_USE_HOOKS
+// Called by the heap for every successful allocation
+void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps) {
+    if (!tracking) {
+        return;
+    }
+    alloc_stats_t *s = &stats[current_module()];
+    __atomic_fetch_add(&s->allocs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->bytes, (uint32_t)size, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->armed_allocs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->armed_bytes, (uint32_t)size, __ATOMIC_RELAXED);
+}
+
+// Called by the heap for every free
+void esp_heap_trace_free_hook(void *ptr) {
+    if (tracking) {
+        __atomic_fetch_add(&frees, 1, __ATOMIC_RELAXED);
+    }
+}
+#endif
+
+// Initialize the tracker
+esp_err_t alloc_tracker_init(void) {
+#if CONFIG_HEAP_USE_HOOKS
+    memset(bindings, 0, sizeof(bindings));
+    memset(stats, 0, sizeof(stats));
+    frees = 0;
+    tracking = true;
+    ESP_LOGI(TAG, "Allocation tracking enabled");
+    return ESP_OK;
+#else
+    ESP_LOGW(TAG, "Allocation tracking needs CONFIG_HEAP_USE_HOOKS");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+// Attribute allocations made by the calling task to a module
+void alloc_tracker_set_task_module(alloc_module_t module) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    task_binding_t *b = find_binding(self);
+    if (!b) {
+        b = find_binding(NULL);
+    }
+    if (!b) {
+        ESP_LOGW(TAG, "No free task slot for %s", module_names[module]);
+        return;
+    }
+    b->module = module;
+    b->task = self;
+}
+
+// Override the module of the calling task
+alloc_module_t alloc_tracker_push(alloc_module_t module) {
+    task_binding_t *b = find_binding(xTaskGetCurrentTaskHandle());
+    if (!b) {
+        return ALLOC_MODULE_BOOT;
+    }
+    alloc_module_t previous = b->module;
+    b->module = module;
+    return previous;
+}
+
+// Restore the module of the calling task
+void alloc_tracker_pop(alloc_module_t previous) {
+    task_binding_t *b = find_binding(xTaskGetCurrentTaskHandle());
+    if (b) {
+        b->module = previous;
+    }
+}
+
+// Get the counters of a module
+void alloc_tracker_get_stats(alloc_module_t module, alloc_stats_t *out) {
+    if (module < ALLOC_MODULE_COUNT && out) {
+        *out = stats[module];
+    }
+}
+
+// Start the steady-state window
+void alloc_tracker_arm(void) {
+    for (int i = 0; i < ALLOC_MODULE_COUNT; i++) {
+        stats[i].armed_allocs = 0;
+        stats[i].armed_bytes = 0;
+    }
+    ESP_LOGI(TAG, "Steady-state window started");
+}
+
+// Log per-module counters and check the core modules
+esp_err_t alloc_tracker_check(uint32_t core_mask) {
+    esp_err_t result = ESP_OK;
+
+    for (int i = 0; i < ALLOC_MODULE_COUNT; i++) {
+        bool core = core_mask & (1U << i);
+        ESP_LOGI(TAG, "ALLOC module=%s allocs=%" PRIu32 " bytes=%" PRIu32
+                 " steady_allocs=%" PRIu32 " steady_bytes=%" PRIu32 "%s",
+                 module_names[i], stats[i].allocs, stats[i].bytes,
+                 stats[i].armed_allocs, stats[i].armed_bytes, core ? " core" : "");
+
+        if (core && stats[i].armed_allocs > 0) {
+            ESP_LOGE(TAG, "Module %s allocated in steady state", module_names[i]);
+            result = ESP_FAIL;
+        }
+    }
+    ESP_LOGI(TAG, "ALLOC frees=%" PRIu32, frees);
+
+    return result;
+}
+
+// Get a module name
+const char *alloc_tracker_module_name(alloc_module_t module) {
+    return module < ALLOC_MODULE_COUNT ? module_names[module] : "unknown";
+}
@@ -0,0 +1,75 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Modules heap allocations are attributed to. Each task is bound to one
+// module; alloc_tracker_push() overrides it for a call path.
+typedef enum {
+    ALLOC_MODULE_BOOT,          // Unbound tasks and startup
+    ALLOC_MODULE_UI,
+    ALLOC_MODULE_CLIMATE,
+    ALLOC_MODULE_SIMULATOR,
+    ALLOC_MODULE_MONITOR,
+    ALLOC_MODULE_POWER,
+    ALLOC_MODULE_NETWORK,
+    ALLOC_MODULE_COUNT
+} alloc_module_t;
+
+// Modules that must not allocate once the system is in steady state
+#define ALLOC_CORE_MODULES ((1U << ALLOC_MODULE_CLIMATE) | (1U << ALLOC_MODULE_SIMULATOR) | \
+                            (1U << ALLOC_MODULE_MONITOR) | (1U << ALLOC_MODULE_POWER) |     \
+                            (1U << ALLOC_MODULE_NETWORK))
+
+// Time after boot before the steady-state window starts
+#define ALLOC_STEADY_STATE_MS 30000
+
+// Length of the steady-state window checked for allocations
+#define ALLOC_CHECK_WINDOW_MS 60000
+
+// Allocation counters for one module
+typedef struct {
+    uint32_t allocs;            // Allocations since boot
+    uint32_t bytes;             // Bytes allocated since boot
+    uint32_t armed_allocs;      // Allocations since alloc_tracker_arm()
+    uint32_t armed_bytes;       // Bytes allocated since alloc_tracker_arm()
+} alloc_stats_t;
+
+#ifdef REPTICONTROL_ALLOC_TRACE
+#define ALLOC_TRACK_TASK(module) alloc_tracker_set_task_module(module)
+#define ALLOC_SCOPE_BEGIN(module) alloc_module_t alloc_prev_module = alloc_tracker_push(module)
+#define ALLOC_SCOPE_END() alloc_tracker_pop(alloc_prev_module)
+#else
+#define ALLOC_TRACK_TASK(module) do { } while (0)
+#define ALLOC_SCOPE_BEGIN(module) do { } while (0)
+#define ALLOC_SCOPE_END() do { } while (0)
+#endif
+
+// Initialize the tracker (needs CONFIG_HEAP_USE_HOOKS)
+esp_err_t alloc_tracker_init(void);
+
+// Attribute allocations made by the calling task to a module
+void alloc_tracker_set_task_module(alloc_module_t module);
+
+// Attribute allocations of the calling task to a module until alloc_tracker_pop()
+alloc_module_t alloc_tracker_push(alloc_module_t module);
+
+// Restore the module returned by alloc_tracker_push()
+void alloc_tracker_pop(alloc_module_t previous);
+
+// Get the counters of a module
+void alloc_tracker_get_stats(alloc_module_t module, alloc_stats_t *stats);
+
+// Start the steady-state window (resets the armed counters)
+void alloc_tracker_arm(void);
+
+// Log per-module counters and fail if a module in core_mask allocated since arming
+esp_err_t alloc_tracker_check(uint32_t core_mask);
+
+// Get a module name
+const char *alloc_tracker_module_name(alloc_module_t module);
+
+#endif /* ALLOC_TRACKER_H */
@@ -0,0 +1,88 @@
+#include "boot_profiler.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "boot_profiler";
+
+typedef struct {
+    const char *name;
+    int64_t start_us;
+    int64_t end_us;
+} boot_stage_t;
+
+static boot_stage_t stages[BOOT_PROFILER_MAX_STAGES];
+static int stage_count = 0;
+static int64_t profile_start_us = 0;
+static int64_t last_mark_us = 0;
+
+// Start timing stages from now
+void boot_profiler_start(void) {
+    stage_count = 0;
+    profile_start_us = esp_timer_get_time();
+    last_mark_us = profile_start_us;
+}
+
+// Record the end of an init stage
+void boot_profiler_mark(const char *stage) {
+    int64_t now = esp_timer_get_time();
+
+    if (stage_count < BOOT_PROFILER_MAX_STAGES) {
+        stages[stage_count].name = stage;
+        stages[stage_count].start_us = last_mark_us;
+        stages[stage_count].end_us = now;
+        stage_count++;
+    }
+
+    last_mark_us = now;
+}
+
+// Print the boot waterfall
+void boot_profiler_report(void) {
+    // esp_timer starts counting early in startup, so profile_start_us is the
+    // time spent in the bootloader hand-off and IDF startup before app code
+    ESP_LOGI(TAG, "BOOT name=startup start_us=0 dur_us=%" PRId64, profile_start_us);
+
+    for (int i = 0; i < stage_count; i++) {
+        ESP_LOGI(TAG, "BOOT name=%s start_us=%" PRId64 " dur_us=%" PRId64,
+                 stages[i].name, stages[i].start_us,
+                 stages[i].end_us - stages[i].start_us);
+    }
+
+    ESP_LOGI(TAG, "BOOT_DONE total_us=%" PRId64, last_mark_us);
+}
+
+// Print per-task CPU usage and idle load since boot
+void boot_profiler_report_tasks(void) {
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS && CONFIG_FREERTOS_USE_TRACE_FACILITY
+    static TaskStatus_t tasks[24];
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t count = uxTaskGetSystemState(tasks, sizeof(tasks) / sizeof(tasks[0]), &total);
+
+    if (total == 0) {
+        return;
+    }
+
+    // Each core has its own idle task; total covers one core's worth of time
+    uint64_t idle = 0;
+    for (UBaseType_t i = 0; i < count; i++) {
+        uint64_t pct_x10 = (uint64_t)tasks[i].ulRunTimeCounter * 1000 / total;
+        ESP_LOGI(TAG, "TASK name=%s prio=%u runtime=%" PRIu64 " pct=%" PRIu64 ".%" PRIu64 " stack_free=%u",
+                 tasks[i].pcTaskName, (unsigned)tasks[i].uxCurrentPriority,
+                 (uint64_t)tasks[i].ulRunTimeCounter, pct_x10 / 10, pct_x10 % 10,
+                 (unsigned)tasks[i].usStackHighWaterMark);
+
+        if (strncmp(tasks[i].pcTaskName, "IDLE", 4) == 0) {
+            idle += tasks[i].ulRunTimeCounter;
+        }
+    }
+
+    uint64_t idle_x10 = idle * 1000 / ((uint64_t)total * portNUM_PROCESSORS);
+    ESP_LOGI(TAG, "IDLE_CPU pct=%" PRIu64 ".%" PRIu64, idle_x10 / 10, idle_x10 % 10);
+#else
+    ESP_LOGW(TAG, "Task stats need CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS");
+#endif
+}
@@ -0,0 +1,26 @@
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <stdint.h>
+
+// Maximum number of recorded init stages
+#define BOOT_PROFILER_MAX_STAGES 24
+
+// How long the application runs before task stats are reported
+#define BOOT_PROFILE_SETTLE_MS 10000
+
+// Record the end of an init stage; its duration is the time since the
+// previous mark (or since the profiler was started)
+void boot_profiler_mark(const char *stage);
+
+// Start timing stages from now (esp_timer time is kept as the boot offset)
+void boot_profiler_start(void);
+
+// Print the boot waterfall as machine-readable BOOT lines
+void boot_profiler_report(void);
+
+// Print per-task CPU usage and idle load since boot as TASK/IDLE_CPU lines.
+// Needs CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS.
+void boot_profiler_report_tasks(void);
+
+#endif /* BOOT_PROFILER_H */
@@ -0,0 +1,237 @@
+#include "control_bench.h"
+#include "climate_controller.h"
+#include "data_simulator.h"
+#include "sensor_hal.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+static const char *TAG = "control_bench";
+
+// The simulator runs at 1 Hz, the controller at CLIMATE_CONTROL_PERIOD_MS
+#define SIM_PERIOD_MS 1000
+
+#define STEPS_PER_MINUTE (60000 / CLIMATE_CONTROL_PERIOD_MS)
+
+static uint32_t virtual_ms;
+static uint32_t update_max_us;
+
+// Advance virtual time by one controller period
+static void step(void) {
+    int64_t start = esp_timer_get_time();
+    climate_controller_update();
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    if (elapsed > update_max_us) {
+        update_max_us = elapsed;
+    }
+
+    virtual_ms += CLIMATE_CONTROL_PERIOD_MS;
+    if (virtual_ms % SIM_PERIOD_MS == 0) {
+        data_simulator_update();
+    }
+    sensor_hal_poll((int64_t)virtual_ms * 1000);
+}
+
+// Run a relay auto-tune to completion
+static bool autotune(climate_loop_t loop) {
+    if (climate_controller_start_autotune(loop) != ESP_OK) {
+        return false;
+    }
+
+    uint32_t max_steps = CLIMATE_AUTOTUNE_TIMEOUT_MS / CLIMATE_CONTROL_PERIOD_MS + 1;
+    uint32_t start_ms = virtual_ms;
+    for (uint32_t i = 0; i < max_steps && climate_controller_is_autotuning(); i++) {
+        step();
+    }
+
+    float kp, ki, kd;
+    climate_controller_get_pid_gains(loop, &kp, &ki, &kd);
+    ESP_LOGI(TAG, "%s auto-tune took %lus: Kp=%.3f Ki=%.4f Kd=%.3f",
+             loop == CLIMATE_LOOP_TEMPERATURE ? "Temperature" : "Humidity",
+             (unsigned long)((virtual_ms - start_ms) / 1000), kp, ki, kd);
+    return !climate_controller_is_autotuning();
+}
+
+// Run one scenario from a fresh controller and simulator
+static esp_err_t run_scenario(const char *name, climate_mode_t temp_mode, climate_mode_t humidity_mode,
+                              bool tune, control_bench_result_t *result) {
+    virtual_ms = 0;
+    climate_controller_init();
+    data_simulator_init();
+    sensor_hal_init();
+    sensor_hal_poll(0);
+    srand(CONTROL_BENCH_SEED);
+
+    climate_controller_set_temp_target(CONTROL_BENCH_TEMP_TARGET);
+    climate_controller_set_humidity_target(CONTROL_BENCH_HUMIDITY_TARGET);
+    climate_controller_set_heating(true);
+    climate_controller_set_cooling(true);
+    climate_controller_set_humidifier(true);
+
+    climate_controller_set_mode(CLIMATE_ACTUATOR_HEATING, temp_mode);
+    climate_controller_set_mode(CLIMATE_ACTUATOR_COOLING, temp_mode);
+    climate_controller_set_mode(CLIMATE_ACTUATOR_HUMIDIFIER, humidity_mode);
+
+    if (tune) {
+        if (!autotune(CLIMATE_LOOP_TEMPERATURE) || !autotune(CLIMATE_LOOP_HUMIDITY)) {
+            ESP_LOGE(TAG, "%s: auto-tune did not finish", name);
+            return ESP_FAIL;
+        }
+    } else if (humidity_mode == CLIMATE_MODE_PID) {
+        climate_controller_set_pid_gains(CLIMATE_LOOP_TEMPERATURE, CLIMATE_TEMP_DEFAULT_KP,
+                                         CLIMATE_TEMP_DEFAULT_KI, CLIMATE_TEMP_DEFAULT_KD);
+        climate_controller_set_pid_gains(CLIMATE_LOOP_HUMIDITY, CLIMATE_HUMIDITY_DEFAULT_KP,
+                                         CLIMATE_HUMIDITY_DEFAULT_KI, CLIMATE_HUMIDITY_DEFAULT_KD);
+    }
+
+    for (uint32_t i = 0; i < CONTROL_BENCH_SETTLE_MINUTES * STEPS_PER_MINUTE; i++) {
+        step();
+    }
+
+    uint32_t cycles_start[CLIMATE_ACTUATOR_COUNT];
+    for (int a = 0; a < CLIMATE_ACTUATOR_COUNT; a++) {
+        cycles_start[a] = climate_controller_get_cycle_count(a);
+    }
+
+    uint32_t samples = CONTROL_BENCH_MINUTES * STEPS_PER_MINUTE;
+    uint32_t temp_in_band = 0, humidity_in_band = 0, on_steps = 0;
+    double temp_sq = 0.0, humidity_sq = 0.0;
+    float overshoot = 0.0f;
+
+    update_max_us = 0;
+    for (uint32_t i = 0; i < samples; i++) {
+        step();
+
+        on_steps += climate_controller_is_heating_on() + climate_controller_is_cooling_on();
+
+        float temp_err = data_simulator_get_temperature() - CONTROL_BENCH_TEMP_TARGET;
+        float humidity_err = data_simulator_get_humidity() - CONTROL_BENCH_HUMIDITY_TARGET;
+
+        if (fabsf(temp_err) <= CONTROL_BENCH_TEMP_BAND) temp_in_band++;
+        if (fabsf(humidity_err) <= CONTROL_BENCH_HUMIDITY_BAND) humidity_in_band++;
+        if (temp_err > overshoot) overshoot = temp_err;
+        temp_sq += temp_err * temp_err;
+        humidity_sq += humidity_err * humidity_err;
+    }
+
+    float hours = CONTROL_BENCH_MINUTES / 60.0f;
+    result->name = name;
+    result->temp_in_band_pct = 100.0f * temp_in_band / samples;
+    result->humidity_in_band_pct = 100.0f * humidity_in_band / samples;
+    result->temp_rms = sqrt(temp_sq / samples);
+    result->humidity_rms = sqrt(humidity_sq / samples);
+    result->heating_cycles_per_hour =
+        (climate_controller_get_cycle_count(CLIMATE_ACTUATOR_HEATING) - cycles_start[CLIMATE_ACTUATOR_HEATING]) / hours;
+    result->cooling_cycles_per_hour =
+        (climate_controller_get_cycle_count(CLIMATE_ACTUATOR_COOLING) - cycles_start[CLIMATE_ACTUATOR_COOLING]) / hours;
+    result->humidifier_cycles_per_hour =
+        (climate_controller_get_cycle_count(CLIMATE_ACTUATOR_HUMIDIFIER) - cycles_start[CLIMATE_ACTUATOR_HUMIDIFIER]) / hours;
+    result->temp_overshoot = overshoot;
+    result->energy_pct = 100.0f * on_steps / samples;
+    result->update_max_us = update_max_us;
+
+    ESP_LOGI(TAG, "CONTROL scenario=%s temp_in_band=%.1f hum_in_band=%.1f temp_rms=%.3f hum_rms=%.3f "
+             "heat_cph=%.1f cool_cph=%.1f humid_cph=%.1f overshoot=%.2f energy=%.1f update_max_us=%lu",
+             result->name, result->temp_in_band_pct, result->humidity_in_band_pct,
+             result->temp_rms, result->humidity_rms, result->heating_cycles_per_hour,
+             result->cooling_cycles_per_hour, result->humidifier_cycles_per_hour,
+             result->temp_overshoot, result->energy_pct, (unsigned long)result->update_max_us);
+    return ESP_OK;
+}
+
+// Time the update pass over many zones, every one under MPC
+static esp_err_t run_zone_scaling(int zones) {
+    virtual_ms = 0;
+    climate_controller_init();
+    data_simulator_init();
+    sensor_hal_init();
+    sensor_hal_poll(0);
+    srand(CONTROL_BENCH_SEED);
+    climate_controller_set_zone_count(zones);
+
+    for (int z = 0; z < zones; z++) {
+        climate_controller_zone_set_temp_target(z, CONTROL_BENCH_TEMP_TARGET);
+        climate_controller_zone_set_humidity_target(z, CONTROL_BENCH_HUMIDITY_TARGET);
+        climate_controller_zone_set_mode(z, CLIMATE_ACTUATOR_HEATING, CLIMATE_MODE_MPC);
+        climate_controller_zone_set_mode(z, CLIMATE_ACTUATOR_COOLING, CLIMATE_MODE_MPC);
+        climate_controller_zone_set_mode(z, CLIMATE_ACTUATOR_HUMIDIFIER, CLIMATE_MODE_PID);
+    }
+
+    // Let every model get identified so the MPC path is the one timed
+    for (uint32_t i = 0; i < CONTROL_BENCH_SETTLE_MINUTES * STEPS_PER_MINUTE; i++) {
+        step();
+    }
+
+    uint32_t samples = STEPS_PER_MINUTE * 10;
+    int64_t total_us = 0;
+    update_max_us = 0;
+    for (uint32_t i = 0; i < samples; i++) {
+        int64_t start = esp_timer_get_time();
+        step();
+        total_us += esp_timer_get_time() - start;
+    }
+
+    int ready = 0;
+    for (int z = 0; z < zones; z++) {
+        ready += climate_controller_zone_is_model_ready(z);
+    }
+
+    uint32_t avg_us = (uint32_t)(total_us / samples);
+    ESP_LOGI(TAG, "CONTROL zones=%d models_ready=%d update_avg_us=%lu update_max_us=%lu per_zone_us=%.1f",
+             zones, ready, (unsigned long)avg_us, (unsigned long)update_max_us, (float)avg_us / zones);
+
+    if (update_max_us > CONTROL_BENCH_UPDATE_BUDGET_US) {
+        ESP_LOGE(TAG, "%d zones: update took %lu us, budget %d us", zones,
+                 (unsigned long)update_max_us, CONTROL_BENCH_UPDATE_BUDGET_US);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// Run every scenario and log the results
+esp_err_t control_bench_run(void) {
+    control_bench_result_t hysteresis, pid_default, pid_tuned, mpc;
+
+    ESP_LOGI(TAG, "Control benchmark: %d virtual minutes per scenario", CONTROL_BENCH_MINUTES);
+
+    if (run_scenario("hysteresis", CLIMATE_MODE_HYSTERESIS, CLIMATE_MODE_HYSTERESIS, false, &hysteresis) != ESP_OK ||
+        run_scenario("pid_default", CLIMATE_MODE_PID, CLIMATE_MODE_PID, false, &pid_default) != ESP_OK ||
+        run_scenario("pid_autotuned", CLIMATE_MODE_PID, CLIMATE_MODE_PID, true, &pid_tuned) != ESP_OK ||
+        run_scenario("mpc", CLIMATE_MODE_MPC, CLIMATE_MODE_PID, false, &mpc) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    if (!climate_controller_is_model_ready()) {
+        ESP_LOGE(TAG, "mpc: thermal model was never identified");
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "Auto-tuned PID vs hysteresis: temperature in band %+.1f pts, humidity in band %+.1f pts",
+             pid_tuned.temp_in_band_pct - hysteresis.temp_in_band_pct,
+             pid_tuned.humidity_in_band_pct - hysteresis.humidity_in_band_pct);
+    ESP_LOGI(TAG, "MPC vs auto-tuned PID: overshoot %+.2f °C, energy %+.1f pts, in band %+.1f pts",
+             mpc.temp_overshoot - pid_tuned.temp_overshoot, mpc.energy_pct - pid_tuned.energy_pct,
+             mpc.temp_in_band_pct - pid_tuned.temp_in_band_pct);
+
+    static const int zone_counts[] = CONTROL_BENCH_ZONE_COUNTS;
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < sizeof(zone_counts) / sizeof(zone_counts[0]); i++) {
+        if (run_zone_scaling(zone_counts[i]) != ESP_OK) {
+            ret = ESP_FAIL;
+        }
+    }
+
+    // Leave the application on its previous behaviour
+    for (int z = climate_controller_get_zone_count() - 1; z > 0; z--) {
+        climate_controller_zone_set_mode(z, CLIMATE_ACTUATOR_HEATING, CLIMATE_MODE_HYSTERESIS);
+        climate_controller_zone_set_mode(z, CLIMATE_ACTUATOR_COOLING, CLIMATE_MODE_HYSTERESIS);
+        climate_controller_zone_set_mode(z, CLIMATE_ACTUATOR_HUMIDIFIER, CLIMATE_MODE_HYSTERESIS);
+    }
+    climate_controller_set_zone_count(CLIMATE_DEFAULT_ZONES);
+    climate_controller_set_mode(CLIMATE_ACTUATOR_HEATING, CLIMATE_MODE_HYSTERESIS);
+    climate_controller_set_mode(CLIMATE_ACTUATOR_COOLING, CLIMATE_MODE_HYSTERESIS);
+    climate_controller_set_mode(CLIMATE_ACTUATOR_HUMIDIFIER, CLIMATE_MODE_HYSTERESIS);
+    return ret;
+}
@@ -0,0 +1,52 @@
+#ifndef CONTROL_BENCH_H
+#define CONTROL_BENCH_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+// Virtual minutes measured per scenario, after the settling period
+#ifndef CONTROL_BENCH_MINUTES
+#define CONTROL_BENCH_MINUTES 240
+#endif
+#ifndef CONTROL_BENCH_SETTLE_MINUTES
+#define CONTROL_BENCH_SETTLE_MINUTES 10
+#endif
+
+// Targets held during the run
+#define CONTROL_BENCH_TEMP_TARGET 24.0f
+#define CONTROL_BENCH_HUMIDITY_TARGET 60.0f
+
+// Band counted as "holding the target"
+#define CONTROL_BENCH_TEMP_BAND 0.5f
+#define CONTROL_BENCH_HUMIDITY_BAND 2.5f
+
+// Zone counts timed by the scaling run, and the slowest update allowed
+#define CONTROL_BENCH_ZONE_COUNTS {1, 8, 64}
+#define CONTROL_BENCH_UPDATE_BUDGET_US 20000
+
+// Fixed seed so scenarios see the same simulator noise
+#define CONTROL_BENCH_SEED 1234
+
+// Result of one control scenario
+typedef struct {
+    const char *name;
+    float temp_in_band_pct;
+    float humidity_in_band_pct;
+    float temp_rms;
+    float humidity_rms;
+    float heating_cycles_per_hour;
+    float cooling_cycles_per_hour;
+    float humidifier_cycles_per_hour;
+    float temp_overshoot;           // Largest excursion above the target (°C)
+    float energy_pct;               // Heater plus cooler on-time, % of the run
+    uint32_t update_max_us;         // Slowest climate_controller_update()
+} control_bench_result_t;
+
+// Run the simulator in virtual time under hysteresis, PID with default
+// gains, PID with auto-tuned gains and MPC, and log a CONTROL line per
+// scenario. Then times one update pass over 1, 8 and 64 zones under MPC
+// and fails if it exceeds CONTROL_BENCH_UPDATE_BUDGET_US.
+// Expects settings_init() and event_logger_init() to have run.
+esp_err_t control_bench_run(void);
+
+#endif /* CONTROL_BENCH_H */
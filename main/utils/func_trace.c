@@ -0,0 +1,125 @@
+#include "func_trace.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Everything here runs on every instrumented call, so it lives in IRAM and
+// must not be instrumented itself
+#define NO_TRACE __attribute__((no_instrument_function))
+
+static const char *TAG = "func_trace";
+
+#define TRACE_STACK_DEPTH 32
+
+typedef struct {
+    uintptr_t fn;
+    uint32_t calls;
+    uint64_t cycles;            // Inclusive, including preemption
+} trace_slot_t;
+
+typedef struct {
+    uintptr_t fn;
+    uint32_t start;
+} trace_frame_t;
+
+static trace_slot_t slots[FUNC_TRACE_SLOTS];
+static trace_frame_t stacks[portNUM_PROCESSORS][TRACE_STACK_DEPTH];
+static int depth[portNUM_PROCESSORS];
+static uint32_t dropped = 0;
+static volatile bool tracing = false;
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Find or claim the slot of a function
+static IRAM_ATTR NO_TRACE trace_slot_t *find_slot(uintptr_t fn) {
+    uint32_t i = (uint32_t)(fn >> 2) & (FUNC_TRACE_SLOTS - 1);
+
+    for (int probe = 0; probe < FUNC_TRACE_SLOTS; probe++) {
+        if (slots[i].fn == fn) {
+            return &slots[i];
+        }
+        if (slots[i].fn == 0) {
+            slots[i].fn = fn;
+            return &slots[i];
+        }
+        i = (i + 1) & (FUNC_TRACE_SLOTS - 1);
+    }
+    return NULL;
+}
+
+IRAM_ATTR NO_TRACE void __cyg_profile_func_enter(void *fn, void *call_site) {
+    if (!tracing) {
+        return;
+    }
+
+    int core = esp_cpu_get_core_id();
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    if (depth[core] < TRACE_STACK_DEPTH) {
+        stacks[core][depth[core]].fn = (uintptr_t)fn;
+        stacks[core][depth[core]].start = esp_cpu_get_cycle_count();
+    }
+    depth[core]++;
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+IRAM_ATTR NO_TRACE void __cyg_profile_func_exit(void *fn, void *call_site) {
+    if (!tracing) {
+        return;
+    }
+
+    int core = esp_cpu_get_core_id();
+    uint32_t now = esp_cpu_get_cycle_count();
+
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    if (depth[core] > 0) {
+        depth[core]--;
+        // Frames deeper than the stack only count calls
+        uint32_t cycles = 0;
+        if (depth[core] < TRACE_STACK_DEPTH && stacks[core][depth[core]].fn == (uintptr_t)fn) {
+            cycles = now - stacks[core][depth[core]].start;
+        }
+
+        trace_slot_t *slot = find_slot((uintptr_t)fn);
+        if (slot) {
+            slot->calls++;
+            slot->cycles += cycles;
+        } else {
+            dropped++;
+        }
+    }
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+// Start collecting
+NO_TRACE void func_trace_start(void) {
+    portENTER_CRITICAL(&trace_lock);
+    memset(slots, 0, sizeof(slots));
+    memset(depth, 0, sizeof(depth));
+    dropped = 0;
+    tracing = true;
+    portEXIT_CRITICAL(&trace_lock);
+    ESP_LOGI(TAG, "Function trace started");
+}
+
+// Stop collecting
+NO_TRACE void func_trace_stop(void) {
+    tracing = false;
+}
+
+// Print one line per traced function
+NO_TRACE void func_trace_dump(void) {
+    int count = 0;
+
+    for (int i = 0; i < FUNC_TRACE_SLOTS; i++) {
+        if (slots[i].fn && slots[i].calls) {
+            ESP_LOGI(TAG, "FTRACE fn=0x%08" PRIxPTR " calls=%" PRIu32 " cycles=%" PRIu64,
+                     slots[i].fn, slots[i].calls, slots[i].cycles);
+            count++;
+        }
+    }
+    ESP_LOGI(TAG, "FTRACE_END functions=%d dropped=%" PRIu32 " cpu_hz=%" PRIu32,
+             count, dropped, (uint32_t)CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000000U);
+}
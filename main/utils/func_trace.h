@@ -0,0 +1,22 @@
+#ifndef FUNC_TRACE_H
+#define FUNC_TRACE_H
+
+#include <stdint.h>
+
+// Distinct functions tracked (open addressing, must be a power of two)
+#define FUNC_TRACE_SLOTS 1024
+
+// How long the application runs before the trace is dumped
+#define FUNC_TRACE_DURATION_MS 60000
+
+// Start collecting per-function call counts and cycles. The main component
+// must be built with -finstrument-functions (REPTICONTROL_FUNC_TRACE).
+void func_trace_start(void);
+
+// Stop collecting
+void func_trace_stop(void);
+
+// Print one FTRACE line per function, consumed by tools/gen_iram_placement.py
+void func_trace_dump(void);
+
+#endif /* FUNC_TRACE_H */
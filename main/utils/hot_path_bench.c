@@ -0,0 +1,141 @@
+#include "hot_path_bench.h"
+#include "hot_paths.h"
+#include "drivers/display_driver.h"
+#include "drivers/touch_driver.h"
+#include "core/climate_controller.h"
+#include "core/event_logger.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_memory_utils.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "hot_path_bench";
+
+// One benchmarked function
+typedef struct {
+    const char *name;
+    const void *fn;
+    void (*run)(void);
+} hot_path_case_t;
+
+static volatile uint8_t *thrash_buf = NULL;
+static uint32_t samples[HOT_PATH_BENCH_ITERATIONS];
+
+static lv_color_t flush_pixels[8 * 8];
+
+static void run_flush(void) {
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_area_t area = {0, 0, 7, 7};
+    display_flush_cb(disp->driver, &area, flush_pixels);
+}
+
+static void run_touch_read(void) {
+    lv_indev_drv_t drv;
+    lv_indev_data_t data;
+    touch_read_cb(&drv, &data);
+}
+
+static void run_climate_update(void) {
+    climate_controller_update();
+}
+
+static void run_logger_add(void) {
+    event_logger_add("Hot path bench", false);
+}
+
+static const hot_path_case_t cases[] = {
+    {"display_flush_cb", (const void *)display_flush_cb, run_flush},
+    {"touch_read_cb", (const void *)touch_read_cb, run_touch_read},
+    {"climate_controller_update", (const void *)climate_controller_update, run_climate_update},
+    {"event_logger_add", (const void *)event_logger_add, run_logger_add},
+};
+
+// Stream through PSRAM so the next call misses in the cache
+static void thrash_cache(void) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < HOT_PATH_BENCH_THRASH_BYTES; i += 32) {
+        sum += thrash_buf[i];
+    }
+    thrash_buf[0] = (uint8_t)sum;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Median cycles per call, optionally with a cold cache
+static uint32_t measure(const hot_path_case_t *c, bool cold) {
+    for (int i = 0; i < HOT_PATH_BENCH_ITERATIONS; i++) {
+        if (cold) {
+            thrash_cache();
+        } else {
+            c->run();
+        }
+        uint32_t start = esp_cpu_get_cycle_count();
+        c->run();
+        samples[i] = esp_cpu_get_cycle_count() - start;
+    }
+    qsort(samples, HOT_PATH_BENCH_ITERATIONS, sizeof(samples[0]), compare_u32);
+    return samples[HOT_PATH_BENCH_ITERATIONS / 2];
+}
+
+// Whether hot_paths.lf places this function in IRAM
+static bool is_listed_hot(const char *name) {
+    for (size_t i = 0; i < sizeof(hot_path_functions) / sizeof(hot_path_functions[0]); i++) {
+        if (strcmp(hot_path_functions[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Run the hot-path microbenchmarks
+esp_err_t hot_path_bench_run(void) {
+    esp_err_t result = ESP_OK;
+
+    thrash_buf = heap_caps_malloc(HOT_PATH_BENCH_THRASH_BYTES, MALLOC_CAP_SPIRAM);
+    if (!thrash_buf) {
+        ESP_LOGE(TAG, "No PSRAM for the cache thrash buffer");
+        return ESP_ERR_NO_MEM;
+    }
+    memset((void *)thrash_buf, 0x5A, HOT_PATH_BENCH_THRASH_BYTES);
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const hot_path_case_t *c = &cases[i];
+        uint32_t warm = measure(c, false);
+        uint32_t cold = measure(c, true);
+        bool in_iram = esp_ptr_in_iram(c->fn);
+        uint32_t cold_pct = warm ? cold * 100 / warm : 0;
+
+        ESP_LOGI(TAG, "HOTPATH name=%s warm_cycles=%" PRIu32 " cold_cycles=%" PRIu32
+                 " cold_pct=%" PRIu32 " iram=%d",
+                 c->name, warm, cold, cold_pct, in_iram);
+
+#ifdef REPTICONTROL_PLACEMENT_PROFILE
+        if (is_listed_hot(c->name)) {
+            if (!in_iram) {
+                ESP_LOGE(TAG, "%s is listed in hot_paths.lf but runs from flash", c->name);
+                result = ESP_FAIL;
+            } else if (cold_pct > HOT_PATH_BENCH_MAX_COLD_PCT) {
+                // Callees outside the hot set (LVGL, esp_lcd) still miss
+                ESP_LOGW(TAG, "%s takes %" PRIu32 "%% of its warm time on a cold cache",
+                         c->name, cold_pct);
+            }
+        }
+#else
+        (void)is_listed_hot;
+#endif
+    }
+
+    heap_caps_free((void *)thrash_buf);
+    thrash_buf = NULL;
+
+    ESP_LOGI(TAG, "HOTPATH_END result=%s", result == ESP_OK ? "pass" : "fail");
+    return result;
+}
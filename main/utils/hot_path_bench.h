@@ -0,0 +1,22 @@
+#ifndef HOT_PATH_BENCH_H
+#define HOT_PATH_BENCH_H
+
+#include "esp_err.h"
+
+// Calls timed per case (the median is reported)
+#define HOT_PATH_BENCH_ITERATIONS 101
+
+// PSRAM streamed between calls to evict the shared flash/PSRAM cache
+#define HOT_PATH_BENCH_THRASH_BYTES (256 * 1024)
+
+// Cold/warm cycle ratio above which an IRAM function is flagged, in percent
+#define HOT_PATH_BENCH_MAX_COLD_PCT 150
+
+// Time the hot-path functions with a warm cache and after PSRAM traffic has
+// evicted the cache, and report whether each runs from IRAM. With
+// REPTICONTROL_PLACEMENT_PROFILE, fails if a function listed in hot_paths.h
+// is not in IRAM and warns if it still slows down on a cold cache.
+// Expects LVGL, the display, touch, the logger and the controller to be initialized.
+esp_err_t hot_path_bench_run(void);
+
+#endif /* HOT_PATH_BENCH_H */
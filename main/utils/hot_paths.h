@@ -0,0 +1,30 @@
+#ifndef HOT_PATHS_H
+#define HOT_PATHS_H
+
+// Functions placed in IRAM by hot_paths.lf. Generated together with the
+// fragment by tools/gen_iram_placement.py; checked by hot_path_bench.
+// Hand-picked until a trace is recorded; see hot_paths.lf.
+static const char *const hot_path_functions[] = {
+    "display_flush_cb",
+    "touch_read_cb",
+    "climate_controller_update",
+    "update_heating_cooling",
+    "update_humidifier",
+    "update_lighting",
+    "update_metrics",
+    "psychro_compute_batch",
+    "psychro_saturation_kpa",
+    "sensor_hal_get_value",
+    "sensor_hal_get_ambient",
+    "probe_manager_get_control_temps",
+    "control_fsm_band",
+    "control_fsm_step",
+    "pid_update",
+    "pid_tpo_update",
+    "thermal_model_update",
+    "actuator_manager_set",
+    "actuator_manager_commit",
+    "energy_meter_update",
+};
+
+#endif /* HOT_PATHS_H */
@@ -0,0 +1,185 @@
+#include "png_writer.h"
+#include "esp_log.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "png_writer";
+
+// Largest payload of a stored (uncompressed) deflate block
+#define DEFLATE_STORED_MAX 65535
+
+// Streaming state for the single IDAT chunk
+typedef struct {
+    FILE *f;
+    uint32_t crc;          // Chunk CRC (type + data)
+    uint32_t adler_a;      // zlib Adler-32
+    uint32_t adler_b;
+    size_t raw_left;       // Uncompressed bytes still to write
+    size_t block_left;     // Bytes left in the current stored block
+} png_stream_t;
+
+uint32_t png_crc32(uint32_t crc, const void *data, size_t len) {
+    static uint32_t table[256];
+    static bool table_ready = false;
+
+    if (!table_ready) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        table_ready = true;
+    }
+
+    const uint8_t *p = data;
+    crc = ~crc;
+    while (len--) {
+        crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void put_be32(uint8_t *out, uint32_t v) {
+    out[0] = v >> 24;
+    out[1] = v >> 16;
+    out[2] = v >> 8;
+    out[3] = v;
+}
+
+// Write bytes that belong to the current chunk and fold them into its CRC
+static void chunk_write(png_stream_t *s, const void *data, size_t len) {
+    fwrite(data, 1, len, s->f);
+    s->crc = png_crc32(s->crc, data, len);
+}
+
+static void write_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len) {
+    uint8_t hdr[8];
+    put_be32(hdr, len);
+    memcpy(hdr + 4, type, 4);
+    fwrite(hdr, 1, 8, f);
+    if (len) {
+        fwrite(data, 1, len, f);
+    }
+
+    uint32_t crc = png_crc32(0, type, 4);
+    crc = png_crc32(crc, data, len);
+    uint8_t crc_be[4];
+    put_be32(crc_be, crc);
+    fwrite(crc_be, 1, 4, f);
+}
+
+// Append uncompressed image bytes, opening stored deflate blocks as needed
+static void idat_put(png_stream_t *s, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        if (s->block_left == 0) {
+            size_t block = s->raw_left > DEFLATE_STORED_MAX ? DEFLATE_STORED_MAX : s->raw_left;
+            uint8_t hdr[5] = {
+                block == s->raw_left ? 1 : 0,    // BFINAL, BTYPE = stored
+                block & 0xFF, block >> 8,
+                ~block & 0xFF, (~block >> 8) & 0xFF
+            };
+            chunk_write(s, hdr, sizeof(hdr));
+            s->block_left = block;
+        }
+
+        size_t n = len < s->block_left ? len : s->block_left;
+        chunk_write(s, data, n);
+
+        for (size_t i = 0; i < n; i++) {
+            s->adler_a = (s->adler_a + data[i]) % 65521;
+            s->adler_b = (s->adler_b + s->adler_a) % 65521;
+        }
+
+        data += n;
+        len -= n;
+        s->block_left -= n;
+        s->raw_left -= n;
+    }
+}
+
+esp_err_t png_write_rgb565(const char *path, const uint16_t *pixels, int width, int height) {
+    if (!path || !pixels || width <= 0 || height <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        ESP_LOGE(TAG, "Cannot open %s", path);
+        return ESP_FAIL;
+    }
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, sizeof(signature), f);
+
+    // IHDR: 8-bit RGB, no interlace
+    uint8_t ihdr[13];
+    put_be32(ihdr, width);
+    put_be32(ihdr + 4, height);
+    ihdr[8] = 8;
+    ihdr[9] = 2;
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+    write_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+
+    // IDAT length is known up front since nothing is compressed
+    size_t row_len = 1 + (size_t)width * 3;
+    size_t raw_len = row_len * height;
+    size_t blocks = (raw_len + DEFLATE_STORED_MAX - 1) / DEFLATE_STORED_MAX;
+    uint32_t idat_len = 2 + blocks * 5 + raw_len + 4;
+
+    uint8_t hdr[8];
+    put_be32(hdr, idat_len);
+    memcpy(hdr + 4, "IDAT", 4);
+    fwrite(hdr, 1, 8, f);
+
+    png_stream_t s = {
+        .f = f,
+        .crc = png_crc32(0, "IDAT", 4),
+        .adler_a = 1,
+        .adler_b = 0,
+        .raw_left = raw_len,
+        .block_left = 0,
+    };
+
+    static const uint8_t zlib_hdr[2] = {0x78, 0x01};
+    chunk_write(&s, zlib_hdr, sizeof(zlib_hdr));
+
+    uint8_t row[1 + 3 * 64];
+    for (int y = 0; y < height; y++) {
+        uint8_t filter = 0;
+        idat_put(&s, &filter, 1);
+
+        // Convert in small batches to keep the stack footprint fixed
+        for (int x = 0; x < width; x += 64) {
+            int n = width - x < 64 ? width - x : 64;
+            for (int i = 0; i < n; i++) {
+                uint16_t px = pixels[(size_t)y * width + x + i];
+                uint8_t r = (px >> 11) & 0x1F;
+                uint8_t g = (px >> 5) & 0x3F;
+                uint8_t b = px & 0x1F;
+                row[i * 3] = (r << 3) | (r >> 2);
+                row[i * 3 + 1] = (g << 2) | (g >> 4);
+                row[i * 3 + 2] = (b << 3) | (b >> 2);
+            }
+            idat_put(&s, row, n * 3);
+        }
+    }
+
+    uint8_t adler[4];
+    put_be32(adler, (s.adler_b << 16) | s.adler_a);
+    chunk_write(&s, adler, sizeof(adler));
+
+    uint8_t crc_be[4];
+    put_be32(crc_be, s.crc);
+    fwrite(crc_be, 1, 4, f);
+
+    write_chunk(f, "IEND", NULL, 0);
+
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok ? ESP_OK : ESP_FAIL;
+}
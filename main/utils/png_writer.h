@@ -0,0 +1,14 @@
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Write an RGB565 image as an uncompressed 8-bit RGB PNG
+esp_err_t png_write_rgb565(const char *path, const uint16_t *pixels, int width, int height);
+
+// Running CRC-32 (PNG/zlib polynomial), start with crc = 0
+uint32_t png_crc32(uint32_t crc, const void *data, size_t len);
+
+#endif /* PNG_WRITER_H */
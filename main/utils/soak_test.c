@@ -0,0 +1,212 @@
+#include "soak_test.h"
+#include "display_driver.h"
+#include "touch_driver.h"
+#include "ui.h"
+#include "climate_controller.h"
+#include "data_simulator.h"
+#include "event_logger.h"
+#include "schedule_manager.h"
+#include "sensor_hal.h"
+#include "settings_manager.h"
+#include "system_monitor.h"
+#include "esp_log.h"
+#include <string.h>
+#include "lvgl.h"
+#if CONFIG_IDF_TARGET_LINUX
+#include <malloc.h>
+#else
+#include "esp_heap_caps.h"
+#endif
+
+static const char *TAG = "soak_test";
+
+// Virtual time step (the sensor period, which paces the climate task)
+#define SOAK_STEP_MS CLIMATE_CONTROL_PERIOD_MS
+
+// How often the UI is serviced in virtual time
+#define SOAK_UI_PERIOD_MS 1000
+
+static const char *metric_names[SOAK_METRIC_COUNT] = {
+    "heap_internal", "heap_spiram", "lvgl_mem", "lvgl_objects"
+};
+
+static soak_series_t series[SOAK_METRIC_COUNT];
+
+// Add one hourly sample; returns true if the series is growing monotonically
+bool soak_series_add(soak_series_t *s, size_t value) {
+    if (s->samples == 0 || value < s->min) s->min = value;
+    if (s->samples == 0 || value > s->max) s->max = value;
+
+    s->window[s->samples % SOAK_GROWTH_WINDOW] = value;
+    s->samples++;
+
+    if (s->samples < SOAK_GROWTH_WINDOW) {
+        s->growing = false;
+        return false;
+    }
+
+    // Oldest to newest: never shrinking and ending higher than it started
+    uint32_t first = s->samples % SOAK_GROWTH_WINDOW;
+    size_t prev = s->window[first];
+    for (uint32_t i = 1; i < SOAK_GROWTH_WINDOW; i++) {
+        size_t v = s->window[(first + i) % SOAK_GROWTH_WINDOW];
+        if (v < prev) {
+            s->growing = false;
+            return false;
+        }
+        prev = v;
+    }
+
+    s->growing = prev > s->window[first];
+    return s->growing;
+}
+
+// Count an object and all of its descendants
+static uint32_t count_objects(lv_obj_t *obj) {
+    uint32_t count = 1;
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < child_cnt; i++) {
+        count += count_objects(lv_obj_get_child(obj, i));
+    }
+    return count;
+}
+
+static uint32_t count_all_objects(void) {
+    lv_disp_t *disp = lv_disp_get_default();
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < disp->screen_cnt; i++) {
+        count += count_objects(disp->screens[i]);
+    }
+    return count + count_objects(disp->top_layer) + count_objects(disp->sys_layer);
+}
+
+static void sample_metrics(size_t *values) {
+#if CONFIG_IDF_TARGET_LINUX
+    // The host heap has no capabilities; report everything as internal
+    struct mallinfo2 mi = mallinfo2();
+    values[SOAK_METRIC_HEAP_INTERNAL] = mi.uordblks;
+    values[SOAK_METRIC_HEAP_SPIRAM] = 0;
+#else
+    values[SOAK_METRIC_HEAP_INTERNAL] = heap_caps_get_total_size(MALLOC_CAP_INTERNAL) -
+                                        heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    values[SOAK_METRIC_HEAP_SPIRAM] = heap_caps_get_total_size(MALLOC_CAP_SPIRAM) -
+                                      heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+#endif
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    values[SOAK_METRIC_LVGL_MEM] = mon.total_size - mon.free_size;
+    values[SOAK_METRIC_LVGL_OBJECTS] = count_all_objects();
+}
+
+// Burst of alerts as produced by sensor faults and watchdog warnings
+static void alert_burst(uint32_t hour) {
+    for (int i = 0; i < 8; i++) {
+        event_logger_add_fmt("ALERT: soak burst %u/%d", true, (unsigned)hour, i);
+    }
+}
+
+// Connection drop and recovery, logged the way mqtt_manager reports them
+static void reconnect_cycle(void) {
+    event_logger_add("Disconnected from MQTT broker", true);
+    event_logger_add("WiFi connection lost", false);
+    event_logger_add("WiFi connection established", false);
+    event_logger_add("Connected to MQTT broker", false);
+}
+
+// Dismiss alert boxes the way a user would, a few times a day
+static void dismiss_alerts(void) {
+    lv_obj_clean(lv_layer_top());
+}
+
+esp_err_t soak_test_run(void) {
+    ESP_LOGI(TAG, "Starting soak test: %d virtual days", SOAK_VIRTUAL_DAYS);
+
+    lv_init();
+    if (display_init() != ESP_OK) {
+        return ESP_FAIL;
+    }
+    touch_init();
+    settings_init();
+    event_logger_init();
+    climate_controller_init();
+    data_simulator_init();
+    sensor_hal_init();
+    schedule_manager_init();
+    system_monitor_init();
+    ui_init();
+
+    memset(series, 0, sizeof(series));
+
+    const uint32_t steps_per_hour = 3600 * 1000 / SOAK_STEP_MS;
+    const uint32_t total_hours = SOAK_VIRTUAL_DAYS * 24;
+    bool failed = false;
+
+    for (uint32_t hour = 0; hour < total_hours && !failed; hour++) {
+        for (uint32_t step = 0; step < steps_per_hour; step++) {
+            uint32_t ms = step * SOAK_STEP_MS;
+
+            if (ms % 1000 == 0) {
+                data_simulator_update();
+                ui_update_sensor_data(data_simulator_get_temperature(),
+                                      data_simulator_get_humidity(),
+                                      data_simulator_get_light());
+            }
+            sensor_hal_poll(((int64_t)hour * 3600 * 1000 + ms) * 1000);
+            climate_controller_update();
+            if (ms % 2000 == 0) {
+                system_monitor_update();
+            }
+            if (ms % SOAK_UI_PERIOD_MS == 0) {
+                lv_tick_inc(SOAK_UI_PERIOD_MS);
+                event_logger_drain_ui();
+                ui_update();
+            }
+        }
+
+        // Hourly disturbances
+        ui_switch_screen((screen_t)(hour % SCREEN_COUNT));
+        if (hour % 3 == 0) {
+            alert_burst(hour);
+        }
+        if (hour % 5 == 0) {
+            reconnect_cycle();
+        }
+        if (hour % 8 == 7) {
+            dismiss_alerts();
+        }
+        event_logger_drain_ui();
+        ui_update();
+
+        size_t values[SOAK_METRIC_COUNT];
+        sample_metrics(values);
+
+        ESP_LOGI(TAG, "hour %4u heap_int=%u heap_psram=%u lvgl_mem=%u objects=%u",
+                 (unsigned)hour,
+                 (unsigned)values[SOAK_METRIC_HEAP_INTERNAL],
+                 (unsigned)values[SOAK_METRIC_HEAP_SPIRAM],
+                 (unsigned)values[SOAK_METRIC_LVGL_MEM],
+                 (unsigned)values[SOAK_METRIC_LVGL_OBJECTS]);
+
+        if (hour < SOAK_WARMUP_HOURS) {
+            continue;
+        }
+
+        for (int m = 0; m < SOAK_METRIC_COUNT; m++) {
+            if (soak_series_add(&series[m], values[m])) {
+                ESP_LOGE(TAG, "%s grew for %d consecutive hours (%u -> %u)",
+                         metric_names[m], SOAK_GROWTH_WINDOW,
+                         (unsigned)series[m].min, (unsigned)values[m]);
+                failed = true;
+            }
+        }
+    }
+
+    for (int m = 0; m < SOAK_METRIC_COUNT; m++) {
+        ESP_LOGI(TAG, "%-13s min=%u max=%u", metric_names[m],
+                 (unsigned)series[m].min, (unsigned)series[m].max);
+    }
+
+    ESP_LOGI(TAG, "Soak test %s", failed ? "FAILED" : "passed");
+    return failed ? ESP_FAIL : ESP_OK;
+}
@@ -0,0 +1,50 @@
+#ifndef SOAK_TEST_H
+#define SOAK_TEST_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Virtual duration of a soak run
+#ifndef SOAK_VIRTUAL_DAYS
+#define SOAK_VIRTUAL_DAYS 14
+#endif
+
+// Hourly samples a metric must keep growing over to count as a leak
+#ifndef SOAK_GROWTH_WINDOW
+#define SOAK_GROWTH_WINDOW 48
+#endif
+
+// Virtual hours ignored before growth checks start (caches, lazy screens)
+#ifndef SOAK_WARMUP_HOURS
+#define SOAK_WARMUP_HOURS 6
+#endif
+
+// Metrics sampled every virtual hour
+typedef enum {
+    SOAK_METRIC_HEAP_INTERNAL,   // Internal RAM in use (bytes)
+    SOAK_METRIC_HEAP_SPIRAM,     // PSRAM in use (bytes)
+    SOAK_METRIC_LVGL_MEM,        // LVGL heap in use (bytes)
+    SOAK_METRIC_LVGL_OBJECTS,    // Live LVGL objects on all screens and layers
+    SOAK_METRIC_COUNT
+} soak_metric_t;
+
+// Growth tracking for one metric
+typedef struct {
+    size_t window[SOAK_GROWTH_WINDOW];
+    uint32_t samples;
+    size_t min;
+    size_t max;
+    bool growing;                // Non-decreasing across the whole window
+} soak_series_t;
+
+// Run the soak scenario: weeks of virtual time with alert bursts, screen
+// switches and connection drops. Expects nothing to be initialized.
+// Returns ESP_FAIL if any metric grew monotonically over a full window.
+esp_err_t soak_test_run(void);
+
+// Add one hourly sample; returns true if the series is growing monotonically
+bool soak_series_add(soak_series_t *series, size_t value);
+
+#endif /* SOAK_TEST_H */
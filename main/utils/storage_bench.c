@@ -0,0 +1,444 @@
+#include "storage_bench.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "lfs.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if CONFIG_IDF_TARGET_LINUX && CONFIG_ESP_PARTITION_ENABLE_STATS
+#include "esp_private/partition_linux.h"
+#define HAVE_PARTITION_STATS 1
+#else
+#define HAVE_PARTITION_STATS 0
+#endif
+
+static const char *TAG = "storage_bench";
+
+#define FLASH_SECTOR_SIZE 4096
+#define MAX_BENCH_SECTORS 256
+
+// Storage backend under test
+typedef struct {
+    const char *name;
+    const char *partition;
+    esp_err_t (*open)(const esp_partition_t *part, size_t record_size);
+    esp_err_t (*append)(uint32_t index, const void *record, size_t size);
+    esp_err_t (*read)(uint32_t index, void *record, size_t size);
+    void (*close)(void);
+    uint32_t (*readable)(uint32_t count);   // Oldest records may be gone
+    bool counts_flash;                      // Flash access goes through bench_flash_*
+} bench_store_t;
+
+// Flash accounting for the backends that write through bench_flash_*
+static const esp_partition_t *bench_part;
+static uint64_t flash_bytes_written;
+static uint16_t sector_erases[MAX_BENCH_SECTORS];
+
+// Read a record back for verification
+static uint8_t read_buffer[sizeof(storage_bench_log_t)];
+static uint32_t read_times[STORAGE_BENCH_READS];
+
+// Reset flash accounting
+static void flash_stats_reset(void) {
+    flash_bytes_written = 0;
+    memset(sector_erases, 0, sizeof(sector_erases));
+#if HAVE_PARTITION_STATS
+    esp_partition_clear_stats();
+#endif
+}
+
+// Write to the partition under test and count the bytes
+static esp_err_t bench_flash_write(size_t offset, const void *data, size_t len) {
+    flash_bytes_written += len;
+    return esp_partition_write(bench_part, offset, data, len);
+}
+
+// Erase a sector range of the partition under test and count the erases
+static esp_err_t bench_flash_erase(size_t offset, size_t len) {
+    for (size_t s = offset / FLASH_SECTOR_SIZE; s < (offset + len) / FLASH_SECTOR_SIZE; s++) {
+        if (s < MAX_BENCH_SECTORS) {
+            sector_erases[s]++;
+        }
+    }
+    return esp_partition_erase_range(bench_part, offset, len);
+}
+
+// ---------------------------------------------------------------------------
+// NVS, one key per record (how settings_manager stores values today)
+
+static nvs_handle_t nvs_bench_handle;
+
+static esp_err_t nvs_store_open(const esp_partition_t *part, size_t record_size) {
+    nvs_flash_erase_partition(part->label);
+    esp_err_t err = nvs_flash_init_partition(part->label);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return nvs_open_from_partition(part->label, "bench", NVS_READWRITE, &nvs_bench_handle);
+}
+
+static esp_err_t nvs_store_append(uint32_t index, const void *record, size_t size) {
+    char key[16];
+    snprintf(key, sizeof(key), "r%05" PRIu32, index);
+    esp_err_t err = nvs_set_blob(nvs_bench_handle, key, record, size);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_bench_handle);
+    }
+    return err;
+}
+
+static esp_err_t nvs_store_read(uint32_t index, void *record, size_t size) {
+    char key[16];
+    snprintf(key, sizeof(key), "r%05" PRIu32, index);
+    size_t len = size;
+    return nvs_get_blob(nvs_bench_handle, key, record, &len);
+}
+
+static void nvs_store_close(void) {
+    nvs_close(nvs_bench_handle);
+    nvs_flash_deinit_partition(STORAGE_BENCH_NVS_PARTITION);
+}
+
+static uint32_t all_readable(uint32_t count) {
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// LittleFS, one append-only file per record type
+
+#define LFS_CACHE_SIZE 256
+#define LFS_LOOKAHEAD_SIZE 32
+
+static lfs_t lfs;
+static lfs_file_t lfs_bench_file;
+static uint8_t lfs_read_cache[LFS_CACHE_SIZE];
+static uint8_t lfs_prog_cache[LFS_CACHE_SIZE];
+static uint8_t lfs_lookahead[LFS_LOOKAHEAD_SIZE];
+static uint8_t lfs_file_cache[LFS_CACHE_SIZE];
+static size_t lfs_record_size;
+
+static int lfs_bd_read(const struct lfs_config *c, lfs_block_t block,
+                       lfs_off_t off, void *buffer, lfs_size_t size) {
+    return esp_partition_read(bench_part, block * c->block_size + off, buffer, size) == ESP_OK ?
+           LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int lfs_bd_prog(const struct lfs_config *c, lfs_block_t block,
+                       lfs_off_t off, const void *buffer, lfs_size_t size) {
+    return bench_flash_write(block * c->block_size + off, buffer, size) == ESP_OK ?
+           LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int lfs_bd_erase(const struct lfs_config *c, lfs_block_t block) {
+    return bench_flash_erase(block * c->block_size, c->block_size) == ESP_OK ?
+           LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int lfs_bd_sync(const struct lfs_config *c) {
+    return LFS_ERR_OK;
+}
+
+static struct lfs_config lfs_cfg = {
+    .read = lfs_bd_read,
+    .prog = lfs_bd_prog,
+    .erase = lfs_bd_erase,
+    .sync = lfs_bd_sync,
+    .read_size = 16,
+    .prog_size = 16,
+    .block_size = FLASH_SECTOR_SIZE,
+    .block_cycles = 500,
+    .cache_size = LFS_CACHE_SIZE,
+    .lookahead_size = LFS_LOOKAHEAD_SIZE,
+    .read_buffer = lfs_read_cache,
+    .prog_buffer = lfs_prog_cache,
+    .lookahead_buffer = lfs_lookahead,
+};
+
+static const struct lfs_file_config lfs_file_cfg = {
+    .buffer = lfs_file_cache,
+};
+
+static esp_err_t lfs_store_open(const esp_partition_t *part, size_t record_size) {
+    lfs_cfg.block_count = part->size / FLASH_SECTOR_SIZE;
+    lfs_record_size = record_size;
+
+    if (lfs_format(&lfs, &lfs_cfg) != LFS_ERR_OK || lfs_mount(&lfs, &lfs_cfg) != LFS_ERR_OK) {
+        return ESP_FAIL;
+    }
+    if (lfs_file_opencfg(&lfs, &lfs_bench_file, "records.bin",
+                         LFS_O_RDWR | LFS_O_CREAT | LFS_O_APPEND, &lfs_file_cfg) != LFS_ERR_OK) {
+        lfs_unmount(&lfs);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t lfs_store_append(uint32_t index, const void *record, size_t size) {
+    if (lfs_file_write(&lfs, &lfs_bench_file, record, size) != (lfs_ssize_t)size) {
+        return ESP_FAIL;
+    }
+    // Every record must survive a reset, like an NVS commit
+    return lfs_file_sync(&lfs, &lfs_bench_file) == LFS_ERR_OK ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t lfs_store_read(uint32_t index, void *record, size_t size) {
+    if (lfs_file_seek(&lfs, &lfs_bench_file, index * lfs_record_size, LFS_SEEK_SET) < 0) {
+        return ESP_FAIL;
+    }
+    return lfs_file_read(&lfs, &lfs_bench_file, record, size) == (lfs_ssize_t)size ?
+           ESP_OK : ESP_FAIL;
+}
+
+static void lfs_store_close(void) {
+    lfs_file_close(&lfs, &lfs_bench_file);
+    lfs_unmount(&lfs);
+}
+
+// ---------------------------------------------------------------------------
+// Raw circular log: sequence-tagged slots packed into sectors, the next
+// sector is erased when the head reaches it
+
+static uint32_t ring_slot_size;
+static uint32_t ring_slots_per_sector;
+static uint32_t ring_sectors;
+static uint8_t ring_slot[sizeof(uint32_t) + sizeof(storage_bench_log_t) + 4];
+
+static esp_err_t ring_store_open(const esp_partition_t *part, size_t record_size) {
+    ring_slot_size = (sizeof(uint32_t) + record_size + 3) & ~3U;
+    ring_slots_per_sector = FLASH_SECTOR_SIZE / ring_slot_size;
+    ring_sectors = part->size / FLASH_SECTOR_SIZE;
+    return esp_partition_erase_range(part, 0, FLASH_SECTOR_SIZE);
+}
+
+static size_t ring_offset(uint32_t index) {
+    uint32_t sector = (index / ring_slots_per_sector) % ring_sectors;
+    return (size_t)sector * FLASH_SECTOR_SIZE + (index % ring_slots_per_sector) * ring_slot_size;
+}
+
+static esp_err_t ring_store_append(uint32_t index, const void *record, size_t size) {
+    size_t offset = ring_offset(index);
+
+    if (index > 0 && index % ring_slots_per_sector == 0) {
+        esp_err_t err = bench_flash_erase(offset, FLASH_SECTOR_SIZE);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    memset(ring_slot, 0xFF, ring_slot_size);
+    memcpy(ring_slot, &index, sizeof(index));
+    memcpy(ring_slot + sizeof(index), record, size);
+    return bench_flash_write(offset, ring_slot, ring_slot_size);
+}
+
+static esp_err_t ring_store_read(uint32_t index, void *record, size_t size) {
+    esp_err_t err = esp_partition_read(bench_part, ring_offset(index), ring_slot,
+                                       sizeof(uint32_t) + size);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint32_t seq;
+    memcpy(&seq, ring_slot, sizeof(seq));
+    if (seq != index) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    memcpy(record, ring_slot + sizeof(seq), size);
+    return ESP_OK;
+}
+
+static void ring_store_close(void) {
+}
+
+// The head sector was erased on entry, so its older records are gone
+static uint32_t ring_readable(uint32_t count) {
+    uint32_t capacity = (ring_sectors - 1) * ring_slots_per_sector;
+    return count < capacity ? count : capacity;
+}
+
+static const bench_store_t stores[] = {
+    {"nvs", STORAGE_BENCH_NVS_PARTITION, nvs_store_open, nvs_store_append,
+     nvs_store_read, nvs_store_close, all_readable, false},
+    {"littlefs", STORAGE_BENCH_LFS_PARTITION, lfs_store_open, lfs_store_append,
+     lfs_store_read, lfs_store_close, all_readable, true},
+    {"raw_ring", STORAGE_BENCH_RAW_PARTITION, ring_store_open, ring_store_append,
+     ring_store_read, ring_store_close, ring_readable, true},
+};
+
+// ---------------------------------------------------------------------------
+
+// Deterministic record contents
+static void make_record(bool is_log, uint32_t index, void *out) {
+    if (is_log) {
+        storage_bench_log_t *log = out;
+        memset(log, 0, sizeof(*log));
+        log->timestamp = index * 60;
+        log->is_alert = (index % 7) == 0;
+        snprintf(log->message, sizeof(log->message),
+                 "Heating %s, temperature %" PRIu32 ".%" PRIu32 " C (entry %" PRIu32 ")",
+                 (index & 1) ? "on" : "off", 25 + index % 10, index % 10, index);
+    } else {
+        storage_bench_sample_t *sample = out;
+        sample->timestamp = index * 60;
+        sample->temperature = 25.0f + (index % 50) * 0.1f;
+        sample->humidity = 60.0f + (index % 20) * 0.5f;
+        sample->light = (float)(index % 100);
+    }
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Flash writes and erases of the last run
+static void collect_flash_stats(const bench_store_t *store, storage_bench_result_t *r) {
+    r->flash_stats_valid = false;
+
+    if (store->counts_flash) {
+        r->flash_bytes_written = flash_bytes_written;
+        r->erases = 0;
+        r->max_sector_erases = 0;
+        for (int s = 0; s < MAX_BENCH_SECTORS; s++) {
+            r->erases += sector_erases[s];
+            if (sector_erases[s] > r->max_sector_erases) {
+                r->max_sector_erases = sector_erases[s];
+            }
+        }
+        r->flash_stats_valid = true;
+        return;
+    }
+
+#if HAVE_PARTITION_STATS
+    // NVS writes straight to the partition; use the emulator's counters
+    r->flash_bytes_written = esp_partition_get_write_bytes();
+    r->erases = esp_partition_get_erase_ops();
+    r->max_sector_erases = 0;
+    size_t first = bench_part->address / FLASH_SECTOR_SIZE;
+    size_t last = (bench_part->address + bench_part->size) / FLASH_SECTOR_SIZE;
+    for (size_t s = first; s < last; s++) {
+        size_t n = esp_partition_get_sector_erase_count(s);
+        if (n > r->max_sector_erases) {
+            r->max_sector_erases = n;
+        }
+    }
+    r->flash_stats_valid = true;
+#endif
+}
+
+// Append count records, then time random reads of the readable ones
+static esp_err_t run_store(const bench_store_t *store, bool is_log, storage_bench_result_t *r) {
+    size_t size = is_log ? sizeof(storage_bench_log_t) : sizeof(storage_bench_sample_t);
+    uint32_t count = is_log ? STORAGE_BENCH_LOG_COUNT : STORAGE_BENCH_SAMPLE_COUNT;
+    uint8_t record[sizeof(storage_bench_log_t)];
+
+    memset(r, 0, sizeof(*r));
+    r->store = store->name;
+    r->record = is_log ? "log" : "sample";
+    r->record_size = size;
+    r->count = count;
+
+    bench_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                          store->partition);
+    if (!bench_part) {
+        ESP_LOGE(TAG, "Partition %s not found (flash partitions_bench.csv)", store->partition);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    esp_err_t err = store->open(bench_part, size);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "%s: open failed: %s", store->name, esp_err_to_name(err));
+        return err;
+    }
+    flash_stats_reset();
+
+    // Append
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < count; i++) {
+        make_record(is_log, i, record);
+        err = store->append(i, record, size);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "%s: append %" PRIu32 " failed: %s", store->name, i, esp_err_to_name(err));
+            store->close();
+            return err;
+        }
+    }
+    r->append_us = esp_timer_get_time() - start;
+    collect_flash_stats(store, r);
+
+    // Random reads of the records still held
+    uint32_t readable = store->readable(count);
+    uint32_t seed = 12345;
+    for (int i = 0; i < STORAGE_BENCH_READS; i++) {
+        seed = seed * 1103515245U + 12345U;
+        uint32_t index = count - readable + (seed >> 8) % readable;
+
+        int64_t t0 = esp_timer_get_time();
+        err = store->read(index, read_buffer, size);
+        read_times[i] = (uint32_t)(esp_timer_get_time() - t0);
+
+        make_record(is_log, index, record);
+        if (err != ESP_OK || memcmp(read_buffer, record, size) != 0) {
+            ESP_LOGE(TAG, "%s: record %" PRIu32 " read back wrong", store->name, index);
+            store->close();
+            return ESP_FAIL;
+        }
+    }
+    store->close();
+
+    qsort(read_times, STORAGE_BENCH_READS, sizeof(read_times[0]), compare_u32);
+    r->read_p50_us = read_times[STORAGE_BENCH_READS / 2];
+    r->read_p99_us = read_times[STORAGE_BENCH_READS * 99 / 100];
+    r->read_max_us = read_times[STORAGE_BENCH_READS - 1];
+
+    return ESP_OK;
+}
+
+// Log one result line
+static void report(const storage_bench_result_t *r) {
+    double secs = r->append_us / 1e6;
+    double payload = (double)r->record_size * r->count;
+    char amp[16] = "n/a";
+    char erases[16] = "n/a";
+    char worst[16] = "n/a";
+
+    if (r->flash_stats_valid) {
+        snprintf(amp, sizeof(amp), "%.2f", r->flash_bytes_written / payload);
+        snprintf(erases, sizeof(erases), "%" PRIu32, r->erases);
+        snprintf(worst, sizeof(worst), "%" PRIu32, r->max_sector_erases);
+    }
+
+    ESP_LOGI(TAG, "STORAGE store=%s record=%s size=%u count=%" PRIu32
+             " rec_per_s=%.0f kib_per_s=%.1f read_p50_us=%" PRIu32 " read_p99_us=%" PRIu32
+             " read_max_us=%" PRIu32 " write_amp=%s erases=%s max_sector_erases=%s",
+             r->store, r->record, (unsigned)r->record_size, r->count,
+             r->count / secs, payload / 1024.0 / secs,
+             r->read_p50_us, r->read_p99_us, r->read_max_us, amp, erases, worst);
+}
+
+// Run every store against both record sizes
+esp_err_t storage_bench_run(void) {
+    esp_err_t result = ESP_OK;
+    storage_bench_result_t r;
+
+    ESP_LOGI(TAG, "Storage benchmark: %d samples of %u bytes, %d log entries of %u bytes",
+             STORAGE_BENCH_SAMPLE_COUNT, (unsigned)sizeof(storage_bench_sample_t),
+             STORAGE_BENCH_LOG_COUNT, (unsigned)sizeof(storage_bench_log_t));
+
+    for (size_t s = 0; s < sizeof(stores) / sizeof(stores[0]); s++) {
+        for (int is_log = 0; is_log <= 1; is_log++) {
+            if (run_store(&stores[s], is_log, &r) != ESP_OK) {
+                result = ESP_FAIL;
+                continue;
+            }
+            report(&r);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef STORAGE_BENCH_H
+#define STORAGE_BENCH_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Partitions from partitions_bench.csv
+#define STORAGE_BENCH_NVS_PARTITION "bench_nvs"
+#define STORAGE_BENCH_LFS_PARTITION "bench_lfs"
+#define STORAGE_BENCH_RAW_PARTITION "bench_raw"
+
+// Records appended per run
+#ifndef STORAGE_BENCH_SAMPLE_COUNT
+#define STORAGE_BENCH_SAMPLE_COUNT 2000
+#endif
+#ifndef STORAGE_BENCH_LOG_COUNT
+#define STORAGE_BENCH_LOG_COUNT 500
+#endif
+
+// Random reads per run
+#ifndef STORAGE_BENCH_READS
+#define STORAGE_BENCH_READS 200
+#endif
+
+// Sensor sample as it would be stored in history
+typedef struct {
+    uint32_t timestamp;
+    float temperature;
+    float humidity;
+    float light;
+} storage_bench_sample_t;
+
+// Event log entry as kept by event_logger
+typedef struct {
+    uint32_t timestamp;
+    char message[127];
+    bool is_alert;
+} storage_bench_log_t;
+
+// Result of one store / record size combination
+typedef struct {
+    const char *store;
+    const char *record;
+    size_t record_size;
+    uint32_t count;
+    int64_t append_us;          // Total time for all appends
+    uint32_t read_p50_us;
+    uint32_t read_p99_us;
+    uint32_t read_max_us;
+    uint64_t flash_bytes_written;   // 0 if the backend can't be measured
+    uint32_t erases;                // Sector erases
+    uint32_t max_sector_erases;     // Erases of the most worn sector
+    bool flash_stats_valid;
+} storage_bench_result_t;
+
+// Run every store against both record sizes and log the results.
+// Expects nvs_flash_init() to have run; erases the bench partitions.
+esp_err_t storage_bench_run(void);
+
+#endif /* STORAGE_BENCH_H */
@@ -0,0 +1,310 @@
+#include "ui_bench.h"
+#include "png_writer.h"
+#include "display_driver.h"
+#include "display_config.h"
+#include "ui_helpers.h"
+#include "screens/ui_dashboard.h"
+#include "screens/ui_climate.h"
+#include "screens/ui_schedule.h"
+#include "screens/ui_system.h"
+#include "screens/ui_logs.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "lvgl.h"
+
+static const char *TAG = "ui_bench";
+
+// Bootstrap build: record the references instead of checking against them
+#ifdef REPTICONTROL_UI_BENCH_UPDATE
+static const bool update_references = true;
+#else
+static const bool update_references = false;
+#endif
+
+// Screen under test: constructor plus a small update that dirties one region
+typedef struct {
+    const char *name;
+    lv_obj_t *(*create)(void);
+    void (*update)(int step);
+} bench_screen_t;
+
+static void update_dashboard(int step) {
+    ui_dashboard_update_sensors(24.0f + (step % 10) * 0.1f, 55.0f, 70.0f);
+}
+
+static void update_climate(int step) {
+    ui_climate_update_values(25.0f + (step % 2), 50.0f, 75.0f, step & 1, false, false, true);
+}
+
+static void update_schedule(int step) {
+    ui_schedule_remove_event(1, 8, 0);
+    ui_schedule_add_event(1, 8, 0, 26.0f + (step % 2), 60.0f, 80.0f);
+}
+
+static void update_system(int step) {
+    const schedule_accuracy_t accuracy = {
+        .events = step + 1,
+        .on_time = step,
+        .last_error_c = 0.2f,
+        .mean_abs_error_c = 0.3f,
+        .last_arrival_s = -120,
+        .arrival_valid = true,
+    };
+
+    ui_system_update_stats(20 + step % 50, 40);
+    ui_system_update_schedule(&accuracy, 0.12f, 0.05f);
+}
+
+static void update_logs(int step) {
+    ui_logs_add_entry(step & 1 ? "Heating activated" : "Heating deactivated", false);
+}
+
+static const bench_screen_t bench_screens[] = {
+    {"dashboard", ui_dashboard_create, update_dashboard},
+    {"climate", ui_climate_create, update_climate},
+    {"schedule", ui_schedule_create, update_schedule},
+    {"system", ui_system_create, update_system},
+    {"logs", ui_logs_create, update_logs},
+};
+
+#define BENCH_SCREEN_COUNT (sizeof(bench_screens) / sizeof(bench_screens[0]))
+
+static const display_type_t bench_displays[] = {DISPLAY_5_INCH, DISPLAY_7_INCH};
+
+// Count an object and all of its descendants
+static uint32_t count_objects(lv_obj_t *obj) {
+    uint32_t count = 1;
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < child_cnt; i++) {
+        count += count_objects(lv_obj_get_child(obj, i));
+    }
+    return count;
+}
+
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int64_t median(int64_t *samples, int n) {
+    qsort(samples, n, sizeof(samples[0]), cmp_i64);
+    return samples[n / 2];
+}
+
+// Advance LVGL time so animations and timers progress deterministically
+static void advance(uint32_t ms) {
+    lv_tick_inc(ms);
+    lv_timer_handler();
+}
+
+static int64_t render_full(lv_obj_t *scr) {
+    lv_obj_invalidate(scr);
+    int64_t start = esp_timer_get_time();
+    lv_refr_now(NULL);
+    return esp_timer_get_time() - start;
+}
+
+static int64_t render_incremental(const bench_screen_t *bs, int step) {
+    bs->update(step);
+    int64_t start = esp_timer_get_time();
+    lv_refr_now(NULL);
+    return esp_timer_get_time() - start;
+}
+
+// Look up the baseline for a screen; returns false if none is recorded
+static bool load_baseline(const char *screen, int w, int h, int64_t *full_us, int64_t *incr_us) {
+    FILE *f = fopen(UI_BENCH_REFERENCE_DIR "/ui_bench_baseline.csv", "r");
+    if (!f) {
+        return false;
+    }
+
+    char line[128];
+    bool found = false;
+    while (fgets(line, sizeof(line), f)) {
+        char name[32];
+        int bw, bh;
+        long long full, incr;
+        if (sscanf(line, "%31[^,],%d,%d,%lld,%lld", name, &bw, &bh, &full, &incr) == 5 &&
+            strcmp(name, screen) == 0 && bw == w && bh == h) {
+            *full_us = full;
+            *incr_us = incr;
+            found = true;
+            break;
+        }
+    }
+
+    fclose(f);
+    return found;
+}
+
+// Compare the current frame with the reference PNG by CRC of the file contents
+static bool reference_matches(const char *png_path, const char *ref_path) {
+    FILE *a = fopen(png_path, "rb");
+    FILE *b = fopen(ref_path, "rb");
+    bool match = a && b;
+    uint32_t crc_a = 0, crc_b = 0;
+    uint8_t buf[512];
+    size_t n;
+
+    if (match) {
+        while ((n = fread(buf, 1, sizeof(buf), a)) > 0) crc_a = png_crc32(crc_a, buf, n);
+        while ((n = fread(buf, 1, sizeof(buf), b)) > 0) crc_b = png_crc32(crc_b, buf, n);
+        match = crc_a == crc_b;
+    }
+
+    if (a) fclose(a);
+    if (b) fclose(b);
+    return match;
+}
+
+static void bench_screen(const bench_screen_t *bs, ui_bench_result_t *res) {
+    int64_t samples[UI_BENCH_ITERATIONS];
+    lv_mem_monitor_t mon;
+
+    lv_obj_t *blank = lv_scr_act();
+    lv_obj_t *scr = bs->create();
+    lv_scr_load(scr);
+    advance(TRANSITION_TIME);
+
+    res->screen = bs->name;
+    res->width = LCD_H_RES;
+    res->height = LCD_V_RES;
+    res->objects = count_objects(scr);
+
+    // First frame warms up font and style caches
+    render_full(scr);
+    for (int i = 0; i < UI_BENCH_ITERATIONS; i++) {
+        samples[i] = render_full(scr);
+    }
+    res->full_us = median(samples, UI_BENCH_ITERATIONS);
+
+    const lv_color_t *fb = display_headless_get_framebuffer();
+    res->fb_crc = png_crc32(0, fb, (size_t)LCD_H_RES * LCD_V_RES * sizeof(lv_color_t));
+
+    char png_path[128], ref_path[128];
+    snprintf(png_path, sizeof(png_path), UI_BENCH_OUTPUT_DIR "/%s_%dx%d.png", bs->name, LCD_H_RES, LCD_V_RES);
+    snprintf(ref_path, sizeof(ref_path), UI_BENCH_REFERENCE_DIR "/%s_%dx%d.png", bs->name, LCD_H_RES, LCD_V_RES);
+    png_write_rgb565(png_path, (const uint16_t *)fb, LCD_H_RES, LCD_V_RES);
+
+    struct stat st;
+    if (update_references) {
+        png_write_rgb565(ref_path, (const uint16_t *)fb, LCD_H_RES, LCD_V_RES);
+    } else if (stat(ref_path, &st) == 0) {
+        res->image_mismatch = !reference_matches(png_path, ref_path);
+    } else {
+        ESP_LOGE(TAG, "No reference image %s", ref_path);
+        res->no_reference = true;
+    }
+
+    // Incremental updates; let animations settle between samples
+    uint32_t pixels = 0;
+    for (int i = 0; i < UI_BENCH_ITERATIONS; i++) {
+        display_headless_reset_flush_stats();
+        samples[i] = render_incremental(bs, i);
+        display_headless_get_flush_stats(NULL, &pixels);
+        advance(TRANSITION_TIME);
+    }
+    res->incr_us = median(samples, UI_BENCH_ITERATIONS);
+    res->incr_pixels = pixels;
+
+    lv_mem_monitor(&mon);
+    res->mem_used = mon.total_size - mon.free_size;
+    res->mem_peak = mon.max_used;
+
+    int64_t base_full, base_incr;
+    if (update_references) {
+        // Nothing to compare: this run is the baseline
+    } else if (load_baseline(bs->name, LCD_H_RES, LCD_V_RES, &base_full, &base_incr)) {
+        res->regressed = res->full_us * 100 > base_full * (100 + UI_BENCH_TOLERANCE_PCT) ||
+                         res->incr_us * 100 > base_incr * (100 + UI_BENCH_TOLERANCE_PCT);
+    } else {
+        ESP_LOGE(TAG, "No baseline for %s %dx%d in " UI_BENCH_REFERENCE_DIR "/ui_bench_baseline.csv",
+                 bs->name, LCD_H_RES, LCD_V_RES);
+        res->no_reference = true;
+    }
+
+    lv_scr_load(blank);
+    lv_obj_del(scr);
+    advance(1);
+}
+
+esp_err_t ui_bench_run(void) {
+    ESP_LOGI(TAG, "Starting UI render benchmark");
+
+    mkdir(UI_BENCH_OUTPUT_DIR, 0755);
+    if (update_references) {
+        mkdir(UI_BENCH_REFERENCE_DIR, 0755);
+    }
+    FILE *csv = fopen(update_references ? UI_BENCH_REFERENCE_DIR "/ui_bench_baseline.csv"
+                                        : UI_BENCH_OUTPUT_DIR "/ui_bench_baseline.csv", "w");
+
+    lv_init();
+    if (display_init() != ESP_OK) {
+        return ESP_FAIL;
+    }
+    init_styles();
+
+    bool failed = false;
+    bool missing = false;
+    lv_obj_t *prev_blank = NULL;
+
+    for (size_t d = 0; d < sizeof(bench_displays) / sizeof(bench_displays[0]); d++) {
+        if (display_headless_set_type(bench_displays[d]) != ESP_OK) {
+            return ESP_FAIL;
+        }
+
+        // Start each resolution from a fresh blank screen
+        lv_obj_t *blank = lv_obj_create(NULL);
+        lv_scr_load(blank);
+        if (prev_blank) {
+            lv_obj_del(prev_blank);
+        }
+        prev_blank = blank;
+        advance(1);
+
+        for (size_t i = 0; i < BENCH_SCREEN_COUNT; i++) {
+            ui_bench_result_t res = {0};
+            bench_screen(&bench_screens[i], &res);
+
+            ESP_LOGI(TAG, "%-9s %4dx%-3d objs=%-4" PRIu32 " full=%6lld us incr=%6lld us (%" PRIu32 " px) "
+                     "mem=%u peak=%u crc=%08" PRIx32 "%s%s%s",
+                     res.screen, res.width, res.height, res.objects,
+                     (long long)res.full_us, (long long)res.incr_us, res.incr_pixels,
+                     (unsigned)res.mem_used, (unsigned)res.mem_peak, res.fb_crc,
+                     res.regressed ? " REGRESSED" : "",
+                     res.image_mismatch ? " IMAGE-MISMATCH" : "",
+                     res.no_reference ? " NO-REFERENCE" : "");
+
+            if (csv) {
+                fprintf(csv, "%s,%d,%d,%lld,%lld\n", res.screen, res.width, res.height,
+                        (long long)res.full_us, (long long)res.incr_us);
+            }
+
+            failed |= res.regressed || res.image_mismatch || res.no_reference;
+            missing |= res.no_reference;
+        }
+    }
+
+    if (csv) {
+        fclose(csv);
+    }
+
+    // A fresh tree has nothing to compare against: fail rather than pass
+    // unchecked, and say how to record the references
+    if (missing) {
+        ESP_LOGE(TAG, "Missing references: build with -DREPTICONTROL_UI_BENCH_UPDATE=ON to record them in "
+                 UI_BENCH_REFERENCE_DIR ", review the PNGs and commit them");
+    }
+    if (update_references) {
+        ESP_LOGI(TAG, "References recorded in " UI_BENCH_REFERENCE_DIR);
+    }
+
+    ESP_LOGI(TAG, "UI render benchmark %s", failed ? "FAILED" : "passed");
+    return failed ? ESP_FAIL : ESP_OK;
+}
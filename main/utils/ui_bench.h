@@ -0,0 +1,53 @@
+#ifndef UI_BENCH_H
+#define UI_BENCH_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Output directory for PNG captures and the results CSV
+#ifndef UI_BENCH_OUTPUT_DIR
+#define UI_BENCH_OUTPUT_DIR "ui_bench_out"
+#endif
+
+// Directory holding reference PNGs and ui_bench_baseline.csv
+#ifndef UI_BENCH_REFERENCE_DIR
+#define UI_BENCH_REFERENCE_DIR "test/ui_reference"
+#endif
+
+// Allowed frame time regression over the baseline, in percent
+#ifndef UI_BENCH_TOLERANCE_PCT
+#define UI_BENCH_TOLERANCE_PCT 20
+#endif
+
+// Render passes per measurement (the median is reported)
+#ifndef UI_BENCH_ITERATIONS
+#define UI_BENCH_ITERATIONS 15
+#endif
+
+// Per-screen benchmark result
+typedef struct {
+    const char *screen;
+    int width;
+    int height;
+    uint32_t objects;        // LVGL objects in the screen tree
+    int64_t full_us;         // Median full-frame render time
+    int64_t incr_us;         // Median render time after a single value update
+    uint32_t incr_pixels;    // Pixels flushed by one incremental update
+    size_t mem_used;         // LVGL heap in use with the screen loaded
+    size_t mem_peak;         // LVGL heap high-water mark so far
+    uint32_t fb_crc;         // CRC-32 of the rendered framebuffer
+    bool regressed;          // Slower than baseline beyond tolerance
+    bool image_mismatch;     // Framebuffer differs from the reference PNG
+    bool no_reference;       // Reference PNG or baseline row missing
+} ui_bench_result_t;
+
+// Run the benchmark for every screen at 1024x600 and 800x480.
+// Returns ESP_FAIL if any screen regressed beyond UI_BENCH_TOLERANCE_PCT,
+// no longer matches its reference image, or has no reference image or
+// baseline row to check against. A REPTICONTROL_UI_BENCH_UPDATE build writes
+// the references into UI_BENCH_REFERENCE_DIR instead and always passes.
+esp_err_t ui_bench_run(void);
+
+#endif /* UI_BENCH_H */
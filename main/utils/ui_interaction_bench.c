@@ -0,0 +1,144 @@
+#include "ui_interaction_bench.h"
+#include "ui_interaction_scripts.h"
+#include "touch_driver.h"
+#include "touch_replay.h"
+#include "ui.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+
+static const char *TAG = "ui_interaction";
+
+// Longest script the sample buffers can hold
+#define MAX_SCRIPT_TICKS 1024
+
+static int64_t input_samples[MAX_SCRIPT_TICKS];
+static int64_t frame_samples[MAX_SCRIPT_TICKS];
+
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 95th percentile and maximum of n samples (sorts in place)
+static void summarize(int64_t *samples, uint32_t n, int64_t *p95, int64_t *max) {
+    if (n == 0) {
+        *p95 = 0;
+        *max = 0;
+        return;
+    }
+    qsort(samples, n, sizeof(samples[0]), cmp_i64);
+    *p95 = samples[(n * 95) / 100 < n ? (n * 95) / 100 : n - 1];
+    *max = samples[n - 1];
+}
+
+static bool over(int64_t value, uint32_t budget) {
+    return value * 100 > (int64_t)budget * (100 + UI_INTERACTION_TOLERANCE_PCT);
+}
+
+// Run the checks due by a script time; returns the index of the next one
+static size_t run_checks(const ui_interaction_script_t *s, size_t next, uint32_t now_ms,
+                         ui_interaction_result_t *res) {
+    while (next < s->check_count && s->checks[next].at_ms <= now_ms) {
+        const ui_interaction_check_t *c = &s->checks[next++];
+        if (!c->check()) {
+            ESP_LOGE(TAG, "%s at %" PRIu32 " ms: expected %s", s->name, c->at_ms, c->what);
+            res->failed_checks++;
+        }
+    }
+    return next;
+}
+
+static void run_script(const ui_interaction_script_t *s, ui_interaction_result_t *res) {
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_timer_t *read_timer = lv_indev_get_read_timer(touch_driver_get_indev());
+
+    memset(res, 0, sizeof(*res));
+    res->script = s->name;
+
+    int64_t start = esp_timer_get_time();
+    ui_switch_screen(s->screen);
+    lv_refr_now(disp);
+    res->open_us = esp_timer_get_time() - start;
+
+    if (s->setup) {
+        s->setup();
+        lv_refr_now(disp);
+    }
+    size_t next_check = 0;
+
+    // Input and rendering are driven explicitly so they can be timed apart
+    lv_timer_pause(read_timer);
+    lv_timer_pause(disp->refr_timer);
+
+    touch_replay_start(s->events, s->count);
+    touch_driver_set_source(touch_replay_get_source());
+
+    while (!touch_replay_is_done() && res->ticks < MAX_SCRIPT_TICKS) {
+        lv_tick_inc(UI_INTERACTION_TICK_MS);
+
+        // Animations and screen timers
+        lv_timer_handler();
+
+        start = esp_timer_get_time();
+        lv_indev_read_timer_cb(read_timer);
+        input_samples[res->ticks++] = esp_timer_get_time() - start;
+
+        if (disp->inv_p > 0) {
+            start = esp_timer_get_time();
+            lv_refr_now(disp);
+            frame_samples[res->frames++] = esp_timer_get_time() - start;
+        }
+
+        next_check = run_checks(s, next_check, res->ticks * UI_INTERACTION_TICK_MS, res);
+    }
+
+    // Checks past the last sample run on the final state
+    run_checks(s, next_check, UINT32_MAX, res);
+    res->transitions = touch_replay_get_transitions();
+
+    touch_driver_set_source(NULL);
+    touch_replay_stop();
+    lv_timer_resume(read_timer);
+    lv_timer_resume(disp->refr_timer);
+
+    summarize(input_samples, res->ticks, &res->input_p95_us, &res->input_max_us);
+    summarize(frame_samples, res->frames, &res->frame_p95_us, &res->frame_max_us);
+
+    res->over_budget = over(res->input_p95_us, s->input_budget_us) ||
+                       over(res->frame_p95_us, s->frame_budget_us);
+
+    // Close dialogs the script left open and go back to the dashboard
+    lv_obj_clean(lv_layer_top());
+    ui_switch_screen(SCREEN_DASHBOARD);
+    lv_refr_now(disp);
+}
+
+esp_err_t ui_interaction_bench_run(void) {
+    ESP_LOGI(TAG, "Starting UI interaction benchmark");
+
+    bool failed = false;
+
+    for (size_t i = 0; i < ui_interaction_script_count; i++) {
+        ui_interaction_result_t res;
+        run_script(&ui_interaction_scripts[i], &res);
+
+        ESP_LOGI(TAG, "%-20s open=%6lld us ticks=%-4u frames=%-4u touches=%-3u "
+                 "input p95=%5lld max=%5lld us frame p95=%6lld max=%6lld us%s%s",
+                 res.script, (long long)res.open_us,
+                 (unsigned)res.ticks, (unsigned)res.frames, (unsigned)res.transitions,
+                 (long long)res.input_p95_us, (long long)res.input_max_us,
+                 (long long)res.frame_p95_us, (long long)res.frame_max_us,
+                 res.over_budget ? " OVER BUDGET" : "",
+                 res.failed_checks ? " CHECK FAILED" : "");
+
+        failed |= res.over_budget || res.failed_checks > 0;
+    }
+
+    ESP_LOGI(TAG, "UI interaction benchmark %s", failed ? "FAILED" : "passed");
+    return failed ? ESP_FAIL : ESP_OK;
+}
@@ -0,0 +1,39 @@
+#ifndef UI_INTERACTION_BENCH_H
+#define UI_INTERACTION_BENCH_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Simulated time between input polls / frames
+#ifndef UI_INTERACTION_TICK_MS
+#define UI_INTERACTION_TICK_MS 10
+#endif
+
+// Allowed overshoot of a script's budgets, in percent
+#ifndef UI_INTERACTION_TOLERANCE_PCT
+#define UI_INTERACTION_TOLERANCE_PCT 20
+#endif
+
+// Per-script interaction result
+typedef struct {
+    const char *script;
+    int64_t open_us;          // ui_switch_screen() to the script's screen
+    uint32_t ticks;           // Input polls during the script
+    uint32_t frames;          // Ticks that produced a redraw
+    uint32_t transitions;     // Press/release transitions delivered
+    int64_t input_p95_us;     // Input read + event handling per tick
+    int64_t input_max_us;
+    int64_t frame_p95_us;     // Render per frame
+    int64_t frame_max_us;
+    uint32_t failed_checks;   // State checks that did not hold
+    bool over_budget;
+} ui_interaction_result_t;
+
+// Replay every script through the LVGL input device of touch_init() and
+// measure event handling and frame times. Expects LVGL, the display, the
+// touch driver and the UI to be initialized. Returns ESP_FAIL if a script
+// exceeds its budget or a check of the state it leaves behind fails.
+esp_err_t ui_interaction_bench_run(void);
+
+#endif /* UI_INTERACTION_BENCH_H */
@@ -0,0 +1,121 @@
+#include "ui_interaction_scripts.h"
+#include "core/schedule_manager.h"
+#include "screens/ui_climate.h"
+#include "screens/ui_logs.h"
+#include "lvgl.h"
+
+// Positions are per mille of the screen (see touch_event_t) and follow the
+// layouts in ui/screens at both supported resolutions.
+
+// State a script's later checks compare against
+static float slider_start;
+static float slider_dragged;
+static int schedule_start;
+
+// A message box is open on the top layer
+static bool dialog_open(void) {
+    return lv_obj_get_child_cnt(lv_layer_top()) > 0;
+}
+
+static bool dialog_closed(void) {
+    return !dialog_open();
+}
+
+// Target temperature shown by the climate slider
+static float temp_slider_value(void) {
+    float temp, humidity, light;
+    bool heating, cooling, humidifier, lighting;
+    ui_climate_get_targets(&temp, &humidity, &light, &heating, &cooling, &humidifier, &lighting);
+    return temp;
+}
+
+// Climate: drag the target temperature slider across its range and back
+static const touch_event_t drag_temp_slider[] = {
+    {0,    200, 190, true},
+    {600,  800, 190, true},
+    {1200, 350, 190, true},
+    {1300, 350, 190, false},
+};
+
+static void drag_temp_slider_setup(void) {
+    slider_start = temp_slider_value();
+}
+
+static bool slider_raised(void) {
+    slider_dragged = temp_slider_value();
+    return slider_dragged > slider_start;
+}
+
+static bool slider_lowered(void) {
+    return temp_slider_value() < slider_dragged;
+}
+
+static const ui_interaction_check_t drag_temp_slider_checks[] = {
+    {650,  "dragging right raises the target", slider_raised},
+    {1300, "dragging back lowers it again", slider_lowered},
+};
+
+// Logs: open the screen, open the filter dialog and pick "Alerts"
+static const touch_event_t filter_alerts[] = {
+    {300,  905, 45,  true},
+    {400,  905, 45,  false},
+    {900,  470, 560, true},
+    {1000, 470, 560, false},
+    {2000, 470, 560, false},
+};
+
+// One row of each kind, so the filter has something to hide
+static void filter_alerts_setup(void) {
+    ui_logs_add_entry("Scripted info", false);
+    ui_logs_add_entry("Scripted alert", true);
+}
+
+static bool only_alerts_shown(void) {
+    int alerts, info;
+    ui_logs_get_shown(&alerts, &info);
+    return alerts > 0 && info == 0;
+}
+
+static const ui_interaction_check_t filter_alerts_checks[] = {
+    {500,  "the filter dialog opens", dialog_open},
+    {1100, "picking Alerts closes it", dialog_closed},
+    {2000, "only alert rows are shown", only_alerts_shown},
+};
+
+// Schedule: pick a date, add an event, dismiss the confirmation
+static const touch_event_t add_schedule_event[] = {
+    {0,    250, 350, true},
+    {100,  250, 350, false},
+    {500,  180, 900, true},
+    {600,  180, 900, false},
+    {1100, 500, 560, true},
+    {1200, 500, 560, false},
+    {3000, 500, 560, false},
+};
+
+static void add_schedule_event_setup(void) {
+    schedule_start = schedule_manager_get_count();
+}
+
+static bool schedule_event_added(void) {
+    return schedule_manager_get_count() == schedule_start + 1;
+}
+
+static const ui_interaction_check_t add_schedule_event_checks[] = {
+    {700,  "the add button stores one entry", schedule_event_added},
+    {700,  "a confirmation is shown", dialog_open},
+    {3000, "the confirmation closes by itself", dialog_closed},
+};
+
+#define COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+const ui_interaction_script_t ui_interaction_scripts[] = {
+    {"drag_temp_slider", SCREEN_CLIMATE, drag_temp_slider, COUNT_OF(drag_temp_slider), 2000, 15000,
+     drag_temp_slider_setup, drag_temp_slider_checks, COUNT_OF(drag_temp_slider_checks)},
+    {"filter_alerts", SCREEN_LOGS, filter_alerts, COUNT_OF(filter_alerts), 5000, 25000,
+     filter_alerts_setup, filter_alerts_checks, COUNT_OF(filter_alerts_checks)},
+    {"add_schedule_event", SCREEN_SCHEDULE, add_schedule_event, COUNT_OF(add_schedule_event), 5000, 25000,
+     add_schedule_event_setup, add_schedule_event_checks, COUNT_OF(add_schedule_event_checks)},
+};
+
+const size_t ui_interaction_script_count = COUNT_OF(ui_interaction_scripts);
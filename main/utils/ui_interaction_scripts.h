@@ -0,0 +1,34 @@
+#ifndef UI_INTERACTION_SCRIPTS_H
+#define UI_INTERACTION_SCRIPTS_H
+
+#include "touch_replay.h"
+#include "ui.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A check of widget or controller state once the script reaches a time
+typedef struct {
+    uint32_t at_ms;               // Script time, after that tick's input
+    const char *what;             // Expected outcome, logged when it fails
+    bool (*check)(void);
+} ui_interaction_check_t;
+
+// A scripted interaction, the state it must leave behind and the per-tick
+// budgets it must stay within
+typedef struct {
+    const char *name;
+    screen_t screen;              // Screen opened before the script starts
+    const touch_event_t *events;
+    size_t count;
+    uint32_t input_budget_us;     // 95th percentile input + event handling per tick
+    uint32_t frame_budget_us;     // 95th percentile render time per frame
+    void (*setup)(void);          // Seeds state once the screen is open, or NULL
+    const ui_interaction_check_t *checks;  // In time order
+    size_t check_count;
+} ui_interaction_script_t;
+
+extern const ui_interaction_script_t ui_interaction_scripts[];
+extern const size_t ui_interaction_script_count;
+
+#endif /* UI_INTERACTION_SCRIPTS_H */
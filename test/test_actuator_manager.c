@@ -0,0 +1,134 @@
+#include "unity.h"
+#include "actuator_manager.h"
+#include "actuator_driver.h"
+#include "climate_controller.h"
+#include "esp_timer.h"
+
+#define MS(ms) ((int64_t)(ms) * 1000)
+
+// Zone 0 heater and humidifier relays, zone 1 lamp dimmer
+static const actuator_channel_t test_channels[] = {
+    { 0, CLIMATE_ACTUATOR_HEATING, ACTUATOR_KIND_RELAY, 0, 1000, 2000 },
+    { 0, CLIMATE_ACTUATOR_HUMIDIFIER, ACTUATOR_KIND_RELAY, 2, 0, 0 },
+    { 1, CLIMATE_ACTUATOR_LIGHTING, ACTUATOR_KIND_PWM, 38, 0, 0 },
+};
+
+void setUp(void) {
+    actuator_manager_set_channels(test_channels, sizeof(test_channels) / sizeof(test_channels[0]));
+}
+
+void tearDown(void) {
+    actuator_manager_cut(0, 0);
+}
+
+void test_relay_min_on_off(void) {
+    actuator_manager_set(0, CLIMATE_ACTUATOR_HEATING, 1.0f);
+    actuator_manager_commit(MS(0));
+    TEST_ASSERT_TRUE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+
+    // Held on for its minimum on time
+    actuator_manager_set(0, CLIMATE_ACTUATOR_HEATING, 0.0f);
+    actuator_manager_commit(MS(500));
+    TEST_ASSERT_TRUE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+    actuator_manager_commit(MS(1000));
+    TEST_ASSERT_FALSE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+
+    // Then held off for its minimum off time
+    actuator_manager_set(0, CLIMATE_ACTUATOR_HEATING, 1.0f);
+    actuator_manager_commit(MS(2500));
+    TEST_ASSERT_FALSE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+    actuator_manager_commit(MS(3000));
+    TEST_ASSERT_TRUE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+
+    actuator_stats_t stats;
+    actuator_manager_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, actuator_manager_get_cycle_count(0, CLIMATE_ACTUATOR_HEATING));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.held);
+}
+
+void test_cut_overrides_min_on(void) {
+    actuator_manager_set(0, CLIMATE_ACTUATOR_HEATING, 1.0f);
+    actuator_manager_commit(esp_timer_get_time());
+    TEST_ASSERT_TRUE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+
+    // Off at once, and stays off while cut
+    actuator_manager_cut(0, 1 << CLIMATE_ACTUATOR_HEATING);
+    TEST_ASSERT_FALSE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+    actuator_manager_commit(esp_timer_get_time() + MS(5000));
+    TEST_ASSERT_FALSE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+
+    actuator_stats_t stats;
+    actuator_manager_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.forced_off);
+
+    // Released: back on after the minimum off time
+    actuator_manager_cut(0, 0);
+    actuator_manager_commit(esp_timer_get_time() + MS(5000));
+    TEST_ASSERT_TRUE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_HEATING));
+}
+
+void test_pwm_duty(void) {
+    actuator_manager_set(1, CLIMATE_ACTUATOR_LIGHTING, 0.5f);
+    actuator_manager_commit(MS(0));
+    TEST_ASSERT_UINT32_WITHIN(1, ACTUATOR_PWM_MAX / 2, actuator_manager_get_duty(1, CLIMATE_ACTUATOR_LIGHTING));
+    TEST_ASSERT_TRUE(actuator_manager_is_on(1, CLIMATE_ACTUATOR_LIGHTING));
+
+    // No minimum times on dimmers
+    actuator_manager_set(1, CLIMATE_ACTUATOR_LIGHTING, 0.0f);
+    actuator_manager_commit(MS(10));
+    TEST_ASSERT_EQUAL_UINT32(0, actuator_manager_get_duty(1, CLIMATE_ACTUATOR_LIGHTING));
+    TEST_ASSERT_EQUAL_UINT32(1, actuator_manager_get_cycle_count(1, CLIMATE_ACTUATOR_LIGHTING));
+}
+
+void test_unmapped_outputs_ignored(void) {
+    actuator_manager_set(5, CLIMATE_ACTUATOR_HEATING, 1.0f);
+    actuator_manager_set(0, CLIMATE_ACTUATOR_LIGHTING, 1.0f);
+    actuator_manager_commit(MS(0));
+    TEST_ASSERT_FALSE(actuator_manager_is_on(5, CLIMATE_ACTUATOR_HEATING));
+    TEST_ASSERT_FALSE(actuator_manager_is_on(0, CLIMATE_ACTUATOR_LIGHTING));
+
+    actuator_stats_t stats;
+    actuator_manager_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.writes);
+}
+
+#ifdef REPTICONTROL_HEADLESS
+void test_one_write_per_tick(void) {
+    // Two relays and a dimmer change together: one write
+    actuator_manager_set(0, CLIMATE_ACTUATOR_HEATING, 1.0f);
+    actuator_manager_set(0, CLIMATE_ACTUATOR_HUMIDIFIER, 1.0f);
+    actuator_manager_set(1, CLIMATE_ACTUATOR_LIGHTING, 1.0f);
+    actuator_manager_commit(MS(0));
+    TEST_ASSERT_EQUAL_UINT32(1, actuator_mock_get_write_count());
+
+    const actuator_mock_event_t *event = actuator_mock_get_event(0);
+    TEST_ASSERT_EQUAL_UINT8(0x05, event->relay_bits);
+    TEST_ASSERT_EQUAL_UINT32(ACTUATOR_PWM_MAX, event->duty[2]);
+
+    // Nothing changed: nothing written
+    actuator_manager_commit(MS(500));
+    TEST_ASSERT_EQUAL_UINT32(1, actuator_mock_get_write_count());
+
+    // The held heater shows up on the timeline at its minimum on time
+    actuator_manager_set(0, CLIMATE_ACTUATOR_HEATING, 0.0f);
+    actuator_manager_set(0, CLIMATE_ACTUATOR_HUMIDIFIER, 0.0f);
+    actuator_manager_commit(MS(600));
+    actuator_manager_commit(MS(1000));
+    TEST_ASSERT_EQUAL_INT(3, actuator_mock_get_event_count());
+    TEST_ASSERT_EQUAL_UINT8(0x01, actuator_mock_get_event(1)->relay_bits);
+    TEST_ASSERT_EQUAL_UINT8(0x00, actuator_mock_get_event(2)->relay_bits);
+    TEST_ASSERT_EQUAL(MS(1000), actuator_mock_get_event(2)->time_us);
+}
+#endif
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_relay_min_on_off);
+    RUN_TEST(test_cut_overrides_min_on);
+    RUN_TEST(test_pwm_duty);
+    RUN_TEST(test_unmapped_outputs_ignored);
+#ifdef REPTICONTROL_HEADLESS
+    RUN_TEST(test_one_write_per_tick);
+#endif
+    UNITY_END();
+}
@@ -0,0 +1,196 @@
+#include "unity.h"
+#include "anomaly_detector.h"
+#include "climate_controller.h"
+#include <math.h>
+
+#define SECOND 1000LL
+#define MINUTE (60 * SECOND)
+
+static int64_t now_ms;
+static int tick;
+
+// A frame of a healthy zone: readings moving a little every second
+static void make_frame(sensor_zone_t *frame, float temp, float humidity) {
+    float noise = 0.05f * sinf(tick * 1.3f);
+
+    frame->value[SENSOR_VALUE_TEMPERATURE] = temp + noise;
+    frame->value[SENSOR_VALUE_HUMIDITY] = humidity - noise;
+    frame->value[SENSOR_VALUE_LIGHT] = NAN;
+    frame->probes[PROBE_BASKING] = 32.0f + noise;
+    frame->probes[PROBE_COOL_SIDE] = 26.0f - noise;
+    frame->probes[PROBE_SUBSTRATE] = 28.0f + 0.5f * noise;
+    frame->probes[PROBE_AMBIENT] = 22.0f;
+}
+
+// Check a frame and move on a second
+static void feed(sensor_zone_t *frame, bool heating_on) {
+    anomaly_detector_update(0, frame, heating_on, now_ms);
+    now_ms += SECOND;
+    tick++;
+}
+
+// Feed healthy frames for a while
+static void run_healthy(int64_t duration_ms) {
+    int64_t end_ms = now_ms + duration_ms;
+    sensor_zone_t frame;
+
+    while (now_ms < end_ms) {
+        make_frame(&frame, 25.0f, 60.0f);
+        feed(&frame, false);
+    }
+}
+
+void setUp(void) {
+    climate_controller_init();
+    anomaly_detector_init();
+    now_ms = 0;
+    tick = 0;
+}
+
+void tearDown(void) {
+}
+
+void test_healthy_zone_is_quiet(void) {
+    anomaly_stats_t stats;
+
+    run_healthy(2 * ANOMALY_FLATLINE_MS);
+    for (int c = 0; c < ANOMALY_CH_COUNT; c++) {
+        TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, c));
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_hold(0));
+
+    anomaly_detector_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2 * ANOMALY_FLATLINE_MS / SECOND, stats.updates);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.raised);
+}
+
+void test_flatline_holds_and_clears(void) {
+    sensor_zone_t frame;
+    int64_t end_ms = 2 * ANOMALY_FLATLINE_MS;
+
+    // A humidity reading frozen at one value
+    while (now_ms < end_ms) {
+        make_frame(&frame, 25.0f, 60.0f);
+        frame.value[SENSOR_VALUE_HUMIDITY] = 60.0f;
+        feed(&frame, false);
+    }
+    TEST_ASSERT_EQUAL_UINT8(ANOMALY_FLATLINE, anomaly_detector_get_flags(0, ANOMALY_CH_HUMIDITY));
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, ANOMALY_CH_TEMPERATURE));
+    TEST_ASSERT_EQUAL_UINT8(ANOMALY_HOLD_HUMIDITY, anomaly_detector_get_hold(0));
+
+    // It clears as soon as the reading moves again
+    run_healthy(10 * SECOND);
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, ANOMALY_CH_HUMIDITY));
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_hold(0));
+}
+
+void test_stuck_probe_is_masked(void) {
+    sensor_zone_t frame;
+    int64_t end_ms = 2 * ANOMALY_FLATLINE_MS;
+
+    while (now_ms < end_ms) {
+        make_frame(&frame, 25.0f, 60.0f);
+        frame.probes[PROBE_SUBSTRATE] = 85.0f;
+        feed(&frame, false);
+    }
+    TEST_ASSERT_TRUE(anomaly_detector_get_flags(0, ANOMALY_CH_SUBSTRATE) & ANOMALY_FLATLINE);
+    TEST_ASSERT_TRUE(isnan(frame.probes[PROBE_SUBSTRATE]));
+    TEST_ASSERT_FALSE(isnan(frame.probes[PROBE_BASKING]));
+
+    // A probe alone does not hold the outputs; the fusion drops it
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_hold(0));
+}
+
+void test_rate_violation_holds_briefly(void) {
+    sensor_zone_t frame;
+
+    // A 10 °C step from one second to the next
+    run_healthy(MINUTE);
+    for (int64_t t = 0; t < ANOMALY_RATE_HOLD_MS; t += SECOND) {
+        make_frame(&frame, 35.0f, 60.0f);
+        feed(&frame, false);
+        TEST_ASSERT_EQUAL_UINT8(ANOMALY_RATE, anomaly_detector_get_flags(0, ANOMALY_CH_TEMPERATURE));
+        TEST_ASSERT_EQUAL_UINT8(ANOMALY_HOLD_TEMPERATURE, anomaly_detector_get_hold(0));
+    }
+
+    // Steady at the new value, the flag lapses after the hold
+    make_frame(&frame, 35.0f, 60.0f);
+    feed(&frame, false);
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, ANOMALY_CH_TEMPERATURE));
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_hold(0));
+}
+
+void test_drift_flags_only_the_drifting_probe(void) {
+    sensor_zone_t frame;
+
+    // The offsets are learned first
+    run_healthy(ANOMALY_DRIFT_WARMUP_MIN * MINUTE + MINUTE);
+
+    // The basking probe wanders off by 0.1 °C a minute
+    for (int64_t t = 0; t < 40 * MINUTE; t += SECOND) {
+        make_frame(&frame, 25.0f, 60.0f);
+        frame.probes[PROBE_BASKING] += 0.1f * t / MINUTE;
+        feed(&frame, false);
+    }
+    TEST_ASSERT_EQUAL_UINT8(ANOMALY_DRIFT, anomaly_detector_get_flags(0, ANOMALY_CH_BASKING));
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, ANOMALY_CH_COOL_SIDE));
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, ANOMALY_CH_SUBSTRATE));
+    TEST_ASSERT_TRUE(isnan(frame.probes[PROBE_BASKING]));
+    TEST_ASSERT_FALSE(isnan(frame.probes[PROBE_COOL_SIDE]));
+
+    // Once it reads true again it comes back, and the others never flag
+    run_healthy(2 * ANOMALY_DRIFT_LIMIT * MINUTE);
+    for (int c = ANOMALY_CH_BASKING; c <= ANOMALY_CH_SUBSTRATE; c++) {
+        TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, c));
+    }
+}
+
+void test_heater_without_response(void) {
+    sensor_zone_t frame;
+
+    // Heater on for a whole window well below target, and the basking spot
+    // does not warm up
+    climate_controller_zone_set_temp_target(0, 35.0f);
+    for (int64_t t = 0; t <= ANOMALY_HEAT_WINDOW_MS; t += SECOND) {
+        make_frame(&frame, 25.0f, 60.0f);
+        feed(&frame, true);
+    }
+    TEST_ASSERT_EQUAL_UINT8(ANOMALY_NO_RESPONSE, anomaly_detector_get_flags(0, ANOMALY_CH_TEMPERATURE));
+
+    // Reported only; the heater keeps its control
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_hold(0));
+
+    // It clears once the rise shows
+    for (int64_t t = 0; t <= ANOMALY_HEAT_WINDOW_MS; t += SECOND) {
+        make_frame(&frame, 25.0f, 60.0f);
+        frame.probes[PROBE_BASKING] += 0.1f * t / MINUTE;
+        feed(&frame, t % (5 * SECOND) == 0);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, ANOMALY_CH_TEMPERATURE));
+}
+
+void test_heater_holding_target_is_healthy(void) {
+    sensor_zone_t frame;
+
+    // A cold night: the heater runs at 90 % just to hold the target
+    climate_controller_zone_set_temp_target(0, 30.0f);
+    for (int64_t t = 0; t <= 2 * ANOMALY_HEAT_WINDOW_MS; t += SECOND) {
+        make_frame(&frame, 30.0f, 60.0f);
+        frame.probes[PROBE_BASKING] = frame.value[SENSOR_VALUE_TEMPERATURE];
+        feed(&frame, t % (10 * SECOND) != 0);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_flags(0, ANOMALY_CH_TEMPERATURE));
+    TEST_ASSERT_EQUAL_UINT8(0, anomaly_detector_get_hold(0));
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_healthy_zone_is_quiet);
+    RUN_TEST(test_flatline_holds_and_clears);
+    RUN_TEST(test_stuck_probe_is_masked);
+    RUN_TEST(test_rate_violation_holds_briefly);
+    RUN_TEST(test_drift_flags_only_the_drifting_probe);
+    RUN_TEST(test_heater_without_response);
+    RUN_TEST(test_heater_holding_target_is_healthy);
+    UNITY_END();
+}
@@ -1,12 +1,28 @@
 #include "unity.h"
 #include "climate_controller.h"
+#include "esp_timer.h"
 #include "data_simulator.h"
+#include "sensor_hal.h"
+#include "sensor_driver.h"
+#include "psychrometrics.h"
+#include <math.h>
 #include <stdio.h>
 
+// Virtual time of the sensor polls
+static int64_t sample_us;
+
+// Take a fresh sample of every active zone
+static void sample(void) {
+    sample_us += CLIMATE_CONTROL_PERIOD_MS * 1000LL;
+    sensor_hal_poll(sample_us);
+}
+
 void setUp(void) {
     // Initialize before each test
     climate_controller_init();
     data_simulator_init();
+    sensor_hal_init();
+    sample();
 }
 
 void tearDown(void) {
@@ -53,36 +69,306 @@ void test_light_control(void) {
 }
 
 void test_system_toggles(void) {
-    // Test heating system toggle
+    // Enabling a system lets the controller decide; with the reading far
+    // from target it runs right away. Disabling turns it off at once.
+    climate_controller_set_temp_target(35.0f);
+    climate_controller_set_heating(false);
+    TEST_ASSERT_FALSE(climate_controller_is_heating_on());
     climate_controller_set_heating(true);
     TEST_ASSERT_TRUE(climate_controller_is_heating_on());
     climate_controller_set_heating(false);
     TEST_ASSERT_FALSE(climate_controller_is_heating_on());
 
     // Test cooling system toggle
+    climate_controller_set_temp_target(15.0f);
     climate_controller_set_cooling(true);
     TEST_ASSERT_TRUE(climate_controller_is_cooling_on());
     climate_controller_set_cooling(false);
     TEST_ASSERT_FALSE(climate_controller_is_cooling_on());
 
     // Test humidifier toggle
+    climate_controller_set_humidity_target(90.0f);
     climate_controller_set_humidifier(true);
     TEST_ASSERT_TRUE(climate_controller_is_humidifier_on());
     climate_controller_set_humidifier(false);
     TEST_ASSERT_FALSE(climate_controller_is_humidifier_on());
 
     // Test lighting toggle
+    climate_controller_set_light_target(100.0f);
     climate_controller_set_lighting(true);
     TEST_ASSERT_TRUE(climate_controller_is_lighting_on());
     climate_controller_set_lighting(false);
     TEST_ASSERT_FALSE(climate_controller_is_lighting_on());
 }
 
+void test_enable_within_band_stays_off(void) {
+    // At target, switching a system on no longer forces its output on
+    climate_controller_set_heating(false);
+    climate_controller_set_heating(true);
+    TEST_ASSERT_FALSE(climate_controller_is_heating_on());
+
+    climate_controller_update();
+    TEST_ASSERT_FALSE(climate_controller_is_heating_on());
+    TEST_ASSERT_FALSE(climate_controller_is_cooling_on());
+}
+
+void test_zones_are_independent(void) {
+    climate_controller_set_zone_count(4);
+    TEST_ASSERT_EQUAL_INT(4, climate_controller_get_zone_count());
+
+    climate_controller_zone_set_temp_target(2, 30.0f);
+    climate_controller_zone_set_heating(3, false);
+
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, climate_controller_zone_get_temp_target(2));
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, climate_controller_zone_get_temp_target(1));
+    TEST_ASSERT_FALSE(climate_controller_zone_is_on(3, CLIMATE_ACTUATOR_HEATING));
+
+    // The single-zone API acts on zone 0
+    climate_controller_set_temp_target(20.0f);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, climate_controller_zone_get_temp_target(0));
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, climate_controller_zone_get_temp_target(2));
+
+    climate_controller_set_zone_count(1);
+}
+
+void test_zone_count_bounds(void) {
+    climate_controller_set_zone_count(0);
+    TEST_ASSERT_EQUAL_INT(1, climate_controller_get_zone_count());
+
+    climate_controller_set_zone_count(CLIMATE_MAX_ZONES + 1);
+    TEST_ASSERT_EQUAL_INT(CLIMATE_MAX_ZONES, climate_controller_get_zone_count());
+
+    // Zones beyond the active count are rejected
+    climate_controller_set_zone_count(2);
+    climate_controller_zone_set_temp_target(5, 30.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, climate_controller_zone_get_temp_target(5));
+
+    climate_controller_set_zone_count(1);
+}
+
+void test_update_all_zones(void) {
+    climate_controller_set_zone_count(CLIMATE_MAX_ZONES);
+
+    for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+        climate_controller_zone_set_temp_target(z, 35.0f);
+    }
+
+    // Every zone starts well below target and must call for heat
+    sample();
+    for (int i = 0; i < 4; i++) {
+        climate_controller_update();
+    }
+    for (int z = 0; z < CLIMATE_MAX_ZONES; z++) {
+        TEST_ASSERT_TRUE(climate_controller_zone_is_on(z, CLIMATE_ACTUATOR_HEATING));
+    }
+
+    climate_controller_set_zone_count(1);
+}
+
+void test_energy_accounting(void) {
+    energy_summary_t energy;
+
+    climate_controller_zone_set_watts(0, CLIMATE_ACTUATOR_HEATING, 200.0f);
+    TEST_ASSERT_EQUAL_FLOAT(200.0f, climate_controller_zone_get_watts(0, CLIMATE_ACTUATOR_HEATING));
+
+    // Ten seconds of heat well below target
+    climate_controller_set_temp_target(35.0f);
+    for (int i = 0; i < 10000 / CLIMATE_CONTROL_PERIOD_MS; i++) {
+        climate_controller_update();
+    }
+
+    climate_controller_zone_get_energy(0, CLIMATE_ACTUATOR_HEATING, &energy);
+    TEST_ASSERT_EQUAL_UINT32(10, energy.day_on_s);
+    TEST_ASSERT_EQUAL_UINT32(1, energy.day_cycles);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 200.0f * 10 / 3600, energy.day_wh);
+
+    climate_controller_zone_get_energy(0, CLIMATE_ACTUATOR_COOLING, &energy);
+    TEST_ASSERT_EQUAL_UINT32(0, energy.day_on_s);
+
+    climate_controller_zone_set_watts(0, CLIMATE_ACTUATOR_HEATING, CLIMATE_HEATING_DEFAULT_WATTS);
+}
+
+void test_missing_reading_holds_heat_off(void) {
+    climate_controller_set_temp_target(35.0f);
+    climate_controller_update();
+    TEST_ASSERT_TRUE(climate_controller_is_heating_on());
+
+    // With no sensor left the reading goes NaN and heat is not left running
+    sensor_hal_set_sensors(NULL, 0);
+    climate_controller_update();
+    TEST_ASSERT_FALSE(climate_controller_is_heating_on());
+    TEST_ASSERT_FALSE(climate_controller_is_humidifier_on());
+
+    // It picks up again with the next sample
+    sensor_hal_init();
+    sample();
+    climate_controller_update();
+    TEST_ASSERT_TRUE(climate_controller_is_heating_on());
+}
+
+// Read the climate from a fake SHT4x until the filters have settled on it
+static void read_sht(float temperature, float humidity) {
+    sensor_mock_set_i2c(0, 0x44, temperature, humidity, 0.0f);
+    for (int i = 0; i < 10; i++) {
+        sample();
+        sensor_hal_poll(sample_us + 9000);
+    }
+    climate_controller_update();
+}
+
+void test_vpd_target_and_condensation(void) {
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_SHT4X, 0, 0x44, 0, 0, SENSOR_PROBE_NONE, 1000, 1 },
+    };
+    climate_metrics_t metrics;
+
+    sensor_mock_reset();
+    sensor_mock_add_i2c(0, SENSOR_KIND_SHT4X, 0x44);
+    sensor_hal_set_sensors(table, 1);
+
+    read_sht(28.0f, 60.0f);
+    climate_controller_zone_get_metrics(0, &metrics);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, psychro_saturation_kpa(28.0f) * 0.4f, metrics.vpd_kpa);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 19.5f, metrics.dew_point_c);
+    TEST_ASSERT_EQUAL_FLOAT(climate_controller_get_humidity_target(), metrics.humidity_setpoint);
+    TEST_ASSERT_FALSE(metrics.condensation_risk);
+
+    // A VPD target moves the humidifier's setpoint with the temperature
+    climate_controller_zone_set_vpd_target(0, 1.5f);
+    climate_controller_update();
+    climate_controller_zone_get_metrics(0, &metrics);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, psychro_humidity_for_vpd(28.0f, 1.5f), metrics.humidity_setpoint);
+    read_sht(32.0f, 60.0f);
+    climate_controller_zone_get_metrics(0, &metrics);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, psychro_humidity_for_vpd(32.0f, 1.5f), metrics.humidity_setpoint);
+    climate_controller_zone_set_vpd_target(0, 0.0f);
+
+    // Near saturation the dew point meets the air temperature
+    read_sht(25.0f, 97.0f);
+    climate_controller_zone_get_metrics(0, &metrics);
+    TEST_ASSERT_TRUE(metrics.condensation_risk);
+    read_sht(25.0f, 70.0f);
+    climate_controller_zone_get_metrics(0, &metrics);
+    TEST_ASSERT_FALSE(metrics.condensation_risk);
+}
+
+void test_missing_humidity_ends_mist_pulse(void) {
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_SHT4X, 0, 0x44, 0, 0, SENSOR_PROBE_NONE, 1000, 1 },
+    };
+    mist_pulse_t mist;
+
+    sensor_mock_reset();
+    sensor_mock_add_i2c(0, SENSOR_KIND_SHT4X, 0x44);
+    sensor_hal_set_sensors(table, 1);
+    climate_controller_zone_set_mode(0, CLIMATE_ACTUATOR_HUMIDIFIER, CLIMATE_MODE_PULSE);
+    climate_controller_set_humidity_target(80.0f);
+
+    read_sht(25.0f, 40.0f);
+    climate_controller_zone_get_mist(0, &mist);
+    TEST_ASSERT_EQUAL(MIST_PULSING, mist.state);
+
+    // The reading goes missing mid-pulse for a minute: the pulse ends at
+    // once and only its time on is booked
+    sensor_hal_set_sensors(NULL, 0);
+    for (int i = 0; i < 60000 / CLIMATE_CONTROL_PERIOD_MS; i++) {
+        climate_controller_update();
+        TEST_ASSERT_FALSE(climate_controller_is_humidifier_on());
+    }
+    climate_controller_zone_get_mist(0, &mist);
+    TEST_ASSERT_TRUE(mist.state != MIST_PULSING);
+    TEST_ASSERT_TRUE(mist.used_ml <= 2 * CLIMATE_CONTROL_PERIOD_MS / 1000.0f * MIST_FLOW_ML_S);
+
+    sensor_hal_set_sensors(table, 1);
+    read_sht(25.0f, 40.0f);
+    climate_controller_zone_get_mist(0, &mist);
+    TEST_ASSERT_TRUE(mist.used_ml <= 2 * CLIMATE_CONTROL_PERIOD_MS / 1000.0f * MIST_FLOW_ML_S);
+    climate_controller_zone_set_mode(0, CLIMATE_ACTUATOR_HUMIDIFIER, CLIMATE_MODE_HYSTERESIS);
+}
+
+void test_stats_follow_readings(void) {
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_SHT4X, 0, 0x44, 0, 0, SENSOR_PROBE_NONE, 1000, 1 },
+    };
+    stream_summary_t summary;
+
+    sensor_mock_reset();
+    sensor_mock_add_i2c(0, SENSOR_KIND_SHT4X, 0x44);
+    sensor_hal_set_sensors(table, 1);
+
+    read_sht(24.0f, 60.0f);
+    read_sht(28.0f, 60.0f);
+    read_sht(26.0f, 60.0f);
+
+    // One sample per update, in every window
+    TEST_ASSERT_TRUE(climate_controller_zone_get_stats(0, CLIMATE_STAT_TEMPERATURE, STREAM_WINDOW_WEEK, false,
+                                                       &summary));
+    TEST_ASSERT_EQUAL_UINT32(3, summary.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 24.0f, summary.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 28.0f, summary.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 26.0f, summary.mean);
+    TEST_ASSERT_TRUE(summary.max_ms > summary.min_ms);
+
+    // No hour has closed yet
+    climate_controller_zone_get_stats(0, CLIMATE_STAT_HUMIDITY, STREAM_WINDOW_HOUR, true, &summary);
+    TEST_ASSERT_EQUAL_UINT32(0, summary.count);
+
+    // Every zone in use keeps them, starting empty; zones out of use do not
+    TEST_ASSERT_FALSE(climate_controller_zone_get_stats(CLIMATE_MAX_ZONES - 1, CLIMATE_STAT_TEMPERATURE,
+                                                        STREAM_WINDOW_DAY, false, &summary));
+    climate_controller_set_zone_count(CLIMATE_MAX_ZONES);
+    TEST_ASSERT_TRUE(climate_controller_zone_get_stats(CLIMATE_MAX_ZONES - 1, CLIMATE_STAT_TEMPERATURE,
+                                                       STREAM_WINDOW_DAY, false, &summary));
+    TEST_ASSERT_EQUAL_UINT32(0, summary.count);
+    climate_controller_set_zone_count(1);
+}
+
+void test_sample_timing(void) {
+    climate_timing_t timing;
+
+    climate_controller_init();
+
+    // An update with no sample is a fallback tick
+    climate_controller_update();
+    climate_controller_get_timing(&timing);
+    TEST_ASSERT_EQUAL_UINT32(0, timing.samples);
+    TEST_ASSERT_EQUAL_UINT32(1, timing.fallback_ticks);
+
+    // A sample is acted on once, with its latency measured
+    climate_controller_sample_ready(esp_timer_get_time() - 3000);
+    climate_controller_update();
+    climate_controller_update();
+    climate_controller_get_timing(&timing);
+    TEST_ASSERT_EQUAL_UINT32(1, timing.samples);
+    TEST_ASSERT_EQUAL_UINT32(2, timing.fallback_ticks);
+    TEST_ASSERT_TRUE(timing.latency_last_us >= 3000);
+    TEST_ASSERT_EQUAL_UINT32(timing.latency_last_us, timing.latency_max_us);
+
+    // A sample replaced before the update ran is counted as missed
+    climate_controller_sample_ready(esp_timer_get_time());
+    climate_controller_sample_ready(esp_timer_get_time());
+    climate_controller_update();
+    climate_controller_get_timing(&timing);
+    TEST_ASSERT_EQUAL_UINT32(2, timing.samples);
+    TEST_ASSERT_EQUAL_UINT32(1, timing.missed_samples);
+    TEST_ASSERT_TRUE(timing.latency_last_us < 3000);
+}
+
 void app_main(void) {
     UNITY_BEGIN();
     RUN_TEST(test_temperature_control);
     RUN_TEST(test_humidity_control);
     RUN_TEST(test_light_control);
     RUN_TEST(test_system_toggles);
+    RUN_TEST(test_enable_within_band_stays_off);
+    RUN_TEST(test_zones_are_independent);
+    RUN_TEST(test_zone_count_bounds);
+    RUN_TEST(test_update_all_zones);
+    RUN_TEST(test_energy_accounting);
+    RUN_TEST(test_missing_reading_holds_heat_off);
+    RUN_TEST(test_vpd_target_and_condensation);
+    RUN_TEST(test_missing_humidity_ends_mist_pulse);
+    RUN_TEST(test_stats_follow_readings);
+    RUN_TEST(test_sample_timing);
     UNITY_END();
 }
@@ -0,0 +1,166 @@
+#include "unity.h"
+#include "control_fsm.h"
+#include <stdio.h>
+
+#define GUARD_SETS (1 << CONTROL_GUARD_COUNT)
+
+static const control_fsm_t *const tables[] = {
+    &control_fsm_heating, &control_fsm_cooling, &control_fsm_humidifier, &control_fsm_lighting
+};
+#define TABLE_COUNT (sizeof(tables) / sizeof(tables[0]))
+
+// Guard sets control_fsm_band() can produce, with and without ENABLED
+static bool possible(uint8_t guards) {
+    uint8_t band = guards & (CONTROL_GUARD_BELOW | CONTROL_GUARD_ABOVE | CONTROL_GUARD_OUTSIDE);
+    return band == 0 ||
+           band == (CONTROL_GUARD_BELOW | CONTROL_GUARD_OUTSIDE) ||
+           band == (CONTROL_GUARD_ABOVE | CONTROL_GUARD_OUTSIDE);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_band_guards(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, control_fsm_band(25.0f, 25.0f, 1.0f));
+    TEST_ASSERT_EQUAL_UINT8(0, control_fsm_band(24.0f, 25.0f, 1.0f));
+    TEST_ASSERT_EQUAL_UINT8(CONTROL_GUARD_BELOW | CONTROL_GUARD_OUTSIDE, control_fsm_band(23.9f, 25.0f, 1.0f));
+    TEST_ASSERT_EQUAL_UINT8(CONTROL_GUARD_ABOVE | CONTROL_GUARD_OUTSIDE, control_fsm_band(26.1f, 25.0f, 1.0f));
+}
+
+void test_tables_well_formed(void) {
+    for (size_t i = 0; i < TABLE_COUNT; i++) {
+        const control_fsm_t *fsm = tables[i];
+        TEST_ASSERT_FALSE(fsm->output[CONTROL_STATE_DISABLED]);
+        TEST_ASSERT_FALSE(fsm->output[CONTROL_STATE_IDLE]);
+
+        for (int s = 0; s < CONTROL_STATE_COUNT; s++) {
+            for (uint8_t r = 0; r < fsm->states[s].count; r++) {
+                const control_transition_t *t = &fsm->states[s].rows[r];
+                TEST_ASSERT_TRUE(t->to < CONTROL_STATE_COUNT);
+                TEST_ASSERT_EQUAL_UINT8(0, t->require & t->forbid);
+                TEST_ASSERT_TRUE(t->require < GUARD_SETS && t->forbid < GUARD_SETS);
+            }
+        }
+    }
+}
+
+void test_every_row_reachable(void) {
+    // A row shadowed by earlier rows of its state is dead data
+    for (size_t i = 0; i < TABLE_COUNT; i++) {
+        const control_fsm_t *fsm = tables[i];
+        for (int s = 0; s < CONTROL_STATE_COUNT; s++) {
+            for (uint8_t r = 0; r < fsm->states[s].count; r++) {
+                bool taken = false;
+                for (int g = 0; g < GUARD_SETS && !taken; g++) {
+                    uint8_t state = s;
+                    if (possible(g) && control_fsm_step(fsm, &state, g) == &fsm->states[s].rows[r]) {
+                        taken = true;
+                    }
+                }
+                if (!taken) {
+                    printf("%s: row %d of state %d never taken\n", fsm->name, r, s);
+                }
+                TEST_ASSERT_TRUE(taken);
+            }
+        }
+    }
+}
+
+void test_exhaustive_step(void) {
+    // Every state under every guard set: disabled means off, and one step
+    // settles (a second step with the same guards changes nothing)
+    for (size_t i = 0; i < TABLE_COUNT; i++) {
+        const control_fsm_t *fsm = tables[i];
+        for (int s = 0; s < CONTROL_STATE_COUNT; s++) {
+            for (int g = 0; g < GUARD_SETS; g++) {
+                if (!possible(g)) {
+                    continue;
+                }
+                uint8_t state = s;
+                control_fsm_step(fsm, &state, g);
+                TEST_ASSERT_TRUE(state < CONTROL_STATE_COUNT);
+
+                if (!(g & CONTROL_GUARD_ENABLED)) {
+                    TEST_ASSERT_EQUAL_UINT8(CONTROL_STATE_DISABLED, state);
+                    TEST_ASSERT_FALSE(fsm->output[state]);
+                }
+
+                uint8_t settled = state;
+                TEST_ASSERT_NULL(control_fsm_step(fsm, &settled, g));
+            }
+        }
+    }
+}
+
+void test_heating_cooling_exclusive(void) {
+    // Walk every reachable pair of heating and cooling states under every
+    // sequence of readings and switch positions: never both on
+    bool seen[CONTROL_STATE_COUNT][CONTROL_STATE_COUNT] = { { false } };
+    uint8_t queue[CONTROL_STATE_COUNT * CONTROL_STATE_COUNT][2];
+    int head = 0, tail = 0;
+    const uint8_t bands[] = {
+        0, CONTROL_GUARD_BELOW | CONTROL_GUARD_OUTSIDE, CONTROL_GUARD_ABOVE | CONTROL_GUARD_OUTSIDE
+    };
+
+    // Both start idle or switched off
+    for (int h = CONTROL_STATE_DISABLED; h <= CONTROL_STATE_IDLE; h++) {
+        for (int c = CONTROL_STATE_DISABLED; c <= CONTROL_STATE_IDLE; c++) {
+            seen[h][c] = true;
+            queue[tail][0] = h;
+            queue[tail][1] = c;
+            tail++;
+        }
+    }
+
+    while (head < tail) {
+        uint8_t h = queue[head][0];
+        uint8_t c = queue[head][1];
+        head++;
+        TEST_ASSERT_FALSE(control_fsm_heating.output[h] && control_fsm_cooling.output[c]);
+
+        for (size_t b = 0; b < sizeof(bands); b++) {
+            for (int en = 0; en < 4; en++) {
+                uint8_t nh = h, nc = c;
+                control_fsm_step(&control_fsm_heating, &nh, bands[b] | ((en & 1) ? CONTROL_GUARD_ENABLED : 0));
+                control_fsm_step(&control_fsm_cooling, &nc, bands[b] | ((en & 2) ? CONTROL_GUARD_ENABLED : 0));
+                if (!seen[nh][nc]) {
+                    seen[nh][nc] = true;
+                    queue[tail][0] = nh;
+                    queue[tail][1] = nc;
+                    tail++;
+                }
+            }
+        }
+    }
+
+    // Each runs on its own, so the walk did cover the running states
+    TEST_ASSERT_TRUE(seen[CONTROL_STATE_RUNNING][CONTROL_STATE_IDLE]);
+    TEST_ASSERT_TRUE(seen[CONTROL_STATE_IDLE][CONTROL_STATE_RUNNING]);
+}
+
+void test_hysteresis_sequence(void) {
+    uint8_t state = CONTROL_STATE_IDLE;
+    const uint8_t on = CONTROL_GUARD_ENABLED;
+
+    // In band: stays off; below: on; back in band: stays on; above: off
+    TEST_ASSERT_NULL(control_fsm_step(&control_fsm_heating, &state, on));
+    TEST_ASSERT_NOT_NULL(control_fsm_step(&control_fsm_heating, &state, on | control_fsm_band(23.0f, 25.0f, 1.0f)));
+    TEST_ASSERT_EQUAL_UINT8(CONTROL_STATE_RUNNING, state);
+    TEST_ASSERT_NULL(control_fsm_step(&control_fsm_heating, &state, on | control_fsm_band(25.5f, 25.0f, 1.0f)));
+    control_fsm_step(&control_fsm_heating, &state, on | control_fsm_band(26.5f, 25.0f, 1.0f));
+    TEST_ASSERT_EQUAL_UINT8(CONTROL_STATE_IDLE, state);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_band_guards);
+    RUN_TEST(test_tables_well_formed);
+    RUN_TEST(test_every_row_reachable);
+    RUN_TEST(test_exhaustive_step);
+    RUN_TEST(test_heating_cooling_exclusive);
+    RUN_TEST(test_hysteresis_sequence);
+    UNITY_END();
+}
@@ -0,0 +1,114 @@
+#include "unity.h"
+#include "energy_meter.h"
+
+#define TICK_MS 500
+#define HOUR_MS ENERGY_HOUR_MS
+
+static energy_meter_t meter;
+
+// Feed one level at 500 ms ticks over [*now, until); returns the hours closed
+static int run(float level, int64_t *now, int64_t until) {
+    int closed = 0;
+
+    for (; *now < until; *now += TICK_MS) {
+        closed += energy_meter_update(&meter, level, TICK_MS, *now);
+    }
+    return closed;
+}
+
+void setUp(void) {
+    energy_meter_init(&meter, 100.0f);
+}
+
+void tearDown(void) {
+}
+
+void test_full_hour(void) {
+    energy_hour_t hour;
+    int64_t now = 0;
+
+    TEST_ASSERT_EQUAL(0, run(1.0f, &now, HOUR_MS));
+    TEST_ASSERT_FALSE(energy_meter_get_hour(&meter, 0, &hour));
+
+    // The hour closes on the first tick after it
+    TEST_ASSERT_EQUAL(1, run(1.0f, &now, HOUR_MS + TICK_MS));
+    TEST_ASSERT_TRUE(energy_meter_get_hour(&meter, 0, &hour));
+    TEST_ASSERT_EQUAL_UINT16(3600, hour.on_s);
+    TEST_ASSERT_EQUAL_UINT16(1, hour.cycles);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, hour.wh);
+}
+
+void test_pwm_level_and_cycles(void) {
+    energy_hour_t hour;
+    int64_t now = 0;
+
+    // A lamp at 40 %, switched off for a second every minute
+    while (now < HOUR_MS) {
+        run(0.4f, &now, now + 59000);
+        run(0.0f, &now, now + 1000);
+    }
+    run(0.0f, &now, now + TICK_MS);
+
+    TEST_ASSERT_TRUE(energy_meter_get_hour(&meter, 0, &hour));
+    TEST_ASSERT_EQUAL_UINT16(60, hour.cycles);
+    TEST_ASSERT_EQUAL_UINT16(60 * 59, hour.on_s);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 40.0f * 59 / 60, hour.wh);
+}
+
+void test_rolling_buckets(void) {
+    energy_summary_t summary;
+    energy_day_t day;
+    energy_hour_t hour;
+    int64_t now = 0;
+
+    // Two days on for one hour in two, then nine more days off
+    for (int h = 0; h < 48; h++) {
+        run(h % 2 ? 1.0f : 0.0f, &now, (h + 1) * HOUR_MS);
+    }
+    run(0.0f, &now, 48 * HOUR_MS + TICK_MS);
+
+    TEST_ASSERT_TRUE(energy_meter_get_day(&meter, 0, &day));
+    TEST_ASSERT_EQUAL_UINT32(12 * 3600, day.on_s);
+    TEST_ASSERT_EQUAL_UINT32(12, day.cycles);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1200.0f, day.wh);
+    TEST_ASSERT_TRUE(energy_meter_get_day(&meter, 1, &day));
+    TEST_ASSERT_FALSE(energy_meter_get_day(&meter, 2, &day));
+
+    energy_meter_get_summary(&meter, &summary);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, summary.last_hour_duty);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1200.0f, summary.day_wh);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 2400.0f, summary.week_wh);
+    TEST_ASSERT_EQUAL_UINT32(24, summary.total_cycles);
+
+    run(0.0f, &now, 11 * 24 * HOUR_MS + TICK_MS);
+    energy_meter_get_summary(&meter, &summary);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, summary.week_wh);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 2400.0f, summary.total_wh);
+    TEST_ASSERT_TRUE(energy_meter_get_hour(&meter, ENERGY_HOURS - 1, &hour));
+    TEST_ASSERT_FALSE(energy_meter_get_hour(&meter, ENERGY_HOURS, &hour));
+    TEST_ASSERT_TRUE(energy_meter_get_day(&meter, ENERGY_DAYS - 1, &day));
+    TEST_ASSERT_FALSE(energy_meter_get_day(&meter, ENERGY_DAYS, &day));
+}
+
+void test_gap_closes_empty_hours(void) {
+    energy_hour_t hour;
+    int64_t now = 0;
+
+    run(1.0f, &now, 30 * 60 * 1000);
+
+    // Three hours later the first hour holds the half hour, the rest nothing
+    TEST_ASSERT_TRUE(energy_meter_update(&meter, 0.0f, TICK_MS, 3 * HOUR_MS));
+    TEST_ASSERT_TRUE(energy_meter_get_hour(&meter, 2, &hour));
+    TEST_ASSERT_EQUAL_UINT16(1800, hour.on_s);
+    TEST_ASSERT_TRUE(energy_meter_get_hour(&meter, 0, &hour));
+    TEST_ASSERT_EQUAL_UINT16(0, hour.on_s);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_hour);
+    RUN_TEST(test_pwm_level_and_cycles);
+    RUN_TEST(test_rolling_buckets);
+    RUN_TEST(test_gap_closes_empty_hours);
+    UNITY_END();
+}
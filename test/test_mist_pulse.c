@@ -0,0 +1,102 @@
+#include "unity.h"
+#include "mist_pulse.h"
+
+static mist_pulse_t mist;
+
+// Run the scheduler in 500 ms ticks against a simple enclosure: humidity
+// rises at rate while misting and leaks away slowly; returns the longest
+// single pulse seen (ms)
+static uint32_t run(float *humidity, float target, float rate, int64_t *now, int64_t until) {
+    uint32_t longest = 0, on_ms = 0;
+
+    for (; *now < until; *now += 500) {
+        bool on = mist_pulse_update(&mist, *humidity, target, true, *now);
+        if (on) {
+            *humidity += rate * 0.5f;
+            on_ms += 500;
+            if (on_ms > longest) longest = on_ms;
+        } else {
+            on_ms = 0;
+            *humidity -= 0.005f;
+        }
+    }
+    return longest;
+}
+
+void setUp(void) {
+    mist_pulse_init(&mist);
+}
+
+void tearDown(void) {
+}
+
+void test_bounded_pulses_with_interval(void) {
+    float humidity = 40.0f;
+    int64_t now = 0;
+
+    // A big deficit still gets pulses no longer than the maximum
+    TEST_ASSERT_TRUE(mist_pulse_update(&mist, humidity, 80.0f, true, now));
+    while (mist.state == MIST_PULSING) {
+        now += 500;
+        mist_pulse_update(&mist, humidity, 80.0f, true, now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(MIST_MAX_PULSE_MS, mist.pulse_ms);
+
+    // Nothing again until the minimum interval from the last start
+    for (now += 500; now < MIST_MIN_INTERVAL_MS; now += 500) {
+        TEST_ASSERT_FALSE(mist_pulse_update(&mist, humidity, 80.0f, true, now));
+    }
+    TEST_ASSERT_TRUE(mist_pulse_update(&mist, humidity, 80.0f, true, now));
+}
+
+void test_in_band_stays_off(void) {
+    TEST_ASSERT_FALSE(mist_pulse_update(&mist, 59.5f, 60.0f, true, 0));
+    TEST_ASSERT_FALSE(mist_pulse_update(&mist, 40.0f, 60.0f, false, 0));
+}
+
+void test_gain_adapts(void) {
+    float humidity = 50.0f;
+    int64_t now = 0;
+
+    // The enclosure responds at 0.4 %RH/s, not the assumed 1.0: pulses grow
+    // to close the deficit and the humidity settles near the target
+    uint32_t longest = run(&humidity, 60.0f, 0.4f, &now, 60LL * 60 * 1000);
+    TEST_ASSERT_TRUE(mist.pulses > 5);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.4f, mist.gain);
+    TEST_ASSERT_TRUE(longest <= MIST_MAX_PULSE_MS);
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, 60.0f, humidity);
+}
+
+void test_daily_cap(void) {
+    float humidity = 20.0f;
+    int64_t now = 0;
+
+    // A leaky enclosure that never reaches the target: mist stops at the cap
+    mist.daily_cap_ml = 30.0f;
+    run(&humidity, 90.0f, 0.01f, &now, 60LL * 60 * 1000);
+    TEST_ASSERT_TRUE(mist.capped);
+    TEST_ASSERT_TRUE(mist.used_ml <= 30.0f);
+    TEST_ASSERT_TRUE(mist.used_ml >= 30.0f - MIST_MIN_PULSE_MS / 1000.0f * MIST_FLOW_ML_S);
+
+    // The next period starts afresh
+    run(&humidity, 90.0f, 0.01f, &now, MIST_DAY_MS + 1000);
+    TEST_ASSERT_FALSE(mist.capped);
+}
+
+void test_cut_ends_pulse(void) {
+    TEST_ASSERT_TRUE(mist_pulse_update(&mist, 40.0f, 60.0f, true, 0));
+    TEST_ASSERT_TRUE(mist_pulse_update(&mist, 40.5f, 60.0f, true, 500));
+    TEST_ASSERT_FALSE(mist_pulse_update(&mist, 41.0f, 60.0f, false, 1000));
+    TEST_ASSERT_EQUAL(MIST_SETTLING, mist.state);
+    TEST_ASSERT_EQUAL_UINT32(1000, mist.pulse_ms);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bounded_pulses_with_interval);
+    RUN_TEST(test_in_band_stays_off);
+    RUN_TEST(test_gain_adapts);
+    RUN_TEST(test_daily_cap);
+    RUN_TEST(test_cut_ends_pulse);
+    UNITY_END();
+}
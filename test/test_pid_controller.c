@@ -0,0 +1,112 @@
+#include "unity.h"
+#include "pid_controller.h"
+#include <stdio.h>
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_pid_output_clamped(void) {
+    pid_controller_t pid;
+    pid_init(&pid, 1.0f, 0.1f, 0.0f, 0.0f, 1.0f);
+
+    // Large positive error saturates high, large negative error saturates low
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, pid_update(&pid, 30.0f, 20.0f, 1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid_update(&pid, 10.0f, 20.0f, 1.0f));
+}
+
+void test_pid_anti_windup(void) {
+    pid_controller_t pid;
+    pid_init(&pid, 0.5f, 0.1f, 0.0f, 0.0f, 1.0f);
+
+    // Hold the output saturated for a long time
+    for (int i = 0; i < 1000; i++) {
+        pid_update(&pid, 30.0f, 20.0f, 1.0f);
+    }
+    TEST_ASSERT_TRUE(pid.integral <= 1.0f);
+
+    // Once past the setpoint the output must drop right away instead of
+    // unwinding a huge integral
+    float out = pid_update(&pid, 30.0f, 32.0f, 1.0f);
+    TEST_ASSERT_TRUE(out < 1.0f);
+}
+
+void test_tpo_duty(void) {
+    pid_tpo_t tpo;
+    pid_tpo_init(&tpo, 10, 2);
+
+    // 40% duty: 4 of 10 ticks on
+    int on = 0;
+    for (int i = 0; i < 10; i++) {
+        on += pid_tpo_update(&tpo, 0.4f);
+    }
+    TEST_ASSERT_EQUAL_INT(4, on);
+
+    // Duty below the minimum on time stays off
+    on = 0;
+    for (int i = 0; i < 10; i++) {
+        on += pid_tpo_update(&tpo, 0.1f);
+    }
+    TEST_ASSERT_EQUAL_INT(0, on);
+
+    // Duty leaving less than the minimum off time stays on
+    on = 0;
+    for (int i = 0; i < 10; i++) {
+        on += pid_tpo_update(&tpo, 0.9f);
+    }
+    TEST_ASSERT_EQUAL_INT(10, on);
+}
+
+void test_autotune_first_order_plant(void) {
+    pid_autotune_t at;
+    float temp = 22.0f;
+    const float dt = 0.5f;
+
+    pid_autotune_start(&at, 25.0f, 0.2f, 0.0f, 1.0f, 3600.0f);
+
+    // First-order plant with a two-sample transport delay
+    float delayed[2] = {0.0f, 0.0f};
+    for (int i = 0; i < 20000 && at.state == PID_AUTOTUNE_RUNNING; i++) {
+        float out = pid_autotune_update(&at, temp, dt);
+        float applied = delayed[0];
+        delayed[0] = delayed[1];
+        delayed[1] = out;
+        temp += dt * (0.1f * (20.0f - temp) + 1.0f * applied);
+    }
+
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_DONE, at.state);
+    TEST_ASSERT_TRUE(at.ku > 0.0f);
+    TEST_ASSERT_TRUE(at.tu > 0.0f);
+
+    float kp, ki, kd;
+    TEST_ASSERT_TRUE(pid_autotune_get_gains(&at, &kp, &ki, &kd));
+    TEST_ASSERT_TRUE(kp > 0.0f);
+    TEST_ASSERT_TRUE(ki > 0.0f);
+    TEST_ASSERT_TRUE(kd >= 0.0f);
+}
+
+void test_autotune_timeout(void) {
+    pid_autotune_t at;
+    pid_autotune_start(&at, 25.0f, 0.2f, 0.0f, 1.0f, 10.0f);
+
+    // A plant that never responds can't oscillate
+    for (int i = 0; i < 100; i++) {
+        pid_autotune_update(&at, 20.0f, 0.5f);
+    }
+
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_FAILED, at.state);
+    float kp, ki, kd;
+    TEST_ASSERT_FALSE(pid_autotune_get_gains(&at, &kp, &ki, &kd));
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pid_output_clamped);
+    RUN_TEST(test_pid_anti_windup);
+    RUN_TEST(test_tpo_duty);
+    RUN_TEST(test_autotune_first_order_plant);
+    RUN_TEST(test_autotune_timeout);
+    UNITY_END();
+}
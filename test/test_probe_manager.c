@@ -0,0 +1,159 @@
+#include "unity.h"
+#include "probe_manager.h"
+#include "climate_controller.h"
+#include <math.h>
+
+#define MS(ms) ((int64_t)(ms) * 1000)
+
+// Basking, cool side, substrate, ambient
+static const float readings[PROBE_COUNT] = { 34.0f, 24.0f, 29.0f, 20.0f };
+
+void setUp(void) {
+    // Saved configuration outlives init; start every test from the defaults
+    probe_manager_init();
+    probe_manager_set_fusion(0, PROBE_FUSION_WEIGHTED);
+    probe_manager_set_fitted(0, PROBE_ALL);
+    probe_manager_set_gradient(0, PROBE_DEFAULT_GRADIENT_C);
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        probe_manager_set_weight(0, p, p == PROBE_AMBIENT ? 0.0f : 1.0f);
+    }
+}
+
+void tearDown(void) {
+}
+
+void test_weighted_default(void) {
+    float heat = 0.0f, cool = 0.0f;
+
+    probe_manager_report(0, readings, MS(0));
+    TEST_ASSERT_TRUE(probe_manager_get_control_temps(0, &heat, &cool));
+
+    // Enclosure probes equally, ambient not at all
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 29.0f, heat);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 29.0f, cool);
+
+    probe_manager_set_weight(0, PROBE_BASKING, 2.0f);
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.25f, heat);
+}
+
+void test_weight_saved(void) {
+    float heat, cool;
+
+    probe_manager_set_weight(0, PROBE_BASKING, 2.0f);
+
+    // The weight outlives a restart
+    probe_manager_init();
+    probe_manager_report(0, readings, MS(0));
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.25f, heat);
+
+    // A zone out of range has no control temperatures
+    TEST_ASSERT_FALSE(probe_manager_get_control_temps(-1, &heat, &cool));
+    TEST_ASSERT_FALSE(probe_manager_get_control_temps(CLIMATE_MAX_ZONES, &heat, &cool));
+}
+
+void test_min_max(void) {
+    float heat, cool;
+
+    probe_manager_report(0, readings, MS(0));
+
+    // The ambient probe is colder, but outside the enclosure
+    probe_manager_set_fusion(0, PROBE_FUSION_MIN);
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_EQUAL_FLOAT(24.0f, heat);
+
+    probe_manager_set_fusion(0, PROBE_FUSION_MAX);
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_EQUAL_FLOAT(34.0f, cool);
+}
+
+void test_gradient(void) {
+    float heat, cool;
+    probe_readings_t snapshot;
+
+    probe_manager_set_fusion(0, PROBE_FUSION_GRADIENT);
+    probe_manager_set_gradient(0, 8.0f);
+    probe_manager_report(0, readings, MS(0));
+
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_EQUAL_FLOAT(34.0f, heat);
+    TEST_ASSERT_EQUAL_FLOAT(32.0f, cool);
+
+    probe_manager_get_readings(0, &snapshot);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, snapshot.spread);
+    TEST_ASSERT_EQUAL_UINT8(PROBE_ALL, snapshot.ok);
+}
+
+void test_fault_held_then_dropped(void) {
+    float faulty[PROBE_COUNT] = { NAN, 24.0f, 29.0f, 20.0f };
+    float heat, cool;
+    probe_readings_t snapshot;
+
+    probe_manager_set_fusion(0, PROBE_FUSION_GRADIENT);
+    probe_manager_report(0, readings, MS(0));
+
+    // Last good basking value held through a short dropout
+    probe_manager_report(0, faulty, MS(PROBE_HOLD_MS));
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_EQUAL_FLOAT(34.0f, heat);
+
+    // Then dropped: heating falls back to the weighted mean of the rest
+    probe_manager_report(0, faulty, MS(PROBE_HOLD_MS + 1000));
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 26.5f, heat);
+
+    probe_manager_get_readings(0, &snapshot);
+    TEST_ASSERT_FALSE(snapshot.ok & PROBE_BIT(PROBE_BASKING));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, snapshot.spread);
+
+    // Back as soon as it reads again
+    probe_manager_report(0, readings, MS(PROBE_HOLD_MS + 2000));
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_EQUAL_FLOAT(34.0f, heat);
+}
+
+void test_out_of_range_is_fault(void) {
+    float shorted[PROBE_COUNT] = { 150.0f, 24.0f, 29.0f, 20.0f };
+    probe_readings_t snapshot;
+
+    probe_manager_report(0, shorted, MS(0));
+    probe_manager_get_readings(0, &snapshot);
+    TEST_ASSERT_FALSE(snapshot.ok & PROBE_BIT(PROBE_BASKING));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 26.5f, snapshot.heat_temp);
+}
+
+void test_no_probes_falls_back(void) {
+    const float none[PROBE_COUNT] = { NAN, NAN, NAN, NAN };
+    float heat = -1.0f, cool = -1.0f;
+
+    // Nothing reported yet
+    TEST_ASSERT_FALSE(probe_manager_get_control_temps(0, &heat, &cool));
+
+    // Only probes that never read: the caller keeps its zone sensor
+    probe_manager_report(0, none, MS(0));
+    TEST_ASSERT_FALSE(probe_manager_get_control_temps(0, &heat, &cool));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, heat);
+}
+
+void test_unfitted_probe_ignored(void) {
+    float heat, cool;
+
+    probe_manager_set_fitted(0, PROBE_BIT(PROBE_COOL_SIDE) | PROBE_BIT(PROBE_SUBSTRATE));
+    probe_manager_report(0, readings, MS(0));
+    probe_manager_get_control_temps(0, &heat, &cool);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 26.5f, heat);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_weighted_default);
+    RUN_TEST(test_weight_saved);
+    RUN_TEST(test_min_max);
+    RUN_TEST(test_gradient);
+    RUN_TEST(test_fault_held_then_dropped);
+    RUN_TEST(test_out_of_range_is_fault);
+    RUN_TEST(test_no_probes_falls_back);
+    RUN_TEST(test_unfitted_probe_ignored);
+    UNITY_END();
+}
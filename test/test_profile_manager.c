@@ -0,0 +1,165 @@
+#include "unity.h"
+#include "profile_manager.h"
+#include "climate_controller.h"
+#include <stdlib.h>
+
+// 2024-06-21 00:00 UTC, day 173
+#define MIDSUMMER ((time_t)1718928000)
+#define HOUR (60 * 60)
+
+static profile_t test_profile(void) {
+    profile_t profile = {
+        .enabled = true,
+        .day_temp = 30.0f,
+        .night_temp = 24.0f,
+        .day_humidity = 50.0f,
+        .night_humidity = 70.0f,
+        .day_light = 100.0f,
+        .ramp_min = 60,
+        .brumation_start = 1,
+        .brumation_days = 0,
+        .brumation_drop_c = 8.0f,
+    };
+    return profile;
+}
+
+void setUp(void) {
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    climate_controller_init();
+    profile_manager_init();
+    profile_manager_set_location(0.0f, 0.0f);
+}
+
+void tearDown(void) {
+    profile_t off = test_profile();
+    off.enabled = false;
+    profile_manager_set(0, &off);
+}
+
+void test_sun_times(void) {
+    float rise, set;
+
+    // Equator: about 12 hours around noon UTC
+    TEST_ASSERT_TRUE(profile_sun_times(80, 0.0f, 0.0f, &rise, &set));
+    TEST_ASSERT_FLOAT_WITHIN(15.0f, 12 * 60 + 7, set - rise);
+    TEST_ASSERT_FLOAT_WITHIN(20.0f, 720.0f, (rise + set) / 2);
+
+    // 60°N at midsummer: about 18h50, noon an hour earlier at 15°E
+    TEST_ASSERT_TRUE(profile_sun_times(173, 60.0f, 15.0f, &rise, &set));
+    TEST_ASSERT_FLOAT_WITHIN(20.0f, 18 * 60 + 50, set - rise);
+    TEST_ASSERT_FLOAT_WITHIN(20.0f, 660.0f, (rise + set) / 2);
+
+    // 80°N: polar night in December, midnight sun in June
+    TEST_ASSERT_FALSE(profile_sun_times(355, 80.0f, 0.0f, &rise, &set));
+    TEST_ASSERT_TRUE(profile_sun_times(173, 80.0f, 0.0f, &rise, &set));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 24 * 60, set - rise);
+}
+
+void test_day_night_targets(void) {
+    profile_t profile = test_profile();
+    profile_day_t day;
+
+    TEST_ASSERT_EQUAL(ESP_OK, profile_manager_set(0, &profile));
+
+    profile_manager_update(MIDSUMMER + 2 * HOUR);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 24.0f, climate_controller_zone_get_temp_target(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 70.0f, climate_controller_zone_get_humidity_target(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, climate_controller_zone_get_light_target(0));
+
+    profile_manager_update(MIDSUMMER + 12 * HOUR);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, climate_controller_zone_get_temp_target(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, climate_controller_zone_get_humidity_target(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, climate_controller_zone_get_light_target(0));
+
+    // Halfway up the sunrise ramp
+    TEST_ASSERT_TRUE(profile_manager_get_day(0, &day));
+    TEST_ASSERT_EQUAL_INT32(60 * 60, day.ramp_s);
+    TEST_ASSERT_INT32_WITHIN(30 * 60, 6 * HOUR, day.sunrise_s);
+    profile_manager_update(MIDSUMMER + day.sunrise_s + day.ramp_s / 2);
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, 27.0f, climate_controller_zone_get_temp_target(0));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 50.0f, climate_controller_zone_get_light_target(0));
+}
+
+void test_breakpoints_once_per_day(void) {
+    profile_t profile = test_profile();
+    profile_stats_t stats;
+
+    profile_manager_set(0, &profile);
+
+    // Two days of 500 ms ticks: trigonometry runs at each midnight only
+    for (time_t t = MIDSUMMER; t < MIDSUMMER + 48 * HOUR; t++) {
+        profile_manager_update(t);
+        profile_manager_update(t);
+    }
+
+    profile_manager_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2 * 48 * HOUR, stats.ticks);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.day_computations);
+
+    // Targets move in steps during the ramps (about 100 light steps each),
+    // not every tick
+    TEST_ASSERT_TRUE(stats.target_updates < 2 * 250);
+}
+
+void test_brumation(void) {
+    profile_t profile = test_profile();
+    profile_day_t day;
+
+    // Day 173 is the depth of a 60-day brumation starting on day 143
+    profile.brumation_start = 143;
+    profile.brumation_days = 60;
+    profile_manager_set(0, &profile);
+
+    profile_manager_update(MIDSUMMER + 12 * HOUR);
+    TEST_ASSERT_TRUE(profile_manager_get_day(0, &day));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, day.brumation);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 22.0f, climate_controller_zone_get_temp_target(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f * PROFILE_BRUMATION_LIGHT, climate_controller_zone_get_light_target(0));
+
+    // Outside the window: the plain profile
+    profile.brumation_start = 200;
+    profile_manager_set(0, &profile);
+    profile_manager_update(MIDSUMMER + 12 * HOUR);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, climate_controller_zone_get_temp_target(0));
+}
+
+void test_photoperiod(void) {
+    profile_t profile = test_profile();
+    profile_day_t day;
+
+    // 60°N at midsummer has a day of nearly 19 hours; 12 are kept around noon
+    profile_manager_set_location(60.0f, 0.0f);
+    profile.photoperiod_h = 12;
+    profile_manager_set(0, &profile);
+
+    profile_manager_update(MIDSUMMER + 12 * HOUR);
+    TEST_ASSERT_TRUE(profile_manager_get_day(0, &day));
+    TEST_ASSERT_EQUAL_INT32(12 * HOUR, day.sunset_s - day.sunrise_s);
+    TEST_ASSERT_INT32_WITHIN(15 * 60, 12 * HOUR, (day.sunrise_s + day.sunset_s) / 2);
+
+    profile_manager_update(MIDSUMMER + 5 * HOUR);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, climate_controller_zone_get_light_target(0));
+
+    profile.photoperiod_h = 25;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, profile_manager_set(0, &profile));
+}
+
+void test_invalid_profile(void) {
+    profile_t profile = test_profile();
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, profile_manager_set(CLIMATE_MAX_ZONES, &profile));
+    profile.brumation_start = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, profile_manager_set(0, &profile));
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sun_times);
+    RUN_TEST(test_day_night_targets);
+    RUN_TEST(test_breakpoints_once_per_day);
+    RUN_TEST(test_brumation);
+    RUN_TEST(test_photoperiod);
+    RUN_TEST(test_invalid_profile);
+    UNITY_END();
+}
@@ -0,0 +1,104 @@
+#include "unity.h"
+#include "psychrometrics.h"
+#include <math.h>
+
+// Reference formulas the table approximates (Magnus form over water)
+static double ref_saturation(double t) {
+    return 0.61094 * exp(17.625 * t / (t + 243.04));
+}
+
+static double ref_dew_point(double t, double rh) {
+    double gamma = log(rh / 100.0) + 17.625 * t / (t + 243.04);
+    return 243.04 * gamma / (17.625 - gamma);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_saturation_matches_reference(void) {
+    // Off the table points too, where interpolation error is largest
+    for (float t = -10.0f; t <= 50.0f; t += 0.37f) {
+        double ref = ref_saturation(t);
+        TEST_ASSERT_FLOAT_WITHIN((float)(ref * 0.001), (float)ref, psychro_saturation_kpa(t));
+    }
+}
+
+void test_metrics_match_reference(void) {
+    psychro_metrics_t m;
+    float worst_dew = 0.0f;
+
+    for (float t = 5.0f; t <= 45.0f; t += 1.3f) {
+        for (float rh = 5.0f; rh <= 99.0f; rh += 3.1f) {
+            double es = ref_saturation(t);
+            double e = es * rh / 100.0;
+
+            psychro_compute(t, rh, &m);
+            TEST_ASSERT_FLOAT_WITHIN((float)(es * 0.001), (float)(es - e), m.vpd_kpa);
+            TEST_ASSERT_FLOAT_WITHIN((float)(e * 2166.8 / (t + 273.15) * 0.001),
+                                     (float)(e * 2166.8 / (t + 273.15)), m.abs_humidity_gm3);
+            float err = fabsf(m.dew_point_c - (float)ref_dew_point(t, rh));
+            if (err > worst_dew) {
+                worst_dew = err;
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(worst_dew < 0.05f);
+}
+
+void test_known_points(void) {
+    psychro_metrics_t m;
+
+    // 25 °C at 50 %: VPD 1.58 kPa, dew point 13.9 °C, 11.5 g/m³
+    psychro_compute(25.0f, 50.0f, &m);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.584f, m.vpd_kpa);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 13.86f, m.dew_point_c);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 11.5f, m.abs_humidity_gm3);
+
+    // Saturated air has no deficit and condenses at its own temperature
+    psychro_compute(30.0f, 100.0f, &m);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, m.vpd_kpa);
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, m.dew_point_c);
+
+    psychro_compute(NAN, 50.0f, &m);
+    TEST_ASSERT_TRUE(isnan(m.vpd_kpa) && isnan(m.dew_point_c) && isnan(m.abs_humidity_gm3));
+}
+
+void test_batch_matches_single(void) {
+    const float t[4] = { 18.0f, 24.5f, 31.2f, NAN };
+    const float rh[4] = { 80.0f, 55.0f, 30.0f, 50.0f };
+    float vpd[4], dew[4], ah[4];
+    psychro_metrics_t m;
+
+    psychro_compute_batch(t, rh, vpd, dew, ah, 4);
+    for (int i = 0; i < 3; i++) {
+        psychro_compute(t[i], rh[i], &m);
+        TEST_ASSERT_EQUAL_FLOAT(m.vpd_kpa, vpd[i]);
+        TEST_ASSERT_EQUAL_FLOAT(m.dew_point_c, dew[i]);
+        TEST_ASSERT_EQUAL_FLOAT(m.abs_humidity_gm3, ah[i]);
+    }
+    TEST_ASSERT_TRUE(isnan(vpd[3]));
+}
+
+void test_humidity_for_vpd_round_trip(void) {
+    psychro_metrics_t m;
+    float rh = psychro_humidity_for_vpd(28.0f, 1.2f);
+
+    psychro_compute(28.0f, rh, &m);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.2f, m.vpd_kpa);
+
+    // A deficit larger than the saturation pressure asks for dry air
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, psychro_humidity_for_vpd(10.0f, 5.0f));
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_saturation_matches_reference);
+    RUN_TEST(test_metrics_match_reference);
+    RUN_TEST(test_known_points);
+    RUN_TEST(test_batch_matches_single);
+    RUN_TEST(test_humidity_for_vpd_round_trip);
+    UNITY_END();
+}
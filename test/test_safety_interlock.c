@@ -0,0 +1,122 @@
+#include "unity.h"
+#include "safety_interlock.h"
+#include "climate_controller.h"
+#include "data_simulator.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+
+void setUp(void) {
+    climate_controller_init();
+    data_simulator_init();
+    safety_interlock_init();
+}
+
+void tearDown(void) {
+    safety_interlock_stop();
+    // Don't leave cutoffs behind for the next test
+    safety_interlock_init();
+}
+
+void test_over_temperature_cuts_heating(void) {
+    safety_interlock_report_sample(0, SAFETY_TEMP_MAX_C + 1.0f, 50.0f);
+    safety_interlock_check(esp_timer_get_time());
+
+    TEST_ASSERT_TRUE(safety_interlock_get_causes(0) & SAFETY_CAUSE_OVER_TEMP);
+    TEST_ASSERT_EQUAL_UINT8(SAFETY_CUT_HEATING, safety_interlock_get_cutoff(0));
+
+    // The output stays off even when heating is requested
+    float before = data_simulator_get_zone_temperature(0);
+    data_simulator_apply_zone_heating(0);
+    TEST_ASSERT_EQUAL_FLOAT(before, data_simulator_get_zone_temperature(0));
+
+    climate_controller_set_heating(true);
+    climate_controller_update();
+    TEST_ASSERT_FALSE(climate_controller_is_heating_on());
+}
+
+void test_release_needs_margin(void) {
+    safety_interlock_report_sample(0, SAFETY_TEMP_MAX_C + 1.0f, 50.0f);
+    safety_interlock_check(esp_timer_get_time());
+    TEST_ASSERT_TRUE(safety_interlock_is_tripped());
+
+    // Just below the cutoff is not enough to release
+    safety_interlock_report_sample(0, SAFETY_TEMP_MAX_C - SAFETY_TEMP_RELEASE_MARGIN_C / 2.0f, 50.0f);
+    safety_interlock_check(esp_timer_get_time());
+    TEST_ASSERT_TRUE(safety_interlock_is_tripped());
+
+    safety_interlock_report_sample(0, SAFETY_TEMP_MAX_C - SAFETY_TEMP_RELEASE_MARGIN_C - 0.5f, 50.0f);
+    safety_interlock_check(esp_timer_get_time());
+    TEST_ASSERT_FALSE(safety_interlock_is_tripped());
+    TEST_ASSERT_EQUAL_UINT8(0, safety_interlock_get_cutoff(0));
+}
+
+void test_humidity_and_under_temperature(void) {
+    safety_interlock_report_sample(0, SAFETY_TEMP_MIN_C - 1.0f, SAFETY_HUMIDITY_MAX_PCT + 1.0f);
+    safety_interlock_check(esp_timer_get_time());
+
+    TEST_ASSERT_EQUAL_UINT8(SAFETY_CUT_COOLING | SAFETY_CUT_HUMIDIFIER, safety_interlock_get_cutoff(0));
+}
+
+void test_stale_sensor_cuts_all(void) {
+    int64_t now = esp_timer_get_time();
+    safety_interlock_report_sample(0, 25.0f, 50.0f);
+    safety_interlock_check(now);
+    TEST_ASSERT_FALSE(safety_interlock_is_tripped());
+
+    // No sample for longer than the stale timeout
+    safety_interlock_check(now + SAFETY_SENSOR_STALE_MS * 1000LL + 1000);
+    TEST_ASSERT_TRUE(safety_interlock_get_causes(0) & SAFETY_CAUSE_SENSOR_STALE);
+    TEST_ASSERT_EQUAL_UINT8(SAFETY_CUT_HEATING | SAFETY_CUT_COOLING | SAFETY_CUT_HUMIDIFIER,
+                            safety_interlock_get_cutoff(0));
+
+    // A fresh sample releases it
+    safety_interlock_report_sample(0, 25.0f, 50.0f);
+    safety_interlock_check(esp_timer_get_time());
+    TEST_ASSERT_FALSE(safety_interlock_is_tripped());
+}
+
+// Reports an over-temperature sample, then hogs the core the interlock runs on
+static void hung_task(void *pvParameter) {
+    safety_interlock_report_sample(0, SAFETY_TEMP_MAX_C + 3.0f, 50.0f);
+
+    int64_t end = esp_timer_get_time() + 500000;
+    while (esp_timer_get_time() < end) {
+    }
+
+    xTaskNotifyGive((TaskHandle_t)pvParameter);
+    vTaskDelete(NULL);
+}
+
+void test_reaction_with_hung_task(void) {
+    TEST_ASSERT_EQUAL(ESP_OK, safety_interlock_start());
+    safety_interlock_report_sample(0, 25.0f, 50.0f);
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    // A task just below the interlock's priority spins on its core
+    xTaskCreatePinnedToCore(hung_task, "hung_task", 2048, xTaskGetCurrentTaskHandle(),
+                            configMAX_PRIORITIES - 2, NULL, 0);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    safety_interlock_stats_t stats;
+    safety_interlock_get_stats(&stats);
+    printf("SAFETY reaction_max_us=%lu worst_case_us=%lu\n",
+           (unsigned long)stats.reaction_max_us, (unsigned long)safety_interlock_get_worst_case_us());
+
+    TEST_ASSERT_EQUAL_UINT8(SAFETY_CUT_HEATING, safety_interlock_get_cutoff(0));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.trips);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SAFETY_MAX_REACTION_MS * 1000, stats.reaction_max_us);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SAFETY_MAX_REACTION_MS * 1000, safety_interlock_get_worst_case_us());
+    TEST_ASSERT_EQUAL_UINT32(0, stats.deadline_misses);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_over_temperature_cuts_heating);
+    RUN_TEST(test_release_needs_margin);
+    RUN_TEST(test_humidity_and_under_temperature);
+    RUN_TEST(test_stale_sensor_cuts_all);
+    RUN_TEST(test_reaction_with_hung_task);
+    UNITY_END();
+}
@@ -0,0 +1,192 @@
+#include "unity.h"
+#include "schedule_manager.h"
+#include "climate_controller.h"
+#include "data_simulator.h"
+#include "sensor_hal.h"
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+// Monday 2025-01-06 08:00 local time
+static time_t monday_8am(void) {
+    struct tm t = {
+        .tm_year = 2025 - 1900,
+        .tm_mon = 0,
+        .tm_mday = 6,
+        .tm_hour = 8,
+        .tm_isdst = -1,
+    };
+    return mktime(&t);
+}
+
+// Virtual time of the sensor polls
+static int64_t sample_us;
+
+// Sample the zones for a few seconds, as the sensor task would, so the
+// filtered reading settles on the simulator's current value
+static void sample(void) {
+    for (int i = 0; i < 10; i++) {
+        sample_us += 1000000;
+        sensor_hal_poll(sample_us);
+    }
+}
+
+void setUp(void) {
+    climate_controller_init();
+    data_simulator_init();
+    sensor_hal_init();
+    sample();
+    schedule_manager_init();
+}
+
+void tearDown(void) {
+}
+
+void test_lead_time_default_rate(void) {
+    // 2°C to go, less the tolerance, at the default warm-up rate. Zone
+    // index 5 never learns here, so rates left in NVS don't matter.
+    uint32_t expected = (uint32_t)((2.0f - SCHEDULE_TOLERANCE_C) / SCHEDULE_DEFAULT_WARM_RATE * 60.0f);
+    TEST_ASSERT_UINT32_WITHIN(1, expected, schedule_manager_get_lead_time(5, 25.0f, 27.0f));
+
+    // Already within tolerance
+    TEST_ASSERT_EQUAL_UINT32(0, schedule_manager_get_lead_time(5, 25.0f, 25.3f));
+}
+
+void test_learns_warm_rate(void) {
+    time_t now = monday_8am();
+    schedule_rate_t before;
+    schedule_manager_get_rate(0, true, &before);
+    schedule_manager_update(now);
+
+    // Warm up at 0.3°C per minute toward a new target
+    climate_controller_set_temp_target(28.0f);
+    for (int i = 0; i < 20; i++) {
+        sample();
+        schedule_manager_update(now);
+        data_simulator_apply_heating();
+        now += 60;
+    }
+
+    schedule_rate_t rate;
+    schedule_manager_get_rate(0, true, &rate);
+    TEST_ASSERT_EQUAL_UINT32(before.count + 1, rate.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, before.mean + (0.3f - before.mean) / rate.count, rate.mean);
+
+    // Lead time now follows the learned rate, well above the default
+    TEST_ASSERT_TRUE(schedule_manager_get_lead_time(0, 25.0f, 27.0f) <
+                     schedule_manager_get_lead_time(5, 25.0f, 27.0f));
+}
+
+void test_entry_starts_early(void) {
+    time_t at = monday_8am();
+    const schedule_entry_t entry = {
+        .zone = 0, .day = 1, .hour = 8, .minute = 0,
+        .temperature = 28.0f, .humidity = 60.0f, .light = 80.0f,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, schedule_manager_add(&entry));
+
+    uint32_t lead = schedule_manager_get_lead_time(0, data_simulator_get_temperature(), 28.0f);
+
+    // Too early: nothing changes
+    schedule_manager_update(at - lead - 120);
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, climate_controller_get_temp_target());
+
+    // Within the lead time: the temperature target moves, the rest waits
+    schedule_manager_update(at - lead + 60);
+    TEST_ASSERT_EQUAL_FLOAT(28.0f, climate_controller_get_temp_target());
+    TEST_ASSERT_EQUAL_FLOAT(50.0f, climate_controller_get_humidity_target());
+
+    // At the entry time everything applies and the miss is recorded
+    schedule_manager_update(at);
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, climate_controller_get_humidity_target());
+
+    schedule_accuracy_t accuracy;
+    schedule_manager_get_accuracy(&accuracy);
+    TEST_ASSERT_EQUAL_UINT32(1, accuracy.events);
+    TEST_ASSERT_EQUAL_UINT32(0, accuracy.on_time);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -3.0f, accuracy.last_error_c);
+}
+
+void test_entry_fires_once_per_week(void) {
+    time_t at = monday_8am();
+    const schedule_entry_t entry = {
+        .zone = 0, .day = 1, .hour = 8, .minute = 0,
+        .temperature = 25.0f, .humidity = 60.0f, .light = 80.0f,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, schedule_manager_add(&entry));
+
+    schedule_manager_update(at);
+    schedule_manager_update(at + 30);
+    schedule_manager_update(at + 3600);
+
+    schedule_accuracy_t accuracy;
+    schedule_manager_get_accuracy(&accuracy);
+    TEST_ASSERT_EQUAL_UINT32(1, accuracy.events);
+    TEST_ASSERT_EQUAL_UINT32(1, accuracy.on_time);
+
+    schedule_manager_update(at + 7 * 24 * 3600);
+    schedule_manager_get_accuracy(&accuracy);
+    TEST_ASSERT_EQUAL_UINT32(2, accuracy.events);
+}
+
+void test_missing_reading_not_scored(void) {
+    time_t at = monday_8am();
+    const schedule_entry_t entry = {
+        .zone = 0, .day = 1, .hour = 8, .minute = 0,
+        .temperature = 25.0f, .humidity = 60.0f, .light = 80.0f,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, schedule_manager_add(&entry));
+
+    // The entry still applies, but a NaN reading is not scored
+    sensor_hal_set_sensors(NULL, 0);
+    schedule_manager_update(at);
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, climate_controller_get_humidity_target());
+
+    schedule_accuracy_t accuracy;
+    schedule_manager_get_accuracy(&accuracy);
+    TEST_ASSERT_EQUAL_UINT32(0, accuracy.events);
+
+    // The next week's reading is scored and the mean stays a number
+    sensor_hal_init();
+    sample();
+    schedule_manager_update(at + 7 * 24 * 3600);
+    schedule_manager_get_accuracy(&accuracy);
+    TEST_ASSERT_EQUAL_UINT32(1, accuracy.events);
+    TEST_ASSERT_FALSE(isnan(accuracy.mean_abs_error_c));
+    TEST_ASSERT_FALSE(isnan(accuracy.last_error_c));
+}
+
+void test_entry_validation(void) {
+    schedule_entry_t entry = {
+        .zone = 0, .day = 8, .hour = 8, .minute = 0,
+        .temperature = 25.0f, .humidity = 60.0f, .light = 80.0f,
+    };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, schedule_manager_add(&entry));
+
+    entry.day = 1;
+    for (int i = 0; i < SCHEDULE_MAX_ENTRIES; i++) {
+        entry.minute = i;
+        TEST_ASSERT_EQUAL(ESP_OK, schedule_manager_add(&entry));
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, schedule_manager_add(&entry));
+
+    TEST_ASSERT_EQUAL(ESP_OK, schedule_manager_remove(0, 1, 8, 3));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, schedule_manager_remove(0, 1, 8, 3));
+    TEST_ASSERT_EQUAL_INT(SCHEDULE_MAX_ENTRIES - 1, schedule_manager_get_count());
+
+    schedule_entry_t copy;
+    TEST_ASSERT_EQUAL(ESP_OK, schedule_manager_get(3, &copy));
+    TEST_ASSERT_EQUAL_INT(4, copy.minute);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, schedule_manager_get(SCHEDULE_MAX_ENTRIES - 1, &copy));
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lead_time_default_rate);
+    RUN_TEST(test_learns_warm_rate);
+    RUN_TEST(test_entry_starts_early);
+    RUN_TEST(test_entry_fires_once_per_week);
+    RUN_TEST(test_missing_reading_not_scored);
+    RUN_TEST(test_entry_validation);
+    UNITY_END();
+}
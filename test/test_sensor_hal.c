@@ -0,0 +1,239 @@
+#include "unity.h"
+#include "sensor_hal.h"
+#include "sensor_chips.h"
+#include "sensor_driver.h"
+#include "climate_controller.h"
+#include "data_simulator.h"
+#include <math.h>
+
+#define SHT_ADDR 0x44
+#define LUX_ADDR 0x23
+
+// A DS18B20 ROM code: family, 48-bit serial, CRC
+static uint64_t make_rom(uint64_t serial) {
+    uint64_t rom = DS18B20_FAMILY | (serial & 0xFFFFFFFFFFFFULL) << 8;
+    uint8_t bytes[7];
+
+    for (int k = 0; k < 7; k++) {
+        bytes[k] = (uint8_t)(rom >> (8 * k));
+    }
+    return rom | (uint64_t)sensor_chips_crc_dallas(bytes, 7) << 56;
+}
+
+void setUp(void) {
+    climate_controller_init();
+    data_simulator_init();
+    sensor_mock_reset();
+}
+
+void tearDown(void) {
+    sensor_hal_init();
+}
+
+void test_i2c_start_then_fetch(void) {
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_SHT4X, 0, SHT_ADDR, 0, 0, SENSOR_PROBE_NONE, 250, 1 },
+        { SENSOR_KIND_BH1750, 0, LUX_ADDR, 0, 0, SENSOR_PROBE_NONE, 500, 1 },
+    };
+    sensor_mock_stats_t bus;
+    sensor_hal_stats_t stats;
+
+    sensor_mock_add_i2c(0, SENSOR_KIND_SHT4X, SHT_ADDR);
+    sensor_mock_add_i2c(0, SENSOR_KIND_BH1750, LUX_ADDR);
+    sensor_mock_set_i2c(0, SHT_ADDR, 26.5f, 61.0f, 0.0f);
+    sensor_mock_set_i2c(0, LUX_ADDR, 0.0f, 0.0f, 5000.0f);
+    TEST_ASSERT_EQUAL(ESP_OK, sensor_hal_set_sensors(table, 2));
+
+    // Both conversions start in one batch; nothing waits on them
+    TEST_ASSERT_EQUAL_INT64(9000, sensor_hal_poll(0));
+    sensor_mock_get_stats(&bus);
+    TEST_ASSERT_EQUAL_UINT32(1, bus.i2c_batches);
+    TEST_ASSERT_EQUAL_UINT32(2, bus.i2c_transactions);
+    TEST_ASSERT_TRUE(isnan(sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE)));
+
+    // The SHT4x is read once its conversion is done, the BH1750 later
+    TEST_ASSERT_EQUAL_INT64(180000, sensor_hal_poll(9000));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 26.5f, sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 61.0f, sensor_hal_get_value(0, SENSOR_VALUE_HUMIDITY));
+    TEST_ASSERT_TRUE(isnan(sensor_hal_get_value(0, SENSOR_VALUE_LIGHT)));
+
+    sensor_hal_poll(180000);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 5000.0f * 100.0f / SENSOR_LIGHT_FULL_SCALE_LUX,
+                             sensor_hal_get_value(0, SENSOR_VALUE_LIGHT));
+
+    sensor_hal_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.i2c_batches);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.samples);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.errors);
+}
+
+void test_ds18b20_convert_together(void) {
+    uint64_t roms[3] = { make_rom(0x1001), make_rom(0x2002), make_rom(0x3003) };
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_DS18B20, 0, 0, roms[2], 0, PROBE_BASKING, 1000, 1 },
+        { SENSOR_KIND_DS18B20, 0, 0, 0, 0, PROBE_COOL_SIDE, 1000, 1 },
+        { SENSOR_KIND_DS18B20, 0, 0, roms[0], 0, PROBE_SUBSTRATE, 1000, 1 },
+    };
+    sensor_mock_stats_t bus;
+    sensor_zone_t zone;
+
+    for (int i = 0; i < 3; i++) {
+        sensor_mock_add_ds18b20(0, roms[i]);
+        sensor_mock_set_ds18b20(0, roms[i], 20.0f + i);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, sensor_hal_set_sensors(table, 3));
+
+    // One broadcast converts all three probes
+    TEST_ASSERT_EQUAL_INT64(DS18B20_CONVERSION_MS * 1000LL, sensor_hal_poll(0));
+    sensor_mock_get_stats(&bus);
+    TEST_ASSERT_EQUAL_UINT32(1, bus.onewire_conversions);
+
+    // Each is read by its ROM code; the probe left at 0 got the one not named
+    sensor_hal_poll(DS18B20_CONVERSION_MS * 1000LL);
+    sensor_hal_get_zone(0, &zone);
+    TEST_ASSERT_FLOAT_WITHIN(0.07f, 22.0f, zone.probes[PROBE_BASKING]);
+    TEST_ASSERT_FLOAT_WITHIN(0.07f, 21.0f, zone.probes[PROBE_COOL_SIDE]);
+    TEST_ASSERT_FLOAT_WITHIN(0.07f, 20.0f, zone.probes[PROBE_SUBSTRATE]);
+    TEST_ASSERT_TRUE(isnan(zone.probes[PROBE_AMBIENT]));
+
+    sensor_hal_poll(1000000);
+    sensor_mock_get_stats(&bus);
+    TEST_ASSERT_EQUAL_UINT32(2, bus.onewire_conversions);
+}
+
+void test_decimation_averages(void) {
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_SHT3X, 0, SHT_ADDR, 0, 0, SENSOR_PROBE_NONE, 100, 4 },
+    };
+    sensor_hal_stats_t stats;
+    int64_t now = 0;
+
+    sensor_mock_add_i2c(0, SENSOR_KIND_SHT3X, SHT_ADDR);
+    TEST_ASSERT_EQUAL(ESP_OK, sensor_hal_set_sensors(table, 1));
+
+    // Four raw samples make one value
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(isnan(sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE)));
+        sensor_mock_set_i2c(0, SHT_ADDR, 20.0f + 2.0f * i, 50.0f, 0.0f);
+        sensor_hal_poll(now);
+        sensor_hal_poll(now + 16000);
+        now += 100000;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 23.0f, sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE));
+
+    sensor_hal_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.samples);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.values);
+}
+
+void test_fault_goes_stale(void) {
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_SHT4X, 0, SHT_ADDR, 0, 0, SENSOR_PROBE_NONE, 1000, 1 },
+    };
+    sensor_hal_stats_t stats;
+    int64_t now = 0;
+
+    sensor_mock_add_i2c(0, SENSOR_KIND_SHT4X, SHT_ADDR);
+    sensor_mock_set_i2c(0, SHT_ADDR, 25.0f, 50.0f, 0.0f);
+    TEST_ASSERT_EQUAL(ESP_OK, sensor_hal_set_sensors(table, 1));
+    sensor_hal_poll(0);
+    sensor_hal_poll(9000);
+    TEST_ASSERT_FALSE(isnan(sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE)));
+
+    // The last value holds until it is stale, then reads as missing
+    sensor_mock_set_fault(0, SHT_ADDR, true);
+    while (now <= 9000 + SENSOR_HAL_STALE_MS * 1000LL) {
+        now += 100000;
+        sensor_hal_poll(now);
+    }
+    TEST_ASSERT_TRUE(isnan(sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE)));
+    sensor_hal_get_stats(&stats);
+    TEST_ASSERT_TRUE(stats.errors >= SENSOR_HAL_STALE_MS / 1000);
+}
+
+void test_filter_rejects_spike(void) {
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_SHT4X, 0, SHT_ADDR, 0, 0, SENSOR_PROBE_NONE, 100, 1 },
+    };
+    sensor_filter_report_t report;
+    int64_t now = 0;
+
+    sensor_mock_add_i2c(0, SENSOR_KIND_SHT4X, SHT_ADDR);
+    TEST_ASSERT_EQUAL(ESP_OK, sensor_hal_set_sensors(table, 1));
+
+    // One reading 20 °C off never reaches the controller
+    for (int i = 0; i < 20; i++) {
+        sensor_mock_set_i2c(0, SHT_ADDR, i == 10 ? 45.0f : 25.0f, 50.0f, 0.0f);
+        sensor_hal_poll(now);
+        sensor_hal_poll(now + 9000);
+        TEST_ASSERT_FLOAT_WITHIN(0.2f, 25.0f, sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE));
+        now += 100000;
+    }
+
+    sensor_hal_get_filter_report(SENSOR_VALUE_TEMPERATURE, &report);
+    TEST_ASSERT_EQUAL_UINT32(20, report.stats.samples);
+    TEST_ASSERT_TRUE(report.lag_ms > 0.0f && report.lag_ms < 1000.0f);
+}
+
+void test_interlock_values_skip_filter(void) {
+    const sensor_config_t table[] = {
+        { SENSOR_KIND_SHT4X, 0, SHT_ADDR, 0, 0, SENSOR_PROBE_NONE, 1000, 1 },
+    };
+    int64_t now = 0;
+
+    sensor_mock_add_i2c(0, SENSOR_KIND_SHT4X, SHT_ADDR);
+    TEST_ASSERT_EQUAL(ESP_OK, sensor_hal_set_sensors(table, 1));
+
+    // A real step to 45 °C: the filter holds the old level for a few
+    // samples, the values for the interlock follow at once
+    for (int i = 0; i < 6; i++) {
+        sensor_mock_set_i2c(0, SHT_ADDR, i < 5 ? 30.0f : 45.0f, 50.0f, 0.0f);
+        sensor_hal_poll(now);
+        sensor_hal_poll(now + 9000);
+        now += 1000000;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 30.0f, sensor_hal_get_value(0, SENSOR_VALUE_TEMPERATURE));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 45.0f, sensor_hal_get_unfiltered(0, SENSOR_VALUE_TEMPERATURE));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, sensor_hal_get_unfiltered(0, SENSOR_VALUE_HUMIDITY));
+}
+
+void test_simulator_backend(void) {
+    float probes[PROBE_COUNT];
+
+    climate_controller_set_zone_count(3);
+    TEST_ASSERT_EQUAL(ESP_OK, sensor_hal_init());
+    sensor_hal_poll(0);
+
+    for (int z = 0; z < 3; z++) {
+        TEST_ASSERT_EQUAL_FLOAT(data_simulator_get_zone_temperature(z),
+                                sensor_hal_get_value(z, SENSOR_VALUE_TEMPERATURE));
+        TEST_ASSERT_EQUAL_FLOAT(data_simulator_get_zone_humidity(z),
+                                sensor_hal_get_value(z, SENSOR_VALUE_HUMIDITY));
+    }
+    data_simulator_get_zone_probes(0, probes);
+    TEST_ASSERT_EQUAL_FLOAT(probes[PROBE_AMBIENT], sensor_hal_get_ambient());
+    TEST_ASSERT_TRUE(isnan(sensor_hal_get_value(3, SENSOR_VALUE_TEMPERATURE)));
+
+    climate_controller_set_zone_count(1);
+}
+
+void test_rejects_bad_table(void) {
+    const sensor_config_t too_fast = { SENSOR_KIND_DS18B20, 0, 0, 0, 0, PROBE_BASKING, 500, 1 };
+    const sensor_config_t bad_probe = { SENSOR_KIND_SHT4X, 0, SHT_ADDR, 0, 0, PROBE_COUNT, 1000, 1 };
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, sensor_hal_set_sensors(&too_fast, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, sensor_hal_set_sensors(&bad_probe, 1));
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_i2c_start_then_fetch);
+    RUN_TEST(test_ds18b20_convert_together);
+    RUN_TEST(test_decimation_averages);
+    RUN_TEST(test_fault_goes_stale);
+    RUN_TEST(test_filter_rejects_spike);
+    RUN_TEST(test_interlock_values_skip_filter);
+    RUN_TEST(test_simulator_backend);
+    RUN_TEST(test_rejects_bad_table);
+    UNITY_END();
+}
@@ -0,0 +1,140 @@
+#include "unity.h"
+#include "signal_filter.h"
+#include <math.h>
+#include <stdio.h>
+
+static const signal_filter_config_t median_only = { 3, SIGNAL_SMOOTH_NONE, 0.0f, 0.0f, 0.0f, 0.0f };
+static const signal_filter_config_t kalman = { 1, SIGNAL_SMOOTH_KALMAN, 0.0f, 0.001f, 0.04f, 4.0f };
+
+// Repeatable noise in [-amplitude, amplitude]
+static float noise(uint32_t *seed, float amplitude) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return ((*seed >> 8) / 8388608.0f - 1.0f) * amplitude;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_median_rejects_spike(void) {
+    const float samples[] = { 25.0f, 25.1f, 40.0f, 25.0f, 24.9f, -10.0f, 25.0f };
+    signal_filter_t filter;
+
+    signal_filter_reset(&filter);
+    for (int i = 0; i < (int)(sizeof(samples) / sizeof(samples[0])); i++) {
+        float out = signal_filter_update(&filter, &median_only, samples[i], NULL);
+        TEST_ASSERT_FLOAT_WITHIN(0.2f, 25.0f, out);
+    }
+}
+
+void test_ema_step(void) {
+    const signal_filter_config_t ema = { 1, SIGNAL_SMOOTH_EMA, 0.5f, 0.0f, 0.0f, 0.0f };
+    signal_filter_t filter;
+
+    signal_filter_reset(&filter);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, signal_filter_update(&filter, &ema, 0.0f, NULL));
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, signal_filter_update(&filter, &ema, 1.0f, NULL));
+    TEST_ASSERT_EQUAL_FLOAT(0.75f, signal_filter_update(&filter, &ema, 1.0f, NULL));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, signal_filter_get_lag(&filter, &ema));
+}
+
+void test_kalman_reduces_noise(void) {
+    signal_filter_t filter;
+    signal_filter_stats_t stats = { 0 };
+    uint32_t seed = 1;
+    float out = 0.0f;
+
+    signal_filter_reset(&filter);
+    for (int i = 0; i < 500; i++) {
+        out = signal_filter_update(&filter, &kalman, 25.0f + noise(&seed, 0.3f), &stats);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 25.0f, out);
+    TEST_ASSERT_TRUE(signal_filter_get_noise_ratio(&stats) < 0.1f);
+    TEST_ASSERT_EQUAL_UINT32(500, stats.samples);
+    printf("Kalman noise ratio %.3f, lag %.1f samples\n", signal_filter_get_noise_ratio(&stats),
+           signal_filter_get_lag(&filter, &kalman));
+}
+
+void test_kalman_gates_then_follows_step(void) {
+    signal_filter_t filter;
+    signal_filter_stats_t stats = { 0 };
+
+    signal_filter_reset(&filter);
+    for (int i = 0; i < 50; i++) {
+        signal_filter_update(&filter, &kalman, 25.0f, &stats);
+    }
+
+    // A lone spike is gated out
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, signal_filter_update(&filter, &kalman, 35.0f, &stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.gated);
+    signal_filter_update(&filter, &kalman, 25.0f, &stats);
+
+    // A level that stays is taken after SIGNAL_KALMAN_REJECT_LIMIT samples
+    float out = 0.0f;
+    for (int i = 0; i < SIGNAL_KALMAN_REJECT_LIMIT; i++) {
+        out = signal_filter_update(&filter, &kalman, 35.0f, &stats);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(35.0f, out);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.restarts);
+}
+
+void test_missing_sample_restarts(void) {
+    signal_filter_t filter;
+
+    signal_filter_reset(&filter);
+    signal_filter_update(&filter, &kalman, 25.0f, NULL);
+    TEST_ASSERT_TRUE(isnan(signal_filter_update(&filter, &kalman, NAN, NULL)));
+
+    // No memory of the old level after the gap
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, signal_filter_update(&filter, &kalman, 30.0f, NULL));
+}
+
+void test_batch_matches_single(void) {
+    signal_filter_t batch[4];
+    signal_filter_t single[4];
+    float in[4];
+    float out[4];
+    uint32_t seed = 7;
+
+    for (int c = 0; c < 4; c++) {
+        signal_filter_reset(&batch[c]);
+        signal_filter_reset(&single[c]);
+    }
+    for (int i = 0; i < 20; i++) {
+        for (int c = 0; c < 4; c++) {
+            in[c] = 20.0f + c + noise(&seed, 0.5f);
+        }
+        signal_filter_update_batch(batch, &kalman, in, out, 4, NULL);
+        for (int c = 0; c < 4; c++) {
+            TEST_ASSERT_EQUAL_FLOAT(signal_filter_update(&single[c], &kalman, in[c], NULL), out[c]);
+        }
+    }
+}
+
+void test_median_lag(void) {
+    const signal_filter_config_t median5 = { 5, SIGNAL_SMOOTH_NONE, 0.0f, 0.0f, 0.0f, 0.0f };
+    signal_filter_t filter;
+    float out = 0.0f;
+
+    // On a ramp the median of 5 trails by two samples
+    signal_filter_reset(&filter);
+    for (int i = 0; i < 10; i++) {
+        out = signal_filter_update(&filter, &median5, (float)i, NULL);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(7.0f, out);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, signal_filter_get_lag(&filter, &median5));
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_median_rejects_spike);
+    RUN_TEST(test_ema_step);
+    RUN_TEST(test_kalman_reduces_noise);
+    RUN_TEST(test_kalman_gates_then_follows_step);
+    RUN_TEST(test_missing_sample_restarts);
+    RUN_TEST(test_batch_matches_single);
+    RUN_TEST(test_median_lag);
+    UNITY_END();
+}
@@ -0,0 +1,141 @@
+#include "unity.h"
+#include "species_preset.h"
+#include "climate_controller.h"
+#include "profile_manager.h"
+#include <string.h>
+
+void setUp(void) {
+    climate_controller_init();
+    profile_manager_init();
+}
+
+void tearDown(void) {
+    climate_zone_targets_t open = {
+        .temp_target = 25.0f,
+        .humidity_target = 60.0f,
+        .light_target = 75.0f,
+        .temp_min = CLIMATE_TEMP_LIMIT_MIN_C,
+        .temp_max = CLIMATE_TEMP_LIMIT_MAX_C,
+        .humidity_min = CLIMATE_HUMIDITY_LIMIT_MIN_PCT,
+        .humidity_max = CLIMATE_HUMIDITY_LIMIT_MAX_PCT,
+    };
+    profile_t profile;
+
+    climate_controller_zone_apply_targets(0, &open);
+    profile_manager_get(0, &profile);
+    profile.enabled = false;
+    profile.photoperiod_h = 0;
+    profile_manager_set(0, &profile);
+}
+
+void test_table(void) {
+    TEST_ASSERT_TRUE(species_preset_count() > 0);
+    TEST_ASSERT_NULL(species_preset_get(-1));
+    TEST_ASSERT_NULL(species_preset_get(species_preset_count()));
+
+    // The generator has checked every row; check the invariants held
+    for (int i = 0; i < species_preset_count(); i++) {
+        const species_preset_t *p = species_preset_get(i);
+        TEST_ASSERT_NOT_NULL(p);
+        TEST_ASSERT_TRUE(p->temp_min >= CLIMATE_TEMP_LIMIT_MIN_C && p->temp_max <= CLIMATE_TEMP_LIMIT_MAX_C);
+        TEST_ASSERT_TRUE(p->day_temp >= p->temp_min && p->day_temp <= p->temp_max);
+        TEST_ASSERT_TRUE(p->night_temp >= p->temp_min && p->night_temp <= p->temp_max);
+        TEST_ASSERT_TRUE(p->day_humidity >= p->humidity_min && p->day_humidity <= p->humidity_max);
+        TEST_ASSERT_TRUE(p->photoperiod_h <= 24);
+        TEST_ASSERT_EQUAL_PTR(p, species_preset_find(p->key));
+    }
+    TEST_ASSERT_NULL(species_preset_find("dragon"));
+}
+
+void test_apply(void) {
+    const species_preset_t *gecko = species_preset_find("leopard_gecko");
+    float t_min, t_max, h_min, h_max;
+    profile_t profile;
+
+    TEST_ASSERT_NOT_NULL(gecko);
+    climate_controller_zone_set_light_target(0, 60.0f);
+    TEST_ASSERT_EQUAL(ESP_OK, species_preset_apply(0, gecko));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->day_temp, climate_controller_zone_get_temp_target(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->day_humidity, climate_controller_zone_get_humidity_target(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 60.0f, climate_controller_zone_get_light_target(0));
+
+    climate_controller_zone_get_limits(0, &t_min, &t_max, &h_min, &h_max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->temp_min, t_min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->humidity_max, h_max);
+
+    profile_manager_get(0, &profile);
+    TEST_ASSERT_TRUE(profile.enabled);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->night_temp, profile.night_temp);
+    TEST_ASSERT_EQUAL_UINT8(gecko->photoperiod_h, profile.photoperiod_h);
+}
+
+void test_limits_bound_targets(void) {
+    const species_preset_t *gecko = species_preset_find("leopard_gecko");
+    float t_min, t_max, h_min, h_max;
+
+    species_preset_apply(0, gecko);
+
+    // Later setters are clamped to the preset's limits
+    climate_controller_zone_set_temp_target(0, 40.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->temp_max, climate_controller_zone_get_temp_target(0));
+    climate_controller_zone_set_humidity_target(0, 90.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->humidity_max, climate_controller_zone_get_humidity_target(0));
+
+    // And they survive a restart
+    climate_controller_init();
+    climate_controller_zone_get_limits(0, &t_min, &t_max, &h_min, &h_max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->temp_max, t_max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, gecko->humidity_min, h_min);
+}
+
+void test_invalid_limits(void) {
+    climate_zone_targets_t targets = {
+        .temp_target = 25.0f,
+        .humidity_target = 60.0f,
+        .light_target = 75.0f,
+        .temp_min = 30.0f,
+        .temp_max = 20.0f,
+        .humidity_min = 20.0f,
+        .humidity_max = 90.0f,
+    };
+    float t_min, t_max, h_min, h_max;
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, climate_controller_zone_apply_targets(0, &targets));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, climate_controller_zone_apply_targets(CLIMATE_MAX_ZONES, &targets));
+
+    // Limits beyond the outer bounds are pulled in to them
+    targets.temp_min = 0.0f;
+    targets.temp_max = 60.0f;
+    TEST_ASSERT_EQUAL(ESP_OK, climate_controller_zone_apply_targets(0, &targets));
+    climate_controller_zone_get_limits(0, &t_min, &t_max, &h_min, &h_max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, CLIMATE_TEMP_LIMIT_MIN_C, t_min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, CLIMATE_TEMP_LIMIT_MAX_C, t_max);
+}
+
+void test_rejected_preset_changes_nothing(void) {
+    species_preset_t bad = *species_preset_find("leopard_gecko");
+    float t_min, t_max, h_min, h_max;
+    profile_t profile;
+
+    // A profile the profile manager refuses must not leave the limits applied
+    bad.photoperiod_h = 25;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, species_preset_apply(0, &bad));
+
+    climate_controller_zone_get_limits(0, &t_min, &t_max, &h_min, &h_max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, CLIMATE_TEMP_LIMIT_MIN_C, t_min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, CLIMATE_HUMIDITY_LIMIT_MAX_PCT, h_max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, climate_controller_zone_get_temp_target(0));
+    profile_manager_get(0, &profile);
+    TEST_ASSERT_FALSE(profile.enabled);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_table);
+    RUN_TEST(test_apply);
+    RUN_TEST(test_limits_bound_targets);
+    RUN_TEST(test_invalid_limits);
+    RUN_TEST(test_rejected_preset_changes_nothing);
+    UNITY_END();
+}
@@ -0,0 +1,133 @@
+#include "unity.h"
+#include "stream_stats.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Repeatable uniform samples in [0, 1)
+static uint32_t rng_state;
+
+static float uniform(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (rng_state >> 8) / 16777216.0f;
+}
+
+static int compare_floats(const void *a, const void *b) {
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+void setUp(void) {
+    rng_state = 12345;
+}
+
+void tearDown(void) {
+}
+
+void test_mean_and_variance_match_two_pass(void) {
+    static float samples[2000];
+    stream_stats_t stats;
+    stream_summary_t summary;
+    double sum = 0.0, sq = 0.0;
+
+    stream_stats_reset(&stats);
+    for (int i = 0; i < 2000; i++) {
+        samples[i] = 25.0f + 3.0f * (uniform() - 0.5f);
+        stream_stats_add(&stats, samples[i], i * 1000LL);
+        sum += samples[i];
+    }
+    double mean = sum / 2000;
+    for (int i = 0; i < 2000; i++) {
+        sq += (samples[i] - mean) * (samples[i] - mean);
+    }
+
+    stream_stats_summarize(&stats, &summary);
+    TEST_ASSERT_EQUAL_UINT32(2000, summary.count);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, (float)mean, summary.mean);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, (float)sqrt(sq / 1999), summary.stddev);
+}
+
+void test_min_max_with_times(void) {
+    const float values[6] = { 24.0f, 22.5f, 27.0f, NAN, 26.0f, 23.0f };
+    stream_stats_t stats;
+    stream_summary_t summary;
+
+    stream_stats_reset(&stats);
+    for (int i = 0; i < 6; i++) {
+        stream_stats_add(&stats, values[i], 100LL * i);
+    }
+
+    // The missing sample is not counted
+    stream_stats_summarize(&stats, &summary);
+    TEST_ASSERT_EQUAL_UINT32(5, summary.count);
+    TEST_ASSERT_EQUAL_FLOAT(22.5f, summary.min);
+    TEST_ASSERT_EQUAL_INT64(100, summary.min_ms);
+    TEST_ASSERT_EQUAL_FLOAT(27.0f, summary.max);
+    TEST_ASSERT_EQUAL_INT64(200, summary.max_ms);
+    TEST_ASSERT_EQUAL_FLOAT(24.0f, summary.quantile[STREAM_STATS_P50]);
+}
+
+void test_p2_percentiles_track_exact(void) {
+    static float samples[10000];
+    stream_stats_t stats;
+
+    // A skewed distribution, where a mean and deviation would mislead
+    stream_stats_reset(&stats);
+    for (int i = 0; i < 10000; i++) {
+        float u = uniform();
+        samples[i] = 20.0f + 10.0f * u * u;
+        stream_stats_add(&stats, samples[i], i);
+    }
+    qsort(samples, 10000, sizeof(float), compare_floats);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, samples[500], stream_stats_quantile(&stats, STREAM_STATS_P05));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, samples[5000], stream_stats_quantile(&stats, STREAM_STATS_P50));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, samples[9500], stream_stats_quantile(&stats, STREAM_STATS_P95));
+}
+
+void test_windows_close_and_keep_last(void) {
+    stream_channel_t channel;
+    stream_summary_t summary;
+    uint8_t closed = 0;
+
+    stream_channel_init(&channel);
+    stream_channel_get(&channel, STREAM_WINDOW_HOUR, true, &summary);
+    TEST_ASSERT_EQUAL_UINT32(0, summary.count);
+    TEST_ASSERT_TRUE(isnan(summary.mean));
+
+    // One sample a minute: the first hour ramps 20..29.83
+    for (int m = 0; m < 60; m++) {
+        closed |= stream_channel_add(&channel, 20.0f + m / 6.0f, m * 60000LL);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, closed);
+
+    closed = stream_channel_add(&channel, 35.0f, STREAM_HOUR_MS);
+    TEST_ASSERT_EQUAL_UINT8(1 << STREAM_WINDOW_HOUR, closed);
+
+    stream_channel_get(&channel, STREAM_WINDOW_HOUR, true, &summary);
+    TEST_ASSERT_EQUAL_UINT32(60, summary.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, summary.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 29.83f, summary.max);
+    TEST_ASSERT_EQUAL_INT64(59 * 60000LL, summary.max_ms);
+
+    stream_channel_get(&channel, STREAM_WINDOW_HOUR, false, &summary);
+    TEST_ASSERT_EQUAL_UINT32(1, summary.count);
+    TEST_ASSERT_EQUAL_FLOAT(35.0f, summary.max);
+
+    // The day still holds everything
+    stream_channel_get(&channel, STREAM_WINDOW_DAY, false, &summary);
+    TEST_ASSERT_EQUAL_UINT32(61, summary.count);
+
+    // After a gap the window restarts on the hour grid
+    stream_channel_add(&channel, 30.0f, 5 * STREAM_HOUR_MS + 1000);
+    TEST_ASSERT_EQUAL_INT64(5 * STREAM_HOUR_MS, channel.start_ms[STREAM_WINDOW_HOUR]);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mean_and_variance_match_two_pass);
+    RUN_TEST(test_min_max_with_times);
+    RUN_TEST(test_p2_percentiles_track_exact);
+    RUN_TEST(test_windows_close_and_keep_last);
+    UNITY_END();
+}
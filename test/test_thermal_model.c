@@ -0,0 +1,108 @@
+#include "unity.h"
+#include "thermal_model.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static thermal_model_t model;
+
+// Known plant: T[k+1] = 0.95*T + 0.3*heat - 0.3*cool + 0.05*ambient
+static float plant_step(float temp, float heat, float cool, float ambient) {
+    return 0.95f * temp + 0.3f * heat - 0.3f * cool + 0.05f * ambient;
+}
+
+// Drive the plant with a pseudo-random relay sequence
+static float excite(thermal_model_t *m, int samples) {
+    float temp = 22.0f;
+    float heat = 0.0f, cool = 0.0f;
+    srand(42);
+
+    for (int i = 0; i < samples; i++) {
+        temp = plant_step(temp, heat, cool, 22.0f + (i % 100) * 0.02f);
+        thermal_model_update(m, temp, heat, cool, 22.0f + (i % 100) * 0.02f);
+        heat = (rand() % 3 == 0) ? 1.0f : 0.0f;
+        cool = (!heat && rand() % 4 == 0) ? 1.0f : 0.0f;
+    }
+    return temp;
+}
+
+void setUp(void) {
+    thermal_model_init(&model, 1);
+}
+
+void tearDown(void) {
+}
+
+void test_model_not_ready_without_samples(void) {
+    TEST_ASSERT_FALSE(thermal_model_is_ready(&model));
+}
+
+void test_model_identifies_first_order_plant(void) {
+    excite(&model, 1000);
+
+    TEST_ASSERT_TRUE(thermal_model_is_ready(&model));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.95f, model.theta[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.3f, thermal_model_heat_gain(&model));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.3f, thermal_model_cool_gain(&model));
+}
+
+void test_second_order_model_fits(void) {
+    thermal_model_init(&model, 2);
+    excite(&model, 1000);
+
+    // The extra lag should end up unused on a first-order plant
+    TEST_ASSERT_TRUE(thermal_model_is_ready(&model));
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.95f, model.theta[0] + model.theta[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.3f, thermal_model_heat_gain(&model));
+}
+
+void test_mpc_direction(void) {
+    excite(&model, 1000);
+
+    // Well below the target: heat at full duty
+    model.history[0] = model.history[1] = 20.0f;
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, thermal_mpc_plan(&model, 28.0f, 22.0f, 0.0f));
+
+    // Well above the target: cool
+    model.history[0] = model.history[1] = 32.0f;
+    TEST_ASSERT_TRUE(thermal_mpc_plan(&model, 28.0f, 22.0f, 0.0f) < 0.0f);
+}
+
+void test_predict_rise(void) {
+    excite(&model, 1000);
+
+    // Equilibrium at half duty is 25 °C: nothing to gain there
+    model.history[0] = model.history[1] = 25.0f;
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, thermal_model_predict_rise(&model, 0.5f, 22.0f, 100));
+
+    // From 20 °C at full duty it heads for 28 °C
+    model.history[0] = model.history[1] = 20.0f;
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 8.0f * (1.0f - powf(0.95f, 100)),
+                             thermal_model_predict_rise(&model, 1.0f, 22.0f, 100));
+}
+
+void test_mpc_holds_target(void) {
+    excite(&model, 1000);
+
+    // Closed loop on the same plant settles near the target
+    float temp = model.history[0];
+    for (int i = 0; i < 400; i++) {
+        float u = thermal_mpc_plan(&model, 28.0f, 22.0f, 0.0f);
+        float heat = u > 0.0f ? u : 0.0f;
+        float cool = u < 0.0f ? -u : 0.0f;
+        temp = plant_step(temp, heat, cool, 22.0f);
+        thermal_model_update(&model, temp, heat, cool, 22.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 28.0f, temp);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_model_not_ready_without_samples);
+    RUN_TEST(test_model_identifies_first_order_plant);
+    RUN_TEST(test_second_order_model_fits);
+    RUN_TEST(test_mpc_direction);
+    RUN_TEST(test_predict_rise);
+    RUN_TEST(test_mpc_holds_target);
+    UNITY_END();
+}
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Generate the IRAM placement profile from a function trace.
+
+Reads the FTRACE lines logged by a REPTICONTROL_FUNC_TRACE build
+(utils/func_trace.c), resolves the traced addresses against the ELF and the
+linker map, and writes:
+
+  main/hot_paths.lf         linker fragment placing the hot set in IRAM
+  main/utils/hot_paths.h    the same list, checked by utils/hot_path_bench.c
+
+Functions are ranked by calls per second: every call of a flash-resident
+function can miss in the cache that PSRAM rendering keeps evicting. Only
+functions of the main component are placed, init and UI construction code is
+never placed, and the set is capped by --budget bytes of IRAM.
+
+Usage:
+    idf.py -DREPTICONTROL_FUNC_TRACE=ON build flash monitor | tee trace.log
+    tools/gen_iram_placement.py trace.log
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_ELF = os.path.join(ROOT, "build", "REPTICONTROL.elf")
+DEFAULT_MAP = os.path.join(ROOT, "build", "REPTICONTROL.map")
+LF_PATH = os.path.join(ROOT, "main", "hot_paths.lf")
+HEADER_PATH = os.path.join(ROOT, "main", "utils", "hot_paths.h")
+
+FTRACE_RE = re.compile(r"FTRACE fn=0x([0-9a-fA-F]+) calls=(\d+) cycles=(\d+)")
+END_RE = re.compile(r"FTRACE_END functions=\d+ dropped=\d+ cpu_hz=(\d+)")
+MAP_SECTION_RE = re.compile(r"^\s*\.(?:text|literal)\.(\S+)\s*$")
+MAP_ENTRY_RE = re.compile(r"^\s*(?:\.(?:text|literal)\.(\S+))?\s+0x[0-9a-f]+\s+0x[0-9a-f]+\s+\S*libmain\.a\(([^)]+)\.c\.obj\)")
+
+# Code that runs once or only while building screens stays in flash
+COLD_NAME_RE = re.compile(r"(_init|_create|_deinit)$")
+COLD_OBJECTS = re.compile(r"^(ui_(climate|dashboard|first_setup|logs|schedule|system)|ui_helpers)$")
+
+
+def parse_trace(path):
+    funcs = {}
+    cpu_hz = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = FTRACE_RE.search(line)
+            if m:
+                funcs[int(m.group(1), 16)] = (int(m.group(2)), int(m.group(3)))
+                continue
+            m = END_RE.search(line)
+            if m:
+                cpu_hz = int(m.group(1))
+    return funcs, cpu_hz
+
+
+def read_symbols(elf, nm):
+    """Map function address -> (name, size)."""
+    out = subprocess.run([nm, "-S", "--defined-only", elf], check=True,
+                         capture_output=True, text=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 4 and parts[2] in ("T", "t"):
+            symbols[int(parts[0], 16)] = (parts[3], int(parts[1], 16))
+    return symbols
+
+
+def read_objects(map_path):
+    """Map function name -> object file (main component only)."""
+    objects = {}
+    pending = None
+    with open(map_path, errors="replace") as f:
+        for line in f:
+            m = MAP_SECTION_RE.match(line)
+            if m:
+                pending = m.group(1)
+                continue
+            m = MAP_ENTRY_RE.match(line)
+            if m:
+                name = m.group(1) or pending
+                if name:
+                    objects[name] = m.group(2)
+            pending = None
+    return objects
+
+
+def select(funcs, symbols, objects, duration_s, budget, min_rate):
+    candidates = []
+    for addr, (calls, cycles) in funcs.items():
+        sym = symbols.get(addr)
+        if not sym:
+            continue
+        name, size = sym
+        obj = objects.get(name)
+        if not obj or COLD_NAME_RE.search(name) or COLD_OBJECTS.match(obj):
+            continue
+        rate = calls / duration_s
+        if rate >= min_rate:
+            candidates.append((rate, cycles, name, obj, size))
+
+    candidates.sort(key=lambda c: (-c[0], -c[1]))
+    chosen, used = [], 0
+    for rate, cycles, name, obj, size in candidates:
+        if used + size > budget:
+            continue
+        chosen.append((name, obj, size, rate))
+        used += size
+    return chosen, used
+
+
+def write_outputs(chosen, trace_name):
+    with open(LF_PATH, "w") as f:
+        f.write("# IRAM placement for REPTICONTROL_PLACEMENT_PROFILE.\n")
+        f.write("# Generated by tools/gen_iram_placement.py from {}; do not edit.\n\n".format(trace_name))
+        f.write("[mapping:repticontrol_hot_paths]\narchive: libmain.a\nentries:\n")
+        for name, obj, size, rate in chosen:
+            f.write("    {}:{} (noflash)\n".format(obj, name))
+
+    with open(HEADER_PATH, "w") as f:
+        f.write("#ifndef HOT_PATHS_H\n#define HOT_PATHS_H\n\n")
+        f.write("// Functions placed in IRAM by hot_paths.lf. Generated together with the\n")
+        f.write("// fragment by tools/gen_iram_placement.py; checked by hot_path_bench.\n")
+        f.write("static const char *const hot_path_functions[] = {\n")
+        for name, obj, size, rate in chosen:
+            f.write("    \"{}\",\n".format(name))
+        f.write("};\n\n#endif /* HOT_PATHS_H */\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace", help="monitor log containing FTRACE lines")
+    parser.add_argument("--elf", default=DEFAULT_ELF)
+    parser.add_argument("--map", default=DEFAULT_MAP)
+    parser.add_argument("--nm", default="xtensa-esp32s3-elf-nm")
+    parser.add_argument("--duration", type=float, default=60.0,
+                        help="trace duration in seconds (FUNC_TRACE_DURATION_MS)")
+    parser.add_argument("--budget", type=int, default=12 * 1024,
+                        help="IRAM bytes available for the hot set")
+    parser.add_argument("--min-rate", type=float, default=1.0,
+                        help="minimum calls per second to be considered hot")
+    args = parser.parse_args()
+
+    funcs, _ = parse_trace(args.trace)
+    if not funcs:
+        print("error: no FTRACE lines in " + args.trace)
+        return 1
+
+    symbols = read_symbols(args.elf, args.nm)
+    objects = read_objects(args.map)
+    chosen, used = select(funcs, symbols, objects, args.duration, args.budget, args.min_rate)
+
+    write_outputs(chosen, os.path.basename(args.trace))
+    for name, obj, size, rate in chosen:
+        print("{:<40} {:<24} {:>6} B {:>10.1f} calls/s".format(name, obj, size, rate))
+    print("{} functions, {} bytes of IRAM".format(len(chosen), used))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
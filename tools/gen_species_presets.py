@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Generate the species preset table from its data file.
+
+Reads main/core/species_presets.csv and writes a header holding one const
+species_preset_t per row, included by core/species_preset.c. Run by the
+build (main/CMakeLists.txt) whenever the data file or this script changes;
+the firmware never parses the data at run time.
+
+Every row is checked here, so a bad preset fails the build rather than
+reaching a terrarium: targets must lie within the row's limits, and the
+limits within the controller's outer bounds (CLIMATE_TEMP_LIMIT_* and
+CLIMATE_HUMIDITY_LIMIT_* in climate_controller.h).
+
+Usage:
+    tools/gen_species_presets.py main/core/species_presets.csv species_presets_table.h
+"""
+
+import argparse
+import csv
+import os
+import re
+import sys
+
+# Outer bounds of climate_controller.h
+TEMP_LIMITS = (15.0, 40.0)
+HUMIDITY_LIMITS = (20.0, 90.0)
+
+KEY_RE = re.compile(r"^[a-z][a-z0-9_]*$")
+KEY_MAX = 23
+NAME_MAX = 31
+
+COLUMNS = [
+    "key", "name", "day_temp_c", "night_temp_c", "day_humidity_pct", "night_humidity_pct",
+    "photoperiod_h", "uvb_h", "temp_min_c", "temp_max_c", "humidity_min_pct", "humidity_max_pct",
+]
+FLOATS = [
+    "day_temp_c", "night_temp_c", "day_humidity_pct", "night_humidity_pct",
+    "temp_min_c", "temp_max_c", "humidity_min_pct", "humidity_max_pct",
+]
+
+
+class PresetError(Exception):
+    pass
+
+
+def check_row(row, keys):
+    key = row["key"]
+    if not KEY_RE.match(key) or len(key) > KEY_MAX:
+        raise PresetError("bad key '{}' (lowercase, digits and _, at most {} chars)".format(key, KEY_MAX))
+    if key in keys:
+        raise PresetError("duplicate key '{}'".format(key))
+    name = row["name"]
+    if not name or len(name) > NAME_MAX or '"' in name or "\\" in name:
+        raise PresetError("bad name '{}' (1..{} chars, no quotes)".format(name, NAME_MAX))
+
+    p = {"key": key, "name": name}
+    try:
+        for col in FLOATS:
+            p[col] = float(row[col])
+        p["photoperiod_h"] = int(row["photoperiod_h"])
+        p["uvb_h"] = int(row["uvb_h"])
+    except ValueError as e:
+        raise PresetError(str(e))
+
+    for kind, unit, bounds in (("temp", "c", TEMP_LIMITS), ("humidity", "pct", HUMIDITY_LIMITS)):
+        lo, hi = p["{}_min_{}".format(kind, unit)], p["{}_max_{}".format(kind, unit)]
+        if not bounds[0] <= lo < hi <= bounds[1]:
+            raise PresetError("{} limits {}..{} outside {}..{}".format(kind, lo, hi, *bounds))
+        for when in ("day", "night"):
+            value = p["{}_{}_{}".format(when, kind, unit)]
+            if not lo <= value <= hi:
+                raise PresetError("{} {} {} outside its limits {}..{}".format(when, kind, value, lo, hi))
+
+    if not 0 <= p["photoperiod_h"] <= 24:
+        raise PresetError("photoperiod {} h outside 0..24".format(p["photoperiod_h"]))
+    if not 0 <= p["uvb_h"] <= (p["photoperiod_h"] or 24):
+        raise PresetError("{} h of UVB in a {} h day".format(p["uvb_h"], p["photoperiod_h"]))
+    return p
+
+
+def read_presets(path):
+    presets = []
+    with open(path, newline="") as f:
+        lines = [(n, line) for n, line in enumerate(f, 1) if line.strip() and not line.startswith("#")]
+    reader = csv.DictReader(line for _, line in lines)
+    if reader.fieldnames != COLUMNS:
+        raise PresetError("{}:{}: expected columns {}".format(path, lines[0][0] if lines else 1, ",".join(COLUMNS)))
+    for (n, _), row in zip(lines[1:], reader):
+        try:
+            presets.append(check_row(row, {p["key"] for p in presets}))
+        except PresetError as e:
+            raise PresetError("{}:{}: {}".format(path, n, e))
+    if not presets:
+        raise PresetError("{}: no presets".format(path))
+    return presets
+
+
+def c_float(value):
+    """Shortest C float literal that reads back as the parsed value."""
+    return repr(value) + "f"
+
+
+def write_header(presets, out_path, source_name):
+    with open(out_path, "w") as f:
+        f.write("#ifndef SPECIES_PRESETS_TABLE_H\n#define SPECIES_PRESETS_TABLE_H\n\n")
+        f.write("// Generated by tools/gen_species_presets.py from {}; do not edit.\n".format(source_name))
+        f.write("// Included once, by species_preset.c; const, so it stays in flash.\n\n")
+        f.write("#define SPECIES_PRESET_TABLE_COUNT {}\n\n".format(len(presets)))
+        f.write("static const species_preset_t species_preset_table[SPECIES_PRESET_TABLE_COUNT] = {\n")
+        for p in presets:
+            f.write("    {\n")
+            f.write("        .key = \"{}\",\n".format(p["key"]))
+            f.write("        .name = \"{}\",\n".format(p["name"]))
+            f.write("        .day_temp = {},\n".format(c_float(p["day_temp_c"])))
+            f.write("        .night_temp = {},\n".format(c_float(p["night_temp_c"])))
+            f.write("        .day_humidity = {},\n".format(c_float(p["day_humidity_pct"])))
+            f.write("        .night_humidity = {},\n".format(c_float(p["night_humidity_pct"])))
+            f.write("        .photoperiod_h = {},\n".format(p["photoperiod_h"]))
+            f.write("        .uvb_h = {},\n".format(p["uvb_h"]))
+            f.write("        .temp_min = {},\n".format(c_float(p["temp_min_c"])))
+            f.write("        .temp_max = {},\n".format(c_float(p["temp_max_c"])))
+            f.write("        .humidity_min = {},\n".format(c_float(p["humidity_min_pct"])))
+            f.write("        .humidity_max = {},\n".format(c_float(p["humidity_max_pct"])))
+            f.write("    },\n")
+        f.write("};\n\n#endif /* SPECIES_PRESETS_TABLE_H */\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("csv", help="preset data file")
+    parser.add_argument("output", help="header to write")
+    args = parser.parse_args()
+
+    try:
+        presets = read_presets(args.csv)
+    except (OSError, PresetError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    write_header(presets, args.output, os.path.basename(args.csv))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+"""Boot ReptiControl under Espressif QEMU (esp32s3) and report boot timing.
+
+Builds the headless firmware with REPTICONTROL_BOOT_PROFILE, merges it into a
+flash image, runs it in qemu-system-xtensa and parses the BOOT / TASK /
+IDLE_CPU lines logged by utils/boot_profiler.c. The result is written as JSON
+and compared against a baseline; the exit status is non-zero on a regression,
+when a task has less than MIN_STACK_FREE bytes of stack left, or when there
+is no baseline to compare against (record one with --update-baseline).
+
+Usage:
+    tools/qemu_boot_bench.py [--no-build] [--baseline tools/boot_baseline.json]
+                             [--update-baseline] [--tolerance 20]
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BUILD_DIR = os.path.join(ROOT, "build_qemu")
+FLASH_IMAGE = os.path.join(BUILD_DIR, "qemu_flash.bin")
+DEFAULT_BASELINE = os.path.join(ROOT, "tools", "boot_baseline.json")
+
+BOOT_RE = re.compile(r"BOOT name=(\S+) start_us=(\d+) dur_us=(\d+)")
+DONE_RE = re.compile(r"BOOT_DONE total_us=(\d+)")
+TASK_RE = re.compile(r"TASK name=(\S+) prio=(\d+) runtime=(\d+) pct=([\d.]+) stack_free=(\d+)")
+IDLE_RE = re.compile(r"IDLE_CPU pct=([\d.]+)")
+END_MARK = "BOOT_PROFILE_END"
+
+# Least free stack (bytes) a task may have left; checked without a baseline
+MIN_STACK_FREE = 512
+
+# Tasks that do I2C or formatting work on their own stack; each must be in
+# the report so its margin is actually checked
+STACK_TASKS = ("climate_task", "monitor_task", "safety_task")
+
+
+def run(cmd, **kwargs):
+    print("+ " + " ".join(cmd), flush=True)
+    subprocess.run(cmd, check=True, cwd=ROOT, **kwargs)
+
+
+def build():
+    run(["idf.py", "-B", BUILD_DIR,
+         "-DSDKCONFIG=" + os.path.join(BUILD_DIR, "sdkconfig"),
+         "-DSDKCONFIG_DEFAULTS=sdkconfig.defaults.qemu",
+         "-DREPTICONTROL_HEADLESS=ON",
+         "-DREPTICONTROL_BOOT_PROFILE=ON",
+         "build"])
+    # Same layout esptool would flash, padded to the full flash size
+    subprocess.run(["esptool.py", "--chip", "esp32s3", "merge_bin",
+                    "--fill-flash-size", "4MB", "-o", FLASH_IMAGE,
+                    "@flash_args"], check=True, cwd=BUILD_DIR)
+
+
+def boot(timeout_s, psram):
+    cmd = ["qemu-system-xtensa", "-nographic",
+           "-machine", "esp32s3",
+           "-m", psram,
+           "-drive", "file={},if=mtd,format=raw".format(FLASH_IMAGE),
+           "-global", "driver=timer.esp32s3.timg,property=wdt_disable,value=true",
+           "-serial", "mon:stdio"]
+    print("+ " + " ".join(cmd), flush=True)
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            stdin=subprocess.DEVNULL, text=True, errors="replace")
+    lines = []
+    deadline = time.monotonic() + timeout_s
+    try:
+        for line in proc.stdout:
+            lines.append(line.rstrip("\n"))
+            if END_MARK in line or time.monotonic() > deadline:
+                break
+    finally:
+        proc.kill()
+        proc.wait()
+    return lines
+
+
+def parse(lines):
+    result = {"stages": [], "total_us": None, "tasks": [], "idle_cpu_pct": None}
+    for line in lines:
+        m = BOOT_RE.search(line)
+        if m:
+            result["stages"].append({"name": m.group(1),
+                                     "start_us": int(m.group(2)),
+                                     "dur_us": int(m.group(3))})
+            continue
+        m = DONE_RE.search(line)
+        if m:
+            result["total_us"] = int(m.group(1))
+            continue
+        m = TASK_RE.search(line)
+        if m:
+            result["tasks"].append({"name": m.group(1),
+                                    "prio": int(m.group(2)),
+                                    "runtime": int(m.group(3)),
+                                    "pct": float(m.group(4)),
+                                    "stack_free": int(m.group(5))})
+            continue
+        m = IDLE_RE.search(line)
+        if m:
+            result["idle_cpu_pct"] = float(m.group(1))
+    return result
+
+
+def compare(result, baseline, tolerance_pct):
+    """Return a list of human-readable regressions."""
+    regressions = []
+    limit = 1.0 + tolerance_pct / 100.0
+
+    if baseline.get("total_us") and result["total_us"] > baseline["total_us"] * limit:
+        regressions.append("total boot {} us > baseline {} us".format(
+            result["total_us"], baseline["total_us"]))
+
+    base_stages = {s["name"]: s["dur_us"] for s in baseline.get("stages", [])}
+    for stage in result["stages"]:
+        base = base_stages.get(stage["name"])
+        # Ignore sub-millisecond stages, QEMU jitter dominates them
+        if base and stage["dur_us"] > 1000 and stage["dur_us"] > base * limit:
+            regressions.append("stage {} {} us > baseline {} us".format(
+                stage["name"], stage["dur_us"], base))
+
+    base_idle = baseline.get("idle_cpu_pct")
+    if base_idle is not None and result["idle_cpu_pct"] is not None:
+        if result["idle_cpu_pct"] < base_idle - tolerance_pct:
+            regressions.append("idle CPU {}% < baseline {}%".format(
+                result["idle_cpu_pct"], base_idle))
+    return regressions
+
+
+def check_stacks(result):
+    """Return the tasks that came within MIN_STACK_FREE of their stack."""
+    errors = ["task {} has {} bytes of stack left < {}".format(t["name"], t["stack_free"], MIN_STACK_FREE)
+              for t in result["tasks"] if t["stack_free"] < MIN_STACK_FREE]
+    names = {t["name"] for t in result["tasks"]}
+    errors += ["task {} not in the report".format(n) for n in STACK_TASKS if n not in names]
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--no-build", action="store_true", help="reuse build_qemu")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE)
+    parser.add_argument("--update-baseline", action="store_true")
+    parser.add_argument("--tolerance", type=float, default=20.0,
+                        help="allowed regression in percent")
+    parser.add_argument("--timeout", type=float, default=120.0,
+                        help="seconds to wait for the profile to finish")
+    parser.add_argument("--psram", default="8M", help="emulated PSRAM size")
+    parser.add_argument("--output", default=os.path.join(BUILD_DIR, "boot_bench.json"))
+    parser.add_argument("--log", default=os.path.join(BUILD_DIR, "qemu_boot.log"))
+    args = parser.parse_args()
+
+    if not args.no_build:
+        build()
+
+    lines = boot(args.timeout, args.psram)
+    with open(args.log, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+    result = parse(lines)
+    if result["total_us"] is None:
+        print("error: firmware did not report BOOT_DONE, see " + args.log)
+        return 2
+
+    with open(args.output, "w") as f:
+        json.dump(result, f, indent=2)
+
+    print("{:<20} {:>12} {:>12}".format("stage", "start_us", "dur_us"))
+    for stage in result["stages"]:
+        print("{:<20} {:>12} {:>12}".format(stage["name"], stage["start_us"], stage["dur_us"]))
+    print("total boot: {} us, idle CPU: {}%".format(result["total_us"], result["idle_cpu_pct"]))
+
+    stack_errors = check_stacks(result)
+    for e in stack_errors:
+        print("STACK: " + e)
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(result, f, indent=2)
+        print("baseline updated: " + args.baseline)
+        return 1 if stack_errors else 0
+
+    # Without a baseline nothing was compared: fail rather than pass unchecked
+    if not os.path.exists(args.baseline):
+        print("error: no baseline at {}, record one with --update-baseline".format(args.baseline))
+        return 1
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    regressions = compare(result, baseline, args.tolerance)
+    for r in regressions:
+        print("REGRESSION: " + r)
+    return 1 if regressions or stack_errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())